@@ -0,0 +1,76 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include <QObject>
+#include <QTest>
+
+#include <solid/device.h>
+#include <solid/devicequeryjob.h>
+
+class DeviceQueryJobTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void testQueryMatchesListFromQuery();
+    void testEmptyQueryReturnsAllDevices();
+    void testBackgroundPriority();
+    void testInvalidPredicate();
+};
+
+void DeviceQueryJobTest::initTestCase()
+{
+    qputenv("SOLID_FAKEHW", FAKE_COMPUTER_XML);
+}
+
+void DeviceQueryJobTest::testQueryMatchesListFromQuery()
+{
+    const QString query = QStringLiteral("StorageVolume.usage == 'FileSystem'");
+
+    auto *job = new Solid::DeviceQueryJob(query);
+    QVERIFY(job->exec());
+    QCOMPARE(job->error(), int(Solid::Job::NoError));
+    QVERIFY(!job->isPartial());
+
+    const QList<Solid::Device> jobDevices = job->devices();
+    const QList<Solid::Device> syncDevices = Solid::Device::listFromQuery(query);
+
+    QCOMPARE(jobDevices.count(), syncDevices.count());
+    for (const Solid::Device &device : jobDevices) {
+        QVERIFY(device.isValid());
+    }
+}
+
+void DeviceQueryJobTest::testEmptyQueryReturnsAllDevices()
+{
+    auto *job = new Solid::DeviceQueryJob;
+    QVERIFY(job->exec());
+
+    QCOMPARE(job->devices().count(), Solid::Device::allDevices().count());
+}
+
+void DeviceQueryJobTest::testBackgroundPriority()
+{
+    const QString query = QStringLiteral("StorageVolume.usage == 'FileSystem'");
+
+    auto *job = new Solid::DeviceQueryJob(query);
+    job->setPriority(Solid::DeviceQueryJob::BackgroundPriority);
+    QVERIFY(job->exec());
+
+    QCOMPARE(job->devices().count(), Solid::Device::listFromQuery(query).count());
+}
+
+void DeviceQueryJobTest::testInvalidPredicate()
+{
+    auto *job = new Solid::DeviceQueryJob(QStringLiteral("blup"));
+    QVERIFY(!job->exec());
+    QCOMPARE(job->error(), int(Solid::DeviceQueryJob::InvalidPredicate));
+    QVERIFY(job->devices().isEmpty());
+}
+
+QTEST_MAIN(DeviceQueryJobTest)
+
+#include "devicequeryjobtest.moc"
@@ -0,0 +1,84 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include <QObject>
+#include <QTest>
+
+#include "solid/devices/frontend/devicestoreformat_p.h"
+
+using Solid::DeviceInterface;
+
+class DeviceStoreFormatTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testRoundTrip();
+    void testEmptyTable();
+    void testRejectsCorruptData();
+};
+
+void DeviceStoreFormatTest::testRoundTrip()
+{
+    QHash<DeviceInterface::Type, QStringList> table;
+    table[DeviceInterface::Block] = QStringList{QStringLiteral("/org/test/volume1"), QStringLiteral("/org/test/volume2")};
+    table[DeviceInterface::StorageVolume] = QStringList{QStringLiteral("/org/test/volume1")};
+    table[DeviceInterface::Battery] = QStringList{QStringLiteral("/org/test/battery")};
+
+    const QByteArray data = Solid::DeviceStoreFormat::serialize(table);
+    QVERIFY(!data.isEmpty());
+
+    bool ok = false;
+    const auto decoded = Solid::DeviceStoreFormat::deserialize(reinterpret_cast<const uchar *>(data.constData()), data.size(), &ok);
+    QVERIFY(ok);
+
+    QCOMPARE(decoded.size(), table.size());
+    for (auto it = table.constBegin(); it != table.constEnd(); ++it) {
+        // Record order is not preserved, membership is.
+        QStringList expected = it.value();
+        QStringList actual = decoded.value(it.key());
+        expected.sort();
+        actual.sort();
+        QCOMPARE(actual, expected);
+    }
+}
+
+void DeviceStoreFormatTest::testEmptyTable()
+{
+    const QByteArray data = Solid::DeviceStoreFormat::serialize({});
+
+    bool ok = false;
+    const auto decoded = Solid::DeviceStoreFormat::deserialize(reinterpret_cast<const uchar *>(data.constData()), data.size(), &ok);
+    QVERIFY(ok);
+    QVERIFY(decoded.isEmpty());
+}
+
+void DeviceStoreFormatTest::testRejectsCorruptData()
+{
+    QHash<DeviceInterface::Type, QStringList> table;
+    table[DeviceInterface::Block] = QStringList{QStringLiteral("/org/test/volume1")};
+
+    QByteArray data = Solid::DeviceStoreFormat::serialize(table);
+    bool ok = true;
+
+    // Truncated below the header.
+    Solid::DeviceStoreFormat::deserialize(reinterpret_cast<const uchar *>(data.constData()), 4, &ok);
+    QVERIFY(!ok);
+
+    // Truncated string table.
+    ok = true;
+    Solid::DeviceStoreFormat::deserialize(reinterpret_cast<const uchar *>(data.constData()), data.size() - 1, &ok);
+    QVERIFY(!ok);
+
+    // Wrong magic.
+    data[0] = 'X';
+    ok = true;
+    Solid::DeviceStoreFormat::deserialize(reinterpret_cast<const uchar *>(data.constData()), data.size(), &ok);
+    QVERIFY(!ok);
+}
+
+QTEST_MAIN(DeviceStoreFormatTest)
+
+#include "devicestoreformattest.moc"
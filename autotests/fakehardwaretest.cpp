@@ -56,6 +56,41 @@ void FakeHardwareTest::testFakeBackend()
     delete processor;
     delete device;
     delete computer;
+
+    const int initialCount = fakeManager->allDevices().count();
+    QMap<QString, QVariant> propertyTemplate;
+    propertyTemplate.insert("name", "Synthetic Volume");
+    propertyTemplate.insert("interfaces", "Block,StorageVolume");
+    propertyTemplate.insert("parent", "/org/kde/solid/fakehw/computer");
+
+    const QStringList synthesized = fakeManager->createSyntheticDevices(10, propertyTemplate);
+    QCOMPARE(synthesized.count(), 10);
+    QCOMPARE(fakeManager->allDevices().count(), initialCount + 10);
+    QVERIFY(fakeManager->findDevice(synthesized.first()) != nullptr);
+    QVERIFY(fakeManager->findDevice(synthesized.first())->queryDeviceInterface(Solid::DeviceInterface::StorageVolume));
+
+    // synthetic devices share the template; writes stay per-device
+    Solid::Backends::Fake::FakeDevice *first = fakeManager->findDevice(synthesized.at(0));
+    Solid::Backends::Fake::FakeDevice *second = fakeManager->findDevice(synthesized.at(1));
+    QVERIFY(first->setProperty("name", "Renamed Volume"));
+    QCOMPARE(first->property("name").toString(), QString("Renamed Volume"));
+    QCOMPARE(second->property("name").toString(), QString("Synthetic Volume"));
+
+    QVERIFY(first->removeProperty("parent"));
+    QVERIFY(!first->propertyExists("parent"));
+    QVERIFY(second->propertyExists("parent"));
+    QVERIFY(!first->allProperties().contains("parent"));
+    QCOMPARE(first->allProperties().value("name").toString(), QString("Renamed Volume"));
+
+    // the capability mask comes from the device table, without
+    // instantiating any device
+    QCOMPARE(fakeManager->deviceInterfacesMask("/org/kde/solid/fakehw/acpi_CPU0"),
+             quint32(1) << Solid::DeviceInterface::Processor);
+    QCOMPARE(fakeManager->deviceInterfacesMask(synthesized.first()),
+             (quint32(1) << Solid::DeviceInterface::Block)
+             | (quint32(1) << Solid::DeviceInterface::StorageVolume));
+    QCOMPARE(fakeManager->deviceInterfacesMask("/com/helloworld/troll/compiutor"), quint32(0));
+
     delete fakeManager;
 }
 
@@ -38,6 +38,9 @@ private:
 void solidFreedesktopTest::initTestCase()
 {
     qputenv("SOLID_POWER_BACKEND", "FREE_DESKTOP");
+    // release inhibitors immediately instead of holding them for the
+    // re-acquire grace window, so the removal spies below see them go away
+    qputenv("SOLID_POWER_INHIBITION_GRACE", "0");
 
     m_fakeUPower = new FakeUpower(this);
     QDBusConnection::systemBus().registerService(QStringLiteral("org.freedesktop.UPower"));
@@ -6,17 +6,27 @@
 
 #include "solidhwtest.h"
 
+#include <QCollator>
+#include <QTemporaryFile>
 #include <QTest>
+#include <QTextStream>
 #include <QSignalSpy>
 
 #include <solid/devicenotifier.h>
 #include <solid/device.h>
+#include <solid/deviceiterator.h>
 #include <solid/genericinterface.h>
+#include <solid/networkshare.h>
 #include <solid/processor.h>
 #include <solid/storageaccess.h>
+#include <solid/storageaccessview.h>
+#include <solid/storagedrive.h>
 #include <solid/storagevolume.h>
 #include <solid/predicate.h>
+#include <solid/propertywatcher.h>
+#include <solid/querywatcher.h>
 #include "solid/devices/managerbase_p.h"
+#include "solid/devices/solidconfig_p.h"
 
 #include <fakemanager.h>
 #include <fakedevice.h>
@@ -37,6 +47,11 @@ QTEST_MAIN(SolidHwTest)
 void SolidHwTest::initTestCase()
 {
     qputenv("SOLID_FAKEHW", FAKE_COMPUTER_XML);
+    // The tests below unplug and replug the same devices many times in
+    // quick succession; keep flap admission control out of the way except
+    // where it is tested explicitly.
+    qputenv("SOLID_DEVICE_EVENT_BUDGET", "0");
+    Solid::Config::reload();
     Solid::ManagerBasePrivate *manager
         = dynamic_cast<Solid::ManagerBasePrivate *>(Solid::DeviceNotifier::instance());
     fakeManager = qobject_cast<Solid::Backends::Fake::FakeManager *>(manager->managerBackends().first());
@@ -89,6 +104,14 @@ void SolidHwTest::testDeviceBasicFeatures()
     QCOMPARE(valid_dev.as<Solid::GenericInterface>()->property("name"), QVariant("Solid IDE DVD Writer"));
     QVERIFY(!valid_dev.as<Solid::GenericInterface>()->property("foo.bar").isValid());
 
+    // Typed accessors
+    QCOMPARE(valid_dev.as<Solid::GenericInterface>()->propertyString("name"), QString("Solid IDE DVD Writer"));
+    QCOMPARE(valid_dev.as<Solid::GenericInterface>()->propertyString("foo.bar"), QString());
+    QCOMPARE(valid_dev.as<Solid::GenericInterface>()->propertyBool("isEjectRequired"), true);
+    QCOMPARE(valid_dev.as<Solid::GenericInterface>()->propertyBool("foo.bar", true), true);
+    QCOMPARE(valid_dev.as<Solid::GenericInterface>()->propertyInt("readSpeed"), 4234);
+    QCOMPARE(valid_dev.as<Solid::GenericInterface>()->propertyInt("foo.bar", -1), -1);
+
     Solid::Backends::Fake::FakeDevice *fake_device = fakeManager->findDevice("/org/kde/solid/fakehw/storage_model_solid_writer");
     QMap<QString, QVariant> expected_properties = fake_device->allProperties();
 
@@ -193,6 +216,65 @@ void SolidHwTest::testDeviceSignals()
     QCOMPARE(condition_raised.at(0).at(1).toString(), QString("Why not?"));
 }
 
+void SolidHwTest::testPropertyValuesChangedSignal()
+{
+    Solid::Backends::Fake::FakeDevice *fake = fakeManager->findDevice("/org/kde/solid/fakehw/platform_floppy_0_storage_virt_volume");
+    Solid::Device device("/org/kde/solid/fakehw/platform_floppy_0_storage_virt_volume");
+
+    QSignalSpy values_changed(device.as<Solid::GenericInterface>(), SIGNAL(propertyValuesChanged(QVariantMap)));
+
+    fake->setProperty("mountPoint", "/tmp.bar");
+    fake->setProperty("hactar", 42);
+    fake->removeProperty("hactar");
+
+    QCOMPARE(values_changed.count(), 3);
+
+    // modifications and additions carry the new value
+    QVariantMap changedValues = values_changed.at(0).at(0).value<QVariantMap>();
+    QCOMPARE(changedValues.count(), 1);
+    QCOMPARE(changedValues["mountPoint"], QVariant("/tmp.bar"));
+
+    changedValues = values_changed.at(1).at(0).value<QVariantMap>();
+    QCOMPARE(changedValues["hactar"], QVariant(42));
+
+    // removals carry an invalid QVariant
+    changedValues = values_changed.at(2).at(0).value<QVariantMap>();
+    QVERIFY(changedValues.contains("hactar"));
+    QVERIFY(!changedValues["hactar"].isValid());
+}
+
+void SolidHwTest::testPropertyWatcher()
+{
+    const QString udi = "/org/kde/solid/fakehw/platform_floppy_0_storage_virt_volume";
+    Solid::Backends::Fake::FakeDevice *fake = fakeManager->findDevice(udi);
+
+    Solid::PropertyWatcher watcher(udi, QStringList() << "hactar");
+    QCOMPARE(watcher.udi(), udi);
+    QCOMPARE(watcher.properties(), QStringList() << "hactar");
+
+    QSignalSpy changes(&watcher, SIGNAL(propertiesChanged(QVariantMap)));
+
+    // changes touching no watched property are filtered out
+    fake->setProperty("zarquon", 23);
+    QCOMPARE(changes.count(), 0);
+
+    // a watched change arrives with the new value, and only watched keys
+    fake->setProperty("hactar", 42);
+    QCOMPARE(changes.count(), 1);
+    QVariantMap changedValues = changes.at(0).at(0).value<QVariantMap>();
+    QCOMPARE(changedValues.count(), 1);
+    QCOMPARE(changedValues["hactar"], QVariant(42));
+
+    // removals are reported with an invalid value
+    fake->removeProperty("hactar");
+    QCOMPARE(changes.count(), 2);
+    changedValues = changes.at(1).at(0).value<QVariantMap>();
+    QVERIFY(changedValues.contains("hactar"));
+    QVERIFY(!changedValues["hactar"].isValid());
+
+    fake->removeProperty("zarquon");
+}
+
 void SolidHwTest::testDeviceExistence()
 {
     QCOMPARE(Solid::Device("/org/kde/solid/fakehw/platform_floppy_0_storage_virt_volume").isValid(), true);
@@ -362,6 +444,93 @@ void SolidHwTest::testPredicate()
 
 }
 
+void SolidHwTest::testPredicateBuilders()
+{
+    Solid::Predicate built = Solid::Predicate::fromTypes({Solid::DeviceInterface::Processor,
+                                                          Solid::DeviceInterface::StorageVolume});
+    Solid::Predicate parsed = Solid::Predicate::fromString("[IS Processor OR IS StorageVolume]");
+    QCOMPARE(built.toString(), parsed.toString());
+
+    Solid::Predicate all = Solid::Predicate::allOf({Solid::Predicate(Solid::DeviceInterface::Processor, "maxSpeed", 3200),
+                                                    Solid::Predicate(Solid::DeviceInterface::Processor, "canChangeFrequency", true)});
+    QCOMPARE(Solid::Device::listFromQuery(all).size(), 2);
+
+    Solid::Predicate any = Solid::Predicate::anyOf({Solid::Predicate(Solid::DeviceInterface::Processor, "number", 1)});
+    QCOMPARE(Solid::Device::listFromQuery(any).size(), 1);
+
+    QVERIFY(!Solid::Predicate::fromTypes({}).isValid());
+    QVERIFY(!Solid::Predicate::allOf({}).isValid());
+    QVERIFY(!Solid::Predicate::anyOf({}).isValid());
+}
+
+void SolidHwTest::testPredicateCandidateTypes()
+{
+    // A disjunction needs the candidates of both operands...
+    Solid::Predicate p1 = Solid::Predicate::fromString("[IS Processor OR IS StorageVolume]");
+    QCOMPARE(p1.candidateTypes(),
+             QSet<Solid::DeviceInterface::Type>() << Solid::DeviceInterface::Processor
+                                                  << Solid::DeviceInterface::StorageVolume);
+    QCOMPARE(p1.candidateTypesMask(),
+             (quint32(1) << Solid::DeviceInterface::Processor)
+             | (quint32(1) << Solid::DeviceInterface::StorageVolume));
+
+    // ...while a conjunction is covered by a single operand.
+    Solid::Predicate p2 = Solid::Predicate::fromString("[IS StorageVolume AND StorageAccess.ignored == false]");
+    QCOMPARE(p2.candidateTypes().size(), 1);
+
+    // The pruned enumeration must not change the query results: both
+    // operand orders cover the same devices.
+    const auto list = Solid::Device::listFromQuery(p2);
+    const auto reversedList = Solid::Device::listFromQuery("[StorageAccess.ignored == false AND IS StorageVolume]");
+    QVERIFY(!list.isEmpty());
+    QCOMPARE(to_string_list(list), to_string_list(reversedList));
+    for (const Solid::Device &dev : list) {
+        QVERIFY(dev.isDeviceInterface(Solid::DeviceInterface::StorageVolume));
+        QVERIFY(dev.isDeviceInterface(Solid::DeviceInterface::StorageAccess));
+    }
+}
+
+void SolidHwTest::testPredicateNormalized()
+{
+    // duplicate terms collapse and the chain is flattened
+    Solid::Predicate p1 = Solid::Predicate::fromString(
+        "[[IS StorageVolume AND IS StorageVolume] AND IS StorageVolume]");
+    QCOMPARE(p1.normalized().toString(), QString("IS StorageVolume"));
+
+    // a property check implies the interface check on the same interface
+    Solid::Predicate p2 = Solid::Predicate::fromString(
+        "[IS StorageAccess AND StorageAccess.ignored == false]");
+    QCOMPARE(p2.normalized().toString(), QString("StorageAccess.ignored == false"));
+
+    // unmatchable disjuncts disappear, unmatchable conjuncts poison
+    Solid::Predicate unmatchable;
+    Solid::Predicate p3 = Solid::Predicate(Solid::DeviceInterface::Processor) | unmatchable;
+    QCOMPARE(p3.normalized().toString(), QString("IS Processor"));
+    Solid::Predicate p4 = Solid::Predicate(Solid::DeviceInterface::Processor) & unmatchable;
+    QVERIFY(!p4.normalized().isValid());
+
+    // the simplified form matches the same devices
+    Solid::Predicate p5 = Solid::Predicate::fromString(
+        "[[IS StorageVolume AND IS StorageVolume] AND StorageAccess.ignored == false]");
+    QCOMPARE(to_string_list(Solid::Device::listFromQuery(p5.normalized())),
+             to_string_list(Solid::Device::listFromQuery(p5)));
+}
+
+void SolidHwTest::testPredicateUsedProperties()
+{
+    // every property check contributes its property name
+    Solid::Predicate p1 = Solid::Predicate::fromString(
+        "[StorageVolume.size == 1024 AND StorageAccess.ignored == false]");
+    QCOMPARE(p1.usedProperties(),
+             QSet<QString>() << QString("size") << QString("ignored"));
+
+    // interface checks depend on no property at all
+    Solid::Predicate p2 = Solid::Predicate::fromString("[IS Processor OR IS StorageVolume]");
+    QVERIFY(p2.usedProperties().isEmpty());
+
+    QVERIFY(Solid::Predicate().usedProperties().isEmpty());
+}
+
 void SolidHwTest::testQueryStorageVolumeOrProcessor()
 {
     auto list = Solid::Device::listFromQuery("[Processor.number==1 OR IS StorageVolume]");
@@ -429,6 +598,35 @@ void SolidHwTest::testQueryWithParentUdi()
              QString("/org/kde/solid/fakehw/acpi_CPU1"));
 }
 
+void SolidHwTest::testUdisFromQuery()
+{
+    // The match-everything form returns the backend's list directly.
+    QStringList allUdis = Solid::Device::udisFromQuery(Solid::Predicate());
+    std::sort(allUdis.begin(), allUdis.end());
+    QStringList expectedUdis = fakeManager->allDevices();
+    std::sort(expectedUdis.begin(), expectedUdis.end());
+    QCOMPARE(allUdis, expectedUdis);
+
+    // A filtered query returns the same UDIs listFromQuery() resolves.
+    const Solid::Predicate predicate
+        = Solid::Predicate::fromString("[Processor.number==1 OR IS StorageVolume]");
+    const QStringList udis = Solid::Device::udisFromQuery(predicate);
+    QCOMPARE(udis, to_string_list(Solid::Device::listFromQuery(predicate)));
+    QCOMPARE(udis.size(), 10);
+
+    // An equality check is answered from the result index.
+    const Solid::Predicate equality
+        = Solid::Predicate::fromString("[StorageVolume.ignored == false]");
+    const QStringList mountable = Solid::Device::udisFromQuery(equality);
+    QCOMPARE(mountable, to_string_list(Solid::Device::listFromQuery(equality)));
+
+    // Parent constraints go through the backend query path.
+    const QString parentUdi = "/org/kde/solid/fakehw/storage_model_solid_reader";
+    const QStringList children
+        = Solid::Device::udisFromQuery(Solid::Predicate(Solid::DeviceInterface::StorageVolume), parentUdi);
+    QCOMPARE(children, QStringList{"/org/kde/solid/fakehw/volume_label_SOLIDMAN_BEGINS"});
+}
+
 void SolidHwTest::testListFromTypeProcessor()
 {
     const auto ifaceType = Solid::DeviceInterface::Processor;
@@ -444,6 +642,298 @@ void SolidHwTest::testListFromTypeInvalid()
     QCOMPARE(list.size(), 0);
 }
 
+void SolidHwTest::testDeviceIterator()
+{
+    // drained completely, the iterator delivers the same devices as a
+    // full enumeration
+    QStringList iterated;
+    Solid::DeviceIterator it;
+    while (it.hasNext()) {
+        iterated << it.next().udi();
+    }
+    QStringList expected = fakeManager->allDevices();
+    std::sort(iterated.begin(), iterated.end());
+    std::sort(expected.begin(), expected.end());
+    QCOMPARE(iterated, expected);
+
+    // the predicate form matches listFromQuery()
+    const QString query = QStringLiteral("IS Processor");
+    QStringList matched;
+    Solid::DeviceIterator typed(Solid::Predicate::fromString(query));
+    while (typed.hasNext()) {
+        matched << typed.next().udi();
+    }
+    const QList<Solid::Device> reference = Solid::Device::listFromQuery(query);
+    QCOMPARE(matched.count(), reference.count());
+    for (const Solid::Device &device : reference) {
+        QVERIFY(matched.contains(device.udi()));
+    }
+
+    // a paging consumer can stop after the first screenful
+    Solid::DeviceIterator page(Solid::DeviceInterface::Processor);
+    QVERIFY(page.hasNext());
+    QVERIFY(page.next().isValid());
+
+    // exhausted iterators report an invalid device
+    Solid::DeviceIterator empty(Solid::Predicate::fromString(QStringLiteral("IS OpticalDrive"))
+                                & Solid::Predicate::fromString(QStringLiteral("IS Camera")));
+    while (empty.hasNext()) {
+        empty.next();
+    }
+    QVERIFY(!empty.next().isValid());
+}
+
+void SolidHwTest::testDisplayOrderedDevices()
+{
+    const QList<Solid::Device> ordered = Solid::Device::allDevices(Solid::Device::DisplayOrder);
+    QCOMPARE(ordered.count(), Solid::Device::allDevices().count());
+
+    QCollator collator;
+    collator.setNumericMode(true);
+    for (int i = 1; i < ordered.count(); ++i) {
+        QVERIFY(collator.compare(ordered.at(i - 1).description(), ordered.at(i).description()) <= 0);
+    }
+
+    // the ordered view follows hotplug incrementally
+    fakeManager->unplug("/org/kde/solid/fakehw/acpi_CPU0");
+    const QList<Solid::Device> afterRemoval = Solid::Device::allDevices(Solid::Device::DisplayOrder);
+    QCOMPARE(afterRemoval.count(), ordered.count() - 1);
+    for (const Solid::Device &device : afterRemoval) {
+        QVERIFY(device.udi() != QString("/org/kde/solid/fakehw/acpi_CPU0"));
+    }
+
+    fakeManager->plug("/org/kde/solid/fakehw/acpi_CPU0");
+    QCOMPARE(Solid::Device::allDevices(Solid::Device::DisplayOrder).count(), ordered.count());
+}
+
+void SolidHwTest::testEventLogReplay()
+{
+    QTemporaryFile logFile;
+    QVERIFY(logFile.open());
+    QTextStream out(&logFile);
+    out << "# recorded by solid-hardware record\n";
+    out << "0 removed /org/kde/solid/fakehw/acpi_CPU0\n";
+    out << "5 added /org/kde/solid/fakehw/acpi_CPU0\n";
+    out << "not a valid line\n";
+    out << "10 changed /org/kde/solid/fakehw/acpi_CPU0\n";
+    out.flush();
+    logFile.close();
+
+    Solid::DeviceNotifier *notifier = Solid::DeviceNotifier::instance();
+    QSignalSpy added(notifier, SIGNAL(deviceAdded(QString)));
+    QSignalSpy removed(notifier, SIGNAL(deviceRemoved(QString)));
+
+    // comments and malformed lines are skipped, the three events apply
+    QCOMPARE(fakeManager->replayEventLog(logFile.fileName(), 0), 3);
+    QCOMPARE(added.count(), 1);
+    QCOMPARE(removed.count(), 1);
+    QCOMPARE(added.at(0).at(0).toString(), QString("/org/kde/solid/fakehw/acpi_CPU0"));
+
+    QCOMPARE(fakeManager->replayEventLog("/nonexistent.log", 0), -1);
+}
+
+void SolidHwTest::testFromBlockDevice()
+{
+    Solid::Device device = Solid::Device::fromBlockDevice(3, 1);
+    QVERIFY(device.isValid());
+    QCOMPARE(device.udi(), QString("/org/kde/solid/fakehw/volume_uuid_feedface"));
+
+    device = Solid::Device::fromBlockDevice(3, 6);
+    QCOMPARE(device.udi(), QString("/org/kde/solid/fakehw/volume_uuid_c0ffee"));
+
+    device = Solid::Device::fromBlockDevice(42, 42);
+    QVERIFY(!device.isValid());
+}
+
+void SolidHwTest::testQueryWatcher()
+{
+    Solid::QueryWatcher watcher(Solid::Predicate(Solid::DeviceInterface::Processor));
+
+    // seeded with the current matches, which are not announced
+    QCOMPARE(watcher.matches().size(), 2);
+    QVERIFY(watcher.matches().contains("/org/kde/solid/fakehw/acpi_CPU0"));
+
+    QSignalSpy entered(&watcher, SIGNAL(deviceEntered(QString)));
+    QSignalSpy left(&watcher, SIGNAL(deviceLeft(QString)));
+
+    fakeManager->unplug("/org/kde/solid/fakehw/acpi_CPU0");
+    QCOMPARE(left.count(), 1);
+    QCOMPARE(left.at(0).at(0).toString(), QString("/org/kde/solid/fakehw/acpi_CPU0"));
+    QCOMPARE(watcher.matches().size(), 1);
+
+    // non-matching devices come and go unannounced
+    fakeManager->unplug("/org/kde/solid/fakehw/volume_uuid_feedface");
+    fakeManager->plug("/org/kde/solid/fakehw/volume_uuid_feedface");
+    QCOMPARE(entered.count(), 0);
+    QCOMPARE(left.count(), 1);
+
+    fakeManager->plug("/org/kde/solid/fakehw/acpi_CPU0");
+    QCOMPARE(entered.count(), 1);
+    QCOMPARE(entered.at(0).at(0).toString(), QString("/org/kde/solid/fakehw/acpi_CPU0"));
+    QCOMPARE(watcher.matches().size(), 2);
+}
+
+void SolidHwTest::testFromUuid()
+{
+    Solid::Device device = Solid::Device::fromUuid("feedface");
+    QVERIFY(device.isValid());
+    QCOMPARE(device.udi(), QString("/org/kde/solid/fakehw/volume_uuid_feedface"));
+
+    // the lookup is case-insensitive
+    device = Solid::Device::fromUuid("C0FFEE");
+    QCOMPARE(device.udi(), QString("/org/kde/solid/fakehw/volume_uuid_c0ffee"));
+
+    device = Solid::Device::fromUuid("deadbeef");
+    QVERIFY(!device.isValid());
+}
+
+void SolidHwTest::testDriveVolumes()
+{
+    Solid::Device drive("/org/kde/solid/fakehw/storage_serial_HD56890I");
+    Solid::StorageDrive *storage = drive.as<Solid::StorageDrive>();
+    QVERIFY(storage != nullptr);
+
+    QStringList udis;
+    const QList<Solid::Device> volumes = storage->volumes();
+    for (const Solid::Device &volume : volumes) {
+        QVERIFY(volume.is<Solid::StorageVolume>());
+        udis << volume.udi();
+    }
+    QCOMPARE(udis.size(), 5);
+    QVERIFY(udis.contains("/org/kde/solid/fakehw/volume_uuid_feedface"));
+    QVERIFY(udis.contains("/org/kde/solid/fakehw/volume_uuid_f00ba7"));
+
+    // the adjacency map follows hotplug events
+    fakeManager->unplug("/org/kde/solid/fakehw/volume_uuid_f00ba7");
+    QCOMPARE(storage->volumes().size(), 4);
+    fakeManager->plug("/org/kde/solid/fakehw/volume_uuid_f00ba7");
+    QCOMPARE(storage->volumes().size(), 5);
+}
+
+void SolidHwTest::testStorageAccessView()
+{
+    Solid::Device device("/org/kde/solid/fakehw/volume_uuid_feedface");
+
+    // the view reads through the backend without creating the frontend
+    // interface object on the device
+    Solid::StorageAccessView view(device);
+    QVERIFY(view.isValid());
+    QVERIFY(view.isAccessible());
+    QCOMPARE(view.filePath(), QString("/"));
+
+    // and agrees with the full interface
+    Solid::StorageAccess *access = device.as<Solid::StorageAccess>();
+    QCOMPARE(view.isAccessible(), access->isAccessible());
+    QCOMPARE(view.filePath(), access->filePath());
+
+    Solid::Device cpu("/org/kde/solid/fakehw/acpi_CPU0");
+    Solid::StorageAccessView invalidView(cpu);
+    QVERIFY(!invalidView.isValid());
+    QVERIFY(!invalidView.isAccessible());
+}
+
+void SolidHwTest::testEventReplay()
+{
+    const quint64 start = Solid::DeviceNotifier::lastEventSequence();
+
+    // nothing to catch up on from the current point
+    QList<Solid::DeviceNotifier::Event> events;
+    QVERIFY(Solid::DeviceNotifier::eventsSince(start, &events));
+    QVERIFY(events.isEmpty());
+
+    fakeManager->unplug("/org/kde/solid/fakehw/acpi_CPU0");
+    fakeManager->plug("/org/kde/solid/fakehw/acpi_CPU0");
+
+    // a late subscriber replays the missed events in order
+    QVERIFY(Solid::DeviceNotifier::eventsSince(start, &events));
+    QCOMPARE(events.count(), 2);
+    QCOMPARE(events.at(0).udi, QString("/org/kde/solid/fakehw/acpi_CPU0"));
+    QCOMPARE(events.at(0).kind, Solid::DeviceNotifier::Event::DeviceRemoved);
+    QCOMPARE(events.at(1).udi, QString("/org/kde/solid/fakehw/acpi_CPU0"));
+    QCOMPARE(events.at(1).kind, Solid::DeviceNotifier::Event::DeviceAdded);
+    QCOMPARE(events.at(1).sequence, Solid::DeviceNotifier::lastEventSequence());
+
+    // property changes only get journaled once requested, and
+    // consecutive changes of the same device collapse into one record
+    FakeDevice *fake = fakeManager->findDevice("/org/kde/solid/fakehw/acpi_CPU0");
+    fake->setProperty("hactar", 42);
+    QCOMPARE(Solid::DeviceNotifier::lastEventSequence(), events.at(1).sequence);
+
+    Solid::Device cpu("/org/kde/solid/fakehw/acpi_CPU0"); // registers the device
+    Solid::DeviceNotifier::setChangeJournalEnabled(true);
+    const quint64 beforeChanges = Solid::DeviceNotifier::lastEventSequence();
+    fake->setProperty("hactar", 43);
+    fake->setProperty("hactar", 44);
+    events.clear();
+    QVERIFY(Solid::DeviceNotifier::eventsSince(beforeChanges, &events));
+    QCOMPARE(events.count(), 1);
+    QCOMPARE(events.at(0).kind, Solid::DeviceNotifier::Event::DeviceChanged);
+    QCOMPARE(events.at(0).udi, QString("/org/kde/solid/fakehw/acpi_CPU0"));
+    Solid::DeviceNotifier::setChangeJournalEnabled(false);
+
+    // a point older than the retained window forces a re-enumeration
+    events.clear();
+    for (int i = 0; i < 300; ++i) {
+        fakeManager->unplug("/org/kde/solid/fakehw/acpi_CPU0");
+        fakeManager->plug("/org/kde/solid/fakehw/acpi_CPU0");
+    }
+    QVERIFY(!Solid::DeviceNotifier::eventsSince(start, &events));
+    QVERIFY(events.isEmpty());
+}
+
+void SolidHwTest::testDeviceEventQuarantine()
+{
+    qputenv("SOLID_DEVICE_EVENT_BUDGET", "4");
+    Solid::Config::reload();
+
+    Solid::DeviceNotifier *notifier = Solid::DeviceNotifier::instance();
+    QSignalSpy added(notifier, SIGNAL(deviceAdded(QString)));
+    QSignalSpy removed(notifier, SIGNAL(deviceRemoved(QString)));
+
+    fakeManager->unplug("/org/kde/solid/fakehw/acpi_CPU0");
+    fakeManager->plug("/org/kde/solid/fakehw/acpi_CPU0");
+    fakeManager->unplug("/org/kde/solid/fakehw/acpi_CPU0");
+    fakeManager->plug("/org/kde/solid/fakehw/acpi_CPU0");
+
+    // The budget covers these four events.
+    QCOMPARE(removed.count(), 2);
+    QCOMPARE(added.count(), 2);
+
+    // The fifth event goes over budget; the removal is still delivered so
+    // the device disappears exactly once, then the quarantine swallows
+    // everything after.
+    fakeManager->unplug("/org/kde/solid/fakehw/acpi_CPU0");
+    QCOMPARE(removed.count(), 3);
+
+    fakeManager->plug("/org/kde/solid/fakehw/acpi_CPU0");
+    fakeManager->unplug("/org/kde/solid/fakehw/acpi_CPU0");
+    QCOMPARE(removed.count(), 3);
+    QCOMPARE(added.count(), 2);
+
+    // Other devices are not affected by the quarantine.
+    fakeManager->unplug("/org/kde/solid/fakehw/acpi_CPU1");
+    fakeManager->plug("/org/kde/solid/fakehw/acpi_CPU1");
+    QCOMPARE(removed.count(), 4);
+    QCOMPARE(added.count(), 3);
+
+    // Disabling the budget bypasses the quarantine; replug the device so
+    // it is visible again for the remaining tests.
+    qputenv("SOLID_DEVICE_EVENT_BUDGET", "0");
+    Solid::Config::reload();
+    fakeManager->plug("/org/kde/solid/fakehw/acpi_CPU0");
+    QCOMPARE(added.count(), 4);
+}
+
+void SolidHwTest::testNetworkShareList()
+{
+    const QList<Solid::NetworkShare::Share> shares = Solid::NetworkShare::allShares();
+
+    QCOMPARE(shares.count(), 1);
+    QCOMPARE(shares.first().udi, QString("/org/kde/solid/fakehw/fstab/thehost/solidpath"));
+    QCOMPARE(shares.first().type, Solid::NetworkShare::Nfs);
+    QCOMPARE(shares.first().url, QUrl("nfs://thehost/solid-path"));
+}
+
 void SolidHwTest::testSetupTeardown()
 {
     Solid::StorageAccess *access;
@@ -469,6 +959,84 @@ void SolidHwTest::testSetupTeardown()
 
 }
 
+void SolidHwTest::testSetupAsyncNotSupported()
+{
+    Solid::Device device("/org/kde/solid/fakehw/volume_part1_size_993284096");
+    Solid::StorageAccess *access = device.as<Solid::StorageAccess>();
+
+    // The volume is already mounted, so another setup is refused and the
+    // future resolves synchronously instead of waiting for setupDone().
+    QVERIFY(access->isAccessible());
+    QFuture<Solid::StorageAccess::AccessResult> future = access->setupAsync();
+    QVERIFY(future.isFinished());
+    QCOMPARE(future.result().error, Solid::OperationFailed);
+}
+
+void SolidHwTest::testBatchSetupTeardown()
+{
+    Solid::Device volume("/org/kde/solid/fakehw/volume_part1_size_993284096");
+    Solid::Device processor("/org/kde/solid/fakehw/acpi_CPU0");
+    QVERIFY(volume.as<Solid::StorageAccess>()->isAccessible());
+
+    // The fake backend completes synchronously, so the aggregated future
+    // resolves as soon as every device has reported.
+    auto teardownFuture = Solid::StorageAccess::teardownAll({volume, processor});
+    QTRY_VERIFY(teardownFuture.isFinished());
+    const auto teardownResults = teardownFuture.result();
+    QCOMPARE(teardownResults.size(), 2);
+    QCOMPARE(teardownResults.value(volume.udi()).error, Solid::NoError);
+    // devices without StorageAccess report the same failure an
+    // unsupported teardownAsync() does
+    QCOMPARE(teardownResults.value(processor.udi()).error, Solid::OperationFailed);
+    QVERIFY(!volume.as<Solid::StorageAccess>()->isAccessible());
+
+    auto setupFuture = Solid::StorageAccess::setupAll({volume});
+    QTRY_VERIFY(setupFuture.isFinished());
+    QCOMPARE(setupFuture.result().value(volume.udi()).error, Solid::NoError);
+    QVERIFY(volume.as<Solid::StorageAccess>()->isAccessible());
+
+    // an empty batch resolves immediately with an empty map
+    auto emptyFuture = Solid::StorageAccess::teardownAll({});
+    QVERIFY(emptyFuture.isFinished());
+    QVERIFY(emptyFuture.result().isEmpty());
+}
+
+void SolidHwTest::testPrefetchIcons()
+{
+    Solid::Device cpu("/org/kde/solid/fakehw/acpi_CPU0");
+    Solid::Device volume("/org/kde/solid/fakehw/volume_part1_size_993284096");
+
+    QFuture<void> future = Solid::Device::prefetchIcons({cpu, volume});
+    QTRY_VERIFY(future.isFinished());
+
+    // the memos answer without touching the fallback chain again
+    QCOMPARE(cpu.icon(), QString("cpu"));
+    QVERIFY(!volume.icon().isEmpty());
+
+    // a batch of already-memoized devices resolves immediately
+    QVERIFY(Solid::Device::prefetchIcons({cpu, volume}).isFinished());
+}
+
+void SolidHwTest::testDiagnosticState()
+{
+    const QVariantMap state = Solid::DeviceNotifier::diagnosticState();
+
+    QVERIFY(state.contains("frontend"));
+    QVERIFY(state.contains("backends"));
+    QVERIFY(state.contains("counters"));
+
+    // the fake backend reports its device table
+    const QVariantMap backends = state.value("backends").toMap();
+    QVERIFY(backends.contains(fakeManager->udiPrefix()));
+    const QVariantMap fakeState = backends.value(fakeManager->udiPrefix()).toMap();
+    QCOMPARE(fakeState.value("loadedDevices").toInt(), fakeManager->allDevices().count());
+
+    // everything must survive a JSON round trip, dump files depend on it
+    const QVariantMap frontend = state.value("frontend").toMap();
+    QVERIFY(frontend.value("registeredDevices").canConvert<qulonglong>());
+    QVERIFY(frontend.value("eventSequence").canConvert<qulonglong>());
+}
+
 void SolidHwTest::slotPropertyChanged(const QMap<QString, int> &changes)
 {
     m_changesList << changes;
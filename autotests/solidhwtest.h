@@ -30,6 +30,8 @@ private Q_SLOTS:
     void testDeviceBasicFeatures();
     void testManagerSignals();
     void testDeviceSignals();
+    void testPropertyValuesChangedSignal();
+    void testPropertyWatcher();
     void testDeviceExistence();
     void testDeviceInterfaceIntrospection_data();
     void testDeviceInterfaceIntrospection();
@@ -37,12 +39,32 @@ private Q_SLOTS:
     void testDeviceInterfaces();
     void testInvalidPredicate();
     void testPredicate();
+    void testPredicateBuilders();
+    void testPredicateCandidateTypes();
+    void testPredicateNormalized();
+    void testPredicateUsedProperties();
     void testQueryStorageVolumeOrProcessor();
     void testQueryStorageVolumeOrStorageAccess();
     void testQueryWithParentUdi();
+    void testUdisFromQuery();
     void testListFromTypeProcessor();
     void testListFromTypeInvalid();
+    void testDeviceIterator();
+    void testDisplayOrderedDevices();
+    void testEventLogReplay();
+    void testFromBlockDevice();
+    void testFromUuid();
+    void testDriveVolumes();
+    void testStorageAccessView();
+    void testNetworkShareList();
+    void testEventReplay();
+    void testDeviceEventQuarantine();
+    void testQueryWatcher();
     void testSetupTeardown();
+    void testSetupAsyncNotSupported();
+    void testBatchSetupTeardown();
+    void testPrefetchIcons();
+    void testDiagnosticState();
 
     void slotPropertyChanged(const QMap<QString, int> &changes);
 private:
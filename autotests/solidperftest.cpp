@@ -0,0 +1,277 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include <QTest>
+#include <QTemporaryDir>
+#include <QTextStream>
+
+#include <solid/device.h>
+#include <solid/devicenotifier.h>
+#include <solid/predicate.h>
+#include <solid/storagevolume.h>
+#include "solid/devices/managerbase_p.h"
+
+#include <fakemanager.h>
+#include <fakedevice.h>
+
+/**
+ * Performance coverage for the enumeration and query paths, run against
+ * the fakehw backend with synthetic trees of various sizes so regressions
+ * in the hot paths show up as measurable benchmark changes in CI.
+ *
+ * The backend-level benchmarks load their own FakeManager per tree size;
+ * the frontend-level ones run against the tree the process-wide manager
+ * loaded in initTestCase(), since backends are only loaded once per
+ * process.
+ */
+class SolidPerfTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void benchmarkBackendLoad_data();
+    void benchmarkBackendLoad();
+    void benchmarkBackendEnumeration_data();
+    void benchmarkBackendEnumeration();
+    void benchmarkFrontendEnumeration();
+    void benchmarkPredicateMatch();
+    void benchmarkInterfaceCreation();
+    void benchmarkBackendInterfaceCreation_data();
+    void benchmarkBackendInterfaceCreation();
+    void benchmarkSignalFanOut();
+
+private:
+    QString fixturePath(int deviceCount) const;
+
+    QTemporaryDir m_fixtureDir;
+    Solid::Backends::Fake::FakeManager *m_fakeManager = nullptr;
+
+    // Loaded from the recorded fakecomputer.xml fixture, which covers
+    // far more interface types than the synthetic volume trees above.
+    Solid::Backends::Fake::FakeManager *m_recordedManager = nullptr;
+};
+
+QTEST_MAIN(SolidPerfTest)
+
+static const QList<int> s_treeSizes = { 10, 100, 1000, 10000 };
+
+// The size the process-wide manager loads for the frontend benchmarks.
+static const int s_frontendTreeSize = 1000;
+
+QString SolidPerfTest::fixturePath(int deviceCount) const
+{
+    return m_fixtureDir.filePath(QStringLiteral("fakecomputer-%1.xml").arg(deviceCount));
+}
+
+static void writeSyntheticTree(const QString &path, int deviceCount)
+{
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Text));
+
+    QTextStream out(&file);
+    out << "<machine>\n";
+    out << "    <device udi=\"/org/kde/solid/fakehw/computer\">\n";
+    out << "        <property key=\"name\">Computer</property>\n";
+    out << "    </device>\n";
+
+    for (int i = 0; i < deviceCount; ++i) {
+        out << "    <device udi=\"/org/kde/solid/fakehw/volume_" << i << "\">\n";
+        out << "        <property key=\"name\">Volume " << i << "</property>\n";
+        out << "        <property key=\"interfaces\">Block,StorageVolume,StorageAccess</property>\n";
+        out << "        <property key=\"parent\">/org/kde/solid/fakehw/computer</property>\n";
+        out << "        <property key=\"device\">/dev/fake" << i << "</property>\n";
+        out << "        <property key=\"major\">8</property>\n";
+        out << "        <property key=\"minor\">" << i << "</property>\n";
+        out << "        <property key=\"usage\">filesystem</property>\n";
+        out << "        <property key=\"fsType\">ext4</property>\n";
+        out << "        <property key=\"label\">vol" << i << "</property>\n";
+        out << "        <property key=\"size\">1048576</property>\n";
+        out << "        <property key=\"isIgnored\">false</property>\n";
+        out << "        <property key=\"isMounted\">false</property>\n";
+        out << "    </device>\n";
+    }
+
+    out << "</machine>\n";
+}
+
+void SolidPerfTest::initTestCase()
+{
+    QVERIFY(m_fixtureDir.isValid());
+
+    for (int size : s_treeSizes) {
+        writeSyntheticTree(fixturePath(size), size);
+    }
+
+    qputenv("SOLID_FAKEHW", fixturePath(s_frontendTreeSize).toLocal8Bit());
+    Solid::ManagerBasePrivate *manager
+        = dynamic_cast<Solid::ManagerBasePrivate *>(Solid::DeviceNotifier::instance());
+    m_fakeManager = qobject_cast<Solid::Backends::Fake::FakeManager *>(manager->managerBackends().first());
+    QVERIFY(m_fakeManager);
+    QCOMPARE(m_fakeManager->allDevices().count(), s_frontendTreeSize + 1);
+
+    m_recordedManager = new Solid::Backends::Fake::FakeManager(this, QStringLiteral(FAKE_COMPUTER_XML));
+    QVERIFY(!m_recordedManager->allDevices().isEmpty());
+}
+
+void SolidPerfTest::benchmarkBackendLoad_data()
+{
+    QTest::addColumn<int>("deviceCount");
+
+    for (int size : s_treeSizes) {
+        QTest::newRow(QByteArray::number(size).constData()) << size;
+    }
+}
+
+void SolidPerfTest::benchmarkBackendLoad()
+{
+    QFETCH(int, deviceCount);
+    const QString path = fixturePath(deviceCount);
+
+    QBENCHMARK {
+        Solid::Backends::Fake::FakeManager manager(nullptr, path);
+        QCOMPARE(manager.allDevices().count(), deviceCount + 1);
+    }
+}
+
+void SolidPerfTest::benchmarkBackendEnumeration_data()
+{
+    benchmarkBackendLoad_data();
+}
+
+void SolidPerfTest::benchmarkBackendEnumeration()
+{
+    QFETCH(int, deviceCount);
+    Solid::Backends::Fake::FakeManager manager(nullptr, fixturePath(deviceCount));
+
+    QBENCHMARK {
+        QCOMPARE(manager.allDevices().count(), deviceCount + 1);
+        QCOMPARE(manager.devicesFromQuery(QString(), Solid::DeviceInterface::StorageVolume).count(), deviceCount);
+    }
+}
+
+void SolidPerfTest::benchmarkFrontendEnumeration()
+{
+    QBENCHMARK {
+        QCOMPARE(Solid::Device::allDevices().count(), s_frontendTreeSize + 1);
+    }
+}
+
+void SolidPerfTest::benchmarkPredicateMatch()
+{
+    const Solid::Predicate predicate
+        = Solid::Predicate::fromString(QStringLiteral("StorageVolume.usage == 'FileSystem'"));
+    QVERIFY(predicate.isValid());
+
+    QBENCHMARK {
+        QCOMPARE(Solid::Device::listFromQuery(predicate).count(), s_frontendTreeSize);
+    }
+}
+
+void SolidPerfTest::benchmarkInterfaceCreation()
+{
+    QStringList udis;
+    for (int i = 0; i < 100; ++i) {
+        udis << QStringLiteral("/org/kde/solid/fakehw/volume_%1").arg(i);
+    }
+
+    QBENCHMARK {
+        for (const QString &udi : qAsConst(udis)) {
+            Solid::Device device(udi);
+            QVERIFY(device.as<Solid::StorageVolume>() != nullptr);
+        }
+    }
+}
+
+void SolidPerfTest::benchmarkBackendInterfaceCreation_data()
+{
+    QTest::addColumn<int>("type");
+    QTest::addColumn<QString>("udi");
+
+    // One row per interface type the recorded fixture has a device for.
+    // The rows are named after the type, so benchmark results from
+    // different runs (ctest -V, or QTest's -csv output) line up per type
+    // and a regression in one backend interface shows up as a single row
+    // moving rather than as noise in an aggregate number.
+    static const QList<Solid::DeviceInterface::Type> allTypes = {
+        Solid::DeviceInterface::GenericInterface,
+        Solid::DeviceInterface::Processor,
+        Solid::DeviceInterface::Block,
+        Solid::DeviceInterface::StorageAccess,
+        Solid::DeviceInterface::StorageDrive,
+        Solid::DeviceInterface::OpticalDrive,
+        Solid::DeviceInterface::StorageVolume,
+        Solid::DeviceInterface::OpticalDisc,
+        Solid::DeviceInterface::Camera,
+        Solid::DeviceInterface::PortableMediaPlayer,
+        Solid::DeviceInterface::Battery,
+        Solid::DeviceInterface::NetworkShare,
+    };
+
+    for (Solid::DeviceInterface::Type type : allTypes) {
+        const QStringList udis = m_recordedManager->devicesFromQuery(QString(), type);
+        if (udis.isEmpty()) {
+            continue;
+        }
+        QTest::newRow(Solid::DeviceInterface::typeToString(type).toLatin1().constData())
+            << int(type) << udis.first();
+    }
+}
+
+void SolidPerfTest::benchmarkBackendInterfaceCreation()
+{
+    QFETCH(int, type);
+    QFETCH(QString, udi);
+
+    // The device object is created once outside the measured loop; what
+    // is being measured is the cost of the backend's
+    // createDeviceInterface() for this type, which is what every
+    // Device::as<T>() call pays the first time.
+    QScopedPointer<QObject> deviceObject(m_recordedManager->createDevice(udi));
+    auto *device = qobject_cast<Solid::Backends::Fake::FakeDevice *>(deviceObject.data());
+    QVERIFY(device);
+
+    const auto ifaceType = static_cast<Solid::DeviceInterface::Type>(type);
+    QVERIFY(device->queryDeviceInterface(ifaceType));
+
+    QBENCHMARK {
+        QObject *iface = device->createDeviceInterface(ifaceType);
+        QVERIFY(iface != nullptr);
+        delete iface;
+    }
+}
+
+void SolidPerfTest::benchmarkSignalFanOut()
+{
+    // Emulate many interested parties, the situation in a running desktop
+    // session where every applet holds its own notifier connections.
+    Solid::DeviceNotifier *notifier = Solid::DeviceNotifier::instance();
+
+    int received = 0;
+    QList<QMetaObject::Connection> connections;
+    for (int i = 0; i < 100; ++i) {
+        connections << connect(notifier, &Solid::DeviceNotifier::deviceAdded,
+                               this, [&received]() { received++; });
+        connections << connect(notifier, &Solid::DeviceNotifier::deviceRemoved,
+                               this, [&received]() { received++; });
+    }
+
+    const QString udi = QStringLiteral("/org/kde/solid/fakehw/volume_0");
+
+    QBENCHMARK {
+        m_fakeManager->unplug(udi);
+        m_fakeManager->plug(udi);
+    }
+
+    QVERIFY(received > 0);
+
+    for (const QMetaObject::Connection &connection : qAsConst(connections)) {
+        disconnect(connection);
+    }
+}
+
+#include "solidperftest.moc"
@@ -49,6 +49,16 @@ void solidPowerTest::testAcPluggedChanged()
 
     QVERIFY(spy.wait());
     QVERIFY(spy.takeFirst().first().toBool());
+
+    // once a change has been seen the state is answered from memory
+    QVERIFY(Power::isAcPluggedCached());
+    QVERIFY(Power::cachedAcPluggedState());
+
+    // the snapshot reads the same cache in one call
+    const Power::StateSnapshot snapshot = Power::stateSnapshot();
+    QVERIFY(snapshot.acPluggedKnown);
+    QVERIFY(snapshot.acPlugged);
+    QCOMPARE(snapshot.activeInhibitions, 0);
 }
 
 void solidPowerTest::testAddInhibition()
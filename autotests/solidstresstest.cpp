@@ -0,0 +1,213 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include <QTest>
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QElapsedTimer>
+#include <QProcess>
+#include <QTextStream>
+#include <QVector>
+
+#include <solid/device.h>
+#include <solid/devicenotifier.h>
+
+#include <algorithm>
+#include <stdlib.h>
+
+/**
+ * Multi-process stress coverage for event fan-out: a desktop session is
+ * many processes all reacting to the same hotplug event, and the bus
+ * contention that creates doesn't show up in single-process benchmarks.
+ *
+ * The test respawns itself as N consumer processes (SOLID_STRESS_CONSUMER
+ * set in their environment flips them into consumer mode). Each consumer
+ * loads the fakehw backend, which exports /org/kde/solid/fakehw on the
+ * session bus, and prints a line for every add/remove event its notifier
+ * delivers. The parent drives rounds of unplug/plug at all consumers over
+ * D-Bus and records when each consumer's reaction arrives, then reports
+ * the aggregate event-to-update latency distribution.
+ *
+ * The whole exercise runs on a private session bus so the measurements
+ * aren't skewed by (or visible to) the real session. The reported
+ * latencies include the consumers' stdout pipe and the parent's
+ * scheduling; that overhead is shared by all samples, so the distribution
+ * still tracks regressions in the event delivery path itself.
+ *
+ * SOLID_STRESS_CONSUMERS and SOLID_STRESS_ROUNDS override the defaults
+ * (15 consumers, 20 rounds) for heavier local runs.
+ */
+class SolidStressTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void testHotplugFanOut();
+    void cleanupTestCase();
+
+private:
+    void dispatchToConsumers(const QString &method, const QString &udi);
+
+    QList<QProcess *> m_consumers;
+    QStringList m_consumerServices;
+    QElapsedTimer m_clock;
+    QVector<qint64> m_latencies; // nanoseconds from dispatch to reaction
+    int m_eventsReceived = 0;
+};
+
+void SolidStressTest::initTestCase()
+{
+    qputenv("SOLID_FAKEHW", FAKE_COMPUTER_XML);
+
+    int consumerCount = qEnvironmentVariableIntValue("SOLID_STRESS_CONSUMERS");
+    if (consumerCount <= 0) {
+        consumerCount = 15;
+    }
+
+    for (int i = 0; i < consumerCount; ++i) {
+        QProcess *consumer = new QProcess(this);
+        QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+        env.insert(QStringLiteral("SOLID_STRESS_CONSUMER"), QStringLiteral("1"));
+        consumer->setProcessEnvironment(env);
+        consumer->setProcessChannelMode(QProcess::ForwardedErrorChannel);
+
+        connect(consumer, &QProcess::readyReadStandardOutput, this, [this, consumer]() {
+            while (consumer->canReadLine()) {
+                const QByteArray line = consumer->readLine().trimmed();
+                if (line.startsWith("READY ")) {
+                    m_consumerServices.append(QString::fromLatin1(line.mid(6)));
+                } else if (line.startsWith("EVENT ")) {
+                    m_latencies.append(m_clock.nsecsElapsed());
+                    ++m_eventsReceived;
+                }
+            }
+        });
+
+        consumer->start(QCoreApplication::applicationFilePath(), QStringList());
+        m_consumers.append(consumer);
+    }
+
+    QTRY_COMPARE_WITH_TIMEOUT(m_consumerServices.count(), consumerCount, 30000);
+}
+
+void SolidStressTest::dispatchToConsumers(const QString &method, const QString &udi)
+{
+    for (const QString &service : qAsConst(m_consumerServices)) {
+        QDBusMessage call = QDBusMessage::createMethodCall(service,
+                                                           QStringLiteral("/org/kde/solid/fakehw"),
+                                                           QString(), method);
+        call << udi;
+        QDBusConnection::sessionBus().asyncCall(call);
+    }
+}
+
+void SolidStressTest::testHotplugFanOut()
+{
+    int rounds = qEnvironmentVariableIntValue("SOLID_STRESS_ROUNDS");
+    if (rounds <= 0) {
+        rounds = 20;
+    }
+
+    const QString udi = QStringLiteral("/org/kde/solid/fakehw/acpi_CPU0");
+    const int consumerCount = m_consumerServices.count();
+
+    m_latencies.clear();
+    m_latencies.reserve(rounds * consumerCount * 2);
+
+    for (int round = 0; round < rounds; ++round) {
+        m_eventsReceived = 0;
+        m_clock.start();
+        dispatchToConsumers(QStringLiteral("unplug"), udi);
+        QTRY_COMPARE_WITH_TIMEOUT(m_eventsReceived, consumerCount, 10000);
+
+        m_eventsReceived = 0;
+        m_clock.start();
+        dispatchToConsumers(QStringLiteral("plug"), udi);
+        QTRY_COMPARE_WITH_TIMEOUT(m_eventsReceived, consumerCount, 10000);
+    }
+
+    std::sort(m_latencies.begin(), m_latencies.end());
+    const int samples = m_latencies.count();
+    QCOMPARE(samples, rounds * consumerCount * 2);
+
+    qInfo("event-to-update latency over %d samples (%d consumers, %d rounds):",
+          samples, consumerCount, rounds);
+    qInfo("  min %lld us, median %lld us, p95 %lld us, max %lld us",
+          m_latencies.first() / 1000,
+          m_latencies.at(samples / 2) / 1000,
+          m_latencies.at(qMin(samples - 1, (samples * 95) / 100)) / 1000,
+          m_latencies.last() / 1000);
+}
+
+void SolidStressTest::cleanupTestCase()
+{
+    for (QProcess *consumer : qAsConst(m_consumers)) {
+        consumer->terminate();
+        if (!consumer->waitForFinished(3000)) {
+            consumer->kill();
+            consumer->waitForFinished(3000);
+        }
+    }
+}
+
+static int consumerMain(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    // Enumerating registers the population with the frontend, and loading
+    // the fakehw backend exports /org/kde/solid/fakehw on the session bus
+    // so the parent can drive hotplug events into this process.
+    const QList<Solid::Device> devices = Solid::Device::allDevices();
+    Q_UNUSED(devices)
+
+    QTextStream out(stdout);
+    auto report = [&out](const QString &udi) {
+        out << "EVENT " << udi << '\n';
+        out.flush();
+    };
+
+    Solid::DeviceNotifier *notifier = Solid::DeviceNotifier::instance();
+    QObject::connect(notifier, &Solid::DeviceNotifier::deviceAdded, &app, report);
+    QObject::connect(notifier, &Solid::DeviceNotifier::deviceRemoved, &app, report);
+
+    out << "READY " << QDBusConnection::sessionBus().baseService() << '\n';
+    out.flush();
+
+    return app.exec();
+}
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsSet("SOLID_STRESS_CONSUMER")) {
+        return consumerMain(argc, argv);
+    }
+
+    // Run the whole stress exercise on a private session bus, following
+    // what qtest_dbus.h does for the system bus.
+    QProcess dbus;
+    dbus.start("dbus-launch");
+    dbus.waitForFinished(10000);
+    QByteArray session = dbus.readLine();
+    if (session.isEmpty()) {
+        qFatal("Couldn't execute new dbus session");
+    }
+    int pos = session.indexOf('=');
+    setenv("DBUS_SESSION_BUS_ADDRESS", session.right(session.count() - pos - 1).trimmed(), 1);
+    session = dbus.readLine();
+    pos = session.indexOf('=');
+    QByteArray pid = session.right(session.count() - pos - 1).trimmed();
+
+    QCoreApplication app(argc, argv);
+    app.setApplicationName(QLatin1String("qttest"));
+    SolidStressTest tc;
+    int result = QTest::qExec(&tc, argc, argv);
+    dbus.start("kill", QStringList() << "-9" << pid);
+    dbus.waitForFinished();
+    return result;
+}
+
+#include "solidstresstest.moc"
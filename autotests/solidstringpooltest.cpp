@@ -0,0 +1,64 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include <QObject>
+#include <QTest>
+
+#include "solid/devices/solidstringpool_p.h"
+
+class SolidStringPoolTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testIntern();
+    void testInternVariant();
+};
+
+void SolidStringPoolTest::testIntern()
+{
+    // Two equal strings built independently don't share a buffer...
+    const QString first = QStringLiteral("ext") + QString::number(4);
+    const QString second = QStringLiteral("ext") + QString::number(4);
+    QCOMPARE(first, second);
+    QVERIFY(first.constData() != second.constData());
+
+    // ...but both interned copies do.
+    const QString firstPooled = Solid::StringPool::intern(first);
+    const QString secondPooled = Solid::StringPool::intern(second);
+    QCOMPARE(firstPooled, first);
+    QVERIFY(firstPooled.constData() == secondPooled.constData());
+
+    // empty strings pass through untouched
+    QVERIFY(Solid::StringPool::intern(QString()).isNull());
+
+    // long strings pass through unpooled
+    const QString longString(512, QLatin1Char('x'));
+    const QString longCopy(512, QLatin1Char('x'));
+    QVERIFY(Solid::StringPool::intern(longString).constData() != Solid::StringPool::intern(longCopy).constData());
+}
+
+void SolidStringPoolTest::testInternVariant()
+{
+    const QString original = QStringLiteral("vfat") + QString();
+    Solid::StringPool::intern(QStringLiteral("vf") + QStringLiteral("at"));
+
+    const QVariant pooled = Solid::StringPool::internVariant(QVariant(original));
+    QCOMPARE(pooled.toString(), original);
+
+    // string list elements are interned individually
+    const QStringList list{QStringLiteral("vf") + QStringLiteral("at"), QStringLiteral("one-off")};
+    const QVariant pooledList = Solid::StringPool::internVariant(QVariant(list));
+    QCOMPARE(pooledList.toStringList(), list);
+    QVERIFY(pooledList.toStringList().at(0).constData() == pooled.toString().constData());
+
+    // non-string payloads are returned unchanged
+    const QVariant number(42);
+    QCOMPARE(Solid::StringPool::internVariant(number), number);
+}
+
+QTEST_GUILESS_MAIN(SolidStringPoolTest)
+
+#include "solidstringpooltest.moc"
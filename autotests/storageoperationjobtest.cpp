@@ -0,0 +1,75 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include <QObject>
+#include <QTest>
+
+#include <solid/device.h>
+#include <solid/storageaccess.h>
+#include <solid/storageoperationjob.h>
+
+class StorageOperationJobTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void testTeardownAndSetup();
+    void testUnsupportedOperation();
+    void testQueueState();
+};
+
+void StorageOperationJobTest::initTestCase()
+{
+    qputenv("SOLID_FAKEHW", FAKE_COMPUTER_XML);
+}
+
+void StorageOperationJobTest::testTeardownAndSetup()
+{
+    Solid::Device device("/org/kde/solid/fakehw/volume_part1_size_993284096");
+    QVERIFY(device.as<Solid::StorageAccess>()->isAccessible());
+
+    auto *job = new Solid::StorageOperationJob(device, Solid::StorageOperationJob::Teardown);
+    QVERIFY(job->exec());
+    QCOMPARE(job->error(), int(Solid::Job::NoError));
+    QCOMPARE(job->errorType(), Solid::NoError);
+    QVERIFY(!device.as<Solid::StorageAccess>()->isAccessible());
+
+    job = new Solid::StorageOperationJob(device, Solid::StorageOperationJob::Setup);
+    QVERIFY(job->exec());
+    QVERIFY(device.as<Solid::StorageAccess>()->isAccessible());
+}
+
+void StorageOperationJobTest::testUnsupportedOperation()
+{
+    Solid::Device device("/org/kde/solid/fakehw/acpi_CPU0");
+
+    auto *job = new Solid::StorageOperationJob(device, Solid::StorageOperationJob::Setup);
+    QVERIFY(!job->exec());
+    QCOMPARE(job->error(), int(Solid::StorageOperationJob::UnsupportedOperation));
+}
+
+void StorageOperationJobTest::testQueueState()
+{
+    const QString udi = QStringLiteral("/org/kde/solid/fakehw/volume_part1_size_993284096");
+
+    // The fake backend answers synchronously, so the queue drains with
+    // the job and only the completion record stays behind.
+    Solid::Device device(udi);
+    auto *job = new Solid::StorageOperationJob(device, Solid::StorageOperationJob::Teardown);
+    QVERIFY(job->exec());
+
+    const Solid::StorageOperationJob::QueueState state = Solid::StorageOperationJob::queueState(udi);
+    QCOMPARE(state.depth, 0);
+    QCOMPARE(state.oldestPendingMsecs, qint64(0));
+    QVERIFY(state.lastCompletedMsecs >= 0);
+
+    job = new Solid::StorageOperationJob(device, Solid::StorageOperationJob::Setup);
+    QVERIFY(job->exec());
+}
+
+QTEST_MAIN(StorageOperationJobTest)
+
+#include "storageoperationjobtest.moc"
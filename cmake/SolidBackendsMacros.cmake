@@ -51,10 +51,14 @@ endmacro()
 # After all the add_device_backend()s are called, create/collect all the
 # material used for the build:
 # - create a config-backends.h file in the current binary directory, with
-#   BUILD_DEVICE_BACKEND_$name defines for all the built backends
+#   BUILD_DEVICE_BACKEND_$name defines for all the built backends, and a
+#   SOLID_DEVICE_BACKENDS_COUNT define so single-backend builds can strip
+#   the multi-backend dispatch at compile time
 # - fill the sources_var, and libs_var variables resp. with the sources,
 #   and the libraries needed for all the built backends
 macro(add_device_backends_build base_backends_dir sources_var libs_var)
+    list(LENGTH ENABLED_DEVICE_BACKENDS enabled_device_backends_count)
+    string(APPEND config_backends_output "#define SOLID_DEVICE_BACKENDS_COUNT ${enabled_device_backends_count}\n")
     foreach(backend ${ENABLED_DEVICE_BACKENDS})
         string(APPEND config_backends_output "#define BUILD_DEVICE_BACKEND_${backend} 1\n")
         unset(backend_sources)
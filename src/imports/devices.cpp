@@ -11,6 +11,11 @@
 #include <solid/device.h>
 #include <solid/devicenotifier.h>
 #include <solid/genericinterface.h>
+#include <solid/storageaccess.h>
+
+#include <QPointer>
+#include <QRunnable>
+#include <QThreadPool>
 
 namespace Solid
 {
@@ -18,6 +23,65 @@ namespace Solid
 // Maps queries to the handler objects
 QHash<QString, QWeakPointer<DevicesQueryPrivate> > DevicesQueryPrivate::handlers;
 
+// Compiled predicates survive the handlers which used them, so a query
+// string is only run through the parser once per process no matter how
+// often the corresponding handler is dropped and recreated.
+static Solid::Predicate compiledPredicate(const QString &query)
+{
+    static QHash<QString, Solid::Predicate> predicates;
+
+    auto it = predicates.constFind(query);
+    if (it != predicates.constEnd()) {
+        return it.value();
+    }
+
+    const Solid::Predicate predicate = Solid::Predicate::fromString(query);
+    predicates.insert(query, predicate);
+    return predicate;
+}
+
+namespace
+{
+
+/**
+ * Runs the initial device enumeration for a query handler on a worker
+ * thread, against that thread's own backends, so instantiating a
+ * Solid.Devices item never blocks the GUI thread on backend round trips.
+ * Only one shared UDI list travels back to the handler's thread; the
+ * model indexes into it and resolves rows to devices lazily.
+ */
+class InitialQueryRunner : public QRunnable
+{
+public:
+    InitialQueryRunner(DevicesQueryPrivate *handler, Solid::DeviceNotifier *notifier, const Solid::Predicate &predicate)
+        : m_handler(handler)
+        , m_notifier(notifier)
+        , m_predicate(predicate)
+    {
+    }
+
+    void run() override
+    {
+        const QStringList udis = Solid::Device::udisFromQuery(m_predicate);
+
+        // The notifier of the handler's thread outlives the handler, so
+        // it is a safe delivery context; the QPointer guards against the
+        // handler having been dropped in the meantime.
+        QMetaObject::invokeMethod(m_notifier, [handler = m_handler, udis]() {
+            if (handler) {
+                handler->setInitialDevices(udis);
+            }
+        }, Qt::QueuedConnection);
+    }
+
+private:
+    QPointer<DevicesQueryPrivate> m_handler;
+    Solid::DeviceNotifier *m_notifier;
+    Solid::Predicate m_predicate;
+};
+
+}
+
 QSharedPointer<DevicesQueryPrivate> DevicesQueryPrivate::forQuery(const QString &query)
 {
     if (handlers.contains(query)) {
@@ -38,7 +102,7 @@ QSharedPointer<DevicesQueryPrivate> DevicesQueryPrivate::forQuery(const QString
 
 DevicesQueryPrivate::DevicesQueryPrivate(const QString &query)
     : query(query)
-    , predicate(Solid::Predicate::fromString(query))
+    , predicate(compiledPredicate(query))
     , notifier(Solid::DeviceNotifier::instance())
 {
     connect(notifier, &Solid::DeviceNotifier::deviceAdded,
@@ -47,13 +111,13 @@ DevicesQueryPrivate::DevicesQueryPrivate(const QString &query)
             this,     &DevicesQueryPrivate::removeDevice);
 
     if (!query.isEmpty() && !predicate.isValid()) {
+        // A malformed query can never match anything, so there is
+        // nothing to enumerate either.
+        m_ready = true;
         return;
     }
 
-    const QList<Solid::Device> deviceList = Solid::Device::listFromQuery(predicate);
-    for (const Solid::Device &device : deviceList) {
-        matchingDevices << device.udi();
-    }
+    QThreadPool::globalInstance()->start(new InitialQueryRunner(this, notifier, predicate));
 }
 
 DevicesQueryPrivate::~DevicesQueryPrivate()
@@ -61,19 +125,72 @@ DevicesQueryPrivate::~DevicesQueryPrivate()
     handlers.remove(query);
 }
 
+void DevicesQueryPrivate::setInitialDevices(const QStringList &udis)
+{
+    if (m_ready) {
+        return;
+    }
+
+    QStringList devices = udis;
+    for (const QString &udi : qAsConst(m_pendingRemoved)) {
+        devices.removeAll(udi);
+    }
+
+    Q_EMIT aboutToLoadDevices();
+    matchingDevices = devices;
+    m_ready = true;
+    Q_EMIT devicesLoaded();
+
+    // Devices which arrived during the enumeration go through the
+    // normal addition path so the granular signals fire for them.
+    const QStringList pendingAdded = m_pendingAdded;
+    m_pendingAdded.clear();
+    m_pendingRemoved.clear();
+
+    for (const QString &udi : pendingAdded) {
+        if (!matchingDevices.contains(udi)) {
+            addDevice(udi);
+        }
+    }
+}
+
+bool DevicesQueryPrivate::isReady() const
+{
+    return m_ready;
+}
+
 void DevicesQueryPrivate::addDevice(const QString &udi)
 {
+    if (!m_ready) {
+        m_pendingAdded << udi;
+        return;
+    }
+
     if (predicate.isValid() && predicate.matches(Solid::Device(udi))) {
+        const int index = matchingDevices.count();
+        Q_EMIT aboutToAddDevice(index);
         matchingDevices << udi;
-        Q_EMIT deviceAdded(udi);
+        Q_EMIT deviceAdded(udi, index);
     }
 }
 
 void DevicesQueryPrivate::removeDevice(const QString &udi)
 {
-    if (predicate.isValid() && matchingDevices.contains(udi)) {
-        matchingDevices.removeAll(udi);
-        Q_EMIT deviceRemoved(udi);
+    if (!m_ready) {
+        m_pendingAdded.removeAll(udi);
+        m_pendingRemoved << udi;
+        return;
+    }
+
+    if (!predicate.isValid()) {
+        return;
+    }
+
+    const int index = matchingDevices.indexOf(udi);
+    if (index != -1) {
+        Q_EMIT aboutToRemoveDevice(index);
+        matchingDevices.removeAt(index);
+        Q_EMIT deviceRemoved(udi, index);
     }
 }
 
@@ -90,12 +207,50 @@ void Devices::initialize() const
 
     m_backend = DevicesQueryPrivate::forQuery(m_query);
 
+    connect(m_backend.data(), &DevicesQueryPrivate::aboutToAddDevice,
+            this, &Devices::beginAddDevice);
     connect(m_backend.data(), &DevicesQueryPrivate::deviceAdded,
             this, &Devices::addDevice);
-    connect(m_backend.data(), &DevicesQueryPrivate::deviceAdded,
-            this, &Devices::addDevice);
+    connect(m_backend.data(), &DevicesQueryPrivate::aboutToRemoveDevice,
+            this, &Devices::beginRemoveDevice);
     connect(m_backend.data(), &DevicesQueryPrivate::deviceRemoved,
             this, &Devices::removeDevice);
+    connect(m_backend.data(), &DevicesQueryPrivate::aboutToLoadDevices,
+            this, &Devices::beginLoadDevices);
+    connect(m_backend.data(), &DevicesQueryPrivate::devicesLoaded,
+            this, &Devices::loadDevices);
+
+    // A shared handler may already have delivered its initial set to an
+    // earlier client; a fresh one announces it through devicesLoaded().
+    if (!m_backend->isReady()) {
+        return;
+    }
+
+    const int matchesCount = m_backend->devices().count();
+
+    if (matchesCount != 0) {
+        Q_EMIT emptyChanged(false);
+        Q_EMIT countChanged(matchesCount);
+        Q_EMIT devicesChanged(m_backend->devices());
+    }
+}
+
+void Devices::beginLoadDevices()
+{
+    if (!m_backend) {
+        return;
+    }
+
+    beginResetModel();
+}
+
+void Devices::loadDevices()
+{
+    if (!m_backend) {
+        return;
+    }
+
+    endResetModel();
 
     const int matchesCount = m_backend->devices().count();
 
@@ -115,17 +270,33 @@ void Devices::reset()
     m_backend->disconnect(this);
     m_backend.reset();
 
+    m_rowCache.clear();
+    m_watchedRows.clear();
+
     Q_EMIT emptyChanged(true);
     Q_EMIT countChanged(0);
     Q_EMIT devicesChanged(QStringList());
 }
 
-void Devices::addDevice(const QString &udi)
+void Devices::beginAddDevice(int index)
+{
+    if (!m_backend) {
+        return;
+    }
+
+    beginInsertRows(QModelIndex(), index, index);
+}
+
+void Devices::addDevice(const QString &udi, int index)
 {
+    Q_UNUSED(index)
+
     if (!m_backend) {
         return;
     }
 
+    endInsertRows();
+
     const int count = m_backend->devices().count();
 
     if (count == 1) {
@@ -137,12 +308,28 @@ void Devices::addDevice(const QString &udi)
     Q_EMIT deviceAdded(udi);
 }
 
-void Devices::removeDevice(const QString &udi)
+void Devices::beginRemoveDevice(int index)
 {
     if (!m_backend) {
         return;
     }
 
+    beginRemoveRows(QModelIndex(), index, index);
+}
+
+void Devices::removeDevice(const QString &udi, int index)
+{
+    Q_UNUSED(index)
+
+    if (!m_backend) {
+        return;
+    }
+
+    endRemoveRows();
+
+    m_rowCache.remove(udi);
+    m_watchedRows.remove(udi);
+
     const int count = m_backend->devices().count();
 
     if (count == 0) {
@@ -155,7 +342,7 @@ void Devices::removeDevice(const QString &udi)
 }
 
 Devices::Devices(QObject *parent)
-    : QObject(parent)
+    : QAbstractListModel(parent)
 {
 }
 
@@ -163,6 +350,105 @@ Devices::~Devices()
 {
 }
 
+int Devices::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+
+    initialize();
+    return m_backend->devices().count();
+}
+
+QVariant Devices::data(const QModelIndex &index, int role) const
+{
+    initialize();
+
+    const QStringList &udis = m_backend->devices();
+    if (index.row() < 0 || index.row() >= udis.count()) {
+        return QVariant();
+    }
+
+    const QString &udi = udis.at(index.row());
+
+    switch (role) {
+    case Qt::DisplayRole:
+    case UdiRole:
+        return udi;
+    case DescriptionRole:
+        return rowData(udi).description;
+    case IconRole:
+        return rowData(udi).icon;
+    case EmblemsRole:
+        return rowData(udi).emblems;
+    case IsAccessibleRole:
+        return rowData(udi).isAccessible;
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> Devices::roleNames() const
+{
+    return {
+        { UdiRole, QByteArrayLiteral("udi") },
+        { DescriptionRole, QByteArrayLiteral("description") },
+        { IconRole, QByteArrayLiteral("icon") },
+        { EmblemsRole, QByteArrayLiteral("emblems") },
+        { IsAccessibleRole, QByteArrayLiteral("isAccessible") }
+    };
+}
+
+const Devices::RowData &Devices::rowData(const QString &udi) const
+{
+    auto it = m_rowCache.constFind(udi);
+    if (it != m_rowCache.constEnd()) {
+        return it.value();
+    }
+
+    Solid::Device device(udi);
+
+    RowData data;
+    data.description = device.description();
+    data.icon = device.icon();
+    data.emblems = device.emblems();
+
+    Solid::StorageAccess *access = device.as<Solid::StorageAccess>();
+    if (access != nullptr) {
+        data.isAccessible = access->isAccessible();
+
+        // Accessibility is the one cached role which changes at
+        // runtime, so mount state changes refresh the row.
+        if (!m_watchedRows.contains(udi)) {
+            m_watchedRows.insert(udi);
+
+            Devices *self = const_cast<Devices *>(this);
+            connect(access, &Solid::StorageAccess::accessibilityChanged,
+                    self, [self, udi]() {
+                self->invalidateRowData(udi);
+            });
+        }
+    }
+
+    return *m_rowCache.insert(udi, data);
+}
+
+void Devices::invalidateRowData(const QString &udi)
+{
+    m_rowCache.remove(udi);
+
+    if (!m_backend) {
+        return;
+    }
+
+    const int row = m_backend->devices().indexOf(udi);
+    if (row != -1) {
+        const QModelIndex rowIndex = index(row);
+        Q_EMIT dataChanged(rowIndex, rowIndex,
+                           { DescriptionRole, IconRole, EmblemsRole, IsAccessibleRole });
+    }
+}
+
 bool Devices::isEmpty() const
 {
     initialize();
@@ -194,8 +480,12 @@ void Devices::setQuery(const QString &query)
 
     m_query = query;
 
+    // Changing the query swaps the whole device set, so this is the one
+    // place where a full model reset is warranted.
+    beginResetModel();
     reset();
     initialize();
+    endResetModel();
 
     Q_EMIT queryChanged(query);
 }
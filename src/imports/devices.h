@@ -7,10 +7,12 @@
 #ifndef SOLID_DECALARATIVE_DEVICES_H
 #define SOLID_DECALARATIVE_DEVICES_H
 
-#include <QObject>
+#include <QAbstractListModel>
 #include <solid/predicate.h>
 #include <solid/deviceinterface.h>
 
+#include <QHash>
+#include <QSet>
 #include <QSharedPointer>
 
 namespace Solid
@@ -20,13 +22,17 @@ class DeviceNotifier;
 class DevicesQueryPrivate;
 
 /**
- * A class that watches the devices known to the solid system.
+ * A model of the devices known to the solid system.
  *
  * It behaves similarly to Solid::DeviceNotifier, but
  * adds some convenience methods which allow it to
  * watch only the devices matching a specified query
  * (formatted for Solid::Predicate).
  *
+ * It is a QAbstractListModel exposing one row per matching
+ * device, so hotplug events translate into granular row
+ * insertions and removals instead of full delegate resets.
+ *
  * It is intended to be used from QML like this:
  *
  * @code
@@ -55,7 +61,7 @@ class DevicesQueryPrivate;
  *    }
  * @endcode
  */
-class Devices: public QObject
+class Devices: public QAbstractListModel
 {
     Q_OBJECT
 
@@ -68,6 +74,18 @@ public:
     explicit Devices(QObject *parent = nullptr);
     ~Devices();
 
+    enum ModelRoles {
+        UdiRole = Qt::UserRole + 1,
+        DescriptionRole,
+        IconRole,
+        EmblemsRole,
+        IsAccessibleRole
+    };
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
 Q_SIGNALS:
     /**
      * Emitted when a new device matching the specified
@@ -153,8 +171,12 @@ public Q_SLOTS:
     QObject *device(const QString &udi, const QString &type);
 
 private Q_SLOTS:
-    void addDevice(const QString &udi);
-    void removeDevice(const QString &udi);
+    void beginAddDevice(int index);
+    void addDevice(const QString &udi, int index);
+    void beginRemoveDevice(int index);
+    void removeDevice(const QString &udi, int index);
+    void beginLoadDevices();
+    void loadDevices();
 
     /**
      * Initializes the backend object
@@ -167,9 +189,29 @@ private Q_SLOTS:
     void reset();
 
 private:
+    /**
+     * The property roles of one row, fetched from the backends on
+     * first access and served from here afterwards
+     */
+    struct RowData {
+        QString description;
+        QString icon;
+        QStringList emblems;
+        bool isAccessible = false;
+    };
+
+    const RowData &rowData(const QString &udi) const;
+    void invalidateRowData(const QString &udi);
+
     QString m_query;
 
     mutable QSharedPointer<DevicesQueryPrivate> m_backend;
+
+    // Per-row property cache, so delegate binds and list scrolling
+    // don't trigger backend property reads on every frame. Entries are
+    // dropped when the device goes away or changes accessibility.
+    mutable QHash<QString, RowData> m_rowCache;
+    mutable QSet<QString> m_watchedRows;
 };
 
 } // namespace Solid
@@ -48,6 +48,13 @@ public:
      */
     const QStringList &devices() const;
 
+    /**
+     * Returns whether the initial enumeration has been delivered.
+     * Until then devices() is empty and devicesLoaded() will be
+     * emitted once the worker thread result arrives.
+     */
+    bool isReady() const;
+
     /**
      * A query which is used to create the predicate.
      * It can be public since it is immutable.
@@ -62,13 +69,39 @@ public:
     const Solid::Predicate predicate;
 
 Q_SIGNALS:
-    void deviceAdded(const QString &udi);
-    void deviceRemoved(const QString &udi);
+    /**
+     * Emitted just before a matching device is appended at the
+     * given position, while the list is still unchanged, so that
+     * attached models can call beginInsertRows()
+     */
+    void aboutToAddDevice(int index);
+    void deviceAdded(const QString &udi, int index);
+
+    /**
+     * Emitted just before the device at the given position is
+     * removed, while the list is still unchanged, so that
+     * attached models can call beginRemoveRows()
+     */
+    void aboutToRemoveDevice(int index);
+    void deviceRemoved(const QString &udi, int index);
+
+    /**
+     * Emitted around the delivery of the initial device set from
+     * the worker thread, so attached models can reset themselves
+     */
+    void aboutToLoadDevices();
+    void devicesLoaded();
 
 public Q_SLOTS:
     void addDevice(const QString &udi);
     void removeDevice(const QString &udi);
 
+    /**
+     * Installs the device set produced by the initial enumeration
+     * and replays the hotplug events that raced with it
+     */
+    void setInitialDevices(const QStringList &udis);
+
 private:
     DevicesQueryPrivate(const QString &query);
 
@@ -77,6 +110,13 @@ private:
 
     QStringList matchingDevices;
 
+    // Initial enumeration state: hotplug events arriving while the
+    // worker thread is still enumerating are buffered and replayed
+    // once the initial set is in place.
+    bool m_ready = false;
+    QStringList m_pendingAdded;
+    QStringList m_pendingRemoved;
+
     // Maps queries to the handler objects
     static QHash<QString, QWeakPointer<DevicesQueryPrivate> > handlers;
 };
@@ -32,9 +32,21 @@ using namespace Solid::Backends::Fake;
 FakeDevice::FakeDevice(const QString &udi, const QMap<QString, QVariant> &propertyMap)
     : Solid::Ifaces::Device(), d(new Private)
 {
-    d->udi = udi;
     d->propertyMap = propertyMap;
-    d->interfaceList = d->propertyMap["interfaces"].toString().simplified().split(',');
+    initialize(udi);
+}
+
+FakeDevice::FakeDevice(const QString &udi, const QSharedPointer<const QMap<QString, QVariant>> &sharedProperties)
+    : Solid::Ifaces::Device(), d(new Private)
+{
+    d->sharedProperties = sharedProperties;
+    initialize(udi);
+}
+
+void FakeDevice::initialize(const QString &udi)
+{
+    d->udi = udi;
+    d->interfaceList = property("interfaces").toString().simplified().split(',');
     d->interfaceList << "GenericInterface";
     d->locked = false;
     d->broken = false;
@@ -54,6 +66,8 @@ FakeDevice::FakeDevice(const QString &udi, const QMap<QString, QVariant> &proper
 
     connect(d.data(), SIGNAL(propertyChanged(QMap<QString,int>)),
             this, SIGNAL(propertyChanged(QMap<QString,int>)));
+    connect(d.data(), SIGNAL(propertyValuesChanged(QVariantMap)),
+            this, SIGNAL(propertyValuesChanged(QVariantMap)));
     connect(d.data(), SIGNAL(conditionRaised(QString,QString)),
             this, SIGNAL(conditionRaised(QString,QString)));
 }
@@ -63,6 +77,8 @@ FakeDevice::FakeDevice(const FakeDevice &dev)
 {
     connect(d.data(), SIGNAL(propertyChanged(QMap<QString,int>)),
             this, SIGNAL(propertyChanged(QMap<QString,int>)));
+    connect(d.data(), SIGNAL(propertyValuesChanged(QVariantMap)),
+            this, SIGNAL(propertyValuesChanged(QVariantMap)));
     connect(d.data(), SIGNAL(conditionRaised(QString,QString)),
             this, SIGNAL(conditionRaised(QString,QString)));
 }
@@ -81,17 +97,17 @@ QString FakeDevice::udi() const
 
 QString FakeDevice::parentUdi() const
 {
-    return d->propertyMap["parent"].toString();
+    return property("parent").toString();
 }
 
 QString FakeDevice::vendor() const
 {
-    return d->propertyMap["vendor"].toString();
+    return property("vendor").toString();
 }
 
 QString FakeDevice::product() const
 {
-    return d->propertyMap["name"].toString();
+    return property("name").toString();
 }
 
 QString FakeDevice::icon() const
@@ -137,17 +153,44 @@ QString FakeDevice::description() const
 
 QVariant FakeDevice::property(const QString &key) const
 {
-    return d->propertyMap[key];
+    const auto it = d->propertyMap.constFind(key);
+    if (it != d->propertyMap.constEnd()) {
+        return it.value();
+    }
+
+    if (d->sharedProperties && !d->removedProperties.contains(key)) {
+        return d->sharedProperties->value(key);
+    }
+
+    return QVariant();
 }
 
 QMap<QString, QVariant> FakeDevice::allProperties() const
 {
-    return d->propertyMap;
+    if (!d->sharedProperties) {
+        return d->propertyMap;
+    }
+
+    QMap<QString, QVariant> merged = *d->sharedProperties;
+    for (const QString &key : qAsConst(d->removedProperties)) {
+        merged.remove(key);
+    }
+    for (auto it = d->propertyMap.constBegin(); it != d->propertyMap.constEnd(); ++it) {
+        merged.insert(it.key(), it.value());
+    }
+
+    return merged;
 }
 
 bool FakeDevice::propertyExists(const QString &key) const
 {
-    return d->propertyMap.contains(key);
+    if (d->propertyMap.contains(key)) {
+        return true;
+    }
+
+    return d->sharedProperties
+        && !d->removedProperties.contains(key)
+        && d->sharedProperties->contains(key);
 }
 
 bool FakeDevice::setProperty(const QString &key, const QVariant &value)
@@ -158,32 +201,44 @@ bool FakeDevice::setProperty(const QString &key, const QVariant &value)
 
     Solid::GenericInterface::PropertyChange change_type = Solid::GenericInterface::PropertyModified;
 
-    if (!d->propertyMap.contains(key)) {
+    if (!propertyExists(key)) {
         change_type = Solid::GenericInterface::PropertyAdded;
     }
 
+    d->removedProperties.remove(key);
     d->propertyMap[key] = value;
 
     QMap<QString, int> change;
     change[key] = change_type;
 
+    QVariantMap changedValues;
+    changedValues[key] = value;
+
     Q_EMIT d->propertyChanged(change);
+    Q_EMIT d->propertyValuesChanged(changedValues);
 
     return true;
 }
 
 bool FakeDevice::removeProperty(const QString &key)
 {
-    if (d->broken || !d->propertyMap.contains(key)) {
+    if (d->broken || !propertyExists(key)) {
         return false;
     }
 
     d->propertyMap.remove(key);
+    if (d->sharedProperties && d->sharedProperties->contains(key)) {
+        d->removedProperties.insert(key);
+    }
 
     QMap<QString, int> change;
     change[key] = Solid::GenericInterface::PropertyRemoved;
 
+    QVariantMap changedValues;
+    changedValues[key] = QVariant();
+
     Q_EMIT d->propertyChanged(change);
+    Q_EMIT d->propertyValuesChanged(changedValues);
 
     return true;
 }
@@ -22,6 +22,16 @@ class FakeDevice : public Solid::Ifaces::Device
     Q_OBJECT
 public:
     FakeDevice(const QString &udi, const QMap<QString, QVariant> &propertyMap);
+
+    /**
+     * Creates a device whose properties are backed by @p sharedProperties,
+     * a template shared with every other device built from it. Reads fall
+     * through to the template and writes land in a per-device overlay, so
+     * constructing a large synthetic tree never copies the template and
+     * modifying one device doesn't detach it for the others.
+     */
+    FakeDevice(const QString &udi, const QSharedPointer<const QMap<QString, QVariant>> &sharedProperties);
+
     FakeDevice(const FakeDevice &dev);
     ~FakeDevice();
 
@@ -55,9 +65,12 @@ public:
 
 Q_SIGNALS:
     void propertyChanged(const QMap<QString, int> &changes);
+    void propertyValuesChanged(const QVariantMap &changedValues);
     void conditionRaised(const QString &condition, const QString &reason);
 
 private:
+    void initialize(const QString &udi);
+
     class Private;
     QSharedPointer<Private> d;
 };
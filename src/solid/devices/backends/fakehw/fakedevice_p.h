@@ -7,6 +7,8 @@
 #define SOLID_BACKENDS_FAKEHW_FAKEDEVICE_P_H
 
 #include <QMap>
+#include <QSet>
+#include <QSharedPointer>
 #include <QString>
 #include <QVariant>
 #include <QObject>
@@ -25,7 +27,15 @@ class FakeDevice::Private : public QObject
     Q_OBJECT
 public:
     QString udi;
+    // Properties resolve in two layers: sharedProperties is an immutable
+    // template shared by every device built from it (may be null),
+    // propertyMap is this device's own values and overrides, and
+    // removedProperties masks template keys this device dropped. Writes
+    // only ever touch the overlay, so a whole synthetic tree keeps
+    // sharing one copy of the template no matter how much it is modified.
+    QSharedPointer<const QMap<QString, QVariant>> sharedProperties;
     QMap<QString, QVariant> propertyMap;
+    QSet<QString> removedProperties;
     QStringList interfaceList;
     bool locked;
     QString lockReason;
@@ -33,6 +43,7 @@ public:
 
 Q_SIGNALS:
     void propertyChanged(const QMap<QString, int> &changes);
+    void propertyValuesChanged(const QVariantMap &changedValues);
     void conditionRaised(const QString &condition, const QString &reason);
 
     friend class FakeDevice;
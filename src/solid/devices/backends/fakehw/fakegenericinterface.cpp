@@ -13,6 +13,8 @@ FakeGenericInterface::FakeGenericInterface(FakeDevice *device)
 {
     connect(device, SIGNAL(propertyChanged(QMap<QString,int>)),
             this, SIGNAL(propertyChanged(QMap<QString,int>)));
+    connect(device, SIGNAL(propertyValuesChanged(QVariantMap)),
+            this, SIGNAL(propertyValuesChanged(QVariantMap)));
     connect(device, SIGNAL(conditionRaised(QString,QString)),
             this, SIGNAL(conditionRaised(QString,QString)));
 }
@@ -31,6 +31,7 @@ public:
 
 Q_SIGNALS:
     void propertyChanged(const QMap<QString, int> &changes) override;
+    void propertyValuesChanged(const QVariantMap &changedValues) override;
     void conditionRaised(const QString &condition, const QString &reason) override;
 };
 }
@@ -8,12 +8,12 @@
 #include "fakedevice.h"
 
 // Qt includes
-#include <QDomDocument>
-#include <QDomElement>
-#include <QDomNode>
 #include <QDebug>
 #include <QFile>
 #include <QString>
+#include <QTextStream>
+#include <QThread>
+#include <QXmlStreamReader>
 #ifdef QT_DBUS_LIB
 #include <QDBusConnection>
 #endif
@@ -39,7 +39,9 @@ FakeManager::FakeManager(QObject *parent, const QString &xmlFile)
     QDBusConnection::sessionBus().registerObject("/org/kde/solid/fakehw", this, QDBusConnection::ExportNonScriptableSlots);
 #endif
 
-    parseMachineFile();
+    if (!machineXmlFile.isEmpty()) {
+        parseMachineFile();
+    }
 
     d->supportedInterfaces << Solid::DeviceInterface::GenericInterface
                            << Solid::DeviceInterface::Processor
@@ -74,6 +76,33 @@ QSet<Solid::DeviceInterface::Type> FakeManager::supportedInterfaces() const
     return d->supportedInterfaces;
 }
 
+quint32 FakeManager::deviceInterfacesMask(const QString &udi)
+{
+    const FakeDevice *device = d->loadedDevices.value(udi);
+    if (device == nullptr) {
+        return 0;
+    }
+
+    // The interface list is part of the device table, so the mask comes
+    // straight from the loaded properties.
+    quint32 mask = 0;
+    const QStringList interfaces = device->property(QStringLiteral("interfaces")).toString().simplified().split(QLatin1Char(','));
+    for (const QString &name : interfaces) {
+        const int type = Solid::DeviceInterface::stringToType(name);
+        if (type >= 0 && type < 32) {
+            mask |= quint32(1) << type;
+        }
+    }
+    return mask;
+}
+
+QVariantMap FakeManager::diagnosticState() const
+{
+    QVariantMap state;
+    state.insert(QStringLiteral("loadedDevices"), d->loadedDevices.count());
+    return state;
+}
+
 QStringList FakeManager::allDevices()
 {
     QStringList deviceUdiList;
@@ -172,6 +201,63 @@ void FakeManager::unplug(const QString &udi)
     }
 }
 
+int FakeManager::replayEventLog(const QString &filePath, qreal speed)
+{
+    QFile logFile(filePath);
+    if (!logFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qWarning() << Q_FUNC_INFO << "Error while opening " << filePath;
+        return -1;
+    }
+
+    int applied = 0;
+    int changeTick = 0;
+    qint64 previousMsecs = -1;
+
+    QTextStream in(&logFile);
+    while (!in.atEnd()) {
+        const QString line = in.readLine().trimmed();
+        if (line.isEmpty() || line.startsWith(QLatin1Char('#'))) {
+            continue;
+        }
+
+        const QStringList fields = line.split(QLatin1Char(' '), QString::SkipEmptyParts);
+        if (fields.count() != 3) {
+            continue;
+        }
+
+        bool ok = false;
+        const qint64 msecs = fields.at(0).toLongLong(&ok);
+        if (!ok) {
+            continue;
+        }
+        const QString &op = fields.at(1);
+        const QString &udi = fields.at(2);
+
+        if (speed > 0 && previousMsecs >= 0 && msecs > previousMsecs) {
+            QThread::msleep(static_cast<unsigned long>((msecs - previousMsecs) / speed));
+        }
+        previousMsecs = msecs;
+
+        if (op == QLatin1String("added")) {
+            plug(udi);
+            ++applied;
+        } else if (op == QLatin1String("removed")) {
+            unplug(udi);
+            ++applied;
+        } else if (op == QLatin1String("changed")) {
+            if (FakeDevice *device = findDevice(udi)) {
+                /* What changed isn't recorded; touching a synthetic
+                 * property reproduces the notification traffic, which is
+                 * what the replayed workload is about. */
+                device->setProperty(QStringLiteral("replayTick"), ++changeTick);
+                ++applied;
+            }
+        }
+    }
+
+    return applied;
+}
+
 void FakeManager::parseMachineFile()
 {
     QFile machineFile(d->xmlFile);
@@ -180,58 +266,65 @@ void FakeManager::parseMachineFile()
         return;
     }
 
-    QDomDocument fakeDocument;
-    if (!fakeDocument.setContent(&machineFile)) {
-        qWarning() << Q_FUNC_INFO << "Error while creating the QDomDocument.";
-        machineFile.close();
-        return;
-    }
-    machineFile.close();
-
     qDebug() << Q_FUNC_INFO << "Parsing fake computer XML: " << d->xmlFile;
-    QDomElement mainElement = fakeDocument.documentElement();
-    QDomNode node = mainElement.firstChild();
-    while (!node.isNull()) {
-        QDomElement tempElement = node.toElement();
-        if (!tempElement.isNull() && tempElement.tagName() == QLatin1String("device")) {
-            FakeDevice *tempDevice = parseDeviceElement(tempElement);
-            if (tempDevice) {
-                Q_ASSERT(!d->loadedDevices.contains(tempDevice->udi()));
-                d->loadedDevices.insert(tempDevice->udi(), tempDevice);
-                Q_EMIT deviceAdded(tempDevice->udi());
+
+    // The file is parsed in one streamed pass, so loading stays cheap
+    // even for the large synthetic trees the benchmarks use.
+    QXmlStreamReader reader(&machineFile);
+
+    QString udi;
+    QMap<QString, QVariant> propertyMap;
+
+    while (!reader.atEnd()) {
+        switch (reader.readNext()) {
+        case QXmlStreamReader::StartElement:
+            if (reader.name() == QLatin1String("device")) {
+                udi = reader.attributes().value(QLatin1String("udi")).toString();
+                propertyMap.clear();
+            } else if (reader.name() == QLatin1String("property")) {
+                const QString key = reader.attributes().value(QLatin1String("key")).toString();
+                propertyMap.insert(key, QVariant(reader.readElementText()));
             }
+            break;
+        case QXmlStreamReader::EndElement:
+            if (reader.name() == QLatin1String("device") && !propertyMap.isEmpty()) {
+                Q_ASSERT(!d->loadedDevices.contains(udi));
+                d->loadedDevices.insert(udi, new FakeDevice(udi, propertyMap));
+                Q_EMIT deviceAdded(udi);
+                propertyMap.clear();
+            }
+            break;
+        default:
+            break;
         }
+    }
 
-        node = node.nextSibling();
+    if (reader.hasError()) {
+        qWarning() << Q_FUNC_INFO << "Error while parsing " << d->xmlFile
+                   << ":" << reader.errorString();
     }
 }
 
-FakeDevice *FakeManager::parseDeviceElement(const QDomElement &deviceElement)
+QStringList FakeManager::createSyntheticDevices(int count, const QMap<QString, QVariant> &propertyTemplate)
 {
-    FakeDevice *device = nullptr;
-    QMap<QString, QVariant> propertyMap;
-    QString udi = deviceElement.attribute("udi");
-
-    QDomNode propertyNode = deviceElement.firstChild();
-    while (!propertyNode.isNull()) {
-        QDomElement propertyElement = propertyNode.toElement();
-        if (!propertyElement.isNull() && propertyElement.tagName() == QLatin1String("property")) {
-            QString propertyKey;
-            QVariant propertyValue;
+    QStringList udis;
+    udis.reserve(count);
 
-            propertyKey = propertyElement.attribute("key");
-            propertyValue = QVariant(propertyElement.text());
+    // One shared copy of the template backs every device; per-device
+    // property writes go to each device's own overlay.
+    const auto sharedTemplate = QSharedPointer<const QMap<QString, QVariant>>::create(propertyTemplate);
 
-            propertyMap.insert(propertyKey, propertyValue);
+    for (int i = 0; i < count; ++i) {
+        const QString udi = udiPrefix() + QStringLiteral("/synthetic_%1").arg(i);
+        if (d->loadedDevices.contains(udi)) {
+            continue;
         }
 
-        propertyNode = propertyNode.nextSibling();
-    }
-
-    if (!propertyMap.isEmpty()) {
-        device = new FakeDevice(udi, propertyMap);
+        d->loadedDevices.insert(udi, new FakeDevice(udi, sharedTemplate));
+        udis.append(udi);
+        Q_EMIT deviceAdded(udi);
     }
 
-    return device;
+    return udis;
 }
 
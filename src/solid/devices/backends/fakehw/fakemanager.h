@@ -9,7 +9,8 @@
 
 #include <solid/devices/ifaces/devicemanager.h>
 
-class QDomElement;
+#include <QMap>
+#include <QVariant>
 
 using namespace Solid::Ifaces;
 
@@ -36,6 +37,8 @@ public:
 
     QString udiPrefix() const override;
     QSet<Solid::DeviceInterface::Type> supportedInterfaces() const override;
+    quint32 deviceInterfacesMask(const QString &udi) override;
+    QVariantMap diagnosticState() const override;
 
     /**
      * Return the list of UDI of all available devices.
@@ -47,6 +50,38 @@ public:
     QObject *createDevice(const QString &udi) override;
     virtual FakeDevice *findDevice(const QString &udi);
 
+    /**
+     * Synthesizes @p count devices in memory, without going through an
+     * XML fixture, so large test trees can be set up in milliseconds.
+     *
+     * Each device gets the UDI <udiPrefix>/synthetic_<n>; all of them
+     * share a single copy of @p propertyTemplate as their properties,
+     * with per-device modifications stored separately. deviceAdded is
+     * emitted per device. Returns the UDIs of the created devices.
+     */
+    QStringList createSyntheticDevices(int count, const QMap<QString, QVariant> &propertyTemplate);
+
+    /**
+     * Replays a recorded device event log against this manager, so an
+     * event interleaving captured on a real system (solid-hardware
+     * record) becomes a repeatable workload for benchmarks and
+     * regression bisecting.
+     *
+     * The log is line-based: "<msecs> added|removed|changed <udi>",
+     * with '#' starting a comment. Added/removed events map to
+     * plug()/unplug() of the named device; changed events touch a
+     * property of it so the usual change notification goes out. Events
+     * for devices the loaded fixture doesn't know are skipped.
+     *
+     * @param filePath the log to replay
+     * @param speed 0 replays as fast as possible; otherwise the
+     * recorded inter-event gaps are kept, divided by @p speed (2.0
+     * replays twice as fast)
+     * @return the number of events applied, or -1 when the log can't
+     * be read
+     */
+    int replayEventLog(const QString &filePath, qreal speed = 0.0);
+
 public Q_SLOTS:
     void plug(const QString &udi);
     void unplug(const QString &udi);
@@ -57,11 +92,6 @@ private Q_SLOTS:
      * Parse the XML file that represent the fake machine.
      */
     void parseMachineFile();
-    /**
-     * @internal
-     * Parse a device node and the return the device.
-     */
-    FakeDevice *parseDeviceElement(const QDomElement &element);
 
 private:
     QStringList findDeviceStringMatch(const QString &key, const QString &value);
@@ -41,6 +41,9 @@ bool FakeStorageAccess::setup()
         return false;
     } else {
         fakeDevice()->setProperty("isMounted", true);
+        // The real backends report completion once the mount landed;
+        // the fake one completes synchronously.
+        Q_EMIT setupDone(Solid::NoError, QVariant(), fakeDevice()->udi());
         return true;
     }
 }
@@ -51,6 +54,7 @@ bool FakeStorageAccess::teardown()
         return false;
     } else {
         fakeDevice()->setProperty("isMounted", false);
+        Q_EMIT teardownDone(Solid::NoError, QVariant(), fakeDevice()->udi());
         return true;
     }
 }
@@ -15,84 +15,102 @@
 
 using namespace Solid::Backends::Fstab;
 
-FstabDevice::FstabDevice(QString uid) :
-    Solid::Ifaces::Device(),
-    m_uid(uid)
+FstabDevice::Identity FstabDevice::resolveIdentity(const QString &device)
 {
-    m_device = m_uid;
-    m_device.remove(parentUdi() + "/");
+    Identity identity;
 
-    const QString& fstype = FstabHandling::fstype(m_device);
-    qCDebug(FSTAB) << "Adding " << m_device << "type:" << fstype;
+    const QString& fstype = FstabHandling::fstype(device);
+    qCDebug(FSTAB) << "Resolving " << device << "type:" << fstype;
 
-    if (m_device.startsWith("//")) {
-        m_vendor = m_device.mid(2, m_device.indexOf("/", 2) - 2);
-        m_product = m_device.mid(m_device.indexOf("/", 2) + 1);
-        m_storageType = StorageType::NetworkShare;
+    if (device.startsWith("//")) {
+        identity.vendor = device.mid(2, device.indexOf("/", 2) - 2);
+        identity.product = device.mid(device.indexOf("/", 2) + 1);
+        identity.storageType = StorageType::NetworkShare;
     } else if (fstype.startsWith("nfs")) {
-        m_vendor = m_device.left(m_device.indexOf(":/"));
-        m_product = m_device.mid(m_device.indexOf(":/") + 1);
-        m_storageType = StorageType::NetworkShare;
+        identity.vendor = device.left(device.indexOf(":/"));
+        identity.product = device.mid(device.indexOf(":/") + 1);
+        identity.storageType = StorageType::NetworkShare;
     } else if (fstype.startsWith("fuse.") ||
                fstype == QLatin1String("overlay")) {
-        m_vendor = fstype;
-        m_product = m_device.mid(m_device.indexOf(fstype) + fstype.length());
+        identity.vendor = fstype;
+        identity.product = device.mid(device.indexOf(fstype) + fstype.length());
         QString home = QDir::homePath();
-        if (m_product.startsWith(home)) {
-            m_product = "~" + m_product.mid(home.length());
+        if (identity.product.startsWith(home)) {
+            identity.product = "~" + identity.product.mid(home.length());
         }
         if ((fstype == QLatin1String("fuse.encfs")) ||
             (fstype == QLatin1String("fuse.cryfs"))) {
-            m_storageType = StorageType::Encrypted;
+            identity.storageType = StorageType::Encrypted;
         }
     }
 
-    const QStringList& gvfsOptions = FstabHandling::options(m_device);
+    const QStringList& gvfsOptions = FstabHandling::options(device);
     for  (const QString &option : gvfsOptions) {
         if (option.startsWith(QLatin1String("x-gvfs-name="))) {
             QStringRef encoded = option.midRef(12);
-            m_displayName = QUrl::fromPercentEncoding(encoded.toLatin1());
+            identity.displayName = QUrl::fromPercentEncoding(encoded.toLatin1());
         } else if (option.startsWith(QLatin1String("x-gvfs-icon="))) {
             QStringRef encoded = option.midRef(12);
-            m_iconName = QUrl::fromPercentEncoding(encoded.toLatin1());
+            identity.iconName = QUrl::fromPercentEncoding(encoded.toLatin1());
         }
     }
 
-    if (m_storageType == StorageType::NetworkShare) {
-        m_description = QCoreApplication::translate("", "%1 on %2",
-        "%1 is sharename, %2 is servername").arg(m_product, m_vendor);
+    if (identity.storageType == StorageType::NetworkShare) {
+        identity.description = QCoreApplication::translate("", "%1 on %2",
+        "%1 is sharename, %2 is servername").arg(identity.product, identity.vendor);
     } else {
-        m_description = QCoreApplication::translate("", "%1 (%2)",
-        "%1 is mountpoint, %2 is fs type").arg(m_product, m_vendor);
+        identity.description = QCoreApplication::translate("", "%1 (%2)",
+        "%1 is mountpoint, %2 is fs type").arg(identity.product, identity.vendor);
     }
 
-    if (m_displayName.isEmpty()) {
-        const QStringList currentMountPoints = FstabHandling::currentMountPoints(m_device);
+    if (identity.displayName.isEmpty()) {
+        const QStringList currentMountPoints = FstabHandling::currentMountPoints(device);
         if (currentMountPoints.isEmpty()) {
-            const QStringList mountPoints = FstabHandling::mountPoints(m_device);
-            m_displayName = mountPoints.isEmpty() ? m_description : mountPoints.first();
+            const QStringList mountPoints = FstabHandling::mountPoints(device);
+            identity.displayName = mountPoints.isEmpty() ? identity.description : mountPoints.first();
         } else {
-            m_displayName = currentMountPoints.first();
+            identity.displayName = currentMountPoints.first();
         }
     }
 
-    if (m_iconName.isEmpty()) {
-        if (m_storageType == StorageType::NetworkShare) {
-            m_iconName = QLatin1String("network-server");
-        } else if (m_storageType == StorageType::Encrypted) {
-            m_iconName = QLatin1String("folder-decrypted");
+    if (identity.iconName.isEmpty()) {
+        if (identity.storageType == StorageType::NetworkShare) {
+            identity.iconName = QLatin1String("network-server");
+        } else if (identity.storageType == StorageType::Encrypted) {
+            identity.iconName = QLatin1String("folder-decrypted");
         } else {
-            const QStringList& mountPoints = FstabHandling::mountPoints(m_device);
+            const QStringList& mountPoints = FstabHandling::mountPoints(device);
             const QString home = QDir::homePath();
             if (mountPoints.contains("/")) {
-                m_iconName = QStringLiteral("drive-harddisk-root");
+                identity.iconName = QStringLiteral("drive-harddisk-root");
             } else if (mountPoints.contains(home)) {
-                m_iconName = QStringLiteral("user-home");
+                identity.iconName = QStringLiteral("user-home");
             } else {
-                m_iconName = QStringLiteral("folder");
+                identity.iconName = QStringLiteral("folder");
             }
         }
     }
+
+    return identity;
+}
+
+FstabDevice::FstabDevice(QString uid) :
+    Solid::Ifaces::Device(),
+    m_uid(uid)
+{
+    m_device = m_uid;
+    m_device.remove(parentUdi() + "/");
+
+    m_identity = resolveIdentity(m_device);
+}
+
+FstabDevice::FstabDevice(QString uid, const Identity &identity) :
+    Solid::Ifaces::Device(),
+    m_uid(uid),
+    m_identity(identity)
+{
+    m_device = m_uid;
+    m_device.remove(parentUdi() + "/");
 }
 
 FstabDevice::~FstabDevice()
@@ -111,17 +129,17 @@ QString FstabDevice::parentUdi() const
 
 QString FstabDevice::vendor() const
 {
-    return m_vendor;
+    return m_identity.vendor;
 }
 
 QString FstabDevice::product() const
 {
-    return m_product;
+    return m_identity.product;
 }
 
 QString FstabDevice::icon() const
 {
-    return m_iconName;
+    return m_identity.iconName;
 }
 
 QStringList FstabDevice::emblems() const
@@ -142,12 +160,12 @@ QStringList FstabDevice::emblems() const
 
 QString FstabDevice::displayName() const
 {
-    return m_displayName;
+    return m_identity.displayName;
 }
 
 QString FstabDevice::description() const
 {
-    return m_description;
+    return m_identity.description;
 }
 
 bool FstabDevice::queryDeviceInterface(const Solid::DeviceInterface::Type &interfaceType) const
@@ -155,7 +173,7 @@ bool FstabDevice::queryDeviceInterface(const Solid::DeviceInterface::Type &inter
     if (interfaceType == Solid::DeviceInterface::StorageAccess) {
         return true;
     }
-    if ((m_storageType == StorageType::NetworkShare) &&
+    if ((m_identity.storageType == StorageType::NetworkShare) &&
         (interfaceType == Solid::DeviceInterface::NetworkShare)) {
         return true;
     }
@@ -169,7 +187,7 @@ QObject *FstabDevice::createDeviceInterface(const Solid::DeviceInterface::Type &
             m_storageAccess = new FstabStorageAccess(this);
         }
         return m_storageAccess;
-    } else if ((m_storageType == StorageType::NetworkShare) &&
+    } else if ((m_identity.storageType == StorageType::NetworkShare) &&
                (interfaceType == Solid::DeviceInterface::NetworkShare)) {
         return new FstabNetworkShare(this);
     }
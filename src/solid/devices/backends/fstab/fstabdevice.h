@@ -24,8 +24,34 @@ class FstabDevice : public Solid::Ifaces::Device
     Q_OBJECT
 
 public:
+    enum class StorageType : uint8_t {
+        Other = 0,
+        NetworkShare,
+        Encrypted,
+    };
+
+    /**
+     * The parts of a device that only depend on its fstab entry:
+     * classification and display strings. Resolving them means parsing
+     * the device name and the mount options, so the manager caches one
+     * Identity per entry and hands it to every FstabDevice it creates,
+     * making repeated enumerations allocation-free.
+     */
+    struct Identity {
+        QString vendor;
+        QString product;
+        QString displayName;
+        QString description;
+        QString iconName;
+        StorageType storageType = StorageType::Other;
+    };
+
+    static Identity resolveIdentity(const QString &device);
+
     FstabDevice(QString uid);
 
+    FstabDevice(QString uid, const Identity &identity);
+
     virtual ~FstabDevice();
 
     QString udi() const override;
@@ -59,18 +85,8 @@ public Q_SLOTS:
 private:
     QString m_uid;
     QString m_device;
-    QString m_product;
-    QString m_vendor;
-    QString m_displayName;
-    QString m_description;
-    QString m_iconName;
+    Identity m_identity;
     QPointer<FstabStorageAccess> m_storageAccess;
-    enum class StorageType : uint8_t {
-        Other = 0,
-        NetworkShare,
-        Encrypted,
-    };
-    StorageType m_storageType = StorageType::Other;
 };
 
 }
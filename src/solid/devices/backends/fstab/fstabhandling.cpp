@@ -8,11 +8,13 @@
 #include "fstabhandling.h"
 
 #include <QFile>
+#include <QMutex>
+#include <QMutexLocker>
 #include <QObject>
 #include <QProcess>
 #include <QRegularExpression>
+#include <QSet>
 #include <QTextStream>
-#include <QThreadStorage>
 
 #include <solid/devices/soliddefs_p.h>
 
@@ -89,11 +91,21 @@
 #define FSNAME(var) var.mnt_special
 #endif
 
-Q_GLOBAL_STATIC(QThreadStorage<Solid::Backends::Fstab::FstabHandling>, globalFstabCache)
+// One cache shared by all threads. The current snapshot is immutable:
+// invalidation replaces it with a freshly parsed copy under the mutex,
+// while readers that already hold a snapshot keep using it lock-free.
+namespace
+{
+struct GlobalFstabCache {
+    QMutex mutex;
+    QSharedPointer<const Solid::Backends::Fstab::FstabHandling> snapshot;
+    bool fstabValid = false;
+    bool mtabValid = false;
+};
+}
+Q_GLOBAL_STATIC(GlobalFstabCache, globalFstabCache)
 
 Solid::Backends::Fstab::FstabHandling::FstabHandling()
-    : m_fstabCacheValid(false),
-      m_mtabCacheValid(false)
 { }
 
 bool _k_isFstabNetworkFileSystem(const QString &fstype, const QString &devName)
@@ -133,14 +145,41 @@ QString _k_deviceNameForMountpoint(const QString &source, const QString &fstype,
     return source + QLatin1Char(':') + mountpoint;
 }
 
-void Solid::Backends::Fstab::FstabHandling::_k_updateFstabMountPointsCache()
+// Mirrors the parsing FstabNetworkShare used to do per call; the share
+// type and URL only depend on the device name, so they are derived once
+// when the mount tables are parsed.
+Solid::Backends::Fstab::FstabHandling::NetworkShareInfo _k_networkShareForDevice(const QString &device)
 {
-    if (globalFstabCache->localData().m_fstabCacheValid) {
-        return;
+    Solid::Backends::Fstab::FstabHandling::NetworkShareInfo info;
+    info.device = device;
+
+    QString url;
+    if (device.startsWith(QLatin1String("//"))) {
+        info.type = Solid::NetworkShare::Cifs;
+        url = QLatin1String("smb:") + device;
+    } else if (device.contains(QLatin1String(":/"))) {
+        info.type = Solid::NetworkShare::Nfs;
+        url = QLatin1String("nfs://") + device.left(device.indexOf(QLatin1String(":/")))
+              + QLatin1Char('/') + device.mid(device.indexOf(QLatin1String(":/")) + 1);
     }
+    info.url = QUrl(url);
+    return info;
+}
 
-    globalFstabCache->localData().m_fstabCache.clear();
-    globalFstabCache->localData().m_fstabOptionsCache.clear();
+void Solid::Backends::Fstab::FstabHandling::_k_updateNetworkShareCache(FstabHandling *cache)
+{
+    const QStringList devices = cache->m_fstabCache.uniqueKeys() + cache->m_mtabCache.uniqueKeys();
+    for (const QString &device : devices) {
+        if (!cache->m_networkShareCache.contains(device)) {
+            cache->m_networkShareCache.insert(device, _k_networkShareForDevice(device));
+        }
+    }
+}
+
+void Solid::Backends::Fstab::FstabHandling::_k_updateFstabMountPointsCache(FstabHandling *cache)
+{
+    cache->m_fstabCache.clear();
+    cache->m_fstabOptionsCache.clear();
 
 #if HAVE_SETMNTENT
 
@@ -159,10 +198,10 @@ void Solid::Backends::Fstab::FstabHandling::_k_updateFstabMountPointsCache()
             const QString device = _k_deviceNameForMountpoint(fsname, fstype, mountpoint);
             QStringList options = QFile::decodeName(fe->mnt_opts).split(QLatin1Char(','));
 
-            globalFstabCache->localData().m_fstabCache.insert(device, mountpoint);
-            globalFstabCache->localData().m_fstabFstypeCache.insert(device, fstype);
+            cache->m_fstabCache.insert(device, mountpoint);
+            cache->m_fstabFstypeCache.insert(device, fstype);
             while (!options.isEmpty()) {
-                globalFstabCache->localData().m_fstabOptionsCache.insert(device, options.takeFirst());
+                cache->m_fstabOptionsCache.insert(device, options.takeFirst());
             }
         }
     }
@@ -203,32 +242,55 @@ void Solid::Backends::Fstab::FstabHandling::_k_updateFstabMountPointsCache()
             const QString device = items.at(0);
             const QString mountpoint = items.at(1);
 
-            globalFstabCache->localData().m_fstabCache.insert(device, mountpoint);
+            cache->m_fstabCache.insert(device, mountpoint);
         }
     }
 
     fstab.close();
 #endif
-    globalFstabCache->localData().m_fstabCacheValid = true;
+}
+
+QSharedPointer<const Solid::Backends::Fstab::FstabHandling> Solid::Backends::Fstab::FstabHandling::snapshot()
+{
+    QMutexLocker locker(&globalFstabCache->mutex);
+
+    if (!globalFstabCache->snapshot || !globalFstabCache->fstabValid || !globalFstabCache->mtabValid) {
+        // start from the previous snapshot so an fstab invalidation
+        // doesn't force an mtab re-parse and vice versa
+        QSharedPointer<FstabHandling> fresh = globalFstabCache->snapshot
+                ? QSharedPointer<FstabHandling>::create(*globalFstabCache->snapshot)
+                : QSharedPointer<FstabHandling>::create();
+
+        if (!globalFstabCache->snapshot || !globalFstabCache->fstabValid) {
+            _k_updateFstabMountPointsCache(fresh.data());
+        }
+        if (!globalFstabCache->snapshot || !globalFstabCache->mtabValid) {
+            _k_updateMtabMountPointsCache(fresh.data());
+        }
+        _k_updateNetworkShareCache(fresh.data());
+
+        globalFstabCache->snapshot = fresh;
+        globalFstabCache->fstabValid = true;
+        globalFstabCache->mtabValid = true;
+    }
+
+    return globalFstabCache->snapshot;
 }
 
 QStringList Solid::Backends::Fstab::FstabHandling::deviceList()
 {
-    _k_updateFstabMountPointsCache();
-    _k_updateMtabMountPointsCache();
+    const auto cache = snapshot();
 
-    QStringList devices = globalFstabCache->localData().m_mtabCache.keys();
+    QStringList devices = cache->m_mtabCache.uniqueKeys();
+    QSet<QString> knownDevices(devices.begin(), devices.end());
 
     // Ensure that regardless an fstab device ends with a slash
     // it will match its eventual mounted device regardless whether or not its path
     // ends with a slash
-    for (auto it = globalFstabCache->localData().m_fstabCache.constBegin(),
-         end = globalFstabCache->localData().m_fstabCache.constEnd();
-         it != end; ++it) {
-
-        auto device = it.key();
+    const QStringList fstabDevices = cache->m_fstabCache.uniqueKeys();
+    for (const QString &device : fstabDevices) {
         // the device is already known
-        if (devices.contains(device)) {
+        if (knownDevices.contains(device)) {
             continue;
         }
 
@@ -239,8 +301,9 @@ QStringList Solid::Backends::Fstab::FstabHandling::deviceList()
         } else {
             deviceName.append(QLatin1Char('/'));
         }
-        if (!devices.contains(deviceName)) {
+        if (!knownDevices.contains(deviceName)) {
             devices.append(device);
+            knownDevices.insert(device);
         }
     }
     return devices;
@@ -248,28 +311,45 @@ QStringList Solid::Backends::Fstab::FstabHandling::deviceList()
 
 QStringList Solid::Backends::Fstab::FstabHandling::mountPoints(const QString &device)
 {
-    _k_updateFstabMountPointsCache();
-    _k_updateMtabMountPointsCache();
+    const auto cache = snapshot();
 
-    QStringList mountpoints = globalFstabCache->localData().m_fstabCache.values(device);
-    mountpoints += globalFstabCache->localData().m_mtabCache.values(device);
+    QStringList mountpoints = cache->m_fstabCache.values(device);
+    mountpoints += cache->m_mtabCache.values(device);
     mountpoints.removeDuplicates();
     return mountpoints;
 }
 
 QStringList Solid::Backends::Fstab::FstabHandling::options(const QString &device)
 {
-    _k_updateFstabMountPointsCache();
-
-    QStringList options = globalFstabCache->localData().m_fstabOptionsCache.values(device);
-    return options;
+    return snapshot()->m_fstabOptionsCache.values(device);
 }
 
 QString Solid::Backends::Fstab::FstabHandling::fstype(const QString &device)
 {
-    _k_updateFstabMountPointsCache();
+    return snapshot()->m_fstabFstypeCache.value(device);
+}
 
-    return globalFstabCache->localData().m_fstabFstypeCache.value(device);
+Solid::Backends::Fstab::FstabHandling::NetworkShareInfo Solid::Backends::Fstab::FstabHandling::networkShareInfo(const QString &device)
+{
+    return snapshot()->m_networkShareCache.value(device);
+}
+
+QList<Solid::Backends::Fstab::FstabHandling::NetworkShareInfo> Solid::Backends::Fstab::FstabHandling::allNetworkShares()
+{
+    const auto cache = snapshot();
+
+    QList<NetworkShareInfo> shares;
+    // deviceList() rather than the share cache keys: the cache keeps
+    // entries of devices which have gone away, like the fstype cache
+    const QStringList devices = deviceList();
+    for (const QString &device : devices) {
+        const auto it = cache->m_networkShareCache.constFind(device);
+        if (it != cache->m_networkShareCache.constEnd()
+                && it->type != Solid::NetworkShare::Unknown) {
+            shares.append(*it);
+        }
+    }
+    return shares;
 }
 
 bool Solid::Backends::Fstab::FstabHandling::callSystemCommand(const QString &commandName, const QStringList &args,
@@ -290,25 +370,25 @@ bool Solid::Backends::Fstab::FstabHandling::callSystemCommand(const QString &com
             process->deleteLater();
     });
 
+    // a process that never starts doesn't emit finished(); report the
+    // failure through the same callback instead of blocking the caller
+    // in waitForStarted() -- callers can tell by checking
+    // process->error() == QProcess::FailedToStart
+    QObject::connect(process, &QProcess::errorOccurred, receiver,
+        [process, callback](QProcess::ProcessError error) {
+            if (error == QProcess::FailedToStart) {
+                callback(process);
+                process->deleteLater();
+            }
+    });
+
     process->setEnvironment(env);
     process->start(commandName, args);
-
-    if (process->waitForStarted()) {
-        return true;
-    }
-
-    delete process;
-    return false;
+    return true;
 }
 
-void Solid::Backends::Fstab::FstabHandling::_k_updateMtabMountPointsCache()
+void Solid::Backends::Fstab::FstabHandling::_k_parseMtab(QStringMultiHash *mtabCache, QHash<QString, QString> *fstypeCache)
 {
-    if (globalFstabCache->localData().m_mtabCacheValid) {
-        return;
-    }
-
-    globalFstabCache->localData().m_mtabCache.clear();
-
 #if HAVE_GETMNTINFO
 
 #if GETMNTINFO_USES_STATVFS
@@ -326,8 +406,8 @@ void Solid::Backends::Fstab::FstabHandling::_k_updateMtabMountPointsCache()
             const QString fsname = QFile::decodeName(mounted[i].f_mntfromname);
             const QString mountpoint = QFile::decodeName(mounted[i].f_mntonname);
             const QString device = _k_deviceNameForMountpoint(fsname, type, mountpoint);
-            globalFstabCache->localData().m_mtabCache.insert(device, mountpoint);
-            globalFstabCache->localData().m_fstabFstypeCache.insert(device, type);
+            mtabCache->insert(device, mountpoint);
+            fstypeCache->insert(device, type);
         }
     }
 
@@ -345,28 +425,69 @@ void Solid::Backends::Fstab::FstabHandling::_k_updateMtabMountPointsCache()
             const QString fsname = QFile::decodeName(FSNAME(fe));
             const QString mountpoint = QFile::decodeName(MOUNTPOINT(fe));
             const QString device = _k_deviceNameForMountpoint(fsname, type, mountpoint);
-            globalFstabCache->localData().m_mtabCache.insert(device, mountpoint);
-            globalFstabCache->localData().m_fstabFstypeCache.insert(device, type);
+            mtabCache->insert(device, mountpoint);
+            fstypeCache->insert(device, type);
         }
     }
     ENDMNTENT(mnttab);
 #endif
+}
+
+void Solid::Backends::Fstab::FstabHandling::_k_updateMtabMountPointsCache(FstabHandling *cache)
+{
+    cache->m_mtabCache.clear();
+    _k_parseMtab(&cache->m_mtabCache, &cache->m_fstabFstypeCache);
+}
+
+QStringList Solid::Backends::Fstab::FstabHandling::refreshMtabCache()
+{
+    const QSharedPointer<const FstabHandling> oldSnapshot = snapshot();
+
+    QSharedPointer<FstabHandling> fresh = QSharedPointer<FstabHandling>::create(*oldSnapshot);
+    fresh->m_mtabCache.clear();
+    _k_parseMtab(&fresh->m_mtabCache, &fresh->m_fstabFstypeCache);
+    _k_updateNetworkShareCache(fresh.data());
+
+    // diff the snapshots so callers can notify only the devices whose
+    // mount points actually changed
+    QStringList changedDevices;
+    const auto collectChanges = [&](const QStringMultiHash &from, const QStringMultiHash &to) {
+        const QStringList devices = from.uniqueKeys();
+        for (const QString &device : devices) {
+            if (changedDevices.contains(device)) {
+                continue;
+            }
+            const QStringList oldPoints = from.values(device);
+            const QStringList newPoints = to.values(device);
+            if (QSet<QString>(oldPoints.begin(), oldPoints.end())
+                    != QSet<QString>(newPoints.begin(), newPoints.end())) {
+                changedDevices.append(device);
+            }
+        }
+    };
+    collectChanges(oldSnapshot->m_mtabCache, fresh->m_mtabCache);
+    collectChanges(fresh->m_mtabCache, oldSnapshot->m_mtabCache);
+
+    QMutexLocker locker(&globalFstabCache->mutex);
+    globalFstabCache->snapshot = fresh;
+    globalFstabCache->mtabValid = true;
 
-    globalFstabCache->localData().m_mtabCacheValid = true;
+    return changedDevices;
 }
 
 QStringList Solid::Backends::Fstab::FstabHandling::currentMountPoints(const QString &device)
 {
-    _k_updateMtabMountPointsCache();
-    return globalFstabCache->localData().m_mtabCache.values(device);
+    return snapshot()->m_mtabCache.values(device);
 }
 
 void Solid::Backends::Fstab::FstabHandling::flushMtabCache()
 {
-    globalFstabCache->localData().m_mtabCacheValid = false;
+    QMutexLocker locker(&globalFstabCache->mutex);
+    globalFstabCache->mtabValid = false;
 }
 
 void Solid::Backends::Fstab::FstabHandling::flushFstabCache()
 {
-    globalFstabCache->localData().m_fstabCacheValid = false;
+    QMutexLocker locker(&globalFstabCache->mutex);
+    globalFstabCache->fstabValid = false;
 }
@@ -8,8 +8,12 @@
 #ifndef SOLID_BACKENDS_FSTAB_FSTABHANDLING_H
 #define SOLID_BACKENDS_FSTAB_FSTABHANDLING_H
 
-#include <QString>
 #include <QMultiHash>
+#include <QSharedPointer>
+#include <QString>
+#include <QUrl>
+
+#include <solid/networkshare.h>
 
 #include <functional>
 
@@ -28,27 +32,68 @@ class FstabHandling
 public:
     FstabHandling();
 
+    /**
+     * Share type and URL of a network mount, derived from its fstab/mtab
+     * source once at parse time instead of per query.
+     */
+    struct NetworkShareInfo {
+        QString device;
+        Solid::NetworkShare::ShareType type = Solid::NetworkShare::Unknown;
+        QUrl url;
+    };
+
     static QStringList deviceList();
     static QStringList currentMountPoints(const QString &device);
     static QStringList mountPoints(const QString &device);
     static QStringList options(const QString &device);
     static QString fstype(const QString &device);
+
+    /**
+     * Returns the share info of @p device, parsed when the mount tables
+     * were. The struct members are implicitly shared, so this is a
+     * refcount bump, not a re-parse.
+     */
+    static NetworkShareInfo networkShareInfo(const QString &device);
+
+    /**
+     * Returns the share info of every network mount currently known, in
+     * one call against a single snapshot of the mount tables.
+     */
+    static QList<NetworkShareInfo> allNetworkShares();
+
     static bool callSystemCommand(const QString &commandName, const QStringList &args, const QObject *recvr, std::function<void(QProcess *)> callback);
     static void flushMtabCache();
     static void flushFstabCache();
 
-private:
-    static void _k_updateMtabMountPointsCache();
-    static void _k_updateFstabMountPointsCache();
+    /**
+     * Re-reads the mount table immediately and updates the cache in place,
+     * instead of invalidating it wholesale. Returns the devices whose set of
+     * mount points changed, so callers can notify only the affected devices.
+     */
+    static QStringList refreshMtabCache();
 
+private:
     typedef QMultiHash<QString, QString> QStringMultiHash;
 
+    /**
+     * Returns an immutable snapshot of the parsed fstab and mount tables,
+     * shared between all threads. The tables are (re)parsed at most once
+     * per invalidation no matter how many threads query them; readers keep
+     * working on their snapshot without any lock while a newer one is
+     * being built.
+     */
+    static QSharedPointer<const FstabHandling> snapshot();
+
+    static void _k_parseMtab(QStringMultiHash *mtabCache, QHash<QString, QString> *fstypeCache);
+    static void _k_updateMtabMountPointsCache(FstabHandling *cache);
+    static void _k_updateFstabMountPointsCache(FstabHandling *cache);
+    static void _k_updateNetworkShareCache(FstabHandling *cache);
+
     QStringMultiHash m_mtabCache;
     QStringMultiHash m_fstabCache;
     QStringMultiHash m_fstabOptionsCache;
     QHash<QString, QString> m_fstabFstypeCache;
-    bool m_fstabCacheValid;
-    bool m_mtabCacheValid;
+    QHash<QString, NetworkShareInfo> m_networkShareCache;
 
 };
 
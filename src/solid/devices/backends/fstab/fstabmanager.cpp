@@ -20,6 +20,14 @@ FstabManager::FstabManager(QObject *parent)
 {
     m_supportedInterfaces << Solid::DeviceInterface::StorageAccess;
     m_supportedInterfaces << Solid::DeviceInterface::NetworkShare;
+}
+
+void FstabManager::ensureDeviceList()
+{
+    if (m_deviceListReady) {
+        return;
+    }
+    m_deviceListReady = true;
 
     m_deviceList = FstabHandling::deviceList();
 
@@ -39,6 +47,8 @@ QSet<Solid::DeviceInterface::Type> FstabManager::supportedInterfaces() const
 
 QStringList FstabManager::allDevices()
 {
+    ensureDeviceList();
+
     QStringList result;
 
     result << udiPrefix();
@@ -52,6 +62,8 @@ QStringList FstabManager::allDevices()
 QStringList FstabManager::devicesFromQuery(const QString &parentUdi,
         Solid::DeviceInterface::Type type)
 {
+    ensureDeviceList();
+
     if ((parentUdi == udiPrefix()) || parentUdi.isEmpty()) {
         QStringList result;
         if (type == Solid::DeviceInterface::StorageAccess) {
@@ -77,6 +89,8 @@ QStringList FstabManager::devicesFromQuery(const QString &parentUdi,
 
 QObject *FstabManager::createDevice(const QString &udi)
 {
+    ensureDeviceList();
+
     if (udi == udiPrefix()) {
         RootDevice *root = new RootDevice(FSTAB_UDI_PREFIX);
 
@@ -93,7 +107,12 @@ QObject *FstabManager::createDevice(const QString &udi)
             return nullptr;
         }
 
-        FstabDevice *device = new FstabDevice(udi);
+        auto it = m_identityCache.constFind(internalName);
+        if (it == m_identityCache.constEnd()) {
+            it = m_identityCache.insert(internalName, FstabDevice::resolveIdentity(internalName));
+        }
+
+        FstabDevice *device = new FstabDevice(udi, *it);
         connect(this, &FstabManager::mtabChanged, device, &FstabDevice::onMtabChanged);
         return device;
 
@@ -103,6 +122,7 @@ QObject *FstabManager::createDevice(const QString &udi)
 void FstabManager::onFstabChanged()
 {
     FstabHandling::flushFstabCache();
+    m_identityCache.clear();
     _k_updateDeviceList();
 }
 
@@ -131,11 +151,15 @@ void FstabManager::_k_updateDeviceList()
 
 void FstabManager::onMtabChanged()
 {
-    FstabHandling::flushMtabCache();
+    // refresh in place and learn which devices actually changed, rather
+    // than invalidating the cache and poking every device
+    const QStringList changedDevices = FstabHandling::refreshMtabCache();
 
     _k_updateDeviceList(); // devicelist is union of mtab and fstab
 
-    for (const QString &device : qAsConst(m_deviceList)) {
+    for (const QString &device : changedDevices) {
+        // the fallback display name follows the current mount point
+        m_identityCache.remove(device);
         // notify storageaccess objects via device ...
         Q_EMIT mtabChanged(device);
     }
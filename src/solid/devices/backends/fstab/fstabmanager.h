@@ -9,6 +9,8 @@
 
 #include <solid/devices/ifaces/devicemanager.h>
 #include <solid/deviceinterface.h>
+#include "fstabdevice.h"
+#include <QHash>
 #include <QStringList>
 #include <QSet>
 
@@ -44,6 +46,13 @@ private Q_SLOTS:
 private:
     QSet<Solid::DeviceInterface::Type> m_supportedInterfaces;
     QStringList m_deviceList;
+    bool m_deviceListReady = false;
+    // parses the tables and starts watching them on the first query, so
+    // applications that never ask about fstab devices don't pay for either
+    void ensureDeviceList();
+    // classification and display strings per fstab entry, resolved once
+    // and reused for every device created for that entry
+    QHash<QString, FstabDevice::Identity> m_identityCache;
     void _k_updateDeviceList();
 };
 
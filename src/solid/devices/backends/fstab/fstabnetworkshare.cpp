@@ -6,6 +6,7 @@
 
 #include "fstabnetworkshare.h"
 #include <solid/devices/backends/fstab/fstabdevice.h>
+#include <solid/devices/backends/fstab/fstabhandling.h>
 
 using namespace Solid::Backends::Fstab;
 
@@ -13,20 +14,11 @@ FstabNetworkShare::FstabNetworkShare(Solid::Backends::Fstab::FstabDevice *device
     QObject(device),
     m_fstabDevice(device)
 {
-    QString url;
-    if (m_fstabDevice->device().startsWith("//")) {
-        m_type = Solid::NetworkShare::Cifs;
-        url = "smb:";
-        url += m_fstabDevice->device();
-    } else if (m_fstabDevice->device().contains(":/")) {
-        m_type = Solid::NetworkShare::Nfs;
-        url = "nfs://";
-        url += m_fstabDevice->vendor() + "/";
-        url += m_fstabDevice->product();
-    } else {
-        m_type = Solid::NetworkShare::Unknown;
-    }
-    m_url = QUrl(url);
+    // parsed once per fstab/mtab generation, shared between all shares
+    const FstabHandling::NetworkShareInfo info =
+        FstabHandling::networkShareInfo(m_fstabDevice->device());
+    m_type = info.type;
+    m_url = info.url;
 }
 
 FstabNetworkShare::~FstabNetworkShare()
@@ -94,7 +94,9 @@ bool FstabStorageAccess::setup()
     }
     m_fstabDevice->broadcastActionRequested("setup");
     return FstabHandling::callSystemCommand("mount", {filePath()}, this, [this](QProcess *process) {
-        if (process->exitCode() == 0) {
+        if (process->error() == QProcess::FailedToStart) {
+            m_fstabDevice->broadcastActionDone("setup", Solid::OperationFailed, process->errorString());
+        } else if (process->exitCode() == 0) {
             m_fstabDevice->broadcastActionDone("setup", Solid::NoError, QString());
         } else {
             m_fstabDevice->broadcastActionDone("setup", Solid::UnauthorizedOperation, process->readAllStandardError());
@@ -114,7 +116,9 @@ bool FstabStorageAccess::teardown()
     }
     m_fstabDevice->broadcastActionRequested("teardown");
     return FstabHandling::callSystemCommand("umount", {filePath()}, this, [this](QProcess *process) {
-        if (process->exitCode() == 0) {
+        if (process->error() == QProcess::FailedToStart) {
+            m_fstabDevice->broadcastActionDone("teardown", Solid::OperationFailed, process->errorString());
+        } else if (process->exitCode() == 0) {
             m_fstabDevice->broadcastActionDone("teardown", Solid::NoError);
         } else if (process->exitCode() == EBUSY) {
             m_fstabDevice->broadcastActionDone("teardown", Solid::DeviceBusy);
@@ -141,6 +145,66 @@ void FstabStorageAccess::slotTeardownDone(int error, const QString &errorString)
     Q_EMIT teardownDone(static_cast<Solid::ErrorType>(error), errorString, m_fstabDevice->udi());
 }
 
+FstabStorageAccessBatch::FstabStorageAccessBatch(const QList<FstabStorageAccess *> &accesses, Operation operation, QObject *parent)
+    : QObject(parent),
+      m_accesses(accesses),
+      m_operation(operation),
+      m_remaining(0)
+{
+}
+
+void FstabStorageAccessBatch::start()
+{
+    m_remaining = m_accesses.count();
+
+    if (m_accesses.isEmpty()) {
+        Q_EMIT finished(m_errors);
+        return;
+    }
+
+    for (FstabStorageAccess *access : qAsConst(m_accesses)) {
+        if (m_operation == Setup) {
+            connect(access, &FstabStorageAccess::setupDone,
+                    this, &FstabStorageAccessBatch::slotOperationDone, Qt::UniqueConnection);
+        } else {
+            connect(access, &FstabStorageAccess::teardownDone,
+                    this, &FstabStorageAccessBatch::slotOperationDone, Qt::UniqueConnection);
+        }
+    }
+
+    // the mount/umount helpers are spawned without waiting, so by the end of
+    // this loop all of them run concurrently
+    for (FstabStorageAccess *access : qAsConst(m_accesses)) {
+        const bool started = (m_operation == Setup) ? access->setup() : access->teardown();
+        if (!started) {
+            // no mount point known for the device
+            operationDone(access->fstabDevice()->udi(), Solid::OperationFailed);
+        }
+    }
+}
+
+void FstabStorageAccessBatch::slotOperationDone(Solid::ErrorType error, QVariant errorData, const QString &udi)
+{
+    Q_UNUSED(errorData)
+    operationDone(udi, error);
+}
+
+void FstabStorageAccessBatch::operationDone(const QString &udi, Solid::ErrorType error)
+{
+    if (m_done.contains(udi)) {
+        return;
+    }
+    m_done.insert(udi);
+
+    if (error != Solid::NoError) {
+        m_errors.insert(udi, error);
+    }
+
+    if (--m_remaining == 0) {
+        Q_EMIT finished(m_errors);
+    }
+}
+
 void FstabStorageAccess::onMtabChanged(const QString &device)
 {
     QStringList currentMountPoints = FstabHandling::currentMountPoints(device);
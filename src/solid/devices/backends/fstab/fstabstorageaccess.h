@@ -9,7 +9,9 @@
 
 #include <solid/devices/ifaces/storageaccess.h>
 
+#include <QMap>
 #include <QObject>
+#include <QSet>
 
 namespace Solid
 {
@@ -68,6 +70,45 @@ private:
     bool m_isIgnored;
 };
 
+/**
+ * Runs setup() or teardown() on a batch of FstabStorageAccess instances
+ * at once. The mount/umount helpers are spawned without blocking, so all
+ * of them run concurrently and the batch completes with the slowest
+ * share instead of the sum of the spawn-and-wait latencies. One
+ * aggregate finished() signal reports the devices that failed.
+ */
+class FstabStorageAccessBatch : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Operation { Setup, Teardown };
+
+    FstabStorageAccessBatch(const QList<FstabStorageAccess *> &accesses, Operation operation, QObject *parent = nullptr);
+
+    void start();
+
+Q_SIGNALS:
+    /**
+     * Emitted once, when the last device of the batch has reported back.
+     *
+     * @param errors the UDIs which failed, with the reported error
+     */
+    void finished(const QMap<QString, Solid::ErrorType> &errors);
+
+private Q_SLOTS:
+    void slotOperationDone(Solid::ErrorType error, QVariant errorData, const QString &udi);
+
+private:
+    void operationDone(const QString &udi, Solid::ErrorType error);
+
+    QList<FstabStorageAccess *> m_accesses;
+    Operation m_operation;
+    int m_remaining;
+    QSet<QString> m_done;
+    QMap<QString, Solid::ErrorType> m_errors;
+};
+
 }
 }
 }
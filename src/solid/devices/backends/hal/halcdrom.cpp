@@ -7,7 +7,7 @@
 #include "halcdrom.h"
 
 #include <QStringList>
-#include <QDBusInterface>
+#include <QDBusConnection>
 #include <QDBusReply>
 
 #include "halfstabhandling.h"
@@ -112,28 +112,64 @@ void Cdrom::slotEjectRequested()
 
 bool Cdrom::callHalDriveEject()
 {
-    QString udi = m_device->udi();
-    QString interface = "org.freedesktop.Hal.Device.Storage";
-
     // HACK: Eject doesn't work on cdrom drives when there's a mounted disc,
     // let's try to workaround this by calling a child volume...
     if (m_device->prop("storage.removable.media_available").toBool()) {
-        QDBusInterface manager("org.freedesktop.Hal",
-                               "/org/freedesktop/Hal/Manager",
-                               "org.freedesktop.Hal.Manager",
-                               QDBusConnection::systemBus());
-
-        QDBusReply<QStringList> reply = manager.call("FindDeviceStringMatch", "info.parent", udi);
-
-        if (reply.isValid()) {
-            const QStringList udis = reply;
-            if (!udis.isEmpty()) {
-                udi = udis[0];
-                interface = "org.freedesktop.Hal.Device.Volume";
-            }
+        // look up the child volume without blocking the caller; the Eject
+        // itself is dispatched from the reply slot
+        Q_EMIT ejectProgress(FindingVolumeStage, m_device->udi());
+
+        QDBusMessage msg = QDBusMessage::createMethodCall("org.freedesktop.Hal",
+                           "/org/freedesktop/Hal/Manager",
+                           "org.freedesktop.Hal.Manager",
+                           "FindDeviceStringMatch");
+        msg << QStringLiteral("info.parent") << m_device->udi();
+
+        if (QDBusConnection::systemBus().callWithCallback(msg, this,
+                SLOT(slotFindDeviceReply(QDBusMessage)),
+                SLOT(slotFindDeviceError(QDBusError)))) {
+            return true;
         }
+        // couldn't even send the lookup; fall through and try ejecting
+        // the drive itself
+    }
+
+    return callEject(m_device->udi(), QStringLiteral("org.freedesktop.Hal.Device.Storage"));
+}
+
+void Cdrom::slotFindDeviceReply(const QDBusMessage &reply)
+{
+    const QDBusReply<QStringList> udis(reply);
+
+    bool dispatched;
+    if (udis.isValid() && !udis.value().isEmpty()) {
+        dispatched = callEject(udis.value().first(), QStringLiteral("org.freedesktop.Hal.Device.Volume"));
+    } else {
+        dispatched = callEject(m_device->udi(), QStringLiteral("org.freedesktop.Hal.Device.Storage"));
     }
 
+    if (!dispatched) {
+        m_ejectInProgress = false;
+        m_device->broadcastActionDone("eject", Solid::OperationFailed,
+                                      QStringLiteral("Failed to send the Eject call"));
+    }
+}
+
+void Cdrom::slotFindDeviceError(const QDBusError &/*error*/)
+{
+    // proceed with ejecting the drive itself, just like the old blocking
+    // code which discarded a failed lookup
+    if (!callEject(m_device->udi(), QStringLiteral("org.freedesktop.Hal.Device.Storage"))) {
+        m_ejectInProgress = false;
+        m_device->broadcastActionDone("eject", Solid::OperationFailed,
+                                      QStringLiteral("Failed to send the Eject call"));
+    }
+}
+
+bool Cdrom::callEject(const QString &udi, const QString &interface)
+{
+    Q_EMIT ejectProgress(EjectingStage, m_device->udi());
+
     QDBusConnection c = QDBusConnection::systemBus();
     QDBusMessage msg = QDBusMessage::createMethodCall("org.freedesktop.Hal", udi,
                        interface, "Eject");
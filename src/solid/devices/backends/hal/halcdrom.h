@@ -26,6 +26,15 @@ class Cdrom : public Storage, virtual public Solid::Ifaces::OpticalDrive
     Q_INTERFACES(Solid::Ifaces::OpticalDrive)
 
 public:
+    /**
+     * Stages of the asynchronous eject pipeline, in the order they run.
+     */
+    enum EjectStage {
+        FindingVolumeStage, ///< looking up a mounted child volume of this drive
+        EjectingStage       ///< issuing the actual Eject call
+    };
+    Q_ENUM(EjectStage)
+
     Cdrom(HalDevice *device);
     virtual ~Cdrom();
 
@@ -39,9 +48,15 @@ Q_SIGNALS:
     void ejectPressed(const QString &udi) override;
     void ejectDone(Solid::ErrorType error, QVariant errorData, const QString &udi) override;
     void ejectRequested(const QString &udi);
+    /**
+     * Emitted when the asynchronous eject pipeline enters a new stage.
+     */
+    void ejectProgress(EjectStage stage, const QString &udi);
 
 private Q_SLOTS:
     void slotCondition(const QString &name, const QString &reason);
+    void slotFindDeviceReply(const QDBusMessage &reply);
+    void slotFindDeviceError(const QDBusError &error);
     void slotDBusReply(const QDBusMessage &reply);
     void slotDBusError(const QDBusError &error);
     void slotProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
@@ -50,6 +65,7 @@ private Q_SLOTS:
 
 private:
     bool callHalDriveEject();
+    bool callEject(const QString &udi, const QString &interface);
     bool callSystemEject();
 
     bool m_ejectInProgress;
@@ -28,49 +28,14 @@
 #include "halportablemediaplayer.h"
 #include "halbattery.h"
 
+#include "../shared/sizeformat.h"
+
 using namespace Solid::Backends::Hal;
 
-// Adapted from KLocale as Solid needs to be Qt-only
-static QString formatByteSize(double size)
-{
-    // Per IEC 60027-2
-
-    // Binary prefixes
-    //Tebi-byte             TiB             2^40    1,099,511,627,776 bytes
-    //Gibi-byte             GiB             2^30    1,073,741,824 bytes
-    //Mebi-byte             MiB             2^20    1,048,576 bytes
-    //Kibi-byte             KiB             2^10    1,024 bytes
-
-    QString s;
-    // Gibi-byte
-    if (size >= 1073741824.0) {
-        size /= 1073741824.0;
-        if (size > 1024) { // Tebi-byte
-            s = HalDevice::tr("%1 TiB").arg(QLocale().toString(size / 1024.0, 'f', 1));
-        } else {
-            s = HalDevice::tr("%1 GiB").arg(QLocale().toString(size, 'f', 1));
-        }
-    }
-    // Mebi-byte
-    else if (size >= 1048576.0) {
-        size /= 1048576.0;
-        s = HalDevice::tr("%1 MiB").arg(QLocale().toString(size, 'f', 1));
-    }
-    // Kibi-byte
-    else if (size >= 1024.0) {
-        size /= 1024.0;
-        s = HalDevice::tr("%1 KiB").arg(QLocale().toString(size, 'f', 1));
-    }
-    // Just byte
-    else if (size > 0) {
-        s = HalDevice::tr("%1 B").arg(QLocale().toString(size, 'f', 1));
-    }
-    // Nothing
-    else {
-        s = HalDevice::tr("0 B");
-    }
-    return s;
-}
+// The shared engine caches the localized unit templates and the
+// rendered strings, so repeated description refreshes don't re-run
+// locale-aware number formatting per device.
+using Solid::Backends::Shared::formatByteSize;
 
 class Solid::Backends::Hal::HalDevicePrivate
 {
@@ -82,6 +47,7 @@ public:
                  QDBusConnection::systemBus()),
         cacheSynced(false), parent(nullptr) { }
     void checkCache(const QString &key = QString());
+    bool refreshInvalidKeys();
 
     QDBusInterface device;
     QMap<QString, QVariant> cache;
@@ -319,13 +285,20 @@ QVariant HalDevice::prop(const QString &key) const
 void HalDevicePrivate::checkCache(const QString &key)
 {
     if (cacheSynced) {
-        if (key.isEmpty()) {
-            if (invalidKeys.isEmpty()) {
-                return;
-            }
-        } else if (!invalidKeys.contains(key)) {
+        if (invalidKeys.isEmpty()) {
+            return;
+        }
+        if (!key.isEmpty() && !invalidKeys.contains(key)) {
             return;
         }
+
+        // Only some keys went stale since the bulk fetch; refresh those
+        // individually instead of retransmitting the whole map.
+        if (refreshInvalidKeys()) {
+            return;
+        }
+        // A stale key couldn't be refreshed (e.g. it vanished between the
+        // signal and our call); resynchronize the whole map below.
     }
 
     QDBusReply<QVariantMap> reply = device.call("GetAllProperties");
@@ -343,6 +316,23 @@ void HalDevicePrivate::checkCache(const QString &key)
     //qDebug( )<< q << udi() << "failure";
 }
 
+bool HalDevicePrivate::refreshInvalidKeys()
+{
+    const QSet<QString> keys = invalidKeys;
+    for (const QString &key : keys) {
+        QDBusReply<QVariant> reply = device.call("GetProperty", key);
+
+        if (!reply.isValid()) {
+            return false;
+        }
+
+        cache[key] = reply;
+        invalidKeys.remove(key);
+    }
+
+    return true;
+}
+
 QMap<QString, QVariant> HalDevice::allProperties() const
 {
     d->checkCache();
@@ -456,17 +446,17 @@ void HalDevice::slotPropertyModified(int /*count */, const QList<ChangeDescripti
         }
 
         result[key] = type;
-        d->cache.remove(key);
 
-        if (d->cache.isEmpty()) {
-            d->cacheSynced = false;
-            d->invalidKeys.clear();
+        if (removed) {
+            // The cache stays an exact mirror of the daemon's map; a
+            // removed key needs no refetch, just dropping.
+            d->cache.remove(key);
+            d->invalidKeys.remove(key);
         } else {
             d->invalidKeys.insert(key);
         }
     }
 
-    //qDebug() << this << "unsyncing the cache";
     Q_EMIT propertyChanged(result);
 }
 
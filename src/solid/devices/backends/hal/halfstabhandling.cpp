@@ -6,6 +6,8 @@
 
 #include "halfstabhandling.h"
 
+#include "../fstab/fstabwatcher.h"
+
 #include <QFile>
 #include <QMultiHash>
 #include <QObject>
@@ -13,7 +15,6 @@
 #include <QRegularExpression>
 #include <QTextStream>
 #include <QWriteLocker>
-#include <QElapsedTimer>
 
 #include <soliddefs_p.h>
 #include <config-solid.h>
@@ -30,15 +31,32 @@
 #define FSTAB "/etc/fstab"
 #endif
 
+#ifdef Q_OS_LINUX
+#include <sys/mount.h>
+#include <unistd.h>
+#endif
+
 typedef QMultiHash<QString, QString> QStringMultiHash;
 
+// The filesystem type and option string of a device's fstab entry, kept
+// around for the direct mount(2) path.
+struct FstabMountArgs {
+    QString mountPoint;
+    QByteArray fstype;
+    QByteArray options;
+};
+
+// Parsed once and then served from the hash until the fstab watcher
+// reports an actual change to the file; every volume property dialog
+// used to trigger a time-based full re-parse here.
 class MountPointsCache
 {
 public:
     QReadWriteLock lock;
-    bool firstCall = true;
-    QElapsedTimer elapsedTime;
+    bool valid = false;
+    bool watcherConnected = false;
     QMultiHash<QString, QString> values;
+    QHash<QString, FstabMountArgs> mountArgs;
 };
 
 Q_GLOBAL_STATIC(MountPointsCache, globalMountPointsCache)
@@ -71,16 +89,25 @@ bool _k_isNetworkFileSystem(const QString &fstype, const QString &devName)
 void _k_updateMountPointsCache()
 {
     QWriteLocker locker(&globalMountPointsCache->lock);
-    if (globalMountPointsCache->firstCall) {
-        globalMountPointsCache->firstCall = false;
-        globalMountPointsCache->elapsedTime.start();
-    } else if (globalMountPointsCache->elapsedTime.elapsed() > 10000) {
-        globalMountPointsCache->elapsedTime.restart();
-    } else {
+
+    if (!globalMountPointsCache->watcherConnected) {
+        // The fstab backend is always built alongside this one, so its
+        // watcher can tell us when a re-parse is actually needed.
+        QObject::connect(Solid::Backends::Fstab::FstabWatcher::instance(),
+                         &Solid::Backends::Fstab::FstabWatcher::fstabChanged, []() {
+            QWriteLocker locker(&globalMountPointsCache->lock);
+            globalMountPointsCache->valid = false;
+        });
+        globalMountPointsCache->watcherConnected = true;
+    }
+
+    if (globalMountPointsCache->valid) {
         return;
     }
+    globalMountPointsCache->valid = true;
 
     globalMountPointsCache->values.clear();
+    globalMountPointsCache->mountArgs.clear();
 
 #if HAVE_SETMNTENT
 
@@ -96,6 +123,9 @@ void _k_updateMountPointsCache()
             const QString mountpoint = _k_resolveSymLink(QFile::decodeName(fe->mnt_dir));
 
             globalMountPointsCache->values.insert(device, mountpoint);
+            if (!globalMountPointsCache->mountArgs.contains(device)) {
+                globalMountPointsCache->mountArgs.insert(device, {mountpoint, QByteArray(fe->mnt_type), QByteArray(fe->mnt_opts)});
+            }
         }
     }
 
@@ -135,6 +165,9 @@ void _k_updateMountPointsCache()
             const QString mountpoint = _k_resolveSymLink(items.at(1));
 
             globalMountPointsCache->values.insert(device, mountpoint);
+            if (!globalMountPointsCache->mountArgs.contains(device)) {
+                globalMountPointsCache->mountArgs.insert(device, {mountpoint, items.at(2).toLatin1(), items.at(3).toLatin1()});
+            }
         }
     }
 
@@ -160,6 +193,131 @@ QStringList Solid::Backends::Hal::FstabHandling::possibleMountPoints(const QStri
     return globalMountPointsCache->values.values(deviceToFind);
 }
 
+#ifdef Q_OS_LINUX
+// Translates the fstab option string into mount(2) flags plus the data
+// string passed through to the filesystem. Options that only instruct
+// mount(8) itself (defaults, auto, user, nofail, ...) are dropped.
+static bool _k_parseMountOptions(const QByteArray &options, unsigned long *flags, QByteArray *data)
+{
+    static const struct {
+        const char *name;
+        unsigned long flag;
+    } flagOptions[] = {
+        { "ro", MS_RDONLY },
+        { "nosuid", MS_NOSUID },
+        { "nodev", MS_NODEV },
+        { "noexec", MS_NOEXEC },
+        { "sync", MS_SYNCHRONOUS },
+        { "noatime", MS_NOATIME },
+        { "nodiratime", MS_NODIRATIME },
+        { "relatime", MS_RELATIME },
+    };
+    static const char *const ignoredOptions[] = {
+        "defaults", "rw", "suid", "dev", "exec", "async", "atime", "diratime",
+        "auto", "noauto", "user", "nouser", "users", "owner", "group",
+        "nofail", "_netdev",
+    };
+
+    *flags = 0;
+    data->clear();
+
+    const QList<QByteArray> items = options.split(',');
+    for (const QByteArray &item : items) {
+        if (item.isEmpty() || item.startsWith("x-")) {
+            continue;
+        }
+
+        bool handled = false;
+        for (const auto &option : flagOptions) {
+            if (item == option.name) {
+                *flags |= option.flag;
+                handled = true;
+                break;
+            }
+        }
+        if (handled) {
+            continue;
+        }
+        for (const char *ignored : ignoredOptions) {
+            if (item == ignored) {
+                handled = true;
+                break;
+            }
+        }
+        if (handled) {
+            continue;
+        }
+
+        // everything else is filesystem-specific data (uid=, umask=, ...)
+        if (!data->isEmpty()) {
+            data->append(',');
+        }
+        data->append(item);
+    }
+
+    return true;
+}
+#endif
+
+bool Solid::Backends::Hal::FstabHandling::directMount(const QString &device)
+{
+#ifdef Q_OS_LINUX
+    if (::geteuid() != 0) {
+        // without mount privilege the setuid helper has to do the work
+        return false;
+    }
+
+    _k_updateMountPointsCache();
+    const QString deviceToFind = _k_resolveSymLink(device);
+
+    FstabMountArgs args;
+    {
+        QReadLocker lock(&globalMountPointsCache->lock);
+        const auto it = globalMountPointsCache->mountArgs.constFind(deviceToFind);
+        if (it == globalMountPointsCache->mountArgs.constEnd()) {
+            return false;
+        }
+        args = *it;
+    }
+
+    // "auto" and "none" need mount(8)'s filesystem probing
+    if (args.fstype.isEmpty() || args.fstype == "auto" || args.fstype == "none") {
+        return false;
+    }
+
+    unsigned long flags;
+    QByteArray data;
+    _k_parseMountOptions(args.options, &flags, &data);
+
+    return ::mount(QFile::encodeName(deviceToFind).constData(),
+                   QFile::encodeName(args.mountPoint).constData(),
+                   args.fstype.constData(), flags, data.constData()) == 0;
+#else
+    Q_UNUSED(device);
+    return false;
+#endif
+}
+
+bool Solid::Backends::Hal::FstabHandling::directUnmount(const QString &device)
+{
+#ifdef Q_OS_LINUX
+    if (::geteuid() != 0) {
+        return false;
+    }
+
+    const QStringList mountPoints = possibleMountPoints(device);
+    for (const QString &mountPoint : mountPoints) {
+        if (::umount(QFile::encodeName(mountPoint).constData()) == 0) {
+            return true;
+        }
+    }
+    return false;
+#else
+    Q_UNUSED(device);
+    return false;
+#endif
+}
+
 QProcess *Solid::Backends::Hal::FstabHandling::callSystemCommand(const QString &commandName,
         const QStringList &args,
         QObject *obj, const char *slot)
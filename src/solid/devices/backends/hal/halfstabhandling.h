@@ -23,6 +23,17 @@ class FstabHandling
 public:
     static bool isInFstab(const QString &device);
     static QStringList possibleMountPoints(const QString &device);
+
+    /**
+     * Attempts to mount or unmount the fstab entry of @p device directly
+     * through the kernel interface, skipping the fork/exec of the mount(8)
+     * helpers. This only succeeds when the process has the privilege to
+     * call mount(2)/umount(2) itself (embedded setups running as root);
+     * otherwise it returns false and the caller falls back to the helper
+     * binaries, which act as the privilege broker via their setuid bits.
+     */
+    static bool directMount(const QString &device);
+    static bool directUnmount(const QString &device);
     static QProcess *callSystemCommand(const QString &commandName,
                                        const QStringList &args,
                                        QObject *obj, const char *slot);
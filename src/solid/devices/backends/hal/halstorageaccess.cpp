@@ -456,6 +456,17 @@ bool StorageAccess::callHalVolumeEject()
 bool Solid::Backends::Hal::StorageAccess::callSystemMount()
 {
     const QString device = m_device->prop("block.device").toString();
+
+    if (FstabHandling::directMount(device)) {
+        // the syscall already completed; report it from the event loop like
+        // the process path does so callers see a consistent ordering
+        QTimer::singleShot(0, this, [this]() {
+            m_setupInProgress = false;
+            m_device->broadcastActionDone("setup");
+        });
+        return true;
+    }
+
     m_process = FstabHandling::callSystemCommand("mount", device,
                 this, SLOT(slotProcessFinished(int,QProcess::ExitStatus)));
 
@@ -465,6 +476,15 @@ bool Solid::Backends::Hal::StorageAccess::callSystemMount()
 bool Solid::Backends::Hal::StorageAccess::callSystemUnmount()
 {
     const QString device = m_device->prop("block.device").toString();
+
+    if (FstabHandling::directUnmount(device)) {
+        QTimer::singleShot(0, this, [this]() {
+            m_teardownInProgress = false;
+            m_device->broadcastActionDone("teardown");
+        });
+        return true;
+    }
+
     m_process = FstabHandling::callSystemCommand("umount", device,
                 this, SLOT(slotProcessFinished(int,QProcess::ExitStatus)));
 
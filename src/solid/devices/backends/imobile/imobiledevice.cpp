@@ -8,6 +8,9 @@
 #include "imobiledevice.h"
 
 #include <QCoreApplication>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
 #include <QScopeGuard>
 
 #include "imobile_debug.h"
@@ -20,17 +23,35 @@
 
 using namespace Solid::Backends::IMobile;
 
-IMobileDevice::IMobileDevice(const QString &udi)
-    : Solid::Ifaces::Device()
-    , m_udi(udi)
+namespace
 {
-    const QString deviceId = udi.mid(udiPrefix().length() + 1);
+
+struct DeviceInfo {
+    QString name;
+    QString deviceClass;
+};
+
+// Info obtained through the lockdownd handshake, shared between all
+// device instances for the same physical device. The handshake takes
+// hundreds of milliseconds per device, so it runs at most once per
+// attachment: the manager warms this cache from a worker thread on
+// attach and drops the entry again on removal or pairing changes.
+struct DeviceInfoCache {
+    QMutex mutex;
+    QHash<QString, DeviceInfo> entries;
+};
+
+Q_GLOBAL_STATIC(DeviceInfoCache, globalDeviceInfoCache)
+
+DeviceInfo fetchDeviceInfo(const QString &deviceId)
+{
+    DeviceInfo info;
 
     idevice_t device;
     idevice_new(&device, deviceId.toUtf8().constData());
     if (!device) {
         qCWarning(IMOBILE) << "Failed to create device instance for" << deviceId;
-        return;
+        return info;
     }
 
     auto deviceCleanup = qScopeGuard([device] {
@@ -41,7 +62,7 @@ IMobileDevice::IMobileDevice(const QString &udi)
     auto ret = lockdownd_client_new(device, &lockdowndClient, "kde_solid_imobile");
     if (ret != LOCKDOWN_E_SUCCESS || !lockdowndClient) {
         qCWarning(IMOBILE) << "Failed to create lockdownd client for" << deviceId;
-        return;
+        return info;
     }
 
     auto lockdowndClientCleanup = qScopeGuard([lockdowndClient] {
@@ -53,7 +74,7 @@ IMobileDevice::IMobileDevice(const QString &udi)
     if (lockdownRet != LOCKDOWN_E_SUCCESS) {
         qCWarning(IMOBILE) << "Failed to get device name for" << deviceId << lockdownRet;
     } else if (name) {
-        m_name = QString::fromUtf8(name);
+        info.name = QString::fromUtf8(name);
         free(name);
     }
 
@@ -65,10 +86,77 @@ IMobileDevice::IMobileDevice(const QString &udi)
         char *deviceClass = nullptr;
         plist_get_string_val(deviceClassEntry, &deviceClass);
         if (deviceClass) {
-            m_deviceClass = QString::fromUtf8(deviceClass);
+            info.deviceClass = QString::fromUtf8(deviceClass);
             free(deviceClass);
         }
     }
+
+    return info;
+}
+
+QString deviceIdFromUdi(const QString &udi)
+{
+    return udi.mid(udiPrefix().length() + 1);
+}
+
+} // namespace
+
+IMobileDevice::IMobileDevice(const QString &udi)
+    : Solid::Ifaces::Device()
+    , m_udi(udi)
+    , m_deviceId(deviceIdFromUdi(udi))
+{
+    // no handshake here: interface queries don't need device info, and
+    // name/class are fetched lazily via ensureDeviceInfo()
+}
+
+void IMobileDevice::ensureDeviceInfo() const
+{
+    if (m_infoFetched) {
+        return;
+    }
+    m_infoFetched = true;
+
+    {
+        QMutexLocker locker(&globalDeviceInfoCache->mutex);
+        const auto it = globalDeviceInfoCache->entries.constFind(m_deviceId);
+        if (it != globalDeviceInfoCache->entries.constEnd()) {
+            m_name = it->name;
+            m_deviceClass = it->deviceClass;
+            return;
+        }
+    }
+
+    // cache miss, e.g. the warm-up on attach hasn't finished yet
+    const DeviceInfo info = fetchDeviceInfo(m_deviceId);
+    m_name = info.name;
+    m_deviceClass = info.deviceClass;
+
+    QMutexLocker locker(&globalDeviceInfoCache->mutex);
+    globalDeviceInfoCache->entries.insert(m_deviceId, info);
+}
+
+void IMobileDevice::prefetchDeviceInfo(const QString &udi)
+{
+    const QString deviceId = deviceIdFromUdi(udi);
+
+    {
+        QMutexLocker locker(&globalDeviceInfoCache->mutex);
+        if (globalDeviceInfoCache->entries.contains(deviceId)) {
+            return;
+        }
+    }
+
+    const DeviceInfo info = fetchDeviceInfo(deviceId);
+
+    QMutexLocker locker(&globalDeviceInfoCache->mutex);
+    globalDeviceInfoCache->entries.insert(deviceId, info);
+}
+
+void IMobileDevice::dropDeviceInfo(const QString &udi)
+{
+    QMutexLocker locker(&globalDeviceInfoCache->mutex);
+    globalDeviceInfoCache->entries.remove(deviceIdFromUdi(udi));
 }
 
 IMobileDevice::~IMobileDevice()
@@ -97,11 +185,13 @@ QString IMobileDevice::product() const
     // but accessing device type requires doing a handshake with the device,
     // which will fail if locked or not paired, and also would require us
     // to maintain a giant mapping table
+    ensureDeviceInfo();
     return m_deviceClass;
 }
 
 QString IMobileDevice::icon() const
 {
+    ensureDeviceInfo();
     if (m_deviceClass.contains(QLatin1String("iPod"))) {
         return QStringLiteral("multimedia-player-apple-ipod-touch");
     } else if (m_deviceClass.contains(QLatin1String("iPad"))) {
@@ -118,6 +208,7 @@ QStringList IMobileDevice::emblems() const
 
 QString IMobileDevice::description() const
 {
+    ensureDeviceInfo();
     return m_name;
 }
 
@@ -39,11 +39,29 @@ public:
 
     QObject *createDeviceInterface(const Solid::DeviceInterface::Type &type) override;
 
+    /**
+     * Performs the lockdownd handshake for @p udi and stores the result
+     * in the shared device info cache, so later device constructions
+     * don't have to talk to the device. Safe to call from a worker
+     * thread; the manager uses it to warm the cache on attach.
+     */
+    static void prefetchDeviceInfo(const QString &udi);
+
+    /**
+     * Drops the cached info for @p udi, e.g. when the device is
+     * unplugged or its pairing state changed.
+     */
+    static void dropDeviceInfo(const QString &udi);
+
 private:
+    void ensureDeviceInfo() const;
+
     QString m_udi;
+    QString m_deviceId;
 
-    QString m_name;
-    QString m_deviceClass;
+    mutable bool m_infoFetched = false;
+    mutable QString m_name;
+    mutable QString m_deviceClass;
 
 };
 
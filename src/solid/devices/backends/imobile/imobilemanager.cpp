@@ -7,6 +7,9 @@
 
 #include "imobilemanager.h"
 
+#include <QRunnable>
+#include <QThreadPool>
+
 #include "imobile_debug.h"
 
 #include "../shared/rootdevice.h"
@@ -17,6 +20,31 @@
 using namespace Solid::Backends::IMobile;
 using namespace Solid::Backends::Shared;
 
+namespace
+{
+
+// performs the lockdownd handshake off the backend thread, so an attach
+// doesn't stall enumeration while the device (or the user unlocking it)
+// takes its time
+class DeviceInfoPrefetcher : public QRunnable
+{
+public:
+    explicit DeviceInfoPrefetcher(const QString &udi)
+        : m_udi(udi)
+    {
+    }
+
+    void run() override
+    {
+        IMobileDevice::prefetchDeviceInfo(m_udi);
+    }
+
+private:
+    QString m_udi;
+};
+
+} // namespace
+
 Manager::Manager(QObject *parent)
     : Solid::Ifaces::DeviceManager(parent)
 {
@@ -39,7 +67,9 @@ Manager::Manager(QObject *parent)
     m_deviceUdis.reserve(count);
 
     for (int i = 0; i < count; ++i) {
-        m_deviceUdis.append(udiPrefix() + QLatin1Char('/') + QString::fromLatin1(devices[i]));
+        const QString udi = udiPrefix() + QLatin1Char('/') + QString::fromLatin1(devices[i]);
+        m_deviceUdis.append(udi);
+        QThreadPool::globalInstance()->start(new DeviceInfoPrefetcher(udi));
     }
 
     if (devices) {
@@ -116,16 +146,21 @@ void Manager::onDeviceEvent(const idevice_event_t *event)
     case IDEVICE_DEVICE_ADD:
         if (!m_deviceUdis.contains(udi)) {
             m_deviceUdis.append(udi);
+            QThreadPool::globalInstance()->start(new DeviceInfoPrefetcher(udi));
             Q_EMIT deviceAdded(udi);
         }
         return;
     case IDEVICE_DEVICE_REMOVE:
+        IMobileDevice::dropDeviceInfo(udi);
         if (m_deviceUdis.removeOne(udi)) {
             Q_EMIT deviceRemoved(udi);
         }
         return;
 #if IMOBILEDEVICE_API >= QT_VERSION_CHECK(1, 3, 0)
     case IDEVICE_DEVICE_PAIRED:
+        // pairing may make the name and class readable now; refresh
+        IMobileDevice::dropDeviceInfo(udi);
+        QThreadPool::globalInstance()->start(new DeviceInfoPrefetcher(udi));
         return;
 #endif
     }
@@ -16,12 +16,16 @@
 #include "iokitopticaldisc.h"
 
 #include <QDebug>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
 #include <QSet>
 #include <QUrl>
 
 #include <sys/types.h>
 #include <sys/sysctl.h>
 
+#include <IOKit/IOMessage.h>
 #include <IOKit/usb/IOUSBLib.h>
 #include <IOKit/network/IOEthernetInterface.h>
 
@@ -105,6 +109,111 @@ static QMap<QString, QVariant> getProperties(const io_registry_entry_t &entry)
     return result;
 }
 
+/* Process-wide cache of the converted property dictionaries, keyed by
+ * registry path. Converting the CFDictionary to a QVariantMap is by far
+ * the most expensive part of constructing an IOKitDevice, and consumers
+ * which enumerate periodically construct fresh device objects for the
+ * same services every cycle.
+ *
+ * Each cached service carries a kIOGeneralInterest notification, so a
+ * registry-side change drops the stale copy and the next construction
+ * reconverts; a terminated service additionally releases its watch. The
+ * notification port is scheduled on the run loop of the thread that
+ * first populates the cache, same as IOKitManager does for hotplug.
+ */
+class PropertyCache
+{
+public:
+    PropertyCache()
+        : m_port(IONotificationPortCreate(kIOMasterPortDefault))
+    {
+        if (m_port) {
+            CFRunLoopAddSource(CFRunLoopGetCurrent(),
+                               IONotificationPortGetRunLoopSource(m_port),
+                               kCFRunLoopDefaultMode);
+        }
+    }
+
+    ~PropertyCache()
+    {
+        for (auto it = m_watches.constBegin(); it != m_watches.constEnd(); ++it) {
+            IOObjectRelease(it.value()->notification);
+            delete it.value();
+        }
+        if (m_port) {
+            IONotificationPortDestroy(m_port);
+        }
+    }
+
+    bool lookup(const QString &udi, QMap<QString, QVariant> *properties)
+    {
+        QMutexLocker locker(&m_mutex);
+        const auto it = m_properties.constFind(udi);
+        if (it == m_properties.constEnd()) {
+            return false;
+        }
+        *properties = it.value();
+        return true;
+    }
+
+    void insert(const QString &udi, const io_registry_entry_t &entry,
+                const QMap<QString, QVariant> &properties)
+    {
+        // an empty map means the conversion failed; without a port there
+        // is no invalidation, so serving a copy could go stale forever
+        if (!m_port || properties.isEmpty()) {
+            return;
+        }
+
+        QMutexLocker locker(&m_mutex);
+
+        if (!m_watches.contains(udi)) {
+            Watch *watch = new Watch{this, udi, MACH_PORT_NULL};
+            kern_return_t ret = IOServiceAddInterestNotification(
+                                    m_port, entry, kIOGeneralInterest,
+                                    &PropertyCache::serviceChanged, watch,
+                                    &watch->notification);
+            if (ret != KERN_SUCCESS) {
+                delete watch;
+                return;
+            }
+            m_watches.insert(udi, watch);
+        }
+
+        m_properties.insert(udi, properties);
+    }
+
+private:
+    struct Watch {
+        PropertyCache *cache;
+        QString udi;
+        io_object_t notification;
+    };
+
+    static void serviceChanged(void *refCon, io_service_t /*service*/,
+                               natural_t messageType, void * /*messageArgument*/)
+    {
+        Watch *watch = static_cast<Watch *>(refCon);
+        PropertyCache *cache = watch->cache;
+
+        QMutexLocker locker(&cache->m_mutex);
+        cache->m_properties.remove(watch->udi);
+
+        if (messageType == kIOMessageServiceIsTerminated) {
+            cache->m_watches.remove(watch->udi);
+            IOObjectRelease(watch->notification);
+            delete watch;
+        }
+    }
+
+    QMutex m_mutex;
+    IONotificationPortRef m_port;
+    QHash<QString, QMap<QString, QVariant> > m_properties;
+    QHash<QString, Watch *> m_watches;
+};
+
+Q_GLOBAL_STATIC(PropertyCache, globalPropertyCache)
+
 // gets the parent's Udi from an entry
 static QString getParentDeviceUdi(const io_registry_entry_t &entry)
 {
@@ -168,7 +277,10 @@ void IOKitDevicePrivate::init(const QString &udiString, const io_registry_entry_
 
     udi = udiString;
 
-    properties = getProperties(entry);
+    if (!globalPropertyCache->lookup(udi, &properties)) {
+        properties = getProperties(entry);
+        globalPropertyCache->insert(udi, entry, properties);
+    }
 
     parentUdi = getParentDeviceUdi(entry);
     type = typesFromEntry(entry, properties, mainType);
@@ -7,6 +7,7 @@
 #include "iokitmanager.h"
 #include "iokitdevice.h"
 
+#include <QHash>
 #include <qdebug.h>
 
 #include <IOKit/IOKitLib.h>
@@ -35,7 +36,15 @@ public:
     static const char *typeToName(Solid::DeviceInterface::Type type);
     static QStringList devicesFromRegistry(io_iterator_t it);
 
+    const QHash<Solid::DeviceInterface::Type, QStringList> &servicesByType();
+
     QSet<Solid::DeviceInterface::Type> supportedInterfaces;
+
+    // Services classified per Solid type by a single registry traversal,
+    // valid for one registry generation; see servicesByType().
+    QHash<Solid::DeviceInterface::Type, QStringList> typedServices;
+    UInt32 typedServicesGeneration = 0;
+    bool typedServicesValid = false;
 };
 
 // gets all registry paths from an iterator
@@ -89,6 +98,76 @@ const char *IOKitManagerPrivate::typeToName(Solid::DeviceInterface::Type type)
     return 0;
 }
 
+// Classifies every service into the supported Solid types with one
+// recursive registry traversal, instead of one matching-services pass
+// per device class. The result is reused as long as the registry
+// generation count doesn't change, so repeated polls of an unchanged
+// registry don't traverse at all.
+const QHash<Solid::DeviceInterface::Type, QStringList> &IOKitManagerPrivate::servicesByType()
+{
+    const UInt32 generation = IORegistryGetGenerationCount(kIOMasterPortDefault);
+    if (typedServicesValid && generation == typedServicesGeneration) {
+        return typedServices;
+    }
+
+    typedServices.clear();
+    typedServicesGeneration = generation;
+    typedServicesValid = true;
+
+    io_iterator_t it;
+    kern_return_t ret = IORegistryCreateIterator(
+                            kIOMasterPortDefault,
+                            kIOServicePlane,
+                            kIORegistryIterateRecursively,
+                            &it);
+    if (ret != KERN_SUCCESS) {
+        qWarning() << Q_FUNC_INFO << "unable to create iterator";
+        typedServicesValid = false;
+        return typedServices;
+    }
+
+    // the inverse of typeToName(); an IOCDMedia conforms to IOMedia too,
+    // so optical media land in the storage buckets as well, exactly as
+    // the separate matching passes used to report them
+    static const struct {
+        const char *className;
+        std::initializer_list<Solid::DeviceInterface::Type> types;
+    } classMappings[] = {
+        {"AppleACPICPU", {Solid::DeviceInterface::Processor}},
+        {"AppleSmartBattery", {Solid::DeviceInterface::Battery}},
+        {"IOMedia", {Solid::DeviceInterface::StorageAccess,
+                     Solid::DeviceInterface::StorageDrive,
+                     Solid::DeviceInterface::StorageVolume}},
+        {"IOCDMedia", {Solid::DeviceInterface::OpticalDrive,
+                       Solid::DeviceInterface::OpticalDisc}},
+    };
+
+    io_object_t obj;
+    io_string_t pathName;
+    while ((obj = IOIteratorNext(it))) {
+        QString path;
+        for (const auto &mapping : classMappings) {
+            if (!IOObjectConformsTo(obj, mapping.className)) {
+                continue;
+            }
+            if (path.isNull()) {
+                if (IORegistryEntryGetPath(obj, kIOServicePlane, pathName) != KERN_SUCCESS) {
+                    qWarning() << Q_FUNC_INFO << "IORegistryEntryGetPath failed";
+                    break;
+                }
+                path = QString::fromUtf8(pathName);
+            }
+            for (Solid::DeviceInterface::Type type : mapping.types) {
+                typedServices[type] += path;
+            }
+        }
+        IOObjectRelease(obj);
+    }
+    IOObjectRelease(it);
+
+    return typedServices;
+}
+
 IOKitManager::IOKitManager(QObject *parent)
     : Solid::Ifaces::DeviceManager(parent), d(new IOKitManagerPrivate)
 {
@@ -168,26 +247,11 @@ QStringList IOKitManager::devicesFromQuery(const QString &parentUdi,
         // match all device interfaces
         result = allDevices();
     } else {
-        const char *deviceClassName = IOKitManagerPrivate::typeToName(type);
-        if (!deviceClassName) {
-            return QStringList();
-        }
-
-        CFMutableDictionaryRef matchingDict = IOServiceMatching(deviceClassName);
-
-        if (!matchingDict) {
+        if (!IOKitManagerPrivate::typeToName(type)) {
             return QStringList();
         }
 
-        io_iterator_t it = 0;
-
-        // note - IOServiceGetMatchingServices dereferences the dict
-        kern_return_t ret = IOServiceGetMatchingServices(
-                                kIOMasterPortDefault,
-                                matchingDict,
-                                &it);
-
-        result = IOKitManagerPrivate::devicesFromRegistry(it);
+        result = d->servicesByType().value(type);
     }
 
     // if the parentUdi is an empty string, return all matches
@@ -26,9 +26,8 @@ using namespace Solid::Backends::IOKit;
 class IOKitOpticalDrive::Private
 {
 public:
-    Private(const IOKitDevice *device, const QVariantMap &devCharMap)
+    Private(const IOKitDevice *device)
         : m_device(device)
-        , m_deviceCharacteristics(devCharMap)
     {
     }
     virtual ~Private()
@@ -37,11 +36,37 @@ public:
 
     QVariant property(const QString &key) const
     {
-        return m_deviceCharacteristics.value(key);
+        return deviceCharacteristics().value(key);
+    }
+
+    // The "Device Characteristics" dictionary holds the drive's SCSI
+    // inquiry data; walking up to the grandparent and reading it can make
+    // an idle external drive spin up, so it's fetched on the first
+    // capability query rather than on device instantiation, and kept for
+    // the lifetime of the drive object.
+    const QVariantMap &deviceCharacteristics() const
+    {
+        if (!m_characteristicsFetched) {
+            m_characteristicsFetched = true;
+
+            // walk up the IOKit chain to find the parent that has the "Device Characteristics" property
+            // In the examples I've seen this is always the 2nd parent but if ever that turns out
+            // to be non-guaranteed we'll need to do a true walk.
+            IOKitDevice ioDVDServices(IOKitDevice(m_device->parentUdi()).parentUdi());
+            if (!ioDVDServices.iOKitPropertyExists(QStringLiteral("Device Characteristics"))) {
+                qWarning() << Q_FUNC_INFO << "Grandparent of" << m_device->udi()
+                    << "doesn't have the \"Device Characteristics\" but is" << ioDVDServices.udi();
+            } else {
+                const QVariant devCharVar = ioDVDServices.property(QStringLiteral("Device Characteristics"));
+                m_deviceCharacteristics = devCharVar.toMap();
+            }
+        }
+        return m_deviceCharacteristics;
     }
 
     const IOKitDevice *m_device;
-    const QVariantMap m_deviceCharacteristics;
+    mutable QVariantMap m_deviceCharacteristics;
+    mutable bool m_characteristicsFetched = false;
 
     static const QMap<Solid::OpticalDrive::MediumType, uint32_t> cdTypeMap;
     static const QMap<Solid::OpticalDrive::MediumType, uint32_t> dvdTypeMap;
@@ -182,19 +207,9 @@ const QMap<Solid::OpticalDrive::MediumType, uint32_t> IOKitOpticalDrive::Private
 IOKitOpticalDrive::IOKitOpticalDrive(IOKitDevice *device)
     : IOKitStorage(device)
 {
-    // walk up the IOKit chain to find the parent that has the "Device Characteristics" property
-    // In the examples I've seen this is always the 2nd parent but if ever that turns out
-    // to be non-guaranteed we'll need to do a true walk.
-    IOKitDevice ioDVDServices(IOKitDevice(device->parentUdi()).parentUdi());
-    QVariantMap devCharMap;
-    if (!ioDVDServices.iOKitPropertyExists(QStringLiteral("Device Characteristics"))) {
-        qWarning() << Q_FUNC_INFO << "Grandparent of" << m_device->udi()
-            << "doesn't have the \"Device Characteristics\" but is" << ioDVDServices.udi();
-    } else {
-        const QVariant devCharVar = ioDVDServices.property(QStringLiteral("Device Characteristics"));
-        devCharMap = devCharVar.toMap();
-    }
-    d = new Private(device, devCharMap);
+    // capability probing is deferred until supportedMedia() is actually
+    // read; see Private::deviceCharacteristics()
+    d = new Private(device);
 }
 
 IOKitOpticalDrive::~IOKitOpticalDrive()
@@ -78,7 +78,7 @@ static void sigill_handler(int sig)
 }
 #endif
 
-Solid::Processor::InstructionSets cpuFeatures()
+static Solid::Processor::InstructionSets probeCpuFeatures()
 {
     volatile unsigned int features = 0;
 
@@ -220,6 +220,15 @@ Solid::Processor::InstructionSets cpuFeatures()
     return featureflags;
 }
 
+Solid::Processor::InstructionSets cpuFeatures()
+{
+    // The instruction set of a running system doesn't change, and the
+    // probe involves signal handler games; run it once per process no
+    // matter how many processor devices ask.
+    static const Solid::Processor::InstructionSets s_features = probeCpuFeatures();
+    return s_features;
+}
+
 }
 }
 }
@@ -0,0 +1,115 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include "sizeformat.h"
+
+#include <QCoreApplication>
+#include <QHash>
+#include <QLocale>
+#include <QMutex>
+#include <QMutexLocker>
+
+namespace
+{
+struct SizeFormatCache {
+    QMutex mutex;
+    // The locale the cached state was built for; templates and rendered
+    // strings are re-resolved when it changes.
+    QString localeName;
+    QString tib, gib, mib, kib, b, zero;
+    QHash<quint64, QString> rendered;
+};
+}
+
+Q_GLOBAL_STATIC(SizeFormatCache, s_sizeFormatCache)
+
+// Keep the memoized strings bounded; past this the cache stops growing
+// and formatting falls back to rendering (still with cached templates).
+static const int s_renderedCacheLimit = 1024;
+
+static QString renderByteSize(const SizeFormatCache *cache, const QLocale &locale, double size)
+{
+    // Per IEC 60027-2
+
+    // Binary prefixes
+    //Tebi-byte             TiB             2^40    1,099,511,627,776 bytes
+    //Gibi-byte             GiB             2^30    1,073,741,824 bytes
+    //Mebi-byte             MiB             2^20    1,048,576 bytes
+    //Kibi-byte             KiB             2^10    1,024 bytes
+
+    QString s;
+    // Gibi-byte
+    if (size >= 1073741824.0) {
+        size /= 1073741824.0;
+        if (size > 1024) { // Tebi-byte
+            s = cache->tib.arg(locale.toString(size / 1024.0, 'f', 1));
+        } else {
+            s = cache->gib.arg(locale.toString(size, 'f', 1));
+        }
+    }
+    // Mebi-byte
+    else if (size >= 1048576.0) {
+        size /= 1048576.0;
+        s = cache->mib.arg(locale.toString(size, 'f', 1));
+    }
+    // Kibi-byte
+    else if (size >= 1024.0) {
+        size /= 1024.0;
+        s = cache->kib.arg(locale.toString(size, 'f', 1));
+    }
+    // Just byte
+    else if (size > 0) {
+        s = cache->b.arg(locale.toString(size, 'f', 1));
+    }
+    // Nothing
+    else {
+        s = cache->zero;
+    }
+    return s;
+}
+
+QString Solid::Backends::Shared::formatByteSize(double size)
+{
+    SizeFormatCache *cache = s_sizeFormatCache();
+    QMutexLocker locker(&cache->mutex);
+
+    const QLocale locale;
+    if (cache->localeName != locale.name()) {
+        cache->localeName = locale.name();
+        cache->tib = QCoreApplication::translate("sizeformat", "%1 TiB");
+        cache->gib = QCoreApplication::translate("sizeformat", "%1 GiB");
+        cache->mib = QCoreApplication::translate("sizeformat", "%1 MiB");
+        cache->kib = QCoreApplication::translate("sizeformat", "%1 KiB");
+        cache->b = QCoreApplication::translate("sizeformat", "%1 B");
+        cache->zero = QCoreApplication::translate("sizeformat", "0 B");
+        cache->rendered.clear();
+        // Pre-render the power-of-two sizes (1 KiB through 8 TiB)
+        // actual hardware overwhelmingly reports, so the first device
+        // list built after a hotplug burst already hits the cache.
+        for (int shift = 10; shift <= 43; ++shift) {
+            const quint64 bytes = quint64(1) << shift;
+            cache->rendered.insert(bytes, renderByteSize(cache, locale, double(bytes)));
+        }
+    }
+
+    // Backends report sizes as integral byte counts, which makes them
+    // usable as cache keys; fractional inputs are just rendered.
+    const quint64 key = size >= 0 ? quint64(size) : 0;
+    const bool cacheable = size >= 0 && double(key) == size;
+    if (cacheable) {
+        const auto it = cache->rendered.constFind(key);
+        if (it != cache->rendered.constEnd()) {
+            return it.value();
+        }
+    }
+
+    const QString s = renderByteSize(cache, locale, size);
+
+    if (cacheable && cache->rendered.size() < s_renderedCacheLimit) {
+        cache->rendered.insert(key, s);
+    }
+    return s;
+}
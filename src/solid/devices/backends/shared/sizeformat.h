@@ -0,0 +1,36 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#ifndef SOLID_BACKENDS_SHARED_SIZEFORMAT_H
+#define SOLID_BACKENDS_SHARED_SIZEFORMAT_H
+
+#include <QString>
+
+namespace Solid
+{
+namespace Backends
+{
+namespace Shared
+{
+
+/**
+ * Locale-aware IEC (binary prefix) byte-size formatting for the
+ * backends' description builders; adapted from KLocale as Solid needs
+ * to be Qt-only.
+ *
+ * The localized unit templates are resolved once per locale, and the
+ * rendered strings are memoized per byte count: a host full of
+ * identical drives and volumes formats the same handful of values over
+ * and over, and locale-aware number formatting is not cheap. The cache
+ * is dropped when the application locale changes.
+ */
+QString formatByteSize(double size);
+
+}
+}
+}
+
+#endif
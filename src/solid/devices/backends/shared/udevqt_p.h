@@ -13,12 +13,41 @@ extern "C"
 #include <libudev.h>
 }
 
-class QByteArray;
-class QSocketNotifier;
+#include <QAtomicInteger>
+#include <QByteArray>
+#include <QHash>
+#include <QReadWriteLock>
+#include <QThread>
+#include <QVariant>
 
 namespace UdevQt
 {
 
+/* Process-wide sysfs attribute cache. libudev caches sysattr values inside
+ * each udev_device forever, so long-lived device handles can return stale
+ * data. This cache keys values by syspath and a generation counter which the
+ * monitor bumps on "change" uevents: repeat reads of the same attribute are
+ * served from the cache, and a bumped generation forces a re-read through a
+ * fresh device handle. */
+class SysfsAttributeCache
+{
+public:
+    QVariant value(struct udev_device *device, const QByteArray &name);
+    void invalidate(const char *syspath);
+
+private:
+    struct Entry {
+        quint64 generation = 0;
+        QHash<QByteArray, QVariant> values;
+    };
+
+    QReadWriteLock m_lock;
+    QHash<QString, quint64> m_generations;
+    QHash<QString, Entry> m_entries;
+};
+
+SysfsAttributeCache *sysfsAttributeCache();
+
 class DevicePrivate
 {
 public:
@@ -29,6 +58,128 @@ public:
     QString decodePropertyValue(const QByteArray &encoded) const;
 
     struct udev_device *udev;
+
+    /* udev properties are immutable for the lifetime of a device handle
+     * (a change event delivers a new handle), so the converted values are
+     * memoized here; description building reads the same properties many
+     * times over. Negative lookups are cached as invalid entries. */
+    mutable QHash<QByteArray, QVariant> propertyCache;
+    mutable QHash<QByteArray, QString> decodedPropertyCache;
+};
+
+/* Bounded single-producer/single-consumer ring buffer carrying uevents from
+ * the monitor thread to the main thread. Producer and consumer synchronize
+ * only through the two atomic indices, so a coldplug storm never makes the
+ * reader block the writer or vice versa. */
+class MonitorEventQueue
+{
+public:
+    struct Event {
+        QByteArray action;
+        struct udev_device *device = nullptr;
+    };
+
+    MonitorEventQueue() : m_head(0), m_tail(0) {}
+
+    /* producer side (monitor thread) */
+    bool enqueue(const QByteArray &action, struct udev_device *device)
+    {
+        const int tail = m_tail.loadRelaxed();
+        const int next = (tail + 1) % Capacity;
+        if (next == m_head.loadAcquire()) {
+            return false; // full, caller has to drop the event
+        }
+        m_events[tail].action = action;
+        m_events[tail].device = device;
+        m_tail.storeRelease(next);
+        return true;
+    }
+
+    /* consumer side (main thread) */
+    bool dequeue(Event *event)
+    {
+        const int head = m_head.loadRelaxed();
+        if (head == m_tail.loadAcquire()) {
+            return false;
+        }
+        *event = m_events[head];
+        m_events[head] = Event();
+        m_head.storeRelease((head + 1) % Capacity);
+        return true;
+    }
+
+private:
+    enum { Capacity = 4096 };
+    Event m_events[Capacity];
+    QAtomicInteger<int> m_head;
+    QAtomicInteger<int> m_tail;
+};
+
+class ClientPrivate;
+class SharedUdevMonitor;
+
+/* Reads uevents off the netlink socket on its own thread so a storm of
+ * events (boot-time coldplug replay) never stalls the main loop; each socket
+ * wakeup drains the socket completely and wakes each subscriber once. */
+class MonitorThread : public QThread
+{
+public:
+    MonitorThread(SharedUdevMonitor *owner, struct udev_monitor *monitor);
+    ~MonitorThread() override;
+
+    void stop();
+
+protected:
+    void run() override;
+
+private:
+    SharedUdevMonitor *m_owner;
+    struct udev_monitor *m_monitor;
+    int m_wakePipe[2];
+};
+
+/* Process-wide udev context and netlink monitor socket.
+ *
+ * Solid creates one Client per device-manager thread, and applications
+ * using UdevQt directly add more, each formerly with its own netlink
+ * socket receiving and decoding the identical uevent traffic. This object
+ * owns the single socket and its reader thread: the kernel-side filter is
+ * the union of every subscriber's subsystem list, and each decoded event
+ * is handed only to the subscribers whose filters match, through their
+ * own queues and on their own threads. The udev context is shared too, so
+ * libudev's internal caches (hwdb and friends) exist once per process. */
+class SharedUdevMonitor
+{
+public:
+    SharedUdevMonitor();
+    ~SharedUdevMonitor();
+
+    static SharedUdevMonitor *instance();
+
+    struct udev *context() const
+    {
+        return m_udev;
+    }
+
+    /* (Re-)registers @p client for the given subsystem list; an empty
+     * list subscribes to everything. */
+    void subscribe(ClientPrivate *client, const QStringList &subsystemList);
+    void unsubscribe(ClientPrivate *client);
+
+    /* Called from the monitor thread; consumes the device reference. */
+    void dispatch(const QByteArray &action, struct udev_device *device);
+
+private:
+    void rebuildFiltersLocked();
+
+    struct udev *m_udev;
+    struct udev_monitor *m_monitor = nullptr;
+    MonitorThread *m_thread = nullptr;
+
+    /* Subscribers come and go from their own threads while the monitor
+     * thread dispatches. */
+    QReadWriteLock m_lock;
+    QHash<ClientPrivate *, QStringList> m_subscribers;
 };
 
 class Client;
@@ -42,13 +193,17 @@ public:
 
     void init(const QStringList &subsystemList, ListenToWhat what);
     void setWatchedSubsystems(const QStringList &subsystemList);
-    void _uq_monitorReadyRead(int fd);
-    DeviceList deviceListFromEnumerate(struct udev_enumerate *en);
+    void scheduleEventProcessing();
+    void _uq_processQueuedEvents();
+    void handleMonitorEvent(const QByteArray &action, struct udev_device *dev);
+    DeviceList deviceListFromEnumerate(struct udev_enumerate *en,
+                                       const QStringList &prefetchSysfsAttributes = QStringList());
 
     struct udev *udev;
-    struct udev_monitor *monitor;
     Client *q;
-    QSocketNotifier *monitorNotifier;
+    bool listening;
+    MonitorEventQueue eventQueue;
+    QAtomicInteger<int> processingScheduled;
     QStringList watchedSubsystems;
 };
 
@@ -7,95 +7,290 @@
 #include "udevqtclient.h"
 #include "udevqt_p.h"
 
-#include <QSocketNotifier>
 #include <qplatformdefs.h>
 
+#include <QSet>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
 namespace UdevQt
 {
 
-ClientPrivate::ClientPrivate(Client *q_)
-    : udev(nullptr), monitor(nullptr), q(q_), monitorNotifier(nullptr)
+Q_GLOBAL_STATIC(SharedUdevMonitor, globalUdevMonitor)
+
+MonitorThread::MonitorThread(SharedUdevMonitor *owner, struct udev_monitor *monitor)
+    : m_owner(owner), m_monitor(monitor)
 {
+    if (pipe2(m_wakePipe, O_CLOEXEC) != 0) {
+        m_wakePipe[0] = m_wakePipe[1] = -1;
+    }
 }
 
-ClientPrivate::~ClientPrivate()
+MonitorThread::~MonitorThread()
 {
-    udev_unref(udev);
-    delete monitorNotifier;
+    stop();
+    wait();
 
-    if (monitor) {
-        udev_monitor_unref(monitor);
+    if (m_wakePipe[0] >= 0) {
+        close(m_wakePipe[0]);
+        close(m_wakePipe[1]);
     }
 }
 
-void ClientPrivate::init(const QStringList &subsystemList, ListenToWhat what)
+void MonitorThread::stop()
 {
-    udev = udev_new();
+    if (m_wakePipe[1] >= 0) {
+        char c = 'q';
+        while (write(m_wakePipe[1], &c, 1) < 0 && errno == EINTR) {}
+    }
+}
 
-    if (what != ListenToNone) {
-        setWatchedSubsystems(subsystemList);
+void MonitorThread::run()
+{
+    const int monitorFd = udev_monitor_get_fd(m_monitor);
+
+    for (;;) {
+        struct pollfd fds[2] = {
+            { monitorFd, POLLIN, 0 },
+            { m_wakePipe[0], POLLIN, 0 },
+        };
+
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+
+        if (fds[1].revents) {
+            break;
+        }
+        if (!(fds[0].revents & POLLIN)) {
+            continue;
+        }
+
+        // drain the socket completely; a coldplug storm delivers many
+        // events per wakeup and we want one wakeup per subscriber per batch
+        struct udev_device *dev;
+        while ((dev = udev_monitor_receive_device(m_monitor))) {
+            m_owner->dispatch(QByteArray(udev_device_get_action(dev)), dev);
+        }
     }
 }
 
-void ClientPrivate::setWatchedSubsystems(const QStringList &subsystemList)
+SharedUdevMonitor::SharedUdevMonitor()
+    : m_udev(udev_new())
 {
-    // create a listener
-    struct udev_monitor *newM = udev_monitor_new_from_netlink(udev, "udev");
+}
+
+SharedUdevMonitor::~SharedUdevMonitor()
+{
+    delete m_thread; // stops and joins the thread
+
+    if (m_monitor) {
+        udev_monitor_unref(m_monitor);
+    }
+    udev_unref(m_udev);
+}
+
+SharedUdevMonitor *SharedUdevMonitor::instance()
+{
+    return globalUdevMonitor;
+}
 
-    if (!newM) {
-        qWarning("UdevQt: unable to create udev monitor connection");
+void SharedUdevMonitor::subscribe(ClientPrivate *client, const QStringList &subsystemList)
+{
+    QWriteLocker locker(&m_lock);
+
+    m_subscribers.insert(client, subsystemList);
+
+    if (!m_monitor) {
+        m_monitor = udev_monitor_new_from_netlink(m_udev, "udev");
+        if (!m_monitor) {
+            qWarning("UdevQt: unable to create udev monitor connection");
+            return;
+        }
+
+        rebuildFiltersLocked();
+        udev_monitor_enable_receiving(m_monitor);
+
+        m_thread = new MonitorThread(this, m_monitor);
+        m_thread->start();
+    } else {
+        rebuildFiltersLocked();
+        udev_monitor_filter_update(m_monitor);
+    }
+}
+
+void SharedUdevMonitor::unsubscribe(ClientPrivate *client)
+{
+    QWriteLocker locker(&m_lock);
+
+    if (m_subscribers.remove(client) == 0 || !m_monitor) {
         return;
     }
 
-    // apply our filters; an empty list means listen to everything
-    for (const QString &subsysDevtype : subsystemList) {
+    // The socket and its thread stay up for the next subscriber; only the
+    // kernel-side filter shrinks back to what is still listened to.
+    rebuildFiltersLocked();
+    udev_monitor_filter_update(m_monitor);
+}
+
+void SharedUdevMonitor::rebuildFiltersLocked()
+{
+    udev_monitor_filter_remove(m_monitor);
+
+    // The kernel-side filter is the union of every subscriber's list; one
+    // unfiltered subscriber means the socket has to see everything and the
+    // per-subscriber match at dispatch does all the narrowing.
+    QSet<QString> subsystems;
+    for (const QStringList &list : qAsConst(m_subscribers)) {
+        if (list.isEmpty()) {
+            return;
+        }
+        for (const QString &subsysDevtype : list) {
+            subsystems.insert(subsysDevtype);
+        }
+    }
+
+    for (const QString &subsysDevtype : qAsConst(subsystems)) {
         int ix = subsysDevtype.indexOf("/");
 
         if (ix > 0) {
             QByteArray subsystem = subsysDevtype.left(ix).toLatin1();
             QByteArray devType = subsysDevtype.mid(ix + 1).toLatin1();
-            udev_monitor_filter_add_match_subsystem_devtype(newM, subsystem.constData(), devType.constData());
+            udev_monitor_filter_add_match_subsystem_devtype(m_monitor, subsystem.constData(), devType.constData());
         } else {
-            udev_monitor_filter_add_match_subsystem_devtype(newM, subsysDevtype.toLatin1().constData(), nullptr);
+            udev_monitor_filter_add_match_subsystem_devtype(m_monitor, subsysDevtype.toLatin1().constData(), nullptr);
         }
     }
+}
+
+static bool subscriptionMatches(const QStringList &subsystemList, const char *subsystem, const char *devtype)
+{
+    if (subsystemList.isEmpty()) {
+        return true;
+    }
+    if (!subsystem) {
+        return false;
+    }
 
-    // start the new monitor receiving
-    udev_monitor_enable_receiving(newM);
-    QSocketNotifier *sn = new QSocketNotifier(udev_monitor_get_fd(newM), QSocketNotifier::Read);
-    QObject::connect(sn, SIGNAL(activated(int)), q, SLOT(_uq_monitorReadyRead(int)));
+    for (const QString &subsysDevtype : subsystemList) {
+        const int ix = subsysDevtype.indexOf(QLatin1Char('/'));
 
-    // kill any previous monitor
-    delete monitorNotifier;
-    if (monitor) {
-        udev_monitor_unref(monitor);
+        if (ix > 0) {
+            if (subsysDevtype.leftRef(ix) == QLatin1String(subsystem)
+                    && devtype && subsysDevtype.midRef(ix + 1) == QLatin1String(devtype)) {
+                return true;
+            }
+        } else if (subsysDevtype == QLatin1String(subsystem)) {
+            return true;
+        }
     }
 
-    // and save our new one
-    monitor = newM;
-    monitorNotifier = sn;
+    return false;
+}
+
+void SharedUdevMonitor::dispatch(const QByteArray &action, struct udev_device *device)
+{
+    const char *subsystem = udev_device_get_subsystem(device);
+    const char *devtype = udev_device_get_devtype(device);
+
+    QReadLocker locker(&m_lock);
+
+    for (auto it = m_subscribers.constBegin(); it != m_subscribers.constEnd(); ++it) {
+        if (!subscriptionMatches(it.value(), subsystem, devtype)) {
+            continue;
+        }
+
+        ClientPrivate *client = it.key();
+        if (client->eventQueue.enqueue(action, udev_device_ref(device))) {
+            client->scheduleEventProcessing();
+        } else {
+            qWarning("UdevQt: monitor event queue overflow, dropping \"%s\" event", action.constData());
+            udev_device_unref(device);
+        }
+    }
+
+    udev_device_unref(device);
+}
+
+ClientPrivate::ClientPrivate(Client *q_)
+    : udev(nullptr), q(q_), listening(false), processingScheduled(0)
+{
+}
+
+ClientPrivate::~ClientPrivate()
+{
+    if (listening) {
+        // after this returns the dispatcher can't enqueue here anymore
+        SharedUdevMonitor::instance()->unsubscribe(this);
+    }
+
+    // release events the main thread never got around to processing
+    MonitorEventQueue::Event event;
+    while (eventQueue.dequeue(&event)) {
+        udev_device_unref(event.device);
+    }
+
+    udev_unref(udev);
+}
+
+void ClientPrivate::init(const QStringList &subsystemList, ListenToWhat what)
+{
+    // every Client shares the process-wide context, so libudev's caches
+    // exist once no matter how many managers are around
+    udev = udev_ref(SharedUdevMonitor::instance()->context());
+
+    if (what != ListenToNone) {
+        setWatchedSubsystems(subsystemList);
+    }
+}
+
+void ClientPrivate::setWatchedSubsystems(const QStringList &subsystemList)
+{
+    // an empty list means listen to everything; the shared monitor merges
+    // this subscription with everyone else's into one kernel-side filter
+    SharedUdevMonitor::instance()->subscribe(this, subsystemList);
+
     watchedSubsystems = subsystemList;
+    listening = true;
 }
 
-void ClientPrivate::_uq_monitorReadyRead(int fd)
+void ClientPrivate::scheduleEventProcessing()
 {
-    Q_UNUSED(fd);
-    monitorNotifier->setEnabled(false);
-    struct udev_device *dev = udev_monitor_receive_device(monitor);
-    monitorNotifier->setEnabled(true);
+    // called from the monitor thread; wake the main thread at most once
+    // per queued batch
+    if (processingScheduled.testAndSetAcquire(0, 1)) {
+        QMetaObject::invokeMethod(q, "_uq_processQueuedEvents", Qt::QueuedConnection);
+    }
+}
 
-    if (!dev) {
-        return;
+void ClientPrivate::_uq_processQueuedEvents()
+{
+    processingScheduled.storeRelease(0);
+
+    MonitorEventQueue::Event event;
+    while (eventQueue.dequeue(&event)) {
+        handleMonitorEvent(event.action, event.device);
     }
+}
 
+void ClientPrivate::handleMonitorEvent(const QByteArray &action, struct udev_device *dev)
+{
     Device device(new DevicePrivate(dev, false));
 
-    QByteArray action(udev_device_get_action(dev));
     if (action == "add") {
         Q_EMIT q->deviceAdded(device);
     } else if (action == "remove") {
+        // drop cached attributes in case the same syspath reappears
+        sysfsAttributeCache()->invalidate(udev_device_get_syspath(dev));
         Q_EMIT q->deviceRemoved(device);
     } else if (action == "change") {
+        sysfsAttributeCache()->invalidate(udev_device_get_syspath(dev));
         Q_EMIT q->deviceChanged(device);
     } else if (action == "online") {
         Q_EMIT q->deviceOnlined(device);
@@ -110,11 +305,18 @@ void ClientPrivate::_uq_monitorReadyRead(int fd)
     }
 }
 
-DeviceList ClientPrivate::deviceListFromEnumerate(struct udev_enumerate *en)
+DeviceList ClientPrivate::deviceListFromEnumerate(struct udev_enumerate *en,
+                                                  const QStringList &prefetchSysfsAttributes)
 {
     DeviceList ret;
     struct udev_list_entry *list, *entry;
 
+    QList<QByteArray> attrs;
+    attrs.reserve(prefetchSysfsAttributes.count());
+    for (const QString &attr : prefetchSysfsAttributes) {
+        attrs << attr.toLatin1();
+    }
+
     udev_enumerate_scan_devices(en);
     list = udev_enumerate_get_list_entry(en);
     udev_list_entry_foreach(entry, list) {
@@ -125,6 +327,14 @@ DeviceList ClientPrivate::deviceListFromEnumerate(struct udev_enumerate *en)
             continue;
         }
 
+        // libudev caches sysattr values in the device; reading them now, while
+        // we're doing a single pass over sysfs anyway, turns the later
+        // on-demand sysfsProperty() calls into cache hits instead of
+        // scattered open/read/close syscalls
+        for (const QByteArray &attr : qAsConst(attrs)) {
+            udev_device_get_sysattr_value(ud, attr.constData());
+        }
+
         ret << Device(new DevicePrivate(ud, false));
     }
 
@@ -160,7 +370,7 @@ QStringList Client::watchedSubsystems() const
     }
 
     // we're not watching anything
-    if (!d->monitor) {
+    if (!d->listening) {
         return QStringList();
     }
 
@@ -191,10 +401,10 @@ DeviceList Client::devicesByProperty(const QString &property, const QVariant &va
     return d->deviceListFromEnumerate(en);
 }
 
-DeviceList Client::allDevices()
+DeviceList Client::allDevices(const QStringList &prefetchSysfsAttributes)
 {
     struct udev_enumerate *en = udev_enumerate_new(d->udev);
-    return d->deviceListFromEnumerate(en);
+    return d->deviceListFromEnumerate(en, prefetchSysfsAttributes);
 }
 
 DeviceList Client::devicesBySubsystem(const QString &subsystem)
@@ -205,6 +415,18 @@ DeviceList Client::devicesBySubsystem(const QString &subsystem)
     return d->deviceListFromEnumerate(en);
 }
 
+DeviceList Client::devicesBySubsystems(const QStringList &subsystems,
+                                       const QStringList &prefetchSysfsAttributes)
+{
+    struct udev_enumerate *en = udev_enumerate_new(d->udev);
+
+    for (const QString &subsystem : subsystems) {
+        udev_enumerate_add_match_subsystem(en, subsystem.toLatin1().constData());
+    }
+
+    return d->deviceListFromEnumerate(en, prefetchSysfsAttributes);
+}
+
 DeviceList Client::devicesBySubsystemsAndProperties(const QStringList &subsystems, const QVariantMap &properties)
 {
     struct udev_enumerate *en = udev_enumerate_new(d->udev);
@@ -32,9 +32,23 @@ public:
     QStringList watchedSubsystems() const;
     void setWatchedSubsystems(const QStringList &subsystemList);
 
-    DeviceList allDevices();
+    /**
+     * Returns all devices known to udev. Sysfs attributes named in
+     * @p prefetchSysfsAttributes are read into libudev's per-device cache
+     * during the enumeration pass, so subsequent Device::sysfsProperty()
+     * calls for them don't have to go back to sysfs.
+     */
+    DeviceList allDevices(const QStringList &prefetchSysfsAttributes = QStringList());
     DeviceList devicesByProperty(const QString &property, const QVariant &value);
     DeviceList devicesBySubsystem(const QString &subsystem);
+    /**
+     * Returns the devices matching any of the given subsystems. The filter is
+     * applied inside udev_enumerate, so irrelevant sysfs nodes are never
+     * handed to us in the first place. Supports the same attribute prefetch
+     * as allDevices().
+     */
+    DeviceList devicesBySubsystems(const QStringList &subsystems,
+                                   const QStringList &prefetchSysfsAttributes = QStringList());
     /**
      * Returns a list of devices matching any of the given subsystems AND any of the properties.
      *
@@ -56,7 +70,7 @@ Q_SIGNALS:
 
 private:
     friend class ClientPrivate;
-    Q_PRIVATE_SLOT(d, void _uq_monitorReadyRead(int fd))
+    Q_PRIVATE_SLOT(d, void _uq_processQueuedEvents())
     ClientPrivate *d;
 };
 
@@ -12,6 +12,79 @@
 namespace UdevQt
 {
 
+Q_GLOBAL_STATIC(SysfsAttributeCache, s_sysfsAttributeCache)
+
+SysfsAttributeCache *sysfsAttributeCache()
+{
+    return s_sysfsAttributeCache();
+}
+
+QVariant SysfsAttributeCache::value(struct udev_device *device, const QByteArray &name)
+{
+    const QString syspath = QString::fromLatin1(udev_device_get_syspath(device));
+
+    {
+        QReadLocker locker(&m_lock);
+        const auto it = m_entries.constFind(syspath);
+        if (it != m_entries.constEnd() && it->generation == m_generations.value(syspath)) {
+            const auto valueIt = it->values.constFind(name);
+            if (valueIt != it->values.constEnd()) {
+                return *valueIt;
+            }
+        }
+    }
+
+    QWriteLocker locker(&m_lock);
+    const quint64 generation = m_generations.value(syspath);
+    Entry &entry = m_entries[syspath];
+    if (entry.generation != generation) {
+        entry.values.clear();
+        entry.generation = generation;
+    }
+    const auto valueIt = entry.values.constFind(name);
+    if (valueIt != entry.values.constEnd()) {
+        return *valueIt;
+    }
+
+    const char *attrValue = nullptr;
+    struct udev_device *fresh = nullptr;
+    if (generation == 0) {
+        attrValue = udev_device_get_sysattr_value(device, name.constData());
+    } else {
+        // the handle we were given may carry values libudev cached before the
+        // last change event; read through a fresh handle to get current data
+        fresh = udev_device_new_from_syspath(udev_device_get_udev(device),
+                                             syspath.toLatin1().constData());
+        if (fresh) {
+            attrValue = udev_device_get_sysattr_value(fresh, name.constData());
+        }
+    }
+
+    QVariant value;
+    const QString attrString = QString::fromLatin1(attrValue);
+    if (!attrString.isEmpty()) {
+        value = QVariant::fromValue(attrString);
+    }
+    // negative results are cached too; they stay valid until the generation moves
+    entry.values.insert(name, value);
+
+    if (fresh) {
+        udev_device_unref(fresh);
+    }
+
+    return value;
+}
+
+void SysfsAttributeCache::invalidate(const char *syspath)
+{
+    if (!syspath) {
+        return;
+    }
+
+    QWriteLocker locker(&m_lock);
+    ++m_generations[QString::fromLatin1(syspath)];
+}
+
 DevicePrivate::DevicePrivate(struct udev_device *udev_, bool ref)
     : udev(udev_)
 {
@@ -29,6 +102,9 @@ DevicePrivate &DevicePrivate::operator=(const DevicePrivate &other)
 {
     udev_device_unref(udev);
     udev = udev_device_ref(other.udev);
+    // the memoized conversions belong to the previous handle
+    propertyCache.clear();
+    decodedPropertyCache.clear();
     return *this;
 }
 
@@ -229,12 +305,20 @@ QVariant Device::deviceProperty(const QString &name) const
         return QVariant();
     }
 
-    QByteArray propName = name.toLatin1();
-    QString propValue = QString::fromLatin1(udev_device_get_property_value(d->udev, propName.constData()));
+    const QByteArray propName = name.toLatin1();
+    const auto it = d->propertyCache.constFind(propName);
+    if (it != d->propertyCache.constEnd()) {
+        return *it;
+    }
+
+    QVariant result;
+    const QString propValue = QString::fromLatin1(udev_device_get_property_value(d->udev, propName.constData()));
     if (!propValue.isEmpty()) {
-        return QVariant::fromValue(propValue);
+        result = QVariant::fromValue(propValue);
     }
-    return QVariant();
+
+    d->propertyCache.insert(propName, result);
+    return result;
 }
 
 QString Device::decodedDeviceProperty(const QString &name) const
@@ -243,8 +327,15 @@ QString Device::decodedDeviceProperty(const QString &name) const
         return QString();
     }
 
-    QByteArray propName = name.toLatin1();
-    return d->decodePropertyValue(udev_device_get_property_value(d->udev, propName.constData()));
+    const QByteArray propName = name.toLatin1();
+    const auto it = d->decodedPropertyCache.constFind(propName);
+    if (it != d->decodedPropertyCache.constEnd()) {
+        return *it;
+    }
+
+    const QString decoded = d->decodePropertyValue(udev_device_get_property_value(d->udev, propName.constData()));
+    d->decodedPropertyCache.insert(propName, decoded);
+    return decoded;
 }
 
 QVariant Device::sysfsProperty(const QString &name) const
@@ -253,12 +344,7 @@ QVariant Device::sysfsProperty(const QString &name) const
         return QVariant();
     }
 
-    QByteArray propName = name.toLatin1();
-    QString propValue = QString::fromLatin1(udev_device_get_sysattr_value(d->udev, propName.constData()));
-    if (!propValue.isEmpty()) {
-        return QVariant::fromValue(propValue);
-    }
-    return QVariant();
+    return sysfsAttributeCache()->value(d->udev, name.toLatin1());
 }
 
 Device Device::ancestorOfType(const QString &subsys, const QString &devtype) const
@@ -13,12 +13,57 @@
 #include "udevblock.h"
 #include "cpuinfo.h"
 
+#include <QHash>
+#include <QReadWriteLock>
+
 #include <sys/socket.h>
 #include <linux/if_arp.h>
 
 
 using namespace Solid::Backends::UDev;
 
+namespace
+{
+
+/* UDIs are the same prefix glued onto every sysfs path; building them over
+ * and over duplicates the path fragments across the backend. One shared
+ * table hands out a single QString per device instead. */
+struct UdiInterner {
+    QReadWriteLock lock;
+    QHash<QString, QString> table;
+};
+
+Q_GLOBAL_STATIC(UdiInterner, s_udiInterner)
+
+}
+
+QString UDevDevice::udiForSysfsPath(const QString &sysfsPath)
+{
+    UdiInterner *interner = s_udiInterner();
+
+    {
+        QReadLocker locker(&interner->lock);
+        const auto it = interner->table.constFind(sysfsPath);
+        if (it != interner->table.constEnd()) {
+            return *it;
+        }
+    }
+
+    QWriteLocker locker(&interner->lock);
+    QString &udi = interner->table[sysfsPath];
+    if (udi.isNull()) {
+        udi = QString::fromLatin1(UDEV_UDI_PREFIX) + sysfsPath;
+    }
+    return udi;
+}
+
+void UDevDevice::releaseUdi(const QString &sysfsPath)
+{
+    UdiInterner *interner = s_udiInterner();
+    QWriteLocker locker(&interner->lock);
+    interner->table.remove(sysfsPath);
+}
+
 UDevDevice::UDevDevice(const UdevQt::Device device)
     : Solid::Ifaces::Device()
     , m_device(device)
@@ -218,7 +263,7 @@ int UDevDevice::deviceNumber() const
 
 QString UDevDevice::devicePath() const
 {
-    return QString(UDEV_UDI_PREFIX) + deviceName();
+    return udiForSysfsPath(deviceName());
 }
 
 UdevQt::Device UDevDevice::udevDevice()
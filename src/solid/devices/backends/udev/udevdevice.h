@@ -27,6 +27,19 @@ public:
     UDevDevice(const UdevQt::Device device);
     virtual ~UDevDevice();
 
+    /**
+     * Returns the interned UDI for @p sysfsPath. All backend objects get the
+     * same shared QString per device, so equal UDIs share their data and
+     * comparisons short-circuit on the data pointer instead of comparing the
+     * long common prefix character by character.
+     */
+    static QString udiForSysfsPath(const QString &sysfsPath);
+    /**
+     * Drops @p sysfsPath from the interning table, to be called when the
+     * device disappears.
+     */
+    static void releaseUdi(const QString &sysfsPath);
+
     QString udi() const override;
 
     QString parentUdi() const override;
@@ -10,6 +10,7 @@
 #include "udev.h"
 #include "udevdevice.h"
 #include "../shared/rootdevice.h"
+#include "solidtrace_p.h"
 
 #include <QSet>
 #include <QFile>
@@ -18,6 +19,13 @@
 using namespace Solid::Backends::UDev;
 using namespace Solid::Backends::Shared;
 
+// sysfs attributes UDevDevice reads for every device it wraps (vendor/product);
+// prefetching them during enumeration avoids per-device sysfs round trips later
+static QStringList prefetchedSysfsAttributes()
+{
+    return {QStringLiteral("manufacturer"), QStringLiteral("product")};
+}
+
 class UDevManager::Private
 {
 public:
@@ -28,23 +36,28 @@ public:
     bool checkOfInterest(const UdevQt::Device &device);
 
     UdevQt::Client *m_client;
-    QStringList m_devicesOfInterest;
+    QStringList m_subsystems;
+    // Both verdicts are cached: the interest check reads sysfs, and with
+    // 1000+ nodes the rejected ones dominate every enumeration. The
+    // properties it looks at are fixed at probe time, so a verdict only
+    // becomes stale when the device node goes away; remove events drop it.
+    QSet<QString> m_devicesOfInterest;
+    QSet<QString> m_devicesNotOfInterest;
     QSet<Solid::DeviceInterface::Type> m_supportedInterfaces;
 };
 
 UDevManager::Private::Private()
 {
-    QStringList subsystems;
-    subsystems << "processor";
-    subsystems << "cpu";
-    subsystems << "sound";
-    subsystems << "tty";
-    subsystems << "dvb";
-    subsystems << "net";
-    subsystems << "usb";
-    subsystems << "input";
-    subsystems << "typec";
-    m_client = new UdevQt::Client(subsystems);
+    m_subsystems << "processor";
+    m_subsystems << "cpu";
+    m_subsystems << "sound";
+    m_subsystems << "tty";
+    m_subsystems << "dvb";
+    m_subsystems << "net";
+    m_subsystems << "usb";
+    m_subsystems << "input";
+    m_subsystems << "typec";
+    m_client = new UdevQt::Client(m_subsystems);
 }
 
 UDevManager::Private::~Private()
@@ -57,10 +70,15 @@ bool UDevManager::Private::isOfInterest(const QString &udi, const UdevQt::Device
     if (m_devicesOfInterest.contains(udi)) {
         return true;
     }
+    if (m_devicesNotOfInterest.contains(udi)) {
+        return false;
+    }
 
     bool isOfInterest = checkOfInterest(device);
     if (isOfInterest) {
-        m_devicesOfInterest.append(udi);
+        m_devicesOfInterest.insert(udi);
+    } else {
+        m_devicesNotOfInterest.insert(udi);
     }
 
     return isOfInterest;
@@ -157,10 +175,13 @@ QSet<Solid::DeviceInterface::Type> UDevManager::supportedInterfaces() const
 QStringList UDevManager::allDevices()
 {
     QStringList res;
-    const UdevQt::DeviceList deviceList = d->m_client->allDevices();
+    // restrict the enumeration to the subsystems we watch anyway; plain
+    // allDevices() returns thousands of nodes isOfInterest would reject
+    const UdevQt::DeviceList deviceList = d->m_client->devicesBySubsystems(d->m_subsystems, prefetchedSysfsAttributes());
     for (const UdevQt::Device &device : deviceList) {
-        if (d->isOfInterest(udiPrefix() + device.sysfsPath(), device)) {
-            res << udiPrefix() + device.sysfsPath();
+        const QString udi = UDevDevice::udiForSysfsPath(device.sysfsPath());
+        if (d->isOfInterest(udi, device)) {
+            res << udi;
         }
     }
     return res;
@@ -172,11 +193,12 @@ QStringList UDevManager::devicesFromQuery(const QString &parentUdi,
     QStringList result;
 
     if (!parentUdi.isEmpty()) {
-        const UdevQt::DeviceList deviceList = d->m_client->allDevices();
+        const UdevQt::DeviceList deviceList = d->m_client->devicesBySubsystems(d->m_subsystems, prefetchedSysfsAttributes());
         for (const UdevQt::Device &dev : deviceList) {
             UDevDevice device(dev);
-            if (device.queryDeviceInterface(type) && d->isOfInterest(udiPrefix() + dev.sysfsPath(), dev) && device.parentUdi() == parentUdi) {
-                result << udiPrefix() + dev.sysfsPath();
+            const QString udi = UDevDevice::udiForSysfsPath(dev.sysfsPath());
+            if (device.queryDeviceInterface(type) && d->isOfInterest(udi, dev) && device.parentUdi() == parentUdi) {
+                result << udi;
             }
         }
         return result;
@@ -205,13 +227,14 @@ QStringList UDevManager::devicesFromQuery(const QString &parentUdi,
             {QStringLiteral("ID_MEDIA_PLAYER"), QStringLiteral("*")} // match any
         });
     } else {
-        deviceList = d->m_client->allDevices();
+        deviceList = d->m_client->devicesBySubsystems(d->m_subsystems, prefetchedSysfsAttributes());
     }
 
     for (const UdevQt::Device &dev : qAsConst(deviceList)) {
         UDevDevice device(dev);
-        if (device.queryDeviceInterface(type) && d->isOfInterest(udiPrefix() + dev.sysfsPath(), dev)) {
-            result << udiPrefix() + dev.sysfsPath();
+        const QString udi = UDevDevice::udiForSysfsPath(dev.sysfsPath());
+        if (device.queryDeviceInterface(type) && d->isOfInterest(udi, dev)) {
+            result << udi;
         }
     }
 
@@ -241,15 +264,30 @@ QObject *UDevManager::createDevice(const QString &udi_)
 
 void UDevManager::slotDeviceAdded(const UdevQt::Device &device)
 {
-    if (d->isOfInterest(udiPrefix() + device.sysfsPath(), device)) {
-        Q_EMIT deviceAdded(udiPrefix() + device.sysfsPath());
+    SOLID_TRACE_TIMER(traceTimer);
+
+    const QString udi = UDevDevice::udiForSysfsPath(device.sysfsPath());
+    // a fresh add deserves a fresh verdict, in case the remove that should
+    // have dropped the old one was missed
+    d->m_devicesNotOfInterest.remove(udi);
+    if (d->isOfInterest(udi, device)) {
+        Q_EMIT deviceAdded(udi);
     }
+
+    SOLID_PROBE2(udev_uevent_add, qPrintable(udi), SOLID_TRACE_NSECS(traceTimer));
 }
 
 void UDevManager::slotDeviceRemoved(const UdevQt::Device &device)
 {
-    if (d->isOfInterest(udiPrefix() + device.sysfsPath(), device)) {
-        Q_EMIT deviceRemoved(udiPrefix() + device.sysfsPath());
-        d->m_devicesOfInterest.removeAll(udiPrefix() + device.sysfsPath());
+    SOLID_TRACE_TIMER(traceTimer);
+
+    const QString udi = UDevDevice::udiForSysfsPath(device.sysfsPath());
+    if (d->isOfInterest(udi, device)) {
+        Q_EMIT deviceRemoved(udi);
+        d->m_devicesOfInterest.remove(udi);
     }
+    d->m_devicesNotOfInterest.remove(udi);
+    UDevDevice::releaseUdi(device.sysfsPath());
+
+    SOLID_PROBE2(udev_uevent_remove, qPrintable(udi), SOLID_TRACE_NSECS(traceTimer));
 }
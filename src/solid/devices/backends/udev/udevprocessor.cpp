@@ -77,9 +77,8 @@ bool Processor::canChangeFrequency() const
 
 Solid::Processor::InstructionSets Processor::instructionSets() const
 {
-    static Solid::Processor::InstructionSets cpuextensions = Solid::Backends::Shared::cpuFeatures();
-
-    return cpuextensions;
+    // memoized per process in cpuFeatures() itself
+    return Solid::Backends::Shared::cpuFeatures();
 }
 
 QString Processor::prefix() const
@@ -28,8 +28,8 @@ using namespace Solid::Backends::UDisks2;
 Block::Block(Device *dev)
     : DeviceInterface(dev)
 {
-    m_devNum = m_device->prop("DeviceNumber").toULongLong();
-    m_devFile = QFile::decodeName(m_device->prop("Device").toByteArray());
+    m_devNum = m_device->prop(QStringLiteral("DeviceNumber")).toULongLong();
+    m_devFile = QFile::decodeName(m_device->prop(QStringLiteral("Device")).toByteArray());
 
     // we have a drive (non-block device for udisks), so let's find the corresponding (real) block device
     if (m_devNum == 0 || m_devFile.isEmpty()) {
@@ -50,8 +50,8 @@ Block::Block(Device *dev)
 
                     Device device(udi);
                     if (device.drivePath() == dev->udi()) {
-                        m_devNum = device.prop("DeviceNumber").toULongLong();
-                        m_devFile = QFile::decodeName(device.prop("Device").toByteArray());
+                        m_devNum = device.prop(QStringLiteral("DeviceNumber")).toULongLong();
+                        m_devFile = QFile::decodeName(device.prop(QStringLiteral("Device")).toByteArray());
                         break;
                     }
                 }
@@ -21,51 +21,16 @@
 
 #include <QMimeDatabase>
 
+#include "../shared/sizeformat.h"
 
 
-using namespace Solid::Backends::UDisks2;
 
-// Adapted from KLocale as Solid needs to be Qt-only
-static QString formatByteSize(double size)
-{
-    // Per IEC 60027-2
+using namespace Solid::Backends::UDisks2;
 
-    // Binary prefixes
-    //Tebi-byte             TiB             2^40    1,099,511,627,776 bytes
-    //Gibi-byte             GiB             2^30    1,073,741,824 bytes
-    //Mebi-byte             MiB             2^20    1,048,576 bytes
-    //Kibi-byte             KiB             2^10    1,024 bytes
-
-    QString s;
-    // Gibi-byte
-    if (size >= 1073741824.0) {
-        size /= 1073741824.0;
-        if (size > 1024) { // Tebi-byte
-            s = QCoreApplication::translate("udisksdevice", "%1 TiB").arg(QLocale().toString(size / 1024.0, 'f', 1));
-        } else {
-            s = QCoreApplication::translate("udisksdevice", "%1 GiB").arg(QLocale().toString(size, 'f', 1));
-        }
-    }
-    // Mebi-byte
-    else if (size >= 1048576.0) {
-        size /= 1048576.0;
-        s = QCoreApplication::translate("udisksdevice", "%1 MiB").arg(QLocale().toString(size, 'f', 1));
-    }
-    // Kibi-byte
-    else if (size >= 1024.0) {
-        size /= 1024.0;
-        s = QCoreApplication::translate("udisksdevice", "%1 KiB").arg(QLocale().toString(size, 'f', 1));
-    }
-    // Just byte
-    else if (size > 0) {
-        s = QCoreApplication::translate("udisksdevice", "%1 B").arg(QLocale().toString(size, 'f', 1));
-    }
-    // Nothing
-    else {
-        s = QCoreApplication::translate("udisksdevice", "0 B");
-    }
-    return s;
-}
+// The shared engine caches the localized unit templates and the
+// rendered strings, so repeated description refreshes don't re-run
+// locale-aware number formatting per device.
+using Solid::Backends::Shared::formatByteSize;
 
 Device::Device(const QString &udi)
     : Solid::Ifaces::Device()
@@ -74,6 +39,7 @@ Device::Device(const QString &udi)
     if (m_backend) {
         connect(m_backend, SIGNAL(changed()), this, SIGNAL(changed()));
         connect(m_backend, SIGNAL(propertyChanged(QMap<QString,int>)), this, SIGNAL(propertyChanged(QMap<QString,int>)));
+        connect(m_backend, SIGNAL(propertyValuesChanged(QVariantMap)), this, SIGNAL(propertyValuesChanged(QVariantMap)));
     } else {
         qCDebug(UDISKS2) << "Created invalid Device for udi" << udi;
     }
@@ -119,6 +85,13 @@ QVariantMap Device::allProperties() const
     return QVariantMap();
 }
 
+void Device::prefetchProperties(const QStringList &interfaces) const
+{
+    if (m_backend) {
+        m_backend->prefetchProperties(interfaces);
+    }
+}
+
 bool Device::hasInterface(const QString &name) const
 {
     if (m_backend) {
@@ -181,27 +154,69 @@ QObject *Device::createDeviceInterface(const Solid::DeviceInterface::Type &type)
 
 bool Device::queryDeviceInterface(const Solid::DeviceInterface::Type &type) const
 {
-    switch (type) {
-    case Solid::DeviceInterface::GenericInterface:
+    if (type == Solid::DeviceInterface::GenericInterface) {
         return true;
+    }
+
+    /* Serve repeated checks, negative ones included, from the backend's
+     * verdict cache; it is cleared on interface and property changes. */
+    bool cached = false;
+    if (m_backend && m_backend->cachedQueryResult(type, &cached)) {
+        return cached;
+    }
+
+    bool res = false;
+    switch (type) {
     case Solid::DeviceInterface::Block:
-        return isBlock() || isDrive();
+        res = isBlock() || isDrive();
+        break;
     case Solid::DeviceInterface::StorageVolume:
-        return isStorageVolume();
+        res = isStorageVolume();
+        break;
     case Solid::DeviceInterface::StorageAccess:
-        return isStorageAccess();
+        res = isStorageAccess();
+        break;
     case Solid::DeviceInterface::StorageDrive:
-        return isDrive();
+        res = isDrive();
+        break;
     case Solid::DeviceInterface::OpticalDrive:
-        return isOpticalDrive();
+        res = isOpticalDrive();
+        break;
     case Solid::DeviceInterface::OpticalDisc:
-        return isOpticalDisc();
+        res = isOpticalDisc();
+        break;
     default:
-        return false;
+        break;
     }
+
+    if (m_backend) {
+        m_backend->cacheQueryResult(type, res);
+    }
+    return res;
 }
 
 QStringList Device::emblems() const
+{
+    /* The emblems of an encrypted container depend on the mount state of
+     * its cleartext device, whose changes don't invalidate our cache, so
+     * memoize only for the ordinary case. */
+    const bool cacheable = m_backend && !isEncryptedContainer();
+
+    if (cacheable) {
+        const QVariant cached = m_backend->cachedDisplayValue(QStringLiteral("emblems"));
+        if (cached.isValid()) {
+            return cached.toStringList();
+        }
+    }
+
+    const QStringList emblems = computeEmblems();
+    if (cacheable) {
+        m_backend->setCachedDisplayValue(QStringLiteral("emblems"), emblems);
+    }
+    return emblems;
+}
+
+QStringList Device::computeEmblems() const
 {
     QStringList res;
 
@@ -224,12 +239,40 @@ QStringList Device::emblems() const
 }
 
 QString Device::description() const
+{
+    /* Dolphin asks for this on every Places panel repaint; answer from the
+     * memoized value, which the backend drops on any property change. */
+    if (m_backend) {
+        const QVariant cached = m_backend->cachedDisplayValue(QStringLiteral("description"));
+        if (cached.isValid()) {
+            return cached.toString();
+        }
+    }
+
+    const QString description = computeDescription();
+    if (m_backend) {
+        m_backend->setCachedDisplayValue(QStringLiteral("description"), description);
+    }
+    return description;
+}
+
+QString Device::computeDescription() const
 {
     const QString hintName = property("HintName").toString(); // non-cached
     if (!hintName.isEmpty()) {
         return hintName;
     }
 
+    /* Warm the cache for every interface the description logic below may
+     * consult, so it doesn't degrade into one Get call per property.
+     * Interfaces the device doesn't advertise are skipped. */
+    prefetchProperties({QStringLiteral(UD2_DBUS_INTERFACE_BLOCK),
+                        QStringLiteral(UD2_DBUS_INTERFACE_DRIVE),
+                        QStringLiteral(UD2_DBUS_INTERFACE_PARTITION),
+                        QStringLiteral(UD2_DBUS_INTERFACE_FILESYSTEM),
+                        QStringLiteral(UD2_DBUS_INTERFACE_LOOP),
+                        QStringLiteral(UD2_DBUS_INTERFACE_SWAP)});
+
     if (isLoop()) {
         return loopDescription();
     } else if (isSwap()) {
@@ -245,12 +288,12 @@ QString Device::description() const
 
 QString Device::loopDescription() const
 {
-    const QString label = prop("IdLabel").toString();
+    const QString label = prop(QStringLiteral("IdLabel")).toString();
     if (!label.isEmpty()) {
         return label;
     }
 
-    const QString backingFile = prop("BackingFile").toString();
+    const QString backingFile = prop(QStringLiteral("BackingFile")).toString();
     if (!backingFile.isEmpty()) {
         return backingFile.section(QLatin1Char('/'), -1);
     }
@@ -404,9 +447,9 @@ QString Device::volumeDescription() const
 {
     QString description;
     const UDisks2::StorageVolume storageVolume(const_cast<Device *>(this));
-    QString volume_label = prop("IdLabel").toString();
+    QString volume_label = prop(QStringLiteral("IdLabel")).toString();
     if (volume_label.isEmpty()) {
-        volume_label = prop("Name").toString();
+        volume_label = prop(QStringLiteral("Name")).toString();
     }
     if (!volume_label.isEmpty()) {
         return volume_label;
@@ -588,15 +631,40 @@ QString Device::volumeDescription() const
 }
 
 QString Device::icon() const
+{
+    if (m_backend) {
+        const QVariant cached = m_backend->cachedDisplayValue(QStringLiteral("icon"));
+        if (cached.isValid()) {
+            return cached.toString();
+        }
+    }
+
+    const QString icon = computeIcon();
+    if (m_backend) {
+        m_backend->setCachedDisplayValue(QStringLiteral("icon"), icon);
+    }
+    return icon;
+}
+
+QString Device::computeIcon() const
 {
     QString iconName = property("HintIconName").toString();   // non-cached
 
     if (!iconName.isEmpty()) {
         return iconName;
-    } else if (isRoot()) {
+    }
+
+    /* Same bulk warm-up as in description() */
+    prefetchProperties({QStringLiteral(UD2_DBUS_INTERFACE_BLOCK),
+                        QStringLiteral(UD2_DBUS_INTERFACE_DRIVE),
+                        QStringLiteral(UD2_DBUS_INTERFACE_PARTITION),
+                        QStringLiteral(UD2_DBUS_INTERFACE_FILESYSTEM),
+                        QStringLiteral(UD2_DBUS_INTERFACE_LOOP)});
+
+    if (isRoot()) {
         return QStringLiteral("drive-harddisk-root");
     } else if (isLoop()) {
-        const QString backingFile = prop("BackingFile").toString();
+        const QString backingFile = prop(QStringLiteral("BackingFile")).toString();
         if (!backingFile.isEmpty()) {
             QMimeType type = QMimeDatabase().mimeTypeForFile(backingFile);
             if (!type.isDefault()) {
@@ -607,12 +675,12 @@ QString Device::icon() const
     } else if (isSwap()) {
         return "drive-harddisk";
     } else if (isDrive()) {
-        const bool isRemovable = prop("Removable").toBool();
-        const QString conn = prop("ConnectionBus").toString();
+        const bool isRemovable = prop(QStringLiteral("Removable")).toBool();
+        const QString conn = prop(QStringLiteral("ConnectionBus")).toString();
 
         if (isOpticalDrive()) {
             return "drive-optical";
-        } else if (isRemovable && !prop("Optical").toBool()) {
+        } else if (isRemovable && !prop(QStringLiteral("Optical")).toBool()) {
             if (conn == "usb") {
                 return "drive-removable-media-usb";
             } else {
@@ -628,11 +696,11 @@ QString Device::icon() const
         Device drive(drv);
 
         // handle media
-        const QString media = drive.prop("Media").toString();
+        const QString media = drive.prop(QStringLiteral("Media")).toString();
 
         if (!media.isEmpty()) {
-            if (drive.prop("Optical").toBool()) {    // optical stuff
-                bool isWritable = drive.prop("OpticalBlank").toBool();
+            if (drive.prop(QStringLiteral("Optical")).toBool()) {    // optical stuff
+                bool isWritable = drive.prop(QStringLiteral("OpticalBlank")).toBool();
 
                 const UDisks2::OpticalDisc disc(const_cast<Device *>(this));
                 Solid::OpticalDisc::ContentTypes availContent = disc.availableContent();
@@ -676,7 +744,7 @@ QString Device::icon() const
             }
         }
 
-        if (drive.prop("ConnectionBus").toString() == "sdio") { // hack for SD cards connected thru sdio bus
+        if (drive.prop(QStringLiteral("ConnectionBus")).toString() == "sdio") { // hack for SD cards connected thru sdio bus
             return "media-flash-sd-mmc";
         }
 
@@ -690,30 +758,30 @@ QString Device::product() const
 {
     if (!isDrive()) {
         Device drive(drivePath());
-        return drive.prop("Model").toString();
+        return drive.prop(QStringLiteral("Model")).toString();
     }
 
-    return prop("Model").toString();
+    return prop(QStringLiteral("Model")).toString();
 }
 
 QString Device::vendor() const
 {
     if (!isDrive()) {
         Device drive(drivePath());
-        return drive.prop("Vendor").toString();
+        return drive.prop(QStringLiteral("Vendor")).toString();
     }
 
-    return prop("Vendor").toString();
+    return prop(QStringLiteral("Vendor")).toString();
 }
 
 QString Device::parentUdi() const
 {
     QString parent;
 
-    if (propertyExists("Drive")) { // block
+    if (isBlock()) { // the Drive property belongs to the Block interface
         parent = drivePath();
-    } else if (propertyExists("Table")) { // partition
-        parent = prop("Table").value<QDBusObjectPath>().path();
+    } else if (isPartition()) { // ditto Table and Partition
+        parent = prop(QStringLiteral("Table")).value<QDBusObjectPath>().path();
     } else if (parent.isEmpty() || parent == "/") {
         parent = UD2_UDI_DISKS_PREFIX;
     }
@@ -772,17 +840,17 @@ Solid::ErrorType Device::errorToSolidError(const QString &error) const
 
 bool Device::isBlock() const
 {
-    return hasInterface(QStringLiteral(UD2_DBUS_INTERFACE_BLOCK));
+    return m_backend && m_backend->hasInterface(DeviceBackend::BlockInterface);
 }
 
 bool Device::isPartition() const
 {
-    return hasInterface(QStringLiteral(UD2_DBUS_INTERFACE_PARTITION));
+    return m_backend && m_backend->hasInterface(DeviceBackend::PartitionInterface);
 }
 
 bool Device::isPartitionTable() const
 {
-    return hasInterface(QStringLiteral(UD2_DBUS_INTERFACE_PARTITIONTABLE));
+    return m_backend && m_backend->hasInterface(DeviceBackend::PartitionTableInterface);
 }
 
 bool Device::isStorageVolume() const
@@ -792,17 +860,37 @@ bool Device::isStorageVolume() const
 
 bool Device::isStorageAccess() const
 {
-    return hasInterface(QStringLiteral(UD2_DBUS_INTERFACE_FILESYSTEM)) || isEncryptedContainer();
+    if (!(m_backend && m_backend->hasInterface(DeviceBackend::FilesystemInterface)) && !isEncryptedContainer()) {
+        return false;
+    }
+
+    /* The mount-blacklist can also block by filesystem type or connection
+     * bus; those properties only exist once the backend is up, so the
+     * check lives here rather than on the backend lookup path. */
+    if (DeviceBackend::hasMountPropertyRules()) {
+        const QString fstype = prop(QStringLiteral("IdType")).toString();
+        QString bus;
+        const QString drv = drivePath();
+        if (!drv.isEmpty() && drv != "/") {
+            Device drive(drv);
+            bus = drive.prop(QStringLiteral("ConnectionBus")).toString();
+        }
+        if (DeviceBackend::isMountBlockedByRules(fstype, bus)) {
+            return false;
+        }
+    }
+
+    return true;
 }
 
 bool Device::isDrive() const
 {
-    return hasInterface(QStringLiteral(UD2_DBUS_INTERFACE_DRIVE));
+    return m_backend && m_backend->hasInterface(DeviceBackend::DriveInterface);
 }
 
 bool Device::isOpticalDrive() const
 {
-    return isDrive() && !prop("MediaCompatibility").toStringList().filter("optical_").isEmpty();
+    return isDrive() && !prop(QStringLiteral("MediaCompatibility")).toStringList().filter("optical_").isEmpty();
 }
 
 bool Device::isOpticalDisc() const
@@ -813,7 +901,7 @@ bool Device::isOpticalDisc() const
     }
 
     Device drive(drv);
-    return drive.prop("Optical").toBool();
+    return drive.prop(QStringLiteral("Optical")).toBool();
 }
 
 bool Device::mightBeOpticalDisc() const
@@ -835,12 +923,12 @@ bool Device::isMounted() const
 
 bool Device::isEncryptedContainer() const
 {
-    return hasInterface(QStringLiteral(UD2_DBUS_INTERFACE_ENCRYPTED));
+    return m_backend && m_backend->hasInterface(DeviceBackend::EncryptedInterface);
 }
 
 bool Device::isEncryptedCleartext() const
 {
-    const QString holderDevice = prop("CryptoBackingDevice").toString();
+    const QString holderDevice = prop(QStringLiteral("CryptoBackingDevice")).toString();
     if (holderDevice.isEmpty() || holderDevice == "/") {
         return false;
     } else {
@@ -869,5 +957,5 @@ bool Device::isLoop() const
 
 QString Device::drivePath() const
 {
-    return prop("Drive").value<QDBusObjectPath>().path();
+    return prop(QStringLiteral("Drive")).value<QDBusObjectPath>().path();
 }
@@ -46,6 +46,7 @@ public:
     QVariant prop(const QString &key) const;
     bool propertyExists(const QString &key) const;
     QVariantMap allProperties() const;
+    void prefetchProperties(const QStringList &interfaces) const;
     void invalidateCache();
 
     bool hasInterface(const QString &name) const;
@@ -75,11 +76,15 @@ public:
 Q_SIGNALS:
     void changed();
     void propertyChanged(const QMap<QString, int> &changes);
+    void propertyValuesChanged(const QVariantMap &changedValues);
 
 protected:
     QPointer<DeviceBackend> m_backend;
 
 private:
+    QString computeDescription() const;
+    QStringList computeEmblems() const;
+    QString computeIcon() const;
     QString loopDescription() const;
     QString storageDescription() const;
     QString volumeDescription() const;
@@ -9,83 +9,443 @@
 */
 
 #include "udisksdevicebackend.h"
+#include "udisksmultiplexer.h"
+#include "udiskspendingcallgroup.h"
+#include "udisksservicehealth.h"
 #include "udisks_debug.h"
 
 #include <QDBusConnection>
-#include <QDomDocument>
+#include <QElapsedTimer>
 #include <QFile>
+#include <QFileSystemWatcher>
+#include <QReadWriteLock>
+#include <QRegularExpression>
+#include <QSet>
+#include <QTextStream>
+#include <QVector>
+#include <QXmlStreamReader>
 
 #include "solid/deviceinterface.h"
 #include "solid/genericinterface.h"
+#include "solidconfig_p.h"
+#include "solidcounters_p.h"
+#include "solidstringpool_p.h"
+#include "solidtrace_p.h"
 
 using namespace Solid::Backends::UDisks2;
 
-/* Static cache for DeviceBackends for all UDIs */
-QThreadStorage<QMap<QString /* UDI */, DeviceBackend *>> DeviceBackend::s_backends;
+namespace
+{
 
-bool DeviceBackend::checkMountPath(QString udi) {
-    QFile file(QStringLiteral("/etc/jingos/udisks/mount-blacklist"));
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        qDebug() << "mount-blacklist file error !";
+static const QString mountBlacklistPath = QStringLiteral("/etc/jingos/udisks/mount-blacklist");
+
+/* Monotonic clock shared by the cache access stamps; a single elapsed
+ * timer read is cheaper and steadier than querying wall time. */
+static qint64 monotonicMsecs()
+{
+    static QElapsedTimer clock;
+    if (!clock.isValid()) {
+        clock.start();
+    }
+    return clock.elapsed();
+}
+
+/* Rough footprint of a cached value: the variant itself plus the payload
+ * of the string-ish types that dominate UDisks2 properties. This is an
+ * estimate for accounting, not an allocator audit. */
+static qint64 variantFootprint(const QVariant &value)
+{
+    qint64 bytes = sizeof(QVariant);
+    switch (value.type()) {
+    case QVariant::String:
+        bytes += value.toString().capacity() * qint64(sizeof(QChar));
+        break;
+    case QVariant::ByteArray:
+        bytes += value.toByteArray().capacity();
+        break;
+    case QVariant::StringList:
+        for (const QString &entry : value.toStringList()) {
+            bytes += sizeof(QString) + entry.capacity() * qint64(sizeof(QChar));
+        }
+        break;
+    default:
+        break;
+    }
+    return bytes;
+}
+
+template<typename Map>
+static qint64 mapFootprint(const Map &map)
+{
+    qint64 bytes = 0;
+    for (auto it = map.cbegin(); it != map.cend(); ++it) {
+        bytes += 4 * sizeof(void *) // per-node bookkeeping
+                 + sizeof(QString) + it.key().capacity() * qint64(sizeof(QChar))
+                 + variantFootprint(it.value());
+    }
+    return bytes;
+}
+
+/* Routes freshly demarshalled string values through the process-wide
+ * pool, so the values repeated across devices ("ext4", "disk", vendor
+ * names) share one buffer each instead of one copy per device. */
+static void internStringProperties(QVariantMap *map)
+{
+    for (auto it = map->begin(); it != map->end(); ++it) {
+        it.value() = Solid::StringPool::internVariant(it.value());
+    }
+}
+
+/* The blacklist is consulted on every backend lookup, so the file is
+ * compiled once into a ruleset and only re-read when the file itself
+ * changes; the lookups are read-only against the compiled form and never
+ * re-split or re-parse anything.
+ *
+ * Besides plain device names, entries may use shell-style globs ("sda*"),
+ * and whole lines of the form "fstype=vfat;ntfs" or "bus=usb" block
+ * mounting by filesystem type or connection bus. Globs that are a plain
+ * prefix are matched by startsWith(); anything fancier becomes an anchored
+ * QRegularExpression compiled at load time. Lines starting with '#' are
+ * comments. */
+class MountBlacklist : public QObject
+{
+public:
+    MountBlacklist()
+    {
+        reload();
+        /* Watching the file is best-effort: if it doesn't exist yet the
+         * watcher silently does nothing and the blacklist stays empty. */
+        m_watcher.addPath(mountBlacklistPath);
+        connect(&m_watcher, &QFileSystemWatcher::fileChanged, this, [this]() {
+            reload();
+            /* Editors typically replace the file, which removes it from
+             * the watcher, so re-add it after every change. */
+            m_watcher.addPath(mountBlacklistPath);
+        });
+    }
+
+    bool containsName(const QString &name) const
+    {
+        QReadLocker locker(&m_lock);
+        if (m_names.contains(name)) {
+            return true;
+        }
+        for (const QString &prefix : m_prefixes) {
+            if (name.startsWith(prefix)) {
+                return true;
+            }
+        }
+        for (const QRegularExpression &pattern : m_patterns) {
+            if (pattern.match(name).hasMatch()) {
+                return true;
+            }
+        }
         return false;
     }
 
-    QTextStream in(&file);
-    QStringList blacklist = in.readLine().split(QStringLiteral(";"));
-    QStringList udiList = udi.split('/', QString::SkipEmptyParts);
+    /* Cheap pre-check so the property-based rules cost one atomic load
+     * when the file doesn't use them (the common case). */
+    bool hasPropertyRules() const
+    {
+        return m_hasPropertyRules.loadAcquire();
+    }
+
+    bool matchesProperties(const QString &fstype, const QString &bus) const
+    {
+        QReadLocker locker(&m_lock);
+        return (!fstype.isEmpty() && m_fstypes.contains(fstype))
+               || (!bus.isEmpty() && m_buses.contains(bus));
+    }
+
+private:
+    void reload()
+    {
+        QSet<QString> names;
+        QVector<QString> prefixes;
+        QVector<QRegularExpression> patterns;
+        QSet<QString> fstypes;
+        QSet<QString> buses;
+
+        QFile file(mountBlacklistPath);
+        if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            QTextStream in(&file);
+            while (!in.atEnd()) {
+                const QString line = in.readLine().trimmed();
+                if (line.isEmpty() || line.startsWith(QLatin1Char('#'))) {
+                    continue;
+                }
+
+                QSet<QString> *propertySet = nullptr;
+                QString entryList = line;
+                if (line.startsWith(QLatin1String("fstype="))) {
+                    propertySet = &fstypes;
+                    entryList = line.mid(7);
+                } else if (line.startsWith(QLatin1String("bus="))) {
+                    propertySet = &buses;
+                    entryList = line.mid(4);
+                }
+
+                const QStringList entries = entryList.split(QLatin1Char(';'), QString::SkipEmptyParts);
+                for (const QString &entry : entries) {
+                    if (propertySet) {
+                        propertySet->insert(entry);
+                    } else if (!entry.contains(QLatin1Char('*')) && !entry.contains(QLatin1Char('?'))
+                               && !entry.contains(QLatin1Char('['))) {
+                        names.insert(entry);
+                    } else if (entry.endsWith(QLatin1Char('*'))
+                               && !entry.leftRef(entry.size() - 1).contains(QLatin1Char('*'))
+                               && !entry.contains(QLatin1Char('?')) && !entry.contains(QLatin1Char('['))) {
+                        prefixes.append(entry.left(entry.size() - 1));
+                    } else {
+                        patterns.append(QRegularExpression(QRegularExpression::wildcardToRegularExpression(entry)));
+                    }
+                }
+            }
+        } else {
+            qDebug() << "mount-blacklist file error !";
+        }
+
+        QWriteLocker locker(&m_lock);
+        m_names = names;
+        m_prefixes = prefixes;
+        m_patterns = patterns;
+        m_fstypes = fstypes;
+        m_buses = buses;
+        m_hasPropertyRules.storeRelease(!fstypes.isEmpty() || !buses.isEmpty());
+    }
+
+    QFileSystemWatcher m_watcher;
+    mutable QReadWriteLock m_lock;
+    QSet<QString> m_names;
+    QVector<QString> m_prefixes;
+    QVector<QRegularExpression> m_patterns;
+    QSet<QString> m_fstypes;
+    QSet<QString> m_buses;
+    QAtomicInteger<int> m_hasPropertyRules;
+};
 
-    if(udiList.isEmpty())
+}
+
+Q_GLOBAL_STATIC(MountBlacklist, s_mountBlacklist)
+
+/* Static cache for DeviceBackends for all UDIs, shared between threads so
+ * there is one backend (and one set of D-Bus match rules) per device
+ * instead of one per device per thread. */
+QHash<QString /* UDI */, DeviceBackend *> DeviceBackend::s_backends;
+QReadWriteLock DeviceBackend::s_backendsLock;
+
+bool DeviceBackend::checkMountPath(QString udi) {
+    /* Only the last path segment names the device; no need to split the
+     * whole UDI apart to get at it. */
+    const QString name = udi.mid(udi.lastIndexOf(QLatin1Char('/')) + 1);
+
+    if (name.isEmpty())
         return false;
-    return blacklist.contains(udiList.takeLast());
+    return s_mountBlacklist->containsName(name);
+}
+
+bool DeviceBackend::hasMountPropertyRules()
+{
+    return s_mountBlacklist->hasPropertyRules();
+}
+
+bool DeviceBackend::isMountBlockedByRules(const QString &fstype, const QString &bus)
+{
+    return s_mountBlacklist->matchesProperties(fstype, bus);
 }
 
 DeviceBackend *DeviceBackend::backendForUDI(const QString &udi, bool create)
 {
-    DeviceBackend *backend = nullptr;
     if (udi.isEmpty() || checkMountPath(udi)) {
-        return backend;
+        return nullptr;
     }
 
-    backend = s_backends.localData().value(udi);
-    if (!backend && create) {
-        backend = new DeviceBackend(udi);
-        s_backends.localData().insert(udi, backend);
+    {
+        QReadLocker locker(&s_backendsLock);
+        DeviceBackend *backend = s_backends.value(udi);
+        if (backend || !create) {
+            return backend;
+        }
+    }
+
+    /* Construct outside the lock, the constructor performs D-Bus calls.
+     * A concurrent creator may win the race below, in which case our
+     * candidate is discarded again. */
+    DeviceBackend *candidate = new DeviceBackend(udi);
+
+    QWriteLocker locker(&s_backendsLock);
+    DeviceBackend *&backend = s_backends[udi];
+    if (!backend) {
+        backend = candidate;
+    } else {
+        candidate->deleteLater();
     }
 
     return backend;
 }
 
+DeviceBackend *DeviceBackend::seedBackendForUDI(const QString &udi, const VariantMapMap &interfacesAndProperties)
+{
+    if (udi.isEmpty() || checkMountPath(udi)) {
+        return nullptr;
+    }
+
+    {
+        QReadLocker locker(&s_backendsLock);
+        DeviceBackend *backend = s_backends.value(udi);
+        if (backend) {
+            backend->seedFromManagedObject(interfacesAndProperties);
+            return backend;
+        }
+    }
+
+    DeviceBackend *candidate = new DeviceBackend(udi, &interfacesAndProperties);
+
+    QWriteLocker locker(&s_backendsLock);
+    DeviceBackend *&backend = s_backends[udi];
+    if (!backend) {
+        backend = candidate;
+    } else {
+        candidate->deleteLater();
+        backend->seedFromManagedObject(interfacesAndProperties);
+    }
+
+    return backend;
+}
+
+void DeviceBackend::evictIdleCaches(qint64 maxIdleMsecs)
+{
+    const qint64 cutoff = monotonicMsecs() - maxIdleMsecs;
+
+    /* Holding the registry lock for the sweep keeps destroyBackend() out
+     * until we're done with the pointers; registry-then-cache is the lock
+     * order seedBackendForUDI() already established. */
+    QReadLocker locker(&s_backendsLock);
+    for (DeviceBackend *backend : qAsConst(s_backends)) {
+        if (backend->m_lastAccessMsecs.loadAcquire() > cutoff) {
+            continue;
+        }
+
+        QMutexLocker cacheLocker(&backend->m_cacheLock);
+        if (backend->m_accountedBytes == 0) {
+            continue;
+        }
+        backend->m_propertyCache.clear();
+        backend->m_fetchedInterfaces.clear();
+        backend->m_displayCache.clear();
+        backend->m_queryKnownMask.storeRelease(0);
+        backend->updateAccountingLocked();
+        Solid::Counters::add(Solid::Counters::PropertyCachesEvicted);
+    }
+}
+
+QVariantMap DeviceBackend::diagnostics()
+{
+    int backendObjects = 0;
+    int cachedProperties = 0;
+    int propertyWatches = 0;
+    qint64 propertyCacheBytes = 0;
+
+    QReadLocker locker(&s_backendsLock);
+    for (DeviceBackend *backend : qAsConst(s_backends)) {
+        ++backendObjects;
+        QMutexLocker cacheLocker(&backend->m_cacheLock);
+        cachedProperties += backend->m_propertyCache.count();
+        propertyWatches += backend->m_propertyWatches.count();
+        propertyCacheBytes += backend->m_accountedBytes;
+    }
+
+    QVariantMap state;
+    state.insert(QStringLiteral("backendObjects"), backendObjects);
+    state.insert(QStringLiteral("cachedProperties"), cachedProperties);
+    state.insert(QStringLiteral("propertyWatches"), propertyWatches);
+    state.insert(QStringLiteral("propertyCacheBytes"), propertyCacheBytes);
+    return state;
+}
+
 void DeviceBackend::destroyBackend(const QString &udi)
 {
-    delete s_backends.localData().take(udi);
+    DeviceBackend *backend;
+    {
+        QWriteLocker locker(&s_backendsLock);
+        backend = s_backends.take(udi);
+    }
+
+    if (backend) {
+        /* The backend may live on another thread; deleteLater() is the
+         * thread-safe way to dispose of a QObject. */
+        backend->deleteLater();
+    }
 }
 
 DeviceBackend::DeviceBackend(const QString &udi)
+    : DeviceBackend(udi, nullptr)
+{
+}
+
+/* How long PropertiesChanged signals are merged before one consolidated
+ * change notification goes out; overridable for tuning. */
+static int changeDebounceWindowMs()
+{
+    return Solid::Config::snapshot()->udisks2ChangeDebounceMs;
+}
+
+DeviceBackend::DeviceBackend(const QString &udi, const VariantMapMap *seedData)
     : m_udi(udi)
 {
     if(checkMountPath(udi))
         return;
 
+    /* Counts as an access so a freshly created backend survives until
+     * the next idle window. */
+    touchAccessClock();
+
+    m_changeDebounceTimer.setSingleShot(true);
+    m_changeDebounceTimer.setInterval(changeDebounceWindowMs());
+    connect(&m_changeDebounceTimer, &QTimer::timeout, this, &DeviceBackend::emitPendingChanges);
+
     //qDebug() << "Creating backend for device" << m_udi;
     m_device = new QDBusInterface(UD2_DBUS_SERVICE, m_udi,
                                   QString(), // no interface, we aggregate them
                                   QDBusConnection::systemBus(), this);
 
     if (m_device->isValid()) {
-        QDBusConnection::systemBus().connect(UD2_DBUS_SERVICE, m_udi, DBUS_INTERFACE_PROPS, "PropertiesChanged", this,
-                                             SLOT(slotPropertiesChanged(QString,QVariantMap,QStringList)));
-        QDBusConnection::systemBus().connect(UD2_DBUS_SERVICE, UD2_DBUS_PATH, DBUS_INTERFACE_MANAGER, "InterfacesAdded",
-                                             this, SLOT(slotInterfacesAdded(QDBusObjectPath,VariantMapMap)));
-        QDBusConnection::systemBus().connect(UD2_DBUS_SERVICE, UD2_DBUS_PATH, DBUS_INTERFACE_MANAGER, "InterfacesRemoved",
-                                             this, SLOT(slotInterfacesRemoved(QDBusObjectPath,QStringList)));
+        /* The multiplexer holds the process-wide match rules and routes
+         * the signals for our path back to the slots below. */
+        SignalMultiplexer::instance()->registerBackend(this);
 
-        initInterfaces();
+        if (seedData) {
+            seedFromManagedObject(*seedData);
+        } else {
+            initInterfaces();
+        }
     }
 }
 
 DeviceBackend::~DeviceBackend()
 {
     //qDebug() << "Destroying backend for device" << m_udi;
+    /* The multiplexer is a global static and may already be gone during
+     * application teardown. */
+    if (SignalMultiplexer *multiplexer = SignalMultiplexer::instance()) {
+        multiplexer->unregisterBackend(this);
+    }
+
+    Solid::Counters::add(Solid::Counters::PropertyCacheBytes, -m_accountedBytes);
+}
+
+void DeviceBackend::updateAccountingLocked() const
+{
+    const qint64 total = mapFootprint(m_propertyCache) + mapFootprint(m_displayCache);
+    if (total != m_accountedBytes) {
+        Solid::Counters::add(Solid::Counters::PropertyCacheBytes, total - m_accountedBytes);
+        m_accountedBytes = total;
+    }
+}
+
+void DeviceBackend::touchAccessClock() const
+{
+    m_lastAccessMsecs.storeRelease(monotonicMsecs());
 }
 
 void DeviceBackend::initInterfaces()
@@ -98,24 +458,93 @@ void DeviceBackend::initInterfaces()
         return;
     }
 
-    QDomDocument dom;
-    dom.setContent(xmlData);
-
-    QDomNodeList ifaceNodeList = dom.elementsByTagName("interface");
-    for (int i = 0; i < ifaceNodeList.count(); i++) {
-        QDomElement ifaceElem = ifaceNodeList.item(i).toElement();
+    /* Pull the interface names out of the stream directly instead of
+     * building a DOM tree for a document we look at exactly once. */
+    QXmlStreamReader xml(xmlData);
+    while (!xml.atEnd()) {
+        if (xml.readNext() != QXmlStreamReader::StartElement) {
+            continue;
+        }
+        if (xml.name() != QLatin1String("interface")) {
+            continue;
+        }
         /* Accept only org.freedesktop.UDisks2.* interfaces so that when the device is unplugged,
          * m_interfaces goes empty and we can easily verify that the device is gone. */
-        if (!ifaceElem.isNull() && ifaceElem.attribute("name").startsWith(UD2_DBUS_SERVICE)) {
-            m_interfaces.append(ifaceElem.attribute("name"));
+        const QString name = xml.attributes().value(QLatin1String("name")).toString();
+        if (name.startsWith(UD2_DBUS_SERVICE)) {
+            m_interfaces.append(name);
         }
     }
 
     //qDebug() << m_udi << "has interfaces:" << m_interfaces;
+    updateInterfaceMask();
+}
+
+void DeviceBackend::updateInterfaceMask()
+{
+    static const struct {
+        QLatin1String name;
+        InterfaceBit bit;
+    } knownInterfaces[] = {
+        { QLatin1String(UD2_DBUS_INTERFACE_BLOCK), BlockInterface },
+        { QLatin1String(UD2_DBUS_INTERFACE_DRIVE), DriveInterface },
+        { QLatin1String(UD2_DBUS_INTERFACE_FILESYSTEM), FilesystemInterface },
+        { QLatin1String(UD2_DBUS_INTERFACE_ENCRYPTED), EncryptedInterface },
+        { QLatin1String(UD2_DBUS_INTERFACE_PARTITION), PartitionInterface },
+        { QLatin1String(UD2_DBUS_INTERFACE_PARTITIONTABLE), PartitionTableInterface },
+        { QLatin1String(UD2_DBUS_INTERFACE_LOOP), LoopInterface },
+        { QLatin1String(UD2_DBUS_INTERFACE_SWAP), SwapInterface },
+    };
+
+    int mask = 0;
+    for (const QString &iface : qAsConst(m_interfaces)) {
+        for (const auto &known : knownInterfaces) {
+            if (iface == known.name) {
+                mask |= known.bit;
+                break;
+            }
+        }
+    }
+    m_interfaceMask.storeRelease(mask);
+    m_queryKnownMask.storeRelease(0);
+}
+
+void DeviceBackend::seedFromManagedObject(const VariantMapMap &interfacesAndProperties)
+{
+    QMutexLocker locker(&m_cacheLock);
+
+    m_interfaces.clear();
+    m_displayCache.clear();
+
+    for (auto it = interfacesAndProperties.cbegin(); it != interfacesAndProperties.cend(); ++it) {
+        /* Accept only org.freedesktop.UDisks2.* interfaces so that when the device is unplugged,
+         * m_interfaces goes empty and we can easily verify that the device is gone. */
+        if (!it.key().startsWith(UD2_DBUS_SERVICE)) {
+            continue;
+        }
+
+        m_interfaces.append(it.key());
+
+        if (m_propertyCache.isEmpty()) {
+            // the first interface's map is adopted wholesale; the pooling
+            // pass only detaches entries whose values dedup elsewhere
+            m_propertyCache = it.value();
+            internStringProperties(&m_propertyCache);
+        } else {
+            const QVariantMap &props = it.value();
+            for (auto propIt = props.cbegin(); propIt != props.cend(); ++propIt) {
+                m_propertyCache.insert(propIt.key(), Solid::StringPool::internVariant(propIt.value()));
+            }
+        }
+        m_fetchedInterfaces.insert(it.key());
+    }
+    updateInterfaceMask();
+    updateAccountingLocked();
 }
 
 QStringList DeviceBackend::interfaces() const
 {
+    QMutexLocker locker(&m_cacheLock);
     return m_interfaces;
 }
 
@@ -126,12 +555,16 @@ const QString &DeviceBackend::udi() const
 
 QVariant DeviceBackend::prop(const QString &key) const
 {
+    touchAccessClock();
+    QMutexLocker locker(&m_cacheLock);
     checkCache(key);
     return m_propertyCache.value(key);
 }
 
 bool DeviceBackend::propertyExists(const QString &key) const
 {
+    touchAccessClock();
+    QMutexLocker locker(&m_cacheLock);
     checkCache(key);
     /* checkCache() will put an invalid QVariant in cache when the property
      * does not exist, so check for validity, not for an actual presence. */
@@ -140,52 +573,168 @@ bool DeviceBackend::propertyExists(const QString &key) const
 
 QVariantMap DeviceBackend::allProperties() const
 {
-    QDBusMessage call = QDBusMessage::createMethodCall(UD2_DBUS_SERVICE, m_udi, DBUS_INTERFACE_PROPS, "GetAll");
+    touchAccessClock();
+    QMutexLocker locker(&m_cacheLock);
+    return allPropertiesLocked();
+}
+
+/* Warms the cache with one GetAll per requested interface which the cache
+ * doesn't cover yet, so a subsequent series of prop() calls is answered
+ * without falling back to one Get round trip per missing key. Interfaces
+ * the device doesn't advertise are skipped. */
+void DeviceBackend::prefetchProperties(const QStringList &interfaces) const
+{
+    touchAccessClock();
+    QMutexLocker locker(&m_cacheLock);
+
+    QStringList wanted;
+    for (const QString &iface : interfaces) {
+        if (m_interfaces.contains(iface) && !m_fetchedInterfaces.contains(iface)) {
+            wanted.append(iface);
+        }
+    }
+
+    fetchPropertiesLocked(wanted);
+}
 
+/* Called with m_cacheLock held */
+QVariantMap DeviceBackend::allPropertiesLocked() const
+{
+    /* Only interfaces the cache doesn't cover yet go on the wire. Once
+     * everything is fetched, this returns the cache itself: QVariantMap is
+     * implicitly shared, so the caller gets a refcount bump instead of a
+     * deep copy, and the snapshot stays valid when a later property change
+     * detaches the cache from it. */
+    QStringList missing;
     for (const QString &iface : qAsConst(m_interfaces)) {
+        if (!m_fetchedInterfaces.contains(iface)) {
+            missing.append(iface);
+        }
+    }
+    if (!missing.isEmpty()) {
+        fetchPropertiesLocked(missing);
+    }
+    return m_propertyCache;
+}
+
+/* Called with m_cacheLock held */
+void DeviceBackend::fetchPropertiesLocked(const QStringList &interfaces) const
+{
+    if (ServiceHealth::instance()->isTripped()) {
+        /* The daemon is hung; serve whatever the cache holds instead of
+         * blocking the caller for one D-Bus timeout per interface. */
+        return;
+    }
+
+    QDBusMessage call = QDBusMessage::createMethodCall(UD2_DBUS_SERVICE, m_udi, DBUS_INTERFACE_PROPS, "GetAll");
+
+    /* One GetAll per interface, registered into a completion group: the
+     * calls all go on the wire before the barrier, and the group slots
+     * stay parallel to the interface list. */
+    PendingCallGroup group;
+    group.reserve(interfaces.size());
+    /* Property reads run on the short timeout tier: the callers block
+     * UI paints, and an expired read degrades to the cache below while
+     * the breaker tracks whether the daemon is actually hung. */
+    const int timeout = ServiceHealth::propertyCallTimeout();
+    for (const QString &iface : interfaces) {
         call.setArguments(QVariantList() << iface);
-        QDBusPendingReply<QVariantMap> reply = QDBusConnection::systemBus().call(call);
+        group.add(QDBusConnection::systemBus().asyncCall(call, timeout));
+    }
+    Solid::Counters::add(Solid::Counters::DBusCallsIssued, group.count());
+    group.waitForAllFinished();
+
+    for (int slot = 0; slot < group.count(); ++slot) {
+        QDBusPendingReply<QVariantMap> reply(group.callAt(slot));
 
         if (reply.isValid()) {
-            auto props = reply.value();
-            // Can not use QMap<>::unite(), as it allows multiple values per key
-            for (auto it = props.cbegin(); it != props.cend(); ++it) {
-                m_propertyCache.insert(it.key(), it.value());
+            QVariantMap props = reply.value();
+            if (m_propertyCache.isEmpty()) {
+                // adopt the freshly demarshalled map wholesale instead of
+                // copying it over element by element
+                m_propertyCache = std::move(props);
+                internStringProperties(&m_propertyCache);
+            } else {
+                // Can not use QMap<>::unite(), as it allows multiple values per key
+                for (auto it = props.cbegin(); it != props.cend(); ++it) {
+                    m_propertyCache.insert(it.key(), Solid::StringPool::internVariant(it.value()));
+                }
             }
+            m_fetchedInterfaces.insert(interfaces.at(slot));
+            ServiceHealth::instance()->recordSuccess();
         } else {
             qCWarning(UDISKS2) << "Error getting props:" << reply.error().name() << reply.error().message();
+            if (ServiceHealth::isTimeoutError(reply.error())) {
+                ServiceHealth::instance()->recordTimeout();
+            }
         }
-        //qDebug() << "After iface" << iface << ", cache now contains" << m_propertyCache.size() << "items";
+        //qDebug() << "After iface" << interfaces.at(slot) << ", cache now contains" << m_propertyCache.size() << "items";
     }
-
-    return m_propertyCache;
+    updateAccountingLocked();
 }
 
 void DeviceBackend::invalidateProperties()
 {
+    QMutexLocker locker(&m_cacheLock);
     m_propertyCache.clear();
+    m_fetchedInterfaces.clear();
+    m_displayCache.clear();
+    m_queryKnownMask.storeRelease(0);
+    updateAccountingLocked();
+}
+
+QVariant DeviceBackend::cachedDisplayValue(const QString &key) const
+{
+    touchAccessClock();
+    QMutexLocker locker(&m_cacheLock);
+    return m_displayCache.value(key);
+}
+
+void DeviceBackend::setCachedDisplayValue(const QString &key, const QVariant &value)
+{
+    QMutexLocker locker(&m_cacheLock);
+    m_displayCache.insert(key, value);
+    updateAccountingLocked();
 }
 
 QString DeviceBackend::introspect() const
 {
+    if (ServiceHealth::instance()->isTripped()) {
+        return QString();
+    }
+
     QDBusMessage call = QDBusMessage::createMethodCall(UD2_DBUS_SERVICE, m_udi,
                         DBUS_INTERFACE_INTROSPECT, "Introspect");
-    QDBusPendingReply<QString> reply = QDBusConnection::systemBus().call(call);
+    QDBusPendingReply<QString> reply = QDBusConnection::systemBus().call(call, QDBus::Block,
+                                                                       ServiceHealth::propertyCallTimeout());
 
     if (reply.isValid()) {
+        ServiceHealth::instance()->recordSuccess();
         return reply.value();
     } else {
+        if (ServiceHealth::isTimeoutError(reply.error())) {
+            ServiceHealth::instance()->recordTimeout();
+        }
         return QString();
     }
 }
 
+/* Called with m_cacheLock held */
 void DeviceBackend::checkCache(const QString &key) const
 {
     if (m_propertyCache.isEmpty()) { // recreate the cache
-        allProperties();
+        allPropertiesLocked();
     }
 
     if (m_propertyCache.contains(key)) {
+        Solid::Counters::add(Solid::Counters::PropertyCacheHits);
+        return;
+    }
+    Solid::Counters::add(Solid::Counters::PropertyCacheMisses);
+
+    if (ServiceHealth::instance()->isTripped()) {
+        /* Don't block and don't cache anything either: once the daemon
+         * answers again the next lookup resolves the property. */
         return;
     }
 
@@ -196,12 +745,23 @@ void DeviceBackend::checkCache(const QString &key) const
      * This matches what QDBusAbstractInterface would do
      */
     call.setArguments(QVariantList() << QString() << key);
-    QDBusPendingReply<QVariant> reply = QDBusConnection::systemBus().call(call);
+    Solid::Counters::add(Solid::Counters::DBusCallsIssued);
+    QDBusPendingReply<QVariant> reply = QDBusConnection::systemBus().call(call, QDBus::Block,
+                                                                          ServiceHealth::propertyCallTimeout());
+
+    if (reply.isError() && ServiceHealth::isTimeoutError(reply.error())) {
+        /* A timeout says nothing about the property; caching it as
+         * absent would outlive the hang. */
+        ServiceHealth::instance()->recordTimeout();
+        return;
+    }
+    ServiceHealth::instance()->recordSuccess();
 
     /* We don't check for error here and store the item in the cache anyway so next time we don't have to
      * do the DBus call to find out it does not exist but just check whether
      * prop(key).isValid() */
-    m_propertyCache.insert(key, reply.value());
+    m_propertyCache.insert(key, Solid::StringPool::internVariant(reply.value()));
+    updateAccountingLocked();
 }
 
 void DeviceBackend::slotPropertiesChanged(const QString &ifaceName, const QVariantMap &changedProps, const QStringList &invalidatedProps)
@@ -209,26 +769,114 @@ void DeviceBackend::slotPropertiesChanged(const QString &ifaceName, const QVaria
     if (!ifaceName.startsWith(UD2_DBUS_SERVICE)) {
         return;
     }
+
+    SOLID_TRACE_TIMER(traceTimer);
     //qDebug() << m_udi << "'s interface" << ifaceName << "changed props:";
 
+    {
+        QMutexLocker locker(&m_cacheLock);
+
+        for (const QString &key : invalidatedProps) {
+            m_propertyCache.remove(key);
+            m_pendingChangeMap.insert(key, Solid::GenericInterface::PropertyModified);
+            m_pendingValueMap.insert(key, QVariant());
+            //qDebug() << "\t invalidated:" << key;
+        }
+
+        QMapIterator<QString, QVariant> i(changedProps);
+        while (i.hasNext()) {
+            i.next();
+            const QString key = i.key();
+            const QVariant value = Solid::StringPool::internVariant(i.value());
+            m_propertyCache.insert(key, value);  // replace the value
+            m_pendingChangeMap.insert(key, Solid::GenericInterface::PropertyModified);
+            m_pendingValueMap.insert(key, value);
+            //qDebug() << "\t modified:" << key << ":" << m_propertyCache.value(key);
+        }
+
+        if (!m_pendingChangeMap.isEmpty()) {
+            m_displayCache.clear();
+            /* property-derived verdicts (optical media presence, mount
+             * blacklisting by filesystem type) may have changed with them */
+            m_queryKnownMask.storeRelease(0);
+            updateAccountingLocked();
+        }
+    }
+
+    /* The cache is up to date immediately; only the fan-out to listeners
+     * is debounced. During a signal storm (mkfs, partition probing) the
+     * changes merge into one notification per window. The timer is not
+     * restarted while active so a continuous storm can't postpone
+     * delivery forever. */
+    if (!m_changeDebounceTimer.isActive()) {
+        m_changeDebounceTimer.start();
+    }
+
+    SOLID_PROBE3(udisks2_properties_changed, qPrintable(m_udi), changedProps.count() + invalidatedProps.count(), SOLID_TRACE_NSECS(traceTimer));
+}
+
+void DeviceBackend::addPropertyWatch(QObject *receiver, const char *member, const QSet<QString> &properties)
+{
+    QMutexLocker locker(&m_cacheLock);
+    m_propertyWatches.append({receiver, member, properties});
+}
+
+void DeviceBackend::removePropertyWatch(QObject *receiver)
+{
+    QMutexLocker locker(&m_cacheLock);
+    for (int i = m_propertyWatches.size() - 1; i >= 0; --i) {
+        if (m_propertyWatches.at(i).receiver.data() == receiver) {
+            m_propertyWatches.removeAt(i);
+        }
+    }
+}
+
+void DeviceBackend::emitPendingChanges()
+{
+    /* Swap the accumulated payloads into locals and emit those: after the
+     * swap nothing writes to the emitted maps anymore, so the queued
+     * deliveries to every per-thread listener share the one allocation
+     * (implicit sharing) instead of each detaching a deep copy. */
     QMap<QString, int> changeMap;
+    QVariantMap valueMap;
+    {
+        QMutexLocker locker(&m_cacheLock);
+        changeMap.swap(m_pendingChangeMap);
+        valueMap.swap(m_pendingValueMap);
+
+        /* Filtered subscriptions are resolved here, before anything is
+         * queued: a subscriber whose properties didn't change gets no
+         * event and therefore no wakeup. Posting under the lock runs no
+         * receiver code (the invocation is always queued), and keeps the
+         * delivery mutually exclusive with removePropertyWatch(). */
+        for (int i = m_propertyWatches.size() - 1; i >= 0; --i) {
+            const PropertyWatch &watch = m_propertyWatches.at(i);
+            QObject *receiver = watch.receiver.data();
+            if (receiver == nullptr) {
+                m_propertyWatches.removeAt(i);
+                continue;
+            }
 
-    for (const QString &key : invalidatedProps) {
-        m_propertyCache.remove(key);
-        changeMap.insert(key, Solid::GenericInterface::PropertyModified);
-        //qDebug() << "\t invalidated:" << key;
+            QVariantMap interesting;
+            for (const QString &key : watch.properties) {
+                const auto value = valueMap.constFind(key);
+                if (value != valueMap.constEnd()) {
+                    interesting.insert(key, value.value());
+                }
+            }
+            if (!interesting.isEmpty()) {
+                QMetaObject::invokeMethod(receiver, watch.member.constData(), Qt::QueuedConnection,
+                                          Q_ARG(QVariantMap, interesting));
+            }
+        }
     }
 
-    QMapIterator<QString, QVariant> i(changedProps);
-    while (i.hasNext()) {
-        i.next();
-        const QString key = i.key();
-        m_propertyCache.insert(key, i.value());  // replace the value
-        changeMap.insert(key, Solid::GenericInterface::PropertyModified);
-        //qDebug() << "\t modified:" << key << ":" << m_propertyCache.value(key);
+    if (changeMap.isEmpty()) {
+        return;
     }
 
     Q_EMIT propertyChanged(changeMap);
+    Q_EMIT propertyValuesChanged(valueMap);
     Q_EMIT changed();
 }
 
@@ -238,6 +886,7 @@ void DeviceBackend::slotInterfacesAdded(const QDBusObjectPath &object_path, cons
         return;
     }
 
+    QMutexLocker locker(&m_cacheLock);
     for (auto it = interfaces_and_properties.cbegin(); it != interfaces_and_properties.cend(); ++it) {
         const QString &iface = it.key();
         /* Don't store generic DBus interfaces */
@@ -245,6 +894,8 @@ void DeviceBackend::slotInterfacesAdded(const QDBusObjectPath &object_path, cons
             m_interfaces.append(iface);
         }
     }
+    updateInterfaceMask();
+    m_displayCache.clear();
 }
 
 void DeviceBackend::slotInterfacesRemoved(const QDBusObjectPath &object_path, const QStringList &interfaces)
@@ -253,13 +904,19 @@ void DeviceBackend::slotInterfacesRemoved(const QDBusObjectPath &object_path, co
         return;
     }
 
+    QMutexLocker locker(&m_cacheLock);
+
     for (const QString &iface : interfaces) {
         m_interfaces.removeAll(iface);
     }
+    updateInterfaceMask();
 
     // We don't know which property belongs to which interface, so remove all
     m_propertyCache.clear();
+    m_fetchedInterfaces.clear();
+    m_displayCache.clear();
     if (!m_interfaces.isEmpty()) {
-        allProperties();
+        allPropertiesLocked();
     }
+    updateAccountingLocked();
 }
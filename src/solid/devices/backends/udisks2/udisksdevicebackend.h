@@ -10,11 +10,18 @@
 #ifndef UDISKSDEVICEBACKEND_H
 #define UDISKSDEVICEBACKEND_H
 
+#include <QAtomicInteger>
 #include <QObject>
 #include <QDBusObjectPath>
 #include <QDBusInterface>
+#include <QHash>
+#include <QMutex>
+#include <QPointer>
+#include <QReadWriteLock>
+#include <QSet>
 #include <QStringList>
-#include <QThreadStorage>
+#include <QTimer>
+#include <QVector>
 
 #include "udisks2.h"
 
@@ -32,41 +39,183 @@ class DeviceBackend: public QObject
 
 public:
     static DeviceBackend *backendForUDI(const QString &udi, bool create = true);
+    static DeviceBackend *seedBackendForUDI(const QString &udi, const VariantMapMap &interfacesAndProperties);
     static void destroyBackend(const QString &udi);
 
+    /* Drops the property and display caches of every backend nobody
+     * consulted for maxIdleMsecs. The backends themselves stay registered
+     * (they are cheap once emptied, and handing out a destroyed one would
+     * be worse); the next lookup refetches. The freed bytes come off the
+     * PropertyCacheBytes counter, so long-running processes don't keep
+     * megabytes of properties for devices that left days ago. */
+    static void evictIdleCaches(qint64 maxIdleMsecs);
+
+    /* Totals over every registered backend — object count, cached
+     * properties and their estimated bytes, filtered change
+     * subscriptions — for the manager's diagnosticState() report. */
+    static QVariantMap diagnostics();
+
+    /* The mount-blacklist ruleset can also match on filesystem type and
+     * connection bus; those rules are evaluated where the properties are
+     * known instead of on the UDI-only lookup path. hasMountPropertyRules()
+     * is a single atomic load, so callers can skip fetching the properties
+     * entirely when the file doesn't use such rules. */
+    static bool hasMountPropertyRules();
+    static bool isMountBlockedByRules(const QString &fstype, const QString &bus);
+
     DeviceBackend(const QString &udi);
     ~DeviceBackend();
 
+    /* Bits for the UDisks2 interfaces the backend recognizes, kept in sync
+     * with m_interfaces so interface-support checks are a single mask test
+     * instead of a string-list scan; queryDeviceInterface runs for every
+     * device on every listFromType. */
+    enum InterfaceBit {
+        BlockInterface = 0x01,
+        DriveInterface = 0x02,
+        FilesystemInterface = 0x04,
+        EncryptedInterface = 0x08,
+        PartitionInterface = 0x10,
+        PartitionTableInterface = 0x20,
+        LoopInterface = 0x40,
+        SwapInterface = 0x80,
+    };
+
+    bool hasInterface(InterfaceBit bit) const
+    {
+        return m_interfaceMask.loadAcquire() & bit;
+    }
+
+    /* Memoized queryDeviceInterface verdicts by Solid device interface
+     * type, negatives included: predicate evaluation asks hundreds of
+     * non-storage devices for StorageAccess per query, and re-deriving
+     * the "no" costs the same property probing as a "yes". Bit
+     * (1 << type) in the known mask says a verdict is cached, the same
+     * bit in the result mask carries it. Cleared whenever the exported
+     * interfaces or the properties change. */
+    bool cachedQueryResult(int type, bool *result) const
+    {
+        if (type < 0 || type >= 32) {
+            return false;
+        }
+        const int bit = 1 << type;
+        if (!(m_queryKnownMask.loadAcquire() & bit)) {
+            return false;
+        }
+        *result = m_queryResultMask.loadAcquire() & bit;
+        return true;
+    }
+
+    void cacheQueryResult(int type, bool result) const
+    {
+        if (type < 0 || type >= 32) {
+            return;
+        }
+        const int bit = 1 << type;
+        if (result) {
+            m_queryResultMask.fetchAndOrRelease(bit);
+        } else {
+            m_queryResultMask.fetchAndAndRelease(~bit);
+        }
+        m_queryKnownMask.fetchAndOrRelease(bit);
+    }
+
     QVariant prop(const QString &key) const;
     bool propertyExists(const QString &key) const;
     QVariantMap allProperties() const;
+    void prefetchProperties(const QStringList &interfaces) const;
+
+    QVariant cachedDisplayValue(const QString &key) const;
+    void setCachedDisplayValue(const QString &key, const QVariant &value);
 
     QStringList interfaces() const;
     const QString &udi() const;
 
+    /* Filtered change subscriptions, evaluated where the
+     * PropertiesChanged payloads are demultiplexed: a receiver whose
+     * watched properties didn't change gets no event queued to its
+     * thread at all. The receiver's @p member must be an invokable
+     * taking a QVariantMap; it is invoked (always queued) with only the
+     * watched properties present, invalidated ones as invalid
+     * QVariants. Registration and delivery share m_cacheLock, so
+     * removing the watch before destroying the receiver is a clean
+     * cut-off. */
+    void addPropertyWatch(QObject *receiver, const char *member, const QSet<QString> &properties);
+    void removePropertyWatch(QObject *receiver);
+
     void invalidateProperties();
 Q_SIGNALS:
     void propertyChanged(const QMap<QString, int> &changeMap);
+    void propertyValuesChanged(const QVariantMap &changedValues);
     void changed();
 
 private Q_SLOTS:
     void slotInterfacesAdded(const QDBusObjectPath &object_path, const VariantMapMap &interfaces_and_properties);
     void slotInterfacesRemoved(const QDBusObjectPath &object_path, const QStringList &interfaces);
     void slotPropertiesChanged(const QString &ifaceName, const QVariantMap &changedProps, const QStringList &invalidatedProps);
+    void emitPendingChanges();
 
 private:
+    DeviceBackend(const QString &udi, const VariantMapMap *seedData);
+
     void initInterfaces();
+    void seedFromManagedObject(const VariantMapMap &interfacesAndProperties);
+    void updateInterfaceMask();
+    /* Re-estimates the bytes held by m_propertyCache and m_displayCache
+     * and posts the delta to the PropertyCacheBytes counter; called with
+     * m_cacheLock held wherever the caches change in bulk. */
+    void updateAccountingLocked() const;
+    void touchAccessClock() const;
     QString introspect() const;
+    QVariantMap allPropertiesLocked() const;
+    void fetchPropertiesLocked(const QStringList &interfaces) const;
     void checkCache(const QString &key) const;
     static bool checkMountPath(QString udi);
 
     QDBusInterface *m_device;
 
+    /* Guards m_propertyCache and m_interfaces; the backend is shared
+     * between threads while the D-Bus slots run on its owning thread. */
+    mutable QMutex m_cacheLock;
     mutable QVariantMap m_propertyCache;
+    mutable QSet<QString> m_fetchedInterfaces;
+    /* Memoized presentation values (description/icon/emblems) computed by
+     * Device; invalidated together with the property cache. */
+    QHash<QString, QVariant> m_displayCache;
     QStringList m_interfaces;
+    /* Derived from m_interfaces by updateInterfaceMask(); atomic so the
+     * bit test doesn't need the cache lock. */
+    QAtomicInteger<int> m_interfaceMask;
+    /* See cachedQueryResult(); writing the result bit before the known
+     * bit keeps concurrent readers from seeing an unset verdict. */
+    mutable QAtomicInteger<int> m_queryKnownMask;
+    mutable QAtomicInteger<int> m_queryResultMask;
+    /* Bytes this backend currently contributes to PropertyCacheBytes;
+     * guarded by m_cacheLock like the caches it accounts for. */
+    mutable qint64 m_accountedBytes = 0;
+    /* Monotonic stamp of the last cache consultation, read lock-free by
+     * the idle sweep; see evictIdleCaches(). */
+    mutable QAtomicInteger<qint64> m_lastAccessMsecs;
     QString m_udi;
 
-    static QThreadStorage<QMap<QString, DeviceBackend *>> s_backends;
+    /* Changes accumulated while the debounce timer runs; guarded by
+     * m_cacheLock like the property cache it mirrors. */
+    QMap<QString, int> m_pendingChangeMap;
+    /* New values from the PropertiesChanged payloads for the same keys;
+     * invalidated properties are carried as invalid QVariants. */
+    QVariantMap m_pendingValueMap;
+    QTimer m_changeDebounceTimer;
+
+    /* See addPropertyWatch(); guarded by m_cacheLock. */
+    struct PropertyWatch {
+        QPointer<QObject> receiver;
+        QByteArray member;
+        QSet<QString> properties;
+    };
+    QVector<PropertyWatch> m_propertyWatches;
+
+    static QHash<QString, DeviceBackend *> s_backends;
+    static QReadWriteLock s_backendsLock;
 
 };
 
@@ -8,6 +8,7 @@
 #include "udisksgenericinterface.h"
 
 #include "udisksdevice.h"
+#include "udisksdevicebackend.h"
 
 using namespace Solid::Backends::UDisks2;
 
@@ -16,6 +17,8 @@ GenericInterface::GenericInterface(Device *device)
 {
     connect(device, SIGNAL(propertyChanged(QMap<QString,int>)),
             this, SIGNAL(propertyChanged(QMap<QString,int>)));
+    connect(device, SIGNAL(propertyValuesChanged(QVariantMap)),
+            this, SIGNAL(propertyValuesChanged(QVariantMap)));
 }
 
 GenericInterface::~GenericInterface()
@@ -37,3 +40,25 @@ bool GenericInterface::propertyExists(const QString &key) const
     return m_device->propertyExists(key);
 }
 
+bool GenericInterface::watchProperties(const QSet<QString> &properties, QObject *receiver, const char *member)
+{
+    /* The shared DeviceBackend is where the PropertiesChanged payloads
+     * are demultiplexed; registering the filter there means changes
+     * touching none of the watched properties are dropped before any
+     * event is queued to the receiver's thread. */
+    DeviceBackend *backend = DeviceBackend::backendForUDI(m_device->udi());
+    if (backend == nullptr) {
+        return false;
+    }
+    backend->addPropertyWatch(receiver, member, properties);
+    return true;
+}
+
+void GenericInterface::unwatchProperties(QObject *receiver)
+{
+    DeviceBackend *backend = DeviceBackend::backendForUDI(m_device->udi(), false);
+    if (backend) {
+        backend->removePropertyWatch(receiver);
+    }
+}
+
@@ -32,8 +32,12 @@ public:
     QVariantMap allProperties() const override;
     bool propertyExists(const QString &key) const override;
 
+    bool watchProperties(const QSet<QString> &properties, QObject *receiver, const char *member) override;
+    void unwatchProperties(QObject *receiver) override;
+
 Q_SIGNALS:
     void propertyChanged(const QMap<QString, int> &changes) override;
+    void propertyValuesChanged(const QVariantMap &changedValues) override;
     void conditionRaised(const QString &condition, const QString &reason) override;
 };
 }
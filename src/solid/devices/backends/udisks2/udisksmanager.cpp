@@ -6,19 +6,30 @@
 
 #include "udisksmanager.h"
 #include "udisksdevicebackend.h"
+#include "udisksmultiplexer.h"
+#include "udisksservicehealth.h"
 #include "udisks_debug.h"
 
 #include <QDBusConnection>
 #include <QDBusObjectPath>
 #include <QDBusMetaType>
 #include <QDBusConnectionInterface>
-#include <QDomDocument>
+#include <QDBusPendingCallWatcher>
 
 #include "../shared/rootdevice.h"
+#include "solidconfig_p.h"
 
 using namespace Solid::Backends::UDisks2;
 using namespace Solid::Backends::Shared;
 
+/* How long a vanished udisksd may take to come back before the stale
+ * device cache is torn down; overridable for tuning. A daemon restart
+ * usually re-registers the name within a second or two. */
+static int serviceGraceMs()
+{
+    return Solid::Config::snapshot()->udisks2ServiceGraceMs;
+}
+
 Manager::Manager(QObject *parent)
     : Solid::Ifaces::DeviceManager(parent),
       m_manager(UD2_DBUS_SERVICE,
@@ -39,35 +50,70 @@ Manager::Manager(QObject *parent)
     qDBusRegisterMetaType<VariantMapMap>();
     qDBusRegisterMetaType<DBUSManagerStruct>();
 
-    bool serviceFound = m_manager.isValid();
-    if (!serviceFound) {
-        // find out whether it will be activated automatically
+    /* Touch the multiplexer here so its match rules live on the thread of
+     * the first manager instead of whichever worker thread happens to
+     * construct the first DeviceBackend. */
+    SignalMultiplexer::instance();
+
+    connect(&m_manager, SIGNAL(InterfacesAdded(QDBusObjectPath,VariantMapMap)),
+            this, SLOT(slotInterfacesAdded(QDBusObjectPath,VariantMapMap)));
+    connect(&m_manager, SIGNAL(InterfacesRemoved(QDBusObjectPath,QStringList)),
+            this, SLOT(slotInterfacesRemoved(QDBusObjectPath,QStringList)));
+
+    m_serviceWatcher = new QDBusServiceWatcher(UD2_DBUS_SERVICE, QDBusConnection::systemBus(),
+                                               QDBusServiceWatcher::WatchForRegistration
+                                               | QDBusServiceWatcher::WatchForUnregistration, this);
+    connect(m_serviceWatcher, &QDBusServiceWatcher::serviceRegistered,
+            this, &Manager::slotServiceRegistered);
+    connect(m_serviceWatcher, &QDBusServiceWatcher::serviceUnregistered,
+            this, &Manager::slotServiceUnregistered);
+
+    m_cacheStale = false;
+    m_revalidation = nullptr;
+    m_serviceGraceTimer.setSingleShot(true);
+    m_serviceGraceTimer.setInterval(serviceGraceMs());
+    connect(&m_serviceGraceTimer, &QTimer::timeout,
+            this, &Manager::slotServiceGraceExpired);
+
+    /* Periodically drop property caches nobody consulted for a whole
+     * sweep interval; see DeviceBackend::evictIdleCaches(). */
+    const int idleEvictMs = Solid::Config::snapshot()->udisks2CacheIdleEvictMs;
+    if (idleEvictMs > 0) {
+        m_cacheSweepTimer.setInterval(idleEvictMs);
+        connect(&m_cacheSweepTimer, &QTimer::timeout, this, []() {
+            DeviceBackend::evictIdleCaches(Solid::Config::snapshot()->udisks2CacheIdleEvictMs);
+        });
+        m_cacheSweepTimer.start();
+    }
+
+    m_serviceAvailable = m_manager.isValid();
+    if (!m_serviceAvailable) {
+        /* Ask the bus to activate the daemon without blocking on it; the
+         * service watcher announces the devices once (and if) the name
+         * appears, so startup isn't serialized behind udisksd activation.
+         * If the service is not activatable the call simply errors out. */
         QDBusMessage message = QDBusMessage::createMethodCall("org.freedesktop.DBus",
                                "/org/freedesktop/DBus",
                                "org.freedesktop.DBus",
-                               "ListActivatableNames");
-
-        QDBusReply<QStringList> reply = QDBusConnection::systemBus().call(message);
-        if (reply.isValid() && reply.value().contains(UD2_DBUS_SERVICE)) {
-            QDBusConnection::systemBus().interface()->startService(UD2_DBUS_SERVICE);
-            serviceFound = true;
-        }
-    }
-
-    if (serviceFound) {
-        connect(&m_manager, SIGNAL(InterfacesAdded(QDBusObjectPath,VariantMapMap)),
-                this, SLOT(slotInterfacesAdded(QDBusObjectPath,VariantMapMap)));
-        connect(&m_manager, SIGNAL(InterfacesRemoved(QDBusObjectPath,QStringList)),
-                this, SLOT(slotInterfacesRemoved(QDBusObjectPath,QStringList)));
+                               "StartServiceByName");
+        message << UD2_DBUS_SERVICE << 0u;
+        QDBusConnection::systemBus().asyncCall(message);
     }
 }
 
 Manager::~Manager()
 {
-    while (!m_deviceCache.isEmpty()) {
-        QString udi = m_deviceCache.takeFirst();
+    /* Guard against static destruction order: the multiplexer singleton
+     * may already be gone when the application tears down. */
+    if (SignalMultiplexer *multiplexer = SignalMultiplexer::instance()) {
+        multiplexer->unregisterMediaWatches(this);
+    }
+
+    const QStringList udis = m_deviceCache.toList();
+    for (const QString &udi : udis) {
         DeviceBackend::destroyBackend(udi);
     }
+    m_deviceCache.clear();
 }
 
 QObject *Manager::createDevice(const QString &udi)
@@ -117,45 +163,100 @@ QStringList Manager::devicesFromQuery(const QString &parentUdi, Solid::DeviceInt
 
 QStringList Manager::allDevices()
 {
+    if (m_cacheStale) {
+        /* Stale-while-revalidate: answer from the last known list and
+         * reconcile against the daemon in the background instead of
+         * stalling the query on a synchronous rebuild. */
+        if (m_serviceAvailable) {
+            revalidateDeviceCache();
+        }
+        return m_deviceCache.toList();
+    }
+
     m_deviceCache.clear();
 
-    introspect("/org/freedesktop/UDisks2/block_devices", true /*checkOptical*/);
-    introspect("/org/freedesktop/UDisks2/drives");
+    if (!m_serviceAvailable) {
+        return m_deviceCache.toList();
+    }
+
+    /* One GetManagedObjects round trip replaces the former Introspect call
+     * per object path: it returns every object together with its interfaces
+     * and properties, so the device backends get their caches seeded for
+     * free and don't have to introspect or GetAll on their own. */
+    QDBusPendingReply<DBUSManagerStruct> reply = m_manager.GetManagedObjects();
+    reply.waitForFinished();
+
+    if (!reply.isValid()) {
+        qCWarning(UDISKS2) << "Failed enumerating UDisks2 objects:" << reply.error().name() << "\n" << reply.error().message();
+        return m_deviceCache.toList();
+    }
+
+    populateDeviceCache(reply.value());
 
-    return m_deviceCache;
+    return m_deviceCache.toList();
 }
 
-void Manager::introspect(const QString &path, bool checkOptical)
+void Manager::populateDeviceCache(const DBUSManagerStruct &managedObjects)
 {
-    QDBusMessage call = QDBusMessage::createMethodCall(UD2_DBUS_SERVICE, path,
-                        DBUS_INTERFACE_INTROSPECT, "Introspect");
-    QDBusPendingReply<QString> reply = QDBusConnection::systemBus().call(call);
-
-    if (reply.isValid()) {
-        QDomDocument dom;
-        dom.setContent(reply.value());
-        QDomNodeList nodeList = dom.documentElement().elementsByTagName("node");
-        for (int i = 0; i < nodeList.count(); i++) {
-            QDomElement nodeElem = nodeList.item(i).toElement();
-            if (!nodeElem.isNull() && nodeElem.hasAttribute("name")) {
-                const QString udi = path + "/" + nodeElem.attribute("name");
-
-                if (checkOptical) {
-                    Device device(udi);
-                    if (device.mightBeOpticalDisc()) {
-                        QDBusConnection::systemBus().connect(UD2_DBUS_SERVICE, udi, DBUS_INTERFACE_PROPS, "PropertiesChanged", this,
-                                                             SLOT(slotMediaChanged(QDBusMessage)));
-                        if (!device.isOpticalDisc()) { // skip empty CD disc
-                            continue;
-                        }
-                    }
+    /* The cache is filled in device-tree order: each drive immediately
+     * followed by its block devices. Consumers walking the list then
+     * touch one drive subtree at a time, so per-subtree property
+     * prefetches batch into one GetAll run per drive instead of hopping
+     * between unrelated drives (the raw managed-objects order lists all
+     * block devices first, sorted by name). */
+    QStringList drives;
+    QHash<QString, QStringList> blocksByDrive;
+    QStringList orphanBlocks; // loop devices and blocks without a drive
+
+    for (auto it = managedObjects.cbegin(); it != managedObjects.cend(); ++it) {
+        const QString udi = it.key().path();
+
+        /* Only block devices and drives; skip the manager object and jobs */
+        const bool isBlockDevice = udi.startsWith(UD2_DBUS_PATH_BLOCKDEVICES);
+        if (!isBlockDevice && !udi.startsWith(UD2_DBUS_PATH_DRIVES)) {
+            continue;
+        }
+
+        DeviceBackend::seedBackendForUDI(udi, it.value());
+
+        if (isBlockDevice) {
+            Device device(udi);
+            if (device.mightBeOpticalDisc()) {
+                SignalMultiplexer::instance()->registerMediaWatch(udi, this);
+                if (!device.isOpticalDisc()) { // skip empty CD disc
+                    continue;
                 }
+            }
 
-                m_deviceCache.append(udi);
+            const QString drivePath = it.value().value(QStringLiteral(UD2_DBUS_INTERFACE_BLOCK))
+                                          .value(QStringLiteral("Drive")).value<QDBusObjectPath>().path();
+            if (drivePath.isEmpty() || drivePath == QLatin1String("/")) {
+                orphanBlocks.append(udi);
+            } else {
+                blocksByDrive[drivePath].append(udi);
             }
+        } else {
+            drives.append(udi);
         }
-    } else {
-        qCWarning(UDISKS2) << "Failed enumerating UDisks2 objects:" << reply.error().name() << "\n" << reply.error().message();
+    }
+
+    for (const QString &drive : qAsConst(drives)) {
+        m_deviceCache.append(drive);
+        const QStringList blocks = blocksByDrive.take(drive);
+        for (const QString &block : blocks) {
+            m_deviceCache.append(block);
+        }
+    }
+
+    /* Blocks whose drive didn't enumerate, plus driveless ones, keep
+     * their original relative order at the end. */
+    for (auto it = blocksByDrive.cbegin(); it != blocksByDrive.cend(); ++it) {
+        for (const QString &block : it.value()) {
+            m_deviceCache.append(block);
+        }
+    }
+    for (const QString &block : qAsConst(orphanBlocks)) {
+        m_deviceCache.append(block);
     }
 }
 
@@ -164,6 +265,44 @@ QSet< Solid::DeviceInterface::Type > Manager::supportedInterfaces() const
     return m_supportedInterfaces;
 }
 
+quint32 Manager::deviceInterfacesMask(const QString &udi)
+{
+    if (!m_deviceCache.contains(udi)) {
+        return 0;
+    }
+
+    /* The verdicts derive from the D-Bus interface lists and the
+     * properties GetManagedObjects already seeded into the shared
+     * backend, so computing the mask costs no bus round trip; repeated
+     * checks come straight from the backend's verdict cache. */
+    Device device(udi);
+    quint32 mask = 0;
+    for (const Solid::DeviceInterface::Type type : qAsConst(m_supportedInterfaces)) {
+        if (type >= 0 && type < 32 && device.queryDeviceInterface(type)) {
+            mask |= quint32(1) << type;
+        }
+    }
+    return mask;
+}
+
+QVariantMap Manager::diagnosticState() const
+{
+    QVariantMap state;
+    state.insert(QStringLiteral("cachedDevices"), m_deviceCache.toList().count());
+    state.insert(QStringLiteral("cacheStale"), m_cacheStale);
+    state.insert(QStringLiteral("serviceAvailable"), m_serviceAvailable);
+    state.insert(QStringLiteral("breakerTripped"), ServiceHealth::instance()->isTripped());
+
+    /* The shared per-UDI backends hold the property caches and the
+     * filtered change subscriptions; their registry reports its own
+     * totals. */
+    const QVariantMap backendState = DeviceBackend::diagnostics();
+    for (auto it = backendState.constBegin(); it != backendState.constEnd(); ++it) {
+        state.insert(it.key(), it.value());
+    }
+    return state;
+}
+
 QString Manager::udiPrefix() const
 {
     return UD2_UDI_DISKS_PREFIX;
@@ -187,8 +326,7 @@ void Manager::slotInterfacesAdded(const QDBusObjectPath &object_path, const Vari
     if (interfaces_and_properties.contains("org.freedesktop.UDisks2.Block")) {
         Device device(udi);
         if (device.mightBeOpticalDisc()) {
-            QDBusConnection::systemBus().connect(UD2_DBUS_SERVICE, udi, DBUS_INTERFACE_PROPS, "PropertiesChanged", this,
-                SLOT(slotMediaChanged(QDBusMessage)));
+            SignalMultiplexer::instance()->registerMediaWatch(udi, this);
         }
     }
 
@@ -232,7 +370,7 @@ void Manager::slotInterfacesRemoved(const QDBusObjectPath &object_path, const QS
     if (leftInterfaces.isEmpty()) {
         // remove the device if the last interface is removed
         Q_EMIT deviceRemoved(udi);
-        m_deviceCache.removeAll(udi);
+        m_deviceCache.remove(udi);
         DeviceBackend::destroyBackend(udi);
     } else {
         /*
@@ -265,18 +403,138 @@ void Manager::slotMediaChanged(const QDBusMessage &msg)
 
     if (m_deviceCache.contains(udi) && size == 0) {  // we know the optdisc, got removed
         Q_EMIT deviceRemoved(udi);
-        m_deviceCache.removeAll(udi);
+        m_deviceCache.remove(udi);
         DeviceBackend::destroyBackend(udi);
     }
 }
 
 const QStringList &Manager::deviceCache()
 {
-    if (m_deviceCache.isEmpty()) {
+    if (m_deviceCache.isEmpty() && m_serviceAvailable) {
         allDevices();
+    } else if (m_cacheStale && m_serviceAvailable) {
+        revalidateDeviceCache();
+    }
+
+    return m_deviceCache.toList();
+}
+
+void Manager::revalidateDeviceCache()
+{
+    if (m_revalidation) {
+        return;
+    }
+
+    m_revalidation = new QDBusPendingCallWatcher(m_manager.GetManagedObjects(), this);
+    connect(m_revalidation, &QDBusPendingCallWatcher::finished,
+            this, &Manager::slotRevalidationFinished);
+}
+
+void Manager::slotRevalidationFinished(QDBusPendingCallWatcher *watcher)
+{
+    QDBusPendingReply<DBUSManagerStruct> reply = *watcher;
+    watcher->deleteLater();
+    m_revalidation = nullptr;
+
+    if (!reply.isValid()) {
+        /* Keep serving the stale list; the next query retries. */
+        qCWarning(UDISKS2) << "Failed revalidating UDisks2 objects:" << reply.error().name() << "\n" << reply.error().message();
+        return;
+    }
+
+    if (!m_serviceAvailable) {
+        /* The daemon went away again while the reply was in flight; stay
+         * stale and let the grace timer or the next registration decide. */
+        return;
+    }
+
+    const DBUSManagerStruct managedObjects = reply.value();
+    const QStringList previous = m_deviceCache.toList();
+
+    /* Devices that survived the restart keep their backends; drop their
+     * property caches (with the usual change notification) before the
+     * reseed below refills them, as the daemon may have come back with
+     * different state. */
+    for (auto it = managedObjects.cbegin(); it != managedObjects.cend(); ++it) {
+        DeviceBackend *backend = DeviceBackend::backendForUDI(it.key().path(), false);
+        if (backend) {
+            backend->invalidateProperties();
+        }
+    }
+
+    m_cacheStale = false;
+    m_deviceCache.clear();
+    populateDeviceCache(managedObjects);
+
+    /* Announce only the difference between the pre- and post-restart
+     * device lists; everything that survived stays put for clients. */
+    const QStringList current = m_deviceCache.toList();
+    const QSet<QString> currentSet(current.begin(), current.end());
+    const QSet<QString> previousSet(previous.begin(), previous.end());
+
+    for (const QString &udi : previous) {
+        if (!currentSet.contains(udi)) {
+            Q_EMIT deviceRemoved(udi);
+            DeviceBackend::destroyBackend(udi);
+        }
+    }
+    for (const QString &udi : current) {
+        if (!previousSet.contains(udi)) {
+            Q_EMIT deviceAdded(udi);
+        }
+    }
+}
+
+void Manager::slotServiceRegistered()
+{
+    m_serviceAvailable = true;
+    m_serviceGraceTimer.stop();
+
+    if (m_cacheStale) {
+        /* The daemon restarted within the grace period; the last known
+         * list is still being served, reconcile it in the background. */
+        revalidateDeviceCache();
+        return;
     }
 
-    return m_deviceCache;
+    /* The daemon came up after us; announce everything it knows about. */
+    const QStringList udis = allDevices();
+    for (const QString &udi : udis) {
+        Q_EMIT deviceAdded(udi);
+    }
+}
+
+void Manager::slotServiceUnregistered()
+{
+    m_serviceAvailable = false;
+
+    if (m_deviceCache.isEmpty()) {
+        return;
+    }
+
+    /* Don't tear the device list down right away: a daemon restart (say,
+     * from a package upgrade) unregisters and re-registers the name within
+     * moments, and dropping every device only to re-add it makes clients
+     * flicker and forces a synchronous rebuild on the next query. Serve
+     * the last known list while the grace timer runs; the teardown only
+     * happens if udisksd doesn't come back. */
+    m_cacheStale = true;
+    m_serviceGraceTimer.start();
+}
+
+void Manager::slotServiceGraceExpired()
+{
+    if (m_serviceAvailable || !m_cacheStale) {
+        return;
+    }
+
+    m_cacheStale = false;
+    const QStringList udis = m_deviceCache.toList();
+    for (const QString &udi : udis) {
+        Q_EMIT deviceRemoved(udi);
+        DeviceBackend::destroyBackend(udi);
+    }
+    m_deviceCache.clear();
 }
 
 void Manager::updateBackend(const QString &udi)
@@ -289,7 +547,7 @@ void Manager::updateBackend(const QString &udi)
     //This doesn't emit "changed" signals. Signals are emitted later by DeviceBackend's slots
     backend->allProperties();
 
-    QVariant driveProp = backend->prop("Drive");
+    QVariant driveProp = backend->prop(QStringLiteral("Drive"));
     if (!driveProp.isValid()) {
         return;
     }
@@ -14,7 +14,11 @@
 
 #include <solid/devices/ifaces/devicemanager.h>
 
+#include <QDBusServiceWatcher>
 #include <QSet>
+#include <QTimer>
+
+class QDBusPendingCallWatcher;
 
 namespace Solid
 {
@@ -23,6 +27,72 @@ namespace Backends
 namespace UDisks2
 {
 
+/**
+ * Insertion-ordered set of UDIs: constant-time membership tests and
+ * removals with the stable enumeration order of a plain list. The list
+ * form handed out to callers is compacted lazily after removals.
+ */
+class OrderedUdiSet
+{
+public:
+    bool contains(const QString &udi) const
+    {
+        return m_set.contains(udi);
+    }
+
+    bool isEmpty() const
+    {
+        return m_set.isEmpty();
+    }
+
+    void append(const QString &udi)
+    {
+        if (m_set.contains(udi)) {
+            return;
+        }
+        if (m_dirty) {
+            toList(); // compact away removed entries before appending
+        }
+        m_set.insert(udi);
+        m_list.append(udi);
+    }
+
+    void remove(const QString &udi)
+    {
+        if (m_set.remove(udi)) {
+            m_dirty = true;
+        }
+    }
+
+    void clear()
+    {
+        m_set.clear();
+        m_list.clear();
+        m_dirty = false;
+    }
+
+    const QStringList &toList() const
+    {
+        if (m_dirty) {
+            QStringList compacted;
+            compacted.reserve(m_set.size());
+            for (const QString &udi : qAsConst(m_list)) {
+                if (m_set.contains(udi)) {
+                    compacted.append(udi);
+                }
+            }
+            m_list = compacted;
+            m_dirty = false;
+        }
+        return m_list;
+    }
+
+private:
+    QSet<QString> m_set;
+    mutable QStringList m_list;
+    mutable bool m_dirty = false;
+};
+
 class Manager: public Solid::Ifaces::DeviceManager
 {
     Q_OBJECT
@@ -33,6 +103,8 @@ public:
     QStringList devicesFromQuery(const QString &parentUdi, Solid::DeviceInterface::Type type) override;
     QStringList allDevices() override;
     QSet< Solid::DeviceInterface::Type > supportedInterfaces() const override;
+    quint32 deviceInterfacesMask(const QString &udi) override;
+    QVariantMap diagnosticState() const override;
     QString udiPrefix() const override;
     virtual ~Manager();
 
@@ -40,14 +112,32 @@ private Q_SLOTS:
     void slotInterfacesAdded(const QDBusObjectPath &object_path, const VariantMapMap &interfaces_and_properties);
     void slotInterfacesRemoved(const QDBusObjectPath &object_path, const QStringList &interfaces);
     void slotMediaChanged(const QDBusMessage &msg);
+    void slotServiceRegistered();
+    void slotServiceUnregistered();
+    void slotRevalidationFinished(QDBusPendingCallWatcher *watcher);
+    void slotServiceGraceExpired();
 
 private:
     const QStringList &deviceCache();
-    void introspect(const QString &path, bool checkOptical = false);
+    void populateDeviceCache(const DBUSManagerStruct &managedObjects);
+    void revalidateDeviceCache();
     void updateBackend(const QString &udi);
     QSet<Solid::DeviceInterface::Type> m_supportedInterfaces;
     org::freedesktop::DBus::ObjectManager m_manager;
-    QStringList m_deviceCache;
+    QDBusServiceWatcher *m_serviceWatcher;
+    bool m_serviceAvailable;
+    /* Set while the last known device list is served in place of a
+     * rebuilt one; see revalidateDeviceCache(). */
+    bool m_cacheStale;
+    /* Non-null while an asynchronous GetManagedObjects reconciliation
+     * is in flight. */
+    QDBusPendingCallWatcher *m_revalidation;
+    /* Started when udisksd goes away; the stale cache is only torn down
+     * if the daemon doesn't come back before it fires. */
+    QTimer m_serviceGraceTimer;
+    /* Drives the periodic eviction of idle property caches. */
+    QTimer m_cacheSweepTimer;
+    OrderedUdiSet m_deviceCache;
 };
 
 }
@@ -0,0 +1,134 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include "udisksmultiplexer.h"
+#include "udisksdevicebackend.h"
+#include "udisks_debug.h"
+
+#include <QDBusConnection>
+#include <QDBusMetaType>
+
+using namespace Solid::Backends::UDisks2;
+
+Q_GLOBAL_STATIC(SignalMultiplexer, globalSignalMultiplexer)
+
+SignalMultiplexer *SignalMultiplexer::instance()
+{
+    return globalSignalMultiplexer;
+}
+
+SignalMultiplexer::SignalMultiplexer()
+{
+    /* An empty path matches signals from every object of the service, so
+     * this is one bus match rule no matter how many devices exist. The
+     * raw-message slot is used because the path the signal came from is
+     * needed for the demultiplexing. */
+    QDBusConnection::systemBus().connect(UD2_DBUS_SERVICE, QString(), DBUS_INTERFACE_PROPS, "PropertiesChanged",
+                                         this, SLOT(slotPropertiesChanged(QDBusMessage)));
+    QDBusConnection::systemBus().connect(UD2_DBUS_SERVICE, UD2_DBUS_PATH, DBUS_INTERFACE_MANAGER, "InterfacesAdded",
+                                         this, SLOT(slotInterfacesAdded(QDBusObjectPath,VariantMapMap)));
+    QDBusConnection::systemBus().connect(UD2_DBUS_SERVICE, UD2_DBUS_PATH, DBUS_INTERFACE_MANAGER, "InterfacesRemoved",
+                                         this, SLOT(slotInterfacesRemoved(QDBusObjectPath,QStringList)));
+}
+
+void SignalMultiplexer::registerBackend(DeviceBackend *backend)
+{
+    QWriteLocker locker(&m_lock);
+    m_backends.insert(backend->udi(), backend);
+}
+
+void SignalMultiplexer::unregisterBackend(DeviceBackend *backend)
+{
+    QWriteLocker locker(&m_lock);
+    auto it = m_backends.find(backend->udi());
+    if (it != m_backends.end() && it.value() == backend) {
+        m_backends.erase(it);
+    }
+}
+
+void SignalMultiplexer::registerMediaWatch(const QString &path, QObject *receiver)
+{
+    QWriteLocker locker(&m_lock);
+    if (!m_mediaWatches.contains(path, receiver)) {
+        m_mediaWatches.insert(path, receiver);
+    }
+}
+
+void SignalMultiplexer::unregisterMediaWatches(QObject *receiver)
+{
+    QWriteLocker locker(&m_lock);
+    for (auto it = m_mediaWatches.begin(); it != m_mediaWatches.end();) {
+        if (it.value() == receiver) {
+            it = m_mediaWatches.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+DeviceBackend *SignalMultiplexer::backendForPath(const QString &path) const
+{
+    QReadLocker locker(&m_lock);
+    return m_backends.value(path);
+}
+
+void SignalMultiplexer::slotPropertiesChanged(const QDBusMessage &message)
+{
+    const QString path = message.path();
+
+    /* Copy the watcher list out of the lock; the invoked slot may call
+     * back into register/unregister. */
+    QList<QObject *> mediaWatchers;
+    {
+        QReadLocker locker(&m_lock);
+        mediaWatchers = m_mediaWatches.values(path);
+    }
+    for (QObject *receiver : qAsConst(mediaWatchers)) {
+        QMetaObject::invokeMethod(receiver, "slotMediaChanged",
+                                  Q_ARG(QDBusMessage, message));
+    }
+
+    DeviceBackend *backend = backendForPath(path);
+    if (!backend) {
+        return;
+    }
+
+    const QVariantList args = message.arguments();
+    if (args.size() < 3) {
+        return;
+    }
+
+    /* invokeMethod instead of a direct call: the backend may live on
+     * another thread, in which case this turns into a queued call. */
+    QMetaObject::invokeMethod(backend, "slotPropertiesChanged",
+                              Q_ARG(QString, args.at(0).toString()),
+                              Q_ARG(QVariantMap, qdbus_cast<QVariantMap>(args.at(1))),
+                              Q_ARG(QStringList, qdbus_cast<QStringList>(args.at(2))));
+}
+
+void SignalMultiplexer::slotInterfacesAdded(const QDBusObjectPath &object_path, const VariantMapMap &interfaces_and_properties)
+{
+    DeviceBackend *backend = backendForPath(object_path.path());
+    if (!backend) {
+        return;
+    }
+
+    QMetaObject::invokeMethod(backend, "slotInterfacesAdded",
+                              Q_ARG(QDBusObjectPath, object_path),
+                              Q_ARG(VariantMapMap, interfaces_and_properties));
+}
+
+void SignalMultiplexer::slotInterfacesRemoved(const QDBusObjectPath &object_path, const QStringList &interfaces)
+{
+    DeviceBackend *backend = backendForPath(object_path.path());
+    if (!backend) {
+        return;
+    }
+
+    QMetaObject::invokeMethod(backend, "slotInterfacesRemoved",
+                              Q_ARG(QDBusObjectPath, object_path),
+                              Q_ARG(QStringList, interfaces));
+}
@@ -0,0 +1,91 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#ifndef UDISKSMULTIPLEXER_H
+#define UDISKSMULTIPLEXER_H
+
+#include <QDBusMessage>
+#include <QDBusObjectPath>
+#include <QHash>
+#include <QObject>
+#include <QReadWriteLock>
+
+#include "udisks2.h"
+
+namespace Solid
+{
+namespace Backends
+{
+namespace UDisks2
+{
+
+class DeviceBackend;
+
+/**
+ * Process-wide subscription point for the udisks2 bus signals.
+ *
+ * Every DeviceBackend used to install its own set of match rules: one
+ * PropertiesChanged rule for its path plus the two manager-level
+ * InterfacesAdded/InterfacesRemoved rules, re-registered per device.
+ * The bus daemon evaluates every rule against every message it routes,
+ * so with hundreds of devices that cost is paid on every signal in
+ * every Solid process.
+ *
+ * The multiplexer installs exactly three rules for the whole process —
+ * one PropertiesChanged rule matching any path of the udisks2 service
+ * and one rule for each manager signal — and demultiplexes internally
+ * to the backend registered for the signal's path. Backends may live
+ * on other threads; dispatch goes through the queued-invocation
+ * machinery in that case.
+ */
+class SignalMultiplexer : public QObject
+{
+    Q_OBJECT
+
+public:
+    /* Public only so Q_GLOBAL_STATIC can construct it; use instance(). */
+    SignalMultiplexer();
+
+    static SignalMultiplexer *instance();
+
+    void registerBackend(DeviceBackend *backend);
+    void unregisterBackend(DeviceBackend *backend);
+
+    /**
+     * Routes PropertiesChanged signals for @p path additionally to
+     * @p receiver's slotMediaChanged() slot. The managers use this for
+     * media detection on optical devices; it replaces one bus match
+     * rule per optical device with an entry in the demultiplexing
+     * table.
+     */
+    void registerMediaWatch(const QString &path, QObject *receiver);
+
+    /**
+     * Drops every media watch installed by @p receiver.
+     */
+    void unregisterMediaWatches(QObject *receiver);
+
+private Q_SLOTS:
+    void slotPropertiesChanged(const QDBusMessage &message);
+    void slotInterfacesAdded(const QDBusObjectPath &object_path, const VariantMapMap &interfaces_and_properties);
+    void slotInterfacesRemoved(const QDBusObjectPath &object_path, const QStringList &interfaces);
+
+private:
+    DeviceBackend *backendForPath(const QString &path) const;
+
+    /* Backends register from whichever thread constructs them while the
+     * bus signals arrive on the multiplexer's thread. */
+    mutable QReadWriteLock m_lock;
+    QHash<QString /* UDI */, DeviceBackend *> m_backends;
+    /* Multi: one manager per thread may watch the same drive. */
+    QMultiHash<QString /* path */, QObject *> m_mediaWatches;
+};
+
+} /* namespace UDisks2 */
+} /* namespace Backends */
+} /* namespace Solid */
+
+#endif /* UDISKSMULTIPLEXER_H */
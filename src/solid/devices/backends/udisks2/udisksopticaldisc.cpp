@@ -11,9 +11,15 @@
 #include <sys/stat.h>
 #include <fcntl.h>
 
+#include <QDataStream>
+#include <QFile>
+#include <QHash>
 #include <QMap>
+#include <QSaveFile>
 #include <QSharedMemory>
+#include <QStandardPaths>
 #include <QSystemSemaphore>
+#include <QThreadPool>
 #include <QThreadStorage>
 
 
@@ -186,12 +192,90 @@ private:
     QPair<OpticalDisc::Identity, Solid::OpticalDisc::ContentTypes> m_info[100];
 };
 
+/* On-disk layer below the shared-memory cache. It is keyed by disc size and
+ * label only, which unlike the detection timestamp survive re-insertion and
+ * reboot, so a known disc is answered without ever touching the drive. */
+class PersistentContentTypesCache
+{
+public:
+    PersistentContentTypesCache()
+        : m_path(QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation)
+                 + QLatin1String("/solid-disc-content-cache"))
+    {
+        load();
+    }
+
+    bool find(const OpticalDisc::Identity &key, Solid::OpticalDisc::ContentTypes *content) const
+    {
+        const auto it = m_entries.constFind(qMakePair(key.size(), key.labelHash()));
+        if (it == m_entries.constEnd()) {
+            return false;
+        }
+
+        *content = Solid::OpticalDisc::ContentTypes(it.value());
+        return true;
+    }
+
+    void add(const OpticalDisc::Identity &key, Solid::OpticalDisc::ContentTypes content)
+    {
+        m_entries.insert(qMakePair(key.size(), key.labelHash()), uint(content));
+        save();
+    }
+
+private:
+    static const quint32 formatVersion = 1;
+
+    void load()
+    {
+        QFile file(m_path);
+        if (!file.open(QIODevice::ReadOnly)) {
+            return;
+        }
+
+        QDataStream in(&file);
+        quint32 version = 0;
+        quint32 count = 0;
+        in >> version;
+        if (version != formatVersion) {
+            return;
+        }
+        in >> count;
+
+        for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+            qint64 size = 0;
+            quint32 labelHash = 0;
+            quint32 content = 0;
+            in >> size >> labelHash >> content;
+            m_entries.insert(qMakePair(qlonglong(size), uint(labelHash)), uint(content));
+        }
+    }
+
+    void save() const
+    {
+        QSaveFile file(m_path);
+        if (!file.open(QIODevice::WriteOnly)) {
+            return;
+        }
+
+        QDataStream out(&file);
+        out << formatVersion << quint32(m_entries.size());
+        for (auto it = m_entries.cbegin(); it != m_entries.cend(); ++it) {
+            out << qint64(it.key().first) << quint32(it.key().second) << quint32(it.value());
+        }
+        file.commit();
+    }
+
+    QHash<QPair<qlonglong, uint>, uint> m_entries;
+    QString m_path;
+};
+
 class SharedContentTypesCache
 {
 private:
     ContentTypesCache *m_pointer;
     QSystemSemaphore m_semaphore;
     QSharedMemory m_shmem;
+    PersistentContentTypesCache m_persistent;
 
     struct Unlocker {
     public:
@@ -260,27 +344,38 @@ public:
             const QByteArray &file)
     {
         if (!m_pointer) {
-            return advancedDiscDetect(file);
+            return probeThroughPersistentCache(info, file);
         }
 
         if (!m_semaphore.acquire()) {
-            return advancedDiscDetect(file);
+            return probeThroughPersistentCache(info, file);
         }
         Releaser releaser(&m_semaphore);
 
         if (!m_shmem.lock()) {
-            return advancedDiscDetect(file);
+            return probeThroughPersistentCache(info, file);
         }
         Unlocker unlocker(&m_shmem);
 
         if (!m_pointer->find(info)) {
-            m_pointer->add(info, advancedDiscDetect(file));
+            m_pointer->add(info, probeThroughPersistentCache(info, file));
         }
 
         Solid::OpticalDisc::ContentTypes content = m_pointer->front().second;
         return content;
     }
 
+    Solid::OpticalDisc::ContentTypes probeThroughPersistentCache(const OpticalDisc::Identity &info,
+            const QByteArray &file)
+    {
+        Solid::OpticalDisc::ContentTypes content;
+        if (!m_persistent.find(info, &content)) {
+            content = advancedDiscDetect(file);
+            m_persistent.add(info, content);
+        }
+        return content;
+    }
+
     ~SharedContentTypesCache()
     {
         m_semaphore.acquire();
@@ -296,9 +391,9 @@ OpticalDisc::Identity::Identity() : m_detectTime(0), m_size(0), m_labelHash(0)
 }
 
 OpticalDisc::Identity::Identity(const Device &device, const Device &drive)
-    : m_detectTime(drive.prop("TimeMediaDetected").toLongLong()),
-      m_size(device.prop("Size").toLongLong()),
-      m_labelHash(qHash(device.prop("IdLabel").toString()))
+    : m_detectTime(drive.prop(QStringLiteral("TimeMediaDetected")).toLongLong()),
+      m_size(device.prop(QStringLiteral("Size")).toLongLong()),
+      m_labelHash(qHash(device.prop(QStringLiteral("IdLabel")).toString()))
 {
 }
 
@@ -309,8 +404,45 @@ bool OpticalDisc::Identity::operator ==(const OpticalDisc::Identity &b) const
            m_labelHash == b.m_labelHash;
 }
 
+long long OpticalDisc::Identity::size() const
+{
+    return m_size;
+}
+
+uint OpticalDisc::Identity::labelHash() const
+{
+    return m_labelHash;
+}
+
+/* Runs the physical probe on a pool thread so the caches are warm by the
+ * time availableContent() is asked. A concurrent synchronous probe of the
+ * same disc simply blocks on the cache semaphore and then finds the entry. */
+class ContentProbeJob : public QObject, public QRunnable
+{
+    Q_OBJECT
+public:
+    ContentProbeJob(const OpticalDisc::Identity &identity, const QByteArray &deviceFile)
+        : m_identity(identity), m_deviceFile(deviceFile)
+    {
+    }
+
+    void run() override
+    {
+        sharedContentTypesCache->localData().getContent(m_identity, m_deviceFile);
+        Q_EMIT finished();
+    }
+
+Q_SIGNALS:
+    void finished();
+
+private:
+    OpticalDisc::Identity m_identity;
+    QByteArray m_deviceFile;
+};
+
 OpticalDisc::OpticalDisc(Device *dev)
     : StorageVolume(dev)
+    , m_availableContentValid(false)
 {
 #if UDEV_FOUND
     UdevQt::Client client(this);
@@ -320,6 +452,28 @@ OpticalDisc::OpticalDisc(Device *dev)
 #endif
 
     m_drive = new Device(m_device->drivePath());
+
+    /* Only a media change can alter what's on the disc, so that's the only
+     * event allowed to invalidate the availableContent() answer; metadata
+     * refreshes on the drive (eject button state, time of last polling...)
+     * must not send callers back into the multi-second content probe. */
+    connect(m_drive, SIGNAL(propertyChanged(QMap<QString,int>)),
+            this, SLOT(slotDrivePropertyChanged(QMap<QString,int>)));
+
+    /* The probe walks the disc's path table with raw reads and can block
+     * for seconds on a spun-down drive, so start it in the background now
+     * instead of paying for it inside the first availableContent() call. */
+    if (!isBlank() && m_drive->prop(QStringLiteral("OpticalNumDataTracks")).toUInt() > 0) {
+        startContentProbe();
+    }
+}
+
+void OpticalDisc::startContentProbe()
+{
+    ContentProbeJob *job = new ContentProbeJob(Identity(*m_device, *m_drive),
+                                               m_device->prop(QStringLiteral("Device")).toByteArray());
+    connect(job, &ContentProbeJob::finished, this, &OpticalDisc::contentProbeFinished, Qt::QueuedConnection);
+    QThreadPool::globalInstance()->start(job);
 }
 
 OpticalDisc::~OpticalDisc()
@@ -329,7 +483,7 @@ OpticalDisc::~OpticalDisc()
 
 qulonglong OpticalDisc::capacity() const
 {
-    return m_device->prop("Size").toULongLong();
+    return m_device->prop(QStringLiteral("Size")).toULongLong();
 }
 
 bool OpticalDisc::isRewritable() const
@@ -343,7 +497,7 @@ bool OpticalDisc::isRewritable() const
 
 bool OpticalDisc::isBlank() const
 {
-    return m_drive->prop("OpticalBlank").toBool();
+    return m_drive->prop(QStringLiteral("OpticalBlank")).toBool();
 }
 
 bool OpticalDisc::isAppendable() const
@@ -352,7 +506,7 @@ bool OpticalDisc::isAppendable() const
 #if UDEV_FOUND
     return m_udevDevice.deviceProperty("ID_CDROM_MEDIA_STATE").toString() == QLatin1String("appendable");
 #elif defined(Q_OS_FREEBSD)
-    return m_device->prop("bsdisks_IsAppendable").toBool();
+    return m_device->prop(QStringLiteral("bsdisks_IsAppendable")).toBool();
 #else
 #error Implement this or stub this out for your platform
 #endif
@@ -386,22 +540,36 @@ Solid::OpticalDisc::DiscType OpticalDisc::discType() const
     return map.key(media(), Solid::OpticalDisc::UnknownDiscType);  // FIXME optimize, lookup by value, not key
 }
 
+void OpticalDisc::slotDrivePropertyChanged(const QMap<QString, int> &changes)
+{
+    if (changes.contains(QStringLiteral("MediaAvailable"))
+            || changes.contains(QStringLiteral("TimeMediaDetected"))) {
+        m_availableContentValid = false;
+    }
+}
+
 Solid::OpticalDisc::ContentTypes OpticalDisc::availableContent() const
 {
+    if (m_availableContentValid) {
+        return m_cachedAvailableContent;
+    }
+
     if (isBlank()) {
-        return Solid::OpticalDisc::NoContent;
+        m_cachedAvailableContent = Solid::OpticalDisc::NoContent;
+        m_availableContentValid = true;
+        return m_cachedAvailableContent;
     }
 
     Solid::OpticalDisc::ContentTypes content = Solid::OpticalDisc::NoContent;
-    const bool hasData = m_drive->prop("OpticalNumDataTracks").toUInt() > 0;
-    const bool hasAudio = m_drive->prop("OpticalNumAudioTracks").toUInt() > 0;
+    const bool hasData = m_drive->prop(QStringLiteral("OpticalNumDataTracks")).toUInt() > 0;
+    const bool hasAudio = m_drive->prop(QStringLiteral("OpticalNumAudioTracks")).toUInt() > 0;
 
     if (hasData) {
         content |= Solid::OpticalDisc::Data;
 
         Identity newIdentity(*m_device, *m_drive);
         if (!(m_identity == newIdentity)) {
-            QByteArray deviceFile(m_device->prop("Device").toByteArray());
+            QByteArray deviceFile(m_device->prop(QStringLiteral("Device")).toByteArray());
             m_cachedContent =
                 sharedContentTypesCache->localData().getContent(newIdentity, deviceFile);
             m_identity = newIdentity;
@@ -413,10 +581,14 @@ Solid::OpticalDisc::ContentTypes OpticalDisc::availableContent() const
         content |= Solid::OpticalDisc::Audio;
     }
 
+    m_cachedAvailableContent = content;
+    m_availableContentValid = true;
     return content;
 }
 
 QString OpticalDisc::media() const
 {
-    return m_drive->prop("Media").toString();
+    return m_drive->prop(QStringLiteral("Media")).toString();
 }
+
+#include "udisksopticaldisc.moc"
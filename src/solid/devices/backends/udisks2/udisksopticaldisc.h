@@ -46,17 +46,39 @@ public:
         Identity(const Device &device, const Device &drive);
         bool operator ==(const Identity &) const;
 
+        /* The size/label pair identifies the disc itself, independent of
+         * when it was inserted; the persistent content cache keys on it. */
+        long long size() const;
+        uint labelHash() const;
+
     private:
         long long m_detectTime;
         long long m_size;
         uint m_labelHash;
     };
 
+Q_SIGNALS:
+    /**
+     * Emitted when the content probe started in the background at
+     * construction time has finished and availableContent() can be
+     * answered from cache without blocking on the drive.
+     */
+    void contentProbeFinished();
+
+private Q_SLOTS:
+    void slotDrivePropertyChanged(const QMap<QString, int> &changes);
+
 private:
+    void startContentProbe();
 
     mutable Identity m_identity;
     QString media() const;
     mutable Solid::OpticalDisc::ContentTypes m_cachedContent;
+    /* The fully assembled availableContent() answer, valid until the drive
+     * reports a media change; metadata updates on the drive don't touch it,
+     * so they can never trigger a re-probe of the disc. */
+    mutable Solid::OpticalDisc::ContentTypes m_cachedAvailableContent;
+    mutable bool m_availableContentValid;
     Device *m_drive;
 #if UDEV_FOUND
     UdevQt::Device m_udevDevice;
@@ -15,6 +15,7 @@
 #include <unistd.h>
 #include <stdlib.h>
 
+#include <QDBusPendingCallWatcher>
 #include <QFile>
 #include <QDebug>
 
@@ -51,14 +52,23 @@ bool OpticalDrive::eject()
     m_ejectInProgress = true;
     m_device->broadcastActionRequested("eject");
 
-    const QString path = m_device->udi();
-    QDBusConnection c = QDBusConnection::connectToBus(QDBusConnection::SystemBus, "Solid::Udisks2::OpticalDrive::" + path);
+    // if the device is mounted we have to unmount first; look for a mounted
+    // block device on this drive without blocking the caller
+    Q_EMIT ejectProgress(EnumeratingStage, m_device->udi());
+
+    org::freedesktop::DBus::ObjectManager manager(UD2_DBUS_SERVICE, UD2_DBUS_PATH, QDBusConnection::systemBus());
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(manager.GetManagedObjects(), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, &OpticalDrive::slotEnumerationFinished);
+    return true;
+}
+
+void OpticalDrive::slotEnumerationFinished(QDBusPendingCallWatcher *watcher)
+{
+    QDBusPendingReply<DBUSManagerStruct> reply = *watcher;
+    watcher->deleteLater();
 
-    // if the device is mounted, unmount first
+    const QString path = m_device->udi();
     QString blockPath;
-    org::freedesktop::DBus::ObjectManager manager(UD2_DBUS_SERVICE, UD2_DBUS_PATH, c);
-    QDBusPendingReply<DBUSManagerStruct> reply = manager.GetManagedObjects();
-    reply.waitForFinished();
     if (!reply.isError()) {  // enum devices
         const auto objPathMap = reply.value();
         for (auto it = objPathMap.cbegin(); it != objPathMap.cend(); ++it) {
@@ -81,16 +91,45 @@ bool OpticalDrive::eject()
         qCWarning(UDISKS2) << "Failed enumerating UDisks2 objects:" << reply.error().name() << "\n" << reply.error().message();
     }
 
-    if (!blockPath.isEmpty()) {
-        //qDebug() << "Calling unmount on" << blockPath;
-        QDBusMessage msg = QDBusMessage::createMethodCall(UD2_DBUS_SERVICE, blockPath, UD2_DBUS_INTERFACE_FILESYSTEM, "Unmount");
-        msg << QVariantMap();   // options, unused now
-        c.call(msg, QDBus::BlockWithGui);
+    if (blockPath.isEmpty()) {
+        callEject();
+        return;
     }
 
+    //qDebug() << "Calling unmount on" << blockPath;
+    Q_EMIT ejectProgress(UnmountingStage, path);
+    QDBusMessage msg = QDBusMessage::createMethodCall(UD2_DBUS_SERVICE, blockPath, UD2_DBUS_INTERFACE_FILESYSTEM, "Unmount");
+    msg << QVariantMap();   // options, unused now
+    if (!QDBusConnection::systemBus().callWithCallback(msg, this, SLOT(slotUnmountReply(QDBusMessage)), SLOT(slotUnmountError(QDBusError)))) {
+        callEject();
+    }
+}
+
+void OpticalDrive::slotUnmountReply(const QDBusMessage &/*reply*/)
+{
+    callEject();
+}
+
+void OpticalDrive::slotUnmountError(const QDBusError &error)
+{
+    // proceed with the eject anyway, just like the old blocking code
+    // which discarded the unmount result
+    qCWarning(UDISKS2) << "Failed to unmount before eject:" << error.name() << "\n" << error.message();
+    callEject();
+}
+
+void OpticalDrive::callEject()
+{
+    const QString path = m_device->udi();
+    Q_EMIT ejectProgress(EjectingStage, path);
+
     QDBusMessage msg = QDBusMessage::createMethodCall(UD2_DBUS_SERVICE, path, UD2_DBUS_INTERFACE_DRIVE, "Eject");
     msg << QVariantMap();
-    return c.callWithCallback(msg, this, SLOT(slotDBusReply(QDBusMessage)), SLOT(slotDBusError(QDBusError)));
+    if (!QDBusConnection::systemBus().callWithCallback(msg, this, SLOT(slotDBusReply(QDBusMessage)), SLOT(slotDBusError(QDBusError)))) {
+        m_ejectInProgress = false;
+        m_device->broadcastActionDone("eject", Solid::OperationFailed,
+                                      QStringLiteral("Failed to send the Eject call"));
+    }
 }
 
 void OpticalDrive::slotDBusReply(const QDBusMessage &/*reply*/)
@@ -177,7 +216,7 @@ int OpticalDrive::readSpeed() const
 
 Solid::OpticalDrive::MediumTypes OpticalDrive::supportedMedia() const
 {
-    const QStringList mediaTypes = m_device->prop("MediaCompatibility").toStringList();
+    const QStringList mediaTypes = m_device->prop(QStringLiteral("MediaCompatibility")).toStringList();
     Solid::OpticalDrive::MediumTypes supported;
 
     QMap<QString, Solid::OpticalDrive::MediumType> map = {
@@ -11,6 +11,8 @@
 #include <solid/devices/ifaces/opticaldrive.h>
 #include "udisksstoragedrive.h"
 
+class QDBusPendingCallWatcher;
+
 namespace Solid
 {
 namespace Backends
@@ -24,6 +26,16 @@ class OpticalDrive: public StorageDrive, virtual public Solid::Ifaces::OpticalDr
     Q_INTERFACES(Solid::Ifaces::OpticalDrive)
 
 public:
+    /**
+     * Stages of the asynchronous eject pipeline, in the order they run.
+     */
+    enum EjectStage {
+        EnumeratingStage,   ///< looking up mounted block devices on this drive
+        UnmountingStage,    ///< unmounting a mounted block device
+        EjectingStage       ///< issuing the actual Eject call
+    };
+    Q_ENUM(EjectStage)
+
     OpticalDrive(Device *device);
     virtual ~OpticalDrive();
 
@@ -31,6 +43,10 @@ Q_SIGNALS:
     void ejectPressed(const QString &udi) override;
     void ejectDone(Solid::ErrorType error, QVariant errorData, const QString &udi) override;
     void ejectRequested(const QString &udi);
+    /**
+     * Emitted when the asynchronous eject pipeline enters a new stage.
+     */
+    void ejectProgress(EjectStage stage, const QString &udi);
 
 public:
     bool eject() override;
@@ -43,12 +59,17 @@ private Q_SLOTS:
     void slotDBusReply(const QDBusMessage &reply);
     void slotDBusError(const QDBusError &error);
 
+    void slotEnumerationFinished(QDBusPendingCallWatcher *watcher);
+    void slotUnmountReply(const QDBusMessage &reply);
+    void slotUnmountError(const QDBusError &error);
+
     void slotEjectRequested();
     void slotEjectDone(int error, const QString &errorString);
 
     void slotChanged();
 
 private:
+    void callEject();
     void initReadWriteSpeeds() const;
 
     bool m_ejectInProgress;
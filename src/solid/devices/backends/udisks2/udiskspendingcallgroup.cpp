@@ -0,0 +1,76 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include "udiskspendingcallgroup.h"
+
+#include <QDBusPendingCallWatcher>
+
+using namespace Solid::Backends::UDisks2;
+
+PendingCallGroup::PendingCallGroup(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void PendingCallGroup::reserve(int count)
+{
+    m_calls.reserve(count);
+}
+
+int PendingCallGroup::add(const QDBusPendingCall &call)
+{
+    Q_ASSERT(!m_sealed);
+    m_calls.append(call);
+    return m_calls.size() - 1;
+}
+
+int PendingCallGroup::count() const
+{
+    return m_calls.size();
+}
+
+const QDBusPendingCall &PendingCallGroup::callAt(int slot) const
+{
+    return m_calls.at(slot);
+}
+
+void PendingCallGroup::seal()
+{
+    Q_ASSERT(!m_sealed);
+    m_sealed = true;
+    m_outstanding = 0;
+
+    for (const QDBusPendingCall &call : qAsConst(m_calls)) {
+        if (call.isFinished()) {
+            continue;
+        }
+        ++m_outstanding;
+        auto *watcher = new QDBusPendingCallWatcher(call, this);
+        connect(watcher, &QDBusPendingCallWatcher::finished,
+                this, [this](QDBusPendingCallWatcher *watcher) {
+            watcher->deleteLater();
+            noteFinished();
+        });
+    }
+
+    if (m_outstanding == 0) {
+        Q_EMIT finished(this);
+    }
+}
+
+void PendingCallGroup::noteFinished()
+{
+    if (--m_outstanding == 0) {
+        Q_EMIT finished(this);
+    }
+}
+
+void PendingCallGroup::waitForAllFinished()
+{
+    for (QDBusPendingCall &call : m_calls) {
+        call.waitForFinished();
+    }
+}
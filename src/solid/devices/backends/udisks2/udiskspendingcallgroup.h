@@ -0,0 +1,83 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#ifndef UDISKSPENDINGCALLGROUP_H
+#define UDISKSPENDINGCALLGROUP_H
+
+#include <QDBusPendingCall>
+#include <QObject>
+#include <QVector>
+
+namespace Solid
+{
+namespace Backends
+{
+namespace UDisks2
+{
+
+/**
+ * Groups a batch of D-Bus pending calls behind one completion.
+ *
+ * Issuing N related calls used to mean either N QDBusPendingCallWatcher
+ * objects — each a QObject with its own finished() emission — or a
+ * hand-rolled list of pending replies. A group stores the calls in
+ * preallocated slots instead: waitForAllFinished() gives the pipelined
+ * synchronous barrier the property-fetch paths use, and seal() arms a
+ * single finished(group) emission for asynchronous batches. Watchers are
+ * only created for sealed asynchronous groups, one per still-pending
+ * call as the Qt API requires, and each is released the moment its
+ * reply lands.
+ */
+class PendingCallGroup : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PendingCallGroup(QObject *parent = nullptr);
+
+    /** Preallocates storage for @p count result slots. */
+    void reserve(int count);
+
+    /** Registers @p call and returns its slot index. */
+    int add(const QDBusPendingCall &call);
+
+    int count() const;
+
+    /** The pending call in @p slot; wrap it in QDBusPendingReply to
+     * read the typed result. */
+    const QDBusPendingCall &callAt(int slot) const;
+
+    /**
+     * Declares the group complete. Once every registered call has its
+     * reply, finished(this) is emitted exactly once — immediately when
+     * the group is empty or everything already finished.
+     */
+    void seal();
+
+    /**
+     * Synchronous barrier: waits for every registered call. The calls
+     * were all put on the wire before the first wait, so the replies
+     * arrive pipelined and the barrier costs roughly one round trip in
+     * total rather than one per call.
+     */
+    void waitForAllFinished();
+
+Q_SIGNALS:
+    void finished(Solid::Backends::UDisks2::PendingCallGroup *group);
+
+private:
+    void noteFinished();
+
+    QVector<QDBusPendingCall> m_calls;
+    int m_outstanding = 0;
+    bool m_sealed = false;
+};
+
+}
+}
+}
+
+#endif
@@ -0,0 +1,139 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include "udisksservicehealth.h"
+#include "udisks2.h"
+#include "udisks_debug.h"
+
+#include "solidconfig_p.h"
+
+#include <QDBusConnection>
+#include <QDBusError>
+#include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+
+using namespace Solid::Backends::UDisks2;
+
+Q_GLOBAL_STATIC(ServiceHealth, globalServiceHealth)
+
+ServiceHealth *ServiceHealth::instance()
+{
+    return globalServiceHealth;
+}
+
+/* How many calls have to time out back to back before the breaker
+ * trips; 0 disables the breaker. A single timeout can be a transient
+ * scheduling hiccup, so one alone doesn't count as a hung daemon. */
+static int tripThreshold()
+{
+    return Solid::Config::snapshot()->udisks2TripThreshold;
+}
+
+/* How often a tripped breaker probes the daemon, and how long one probe
+ * may take. The probe timeout is what bounds the recovery detection, so
+ * it is deliberately short. */
+static const int s_probeIntervalMs = 5000;
+static const int s_probeTimeoutMs = 2000;
+
+ServiceHealth::ServiceHealth()
+{
+    m_probeTimer.setInterval(s_probeIntervalMs);
+    connect(&m_probeTimer, &QTimer::timeout, this, &ServiceHealth::probe);
+}
+
+bool ServiceHealth::isTripped() const
+{
+    return m_tripped.loadAcquire() != 0;
+}
+
+bool ServiceHealth::isTimeoutError(const QDBusError &error)
+{
+    switch (error.type()) {
+    case QDBusError::NoReply:
+    case QDBusError::Timeout:
+    case QDBusError::TimedOut:
+        return true;
+    default:
+        return false;
+    }
+}
+
+int ServiceHealth::propertyCallTimeout()
+{
+    const int timeout = Solid::Config::snapshot()->udisks2PropertyTimeoutMs;
+    return timeout > 0 ? timeout : -1;
+}
+
+void ServiceHealth::recordSuccess()
+{
+    m_consecutiveTimeouts.storeRelease(0);
+
+    if (m_tripped.testAndSetOrdered(1, 0)) {
+        qCWarning(UDISKS2) << "udisks2 daemon is answering again, serving live state";
+        /* The timer lives on the creating thread; a success may be
+         * reported from any of them. */
+        QMetaObject::invokeMethod(this, "stopProbing", Qt::QueuedConnection);
+    }
+}
+
+void ServiceHealth::recordTimeout()
+{
+    const int threshold = tripThreshold();
+    if (threshold == 0) {
+        return;
+    }
+
+    const int timeouts = m_consecutiveTimeouts.fetchAndAddOrdered(1) + 1;
+    if (timeouts < threshold) {
+        return;
+    }
+
+    if (m_tripped.testAndSetOrdered(0, 1)) {
+        qCWarning(UDISKS2) << "udisks2 daemon stopped answering after" << timeouts
+                           << "consecutive timeouts, serving cached state until it recovers";
+        QMetaObject::invokeMethod(this, "startProbing", Qt::QueuedConnection);
+    }
+}
+
+void ServiceHealth::startProbing()
+{
+    m_probeTimer.start();
+    probe();
+}
+
+void ServiceHealth::stopProbing()
+{
+    m_probeTimer.stop();
+}
+
+void ServiceHealth::probe()
+{
+    if (m_probe) {
+        return; // the previous probe is still in flight
+    }
+
+    /* Peer.Ping answers from the daemon's main loop without touching
+     * any device, so it tells responsiveness and nothing else. */
+    QDBusMessage call = QDBusMessage::createMethodCall(UD2_DBUS_SERVICE, UD2_DBUS_PATH,
+                                                       QStringLiteral("org.freedesktop.DBus.Peer"), QStringLiteral("Ping"));
+    m_probe = new QDBusPendingCallWatcher(QDBusConnection::systemBus().asyncCall(call, s_probeTimeoutMs), this);
+    connect(m_probe, &QDBusPendingCallWatcher::finished, this, &ServiceHealth::slotProbeFinished);
+}
+
+void ServiceHealth::slotProbeFinished(QDBusPendingCallWatcher *watcher)
+{
+    watcher->deleteLater();
+    m_probe = nullptr;
+
+    QDBusPendingReply<> reply = *watcher;
+    if (!reply.isError()) {
+        recordSuccess();
+    }
+    /* Still unresponsive: the timer keeps probing. Errors other than a
+     * timeout (service not running at all) also keep the breaker open;
+     * the service watcher in the manager handles re-registration. */
+}
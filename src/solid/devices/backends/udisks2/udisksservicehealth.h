@@ -0,0 +1,116 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#ifndef UDISKSSERVICEHEALTH_H
+#define UDISKSSERVICEHEALTH_H
+
+#include <QAtomicInteger>
+#include <QObject>
+#include <QTimer>
+
+class QDBusError;
+class QDBusPendingCallWatcher;
+
+namespace Solid
+{
+namespace Backends
+{
+namespace UDisks2
+{
+
+/**
+ * Circuit breaker and timeout policy for the udisks2 daemon.
+ *
+ * Every blocking property fetch used to wait up to the full D-Bus
+ * timeout (25 seconds by default) when udisksd hangs, and since the
+ * callers sit on application hot paths (device descriptions,
+ * accessibility checks) a hung daemon used to freeze the application
+ * for one timeout per call. Property reads now run on a short timeout
+ * tier (propertyCallTimeout()), so even the calls it takes to trip the
+ * breaker stall the caller for fractions of a second rather than
+ * multiples of 25. The breaker trips after a few consecutive timed-out calls;
+ * while tripped the backends skip the wire entirely and serve whatever
+ * state their caches hold, and mount/unmount requests fail immediately
+ * with Solid::BackendUnavailable instead of queueing up behind the
+ * hung daemon. A lightweight periodic Ping probes the service and the
+ * breaker closes again as soon as it answers, so the worst-case stall
+ * is bounded by a few timeouts instead of one per operation.
+ */
+class ServiceHealth : public QObject
+{
+    Q_OBJECT
+
+public:
+    /* Public only so Q_GLOBAL_STATIC can construct it; use instance(). */
+    ServiceHealth();
+
+    static ServiceHealth *instance();
+
+    /**
+     * Whether the breaker is currently tripped. One atomic load, cheap
+     * enough for every property access.
+     */
+    bool isTripped() const;
+
+    /**
+     * Tells whether the D-Bus error reports an unresponsive peer (as
+     * opposed to a negative answer from a responsive one).
+     */
+    static bool isTimeoutError(const QDBusError &error);
+
+    /**
+     * Timeout to pass to blocking property reads, in milliseconds.
+     *
+     * Property reads sit on paint-blocking paths and have a cache to
+     * fall back to, so they get a far shorter leash than the 25 second
+     * D-Bus default: a read that can't be answered promptly degrades to
+     * cached state instead of hanging the caller's event loop.
+     * Expiries still go through recordTimeout(), so a daemon that stays
+     * slow trips the breaker, and the recovery probe (which waits
+     * longer than this tier) closes it again when the daemon is merely
+     * busy rather than hung. Mount/unmount/eject keep their long
+     * timeouts; an operation in progress is worth waiting for.
+     *
+     * Returns -1 (the D-Bus default) when the tier is disabled.
+     */
+    static int propertyCallTimeout();
+
+    /**
+     * Records a completed call to the service. Resets the consecutive
+     * timeout count; closes the breaker when it was tripped.
+     */
+    void recordSuccess();
+
+    /**
+     * Records a timed-out call to the service. Trips the breaker after
+     * enough consecutive timeouts and starts probing for recovery.
+     *
+     * Safe to call from any thread, like recordSuccess().
+     */
+    void recordTimeout();
+
+private Q_SLOTS:
+    void startProbing();
+    void stopProbing();
+    void probe();
+    void slotProbeFinished(QDBusPendingCallWatcher *watcher);
+
+private:
+    QAtomicInteger<int> m_tripped;
+    QAtomicInteger<int> m_consecutiveTimeouts;
+
+    /* Fires the periodic recovery probes; lives on the thread the
+     * instance was created on, so the worker threads reach it through
+     * queued invocations. */
+    QTimer m_probeTimer;
+    QDBusPendingCallWatcher *m_probe = nullptr;
+};
+
+}
+}
+}
+
+#endif
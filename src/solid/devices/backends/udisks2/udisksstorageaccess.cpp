@@ -7,6 +7,7 @@
 */
 
 #include "udisksstorageaccess.h"
+#include "udisksservicehealth.h"
 #include "udisks_debug.h"
 #include "udisks2.h"
 
@@ -93,19 +94,19 @@ QString StorageAccess::filePath() const
             return QString();
         }
         Device holderDevice(path);
-        mntPoints = qdbus_cast<QByteArrayList>(holderDevice.prop("MountPoints"));
+        mntPoints = qdbus_cast<QByteArrayList>(holderDevice.prop(QStringLiteral("MountPoints")));
         // FIXME Solid doesn't support multiple mount points
         return get_shortest(mntPoints);
     }
 
-    mntPoints = qdbus_cast<QByteArrayList>(m_device->prop("MountPoints"));
+    mntPoints = qdbus_cast<QByteArrayList>(m_device->prop(QStringLiteral("MountPoints")));
     // FIXME Solid doesn't support multiple mount points
     return get_shortest(mntPoints);
 }
 
 bool StorageAccess::isIgnored() const
 {
-    if (m_device->prop("HintIgnore").toBool()) {
+    if (m_device->prop(QStringLiteral("HintIgnore")).toBool()) {
         return true;
     }
 
@@ -122,6 +123,13 @@ bool StorageAccess::setup()
     if (m_teardownInProgress || m_setupInProgress) {
         return false;
     }
+    if (ServiceHealth::instance()->isTripped()) {
+        /* Fail in milliseconds instead of queueing the request behind
+         * the hung daemon for a 25 second D-Bus timeout. */
+        m_device->broadcastActionDone("setup", Solid::BackendUnavailable,
+                                      QStringLiteral("The udisks2 daemon is not responding"));
+        return false;
+    }
     m_setupInProgress = true;
     m_device->broadcastActionRequested("setup");
 
@@ -137,6 +145,11 @@ bool StorageAccess::teardown()
     if (m_teardownInProgress || m_setupInProgress) {
         return false;
     }
+    if (ServiceHealth::instance()->isTripped()) {
+        m_device->broadcastActionDone("teardown", Solid::BackendUnavailable,
+                                      QStringLiteral("The udisks2 daemon is not responding"));
+        return false;
+    }
     m_teardownInProgress = true;
     m_device->broadcastActionRequested("teardown");
 
@@ -150,6 +163,10 @@ void StorageAccess::updateCache()
 
 void StorageAccess::checkAccessibility()
 {
+    /* A change may be a lock or unlock; the cleartext device has to be
+     * re-resolved in that case. */
+    m_clearTextPath.clear();
+
     const bool old_isAccessible = m_isAccessible;
     updateCache();
 
@@ -184,13 +201,13 @@ void StorageAccess::slotDBusReply(const QDBusMessage & /*reply*/)
                 Device drive(drivePath);
                 QDBusConnection c = QDBusConnection::systemBus();
 
-                if (drive.prop("MediaRemovable").toBool() &&
-                        drive.prop("MediaAvailable").toBool() &&
+                if (drive.prop(QStringLiteral("MediaRemovable")).toBool() &&
+                        drive.prop(QStringLiteral("MediaAvailable")).toBool() &&
                         !m_device->isOpticalDisc()) { // optical drives have their Eject method
                     QDBusMessage msg = QDBusMessage::createMethodCall(UD2_DBUS_SERVICE, drivePath, UD2_DBUS_INTERFACE_DRIVE, "Eject");
                     msg << QVariantMap();   // options, unused now
                     c.call(msg, QDBus::NoBlock);
-                } else if (drive.prop("CanPowerOff").toBool() &&
+                } else if (drive.prop(QStringLiteral("CanPowerOff")).toBool() &&
                         !m_device->isOpticalDisc()) { // avoid disconnecting optical drives from the bus
                     qCDebug(UDISKS2) << "Drive can power off:" << drivePath;
                     QDBusMessage msg = QDBusMessage::createMethodCall(UD2_DBUS_SERVICE, drivePath, UD2_DBUS_INTERFACE_DRIVE, "PowerOff");
@@ -212,6 +229,24 @@ void StorageAccess::slotDBusError(const QDBusError &error)
 {
     //qDebug() << Q_FUNC_INFO << "DBUS ERROR:" << error.name() << error.message();
 
+    if (ServiceHealth::isTimeoutError(error)) {
+        /* Feed the circuit breaker; enough of these in a row and the
+         * following operations fail fast instead of timing out too. */
+        ServiceHealth::instance()->recordTimeout();
+
+        const QString message = QStringLiteral("The udisks2 daemon did not respond: ") + error.message();
+        if (m_setupInProgress) {
+            m_setupInProgress = false;
+            m_device->broadcastActionDone("setup", Solid::BackendUnavailable, message);
+            checkAccessibility();
+        } else if (m_teardownInProgress) {
+            m_teardownInProgress = false;
+            m_device->broadcastActionDone("teardown", Solid::BackendUnavailable, message);
+            checkAccessibility();
+        }
+        return;
+    }
+
     if (m_setupInProgress) {
         m_setupInProgress = false;
         m_device->broadcastActionDone("setup", m_device->errorToSolidError(error.name()),
@@ -269,7 +304,7 @@ bool StorageAccess::mount()
     QDBusMessage msg = QDBusMessage::createMethodCall(UD2_DBUS_SERVICE, path, UD2_DBUS_INTERFACE_FILESYSTEM, "Mount");
     QVariantMap options;
 
-    if (m_device->prop("IdType").toString() == "vfat") {
+    if (m_device->prop(QStringLiteral("IdType")).toString() == "vfat") {
         options.insert("options", "flush");
     }
 
@@ -312,6 +347,21 @@ QString StorageAccess::generateReturnObjectPath()
 
 QString StorageAccess::clearTextPath() const
 {
+    /* Recent daemons track the unlocked device for us; one cached property
+     * read replaces enumerating all block devices. */
+    const QVariant cleartextDevice = m_device->prop(QStringLiteral("CleartextDevice"));
+    if (cleartextDevice.isValid()) {
+        const QString path = cleartextDevice.value<QDBusObjectPath>().path();
+        return path == QLatin1String("/") ? QString() : path;
+    }
+
+    /* Old daemons: walk the block devices looking for the one backed by
+     * us. The walk is expensive, so the hit is cached until the device
+     * changes again (lock/unlock). */
+    if (!m_clearTextPath.isEmpty()) {
+        return m_clearTextPath;
+    }
+
     const QString prefix = "/org/freedesktop/UDisks2/block_devices";
     QDBusMessage call = QDBusMessage::createMethodCall(UD2_DBUS_SERVICE, prefix,
                         DBUS_INTERFACE_INTROSPECT, "Introspect");
@@ -328,8 +378,9 @@ QString StorageAccess::clearTextPath() const
                 const QString udi = prefix + "/" + nodeElem.attribute("name");
                 Device holderDevice(udi);
 
-                if (m_device->udi() == holderDevice.prop("CryptoBackingDevice").value<QDBusObjectPath>().path()) {
+                if (m_device->udi() == holderDevice.prop(QStringLiteral("CryptoBackingDevice")).value<QDBusObjectPath>().path()) {
                     //qDebug() << Q_FUNC_INFO << "CLEARTEXT device path: " << udi;
+                    m_clearTextPath = udi;
                     return udi;
                 }
             }
@@ -395,11 +446,72 @@ void StorageAccess::callCryptoSetup(const QString &passphrase)
                        SLOT(slotDBusError(QDBusError)));
 }
 
+StorageAccessBatch::StorageAccessBatch(const QList<StorageAccess *> &accesses, Operation operation, QObject *parent)
+    : QObject(parent), m_accesses(accesses), m_operation(operation), m_remaining(0)
+{
+}
+
+void StorageAccessBatch::start()
+{
+    m_remaining = m_accesses.count();
+    m_done.clear();
+    m_errors.clear();
+
+    if (m_accesses.isEmpty()) {
+        Q_EMIT finished(m_errors);
+        return;
+    }
+
+    /* Connect everything first, then fire all operations; each setup() or
+     * teardown() just dispatches an asynchronous D-Bus call, so the whole
+     * batch is in flight before the first reply arrives. */
+    for (StorageAccess *access : qAsConst(m_accesses)) {
+        if (m_operation == Setup) {
+            connect(access, &StorageAccess::setupDone,
+                    this, &StorageAccessBatch::slotOperationDone, Qt::UniqueConnection);
+        } else {
+            connect(access, &StorageAccess::teardownDone,
+                    this, &StorageAccessBatch::slotOperationDone, Qt::UniqueConnection);
+        }
+    }
+
+    for (StorageAccess *access : qAsConst(m_accesses)) {
+        const bool started = (m_operation == Setup) ? access->setup() : access->teardown();
+        if (!started) {
+            /* Another operation is already running on this device; it will
+             * not report for us, so account for it right away. */
+            operationDone(access->m_device->udi(), Solid::DeviceBusy);
+        }
+    }
+}
+
+void StorageAccessBatch::slotOperationDone(Solid::ErrorType error, QVariant errorData, const QString &udi)
+{
+    Q_UNUSED(errorData)
+    operationDone(udi, error);
+}
+
+void StorageAccessBatch::operationDone(const QString &udi, Solid::ErrorType error)
+{
+    if (m_done.contains(udi)) {
+        return;
+    }
+    m_done.insert(udi);
+
+    if (error != Solid::NoError) {
+        m_errors.insert(udi, error);
+    }
+
+    if (--m_remaining == 0) {
+        Q_EMIT finished(m_errors);
+    }
+}
+
 bool StorageAccess::callCryptoTeardown(bool actOnParent)
 {
     QDBusConnection c = QDBusConnection::systemBus();
     QDBusMessage msg = QDBusMessage::createMethodCall(UD2_DBUS_SERVICE,
-                       actOnParent ? (m_device->prop("CryptoBackingDevice").value<QDBusObjectPath>().path()) : m_device->udi(),
+                       actOnParent ? (m_device->prop(QStringLiteral("CryptoBackingDevice")).value<QDBusObjectPath>().path()) : m_device->udi(),
                        UD2_DBUS_INTERFACE_ENCRYPTED, "Lock");
     msg << QVariantMap();   // options, unused now
 
@@ -13,6 +13,8 @@
 
 #include <QDBusMessage>
 #include <QDBusError>
+#include <QMap>
+#include <QSet>
 
 namespace Solid
 {
@@ -81,7 +83,53 @@ private:
     bool m_passphraseRequested;
     QString m_lastReturnObject;
 
+    /* Resolved cleartext device of a LUKS container, dropped whenever the
+     * device changes (lock/unlock). Only used for daemons too old to
+     * provide the CleartextDevice property. */
+    mutable QString m_clearTextPath;
+
     static const int s_unmountTimeout = 0x7fffffff;
+
+    friend class StorageAccessBatch;
+};
+
+/**
+ * Drives setup() or teardown() on a whole batch of StorageAccess
+ * instances at once. The underlying UDisks2 calls are asynchronous, so
+ * all operations stay in flight concurrently and the batch completes
+ * with the slowest device instead of the sum of all of them. One
+ * aggregate finished() signal reports the devices that failed.
+ */
+class StorageAccessBatch : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Operation { Setup, Teardown };
+
+    StorageAccessBatch(const QList<StorageAccess *> &accesses, Operation operation, QObject *parent = nullptr);
+
+    void start();
+
+Q_SIGNALS:
+    /**
+     * Emitted once, when the last device of the batch has reported back.
+     *
+     * @param errors the UDIs which failed, with the reported error
+     */
+    void finished(const QMap<QString, Solid::ErrorType> &errors);
+
+private Q_SLOTS:
+    void slotOperationDone(Solid::ErrorType error, QVariant errorData, const QString &udi);
+
+private:
+    void operationDone(const QString &udi, Solid::ErrorType error);
+
+    QList<StorageAccess *> m_accesses;
+    Operation m_operation;
+    int m_remaining;
+    QSet<QString> m_done;
+    QMap<QString, Solid::ErrorType> m_errors;
 };
 }
 }
@@ -28,7 +28,7 @@ StorageDrive::~StorageDrive()
 
 qulonglong StorageDrive::size() const
 {
-    return m_device->prop("Size").toULongLong();
+    return m_device->prop(QStringLiteral("Size")).toULongLong();
 }
 
 bool StorageDrive::isHotpluggable() const
@@ -38,7 +38,7 @@ bool StorageDrive::isHotpluggable() const
     return _bus == Solid::StorageDrive::Usb || _bus == Solid::StorageDrive::Ieee1394 ||
            (m_udevDevice.deviceProperty("UDISKS_SYSTEM").isValid() && !m_udevDevice.deviceProperty("UDISKS_SYSTEM").toBool());
 #elif defined(Q_OS_FREEBSD)
-    return m_device->prop("bsdisks_IsHotpluggable").toBool();
+    return m_device->prop(QStringLiteral("bsdisks_IsHotpluggable")).toBool();
 #else
 #error Implement this or stub this out for your platform
 #endif
@@ -46,12 +46,12 @@ bool StorageDrive::isHotpluggable() const
 
 bool StorageDrive::isRemovable() const
 {
-    return m_device->prop("MediaRemovable").toBool() || m_device->prop("Removable").toBool();
+    return m_device->prop(QStringLiteral("MediaRemovable")).toBool() || m_device->prop(QStringLiteral("Removable")).toBool();
 }
 
 Solid::StorageDrive::DriveType StorageDrive::driveType() const
 {
-    const QStringList mediaTypes = m_device->prop("MediaCompatibility").toStringList();
+    const QStringList mediaTypes = m_device->prop(QStringLiteral("MediaCompatibility")).toStringList();
 
     if (m_device->isOpticalDrive()) { // optical disks
         return Solid::StorageDrive::CdromDrive;
@@ -85,12 +85,12 @@ Solid::StorageDrive::DriveType StorageDrive::driveType() const
 
 Solid::StorageDrive::Bus StorageDrive::bus() const
 {
-    const QString bus = m_device->prop("ConnectionBus").toString();
+    const QString bus = m_device->prop(QStringLiteral("ConnectionBus")).toString();
     const QString udevBus = 
 #if UDEV_FOUND
         m_udevDevice.deviceProperty("ID_BUS").toString();
 #elif defined(Q_OS_FREEBSD)
-        m_device->prop("bsdisks_ConnectionBus").toString();
+        m_device->prop(QStringLiteral("bsdisks_ConnectionBus")).toString();
 #else
 #error Implement this or stub this out for your platform
 #endif
@@ -105,7 +105,7 @@ Solid::StorageDrive::Bus StorageDrive::bus() const
             return Solid::StorageDrive::Ide;
         }
 #elif defined(Q_OS_FREEBSD)
-        if (m_device->prop("bsdisks_AtaSata").toString() == "sata") { // serial ATA
+        if (m_device->prop(QStringLiteral("bsdisks_AtaSata")).toString() == "sata") { // serial ATA
             return Solid::StorageDrive::Sata;
         } else { // parallel (classical) ATA
             return Solid::StorageDrive::Ide;
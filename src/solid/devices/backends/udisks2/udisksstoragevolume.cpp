@@ -23,7 +23,7 @@ StorageVolume::~StorageVolume()
 
 QString StorageVolume::encryptedContainerUdi() const
 {
-    const QString path = m_device->prop("CryptoBackingDevice").value<QDBusObjectPath>().path();
+    const QString path = m_device->prop(QStringLiteral("CryptoBackingDevice")).value<QDBusObjectPath>().path();
     if (path.isEmpty() || path == "/") {
         return QString();
     } else {
@@ -33,34 +33,34 @@ QString StorageVolume::encryptedContainerUdi() const
 
 qulonglong StorageVolume::size() const
 {
-    return m_device->prop("Size").toULongLong();
+    return m_device->prop(QStringLiteral("Size")).toULongLong();
 }
 
 QString StorageVolume::uuid() const
 {
-    return m_device->prop("IdUUID").toString();
+    return m_device->prop(QStringLiteral("IdUUID")).toString();
 }
 
 QString StorageVolume::label() const
 {
-    QString label = m_device->prop("HintName").toString();
+    QString label = m_device->prop(QStringLiteral("HintName")).toString();
     if (label.isEmpty()) {
-        label = m_device->prop("IdLabel").toString();
+        label = m_device->prop(QStringLiteral("IdLabel")).toString();
     }
     if (label.isEmpty()) {
-        label = m_device->prop("Name").toString();
+        label = m_device->prop(QStringLiteral("Name")).toString();
     }
     return label;
 }
 
 QString StorageVolume::fsType() const
 {
-    return m_device->prop("IdType").toString();
+    return m_device->prop(QStringLiteral("IdType")).toString();
 }
 
 Solid::StorageVolume::UsageType StorageVolume::usage() const
 {
-    const QString usage = m_device->prop("IdUsage").toString();
+    const QString usage = m_device->prop(QStringLiteral("IdUsage")).toString();
 
     if (m_device->hasInterface(UD2_DBUS_INTERFACE_FILESYSTEM)) {
         return Solid::StorageVolume::FileSystem;
@@ -80,7 +80,7 @@ Solid::StorageVolume::UsageType StorageVolume::usage() const
 bool StorageVolume::isIgnored() const
 {
     const Solid::StorageVolume::UsageType usg = usage();
-    if (m_device->prop("HintIgnore").toBool()) {
+    if (m_device->prop(QStringLiteral("HintIgnore")).toBool()) {
         return true;
     }
 
@@ -89,6 +89,6 @@ bool StorageVolume::isIgnored() const
         return true;
     }
 
-    const QString backingFile = m_device->prop("BackingFile").toString();
+    const QString backingFile = m_device->prop(QStringLiteral("BackingFile")).toString();
     return !backingFile.isEmpty() && !backingFile.startsWith(QDir::homePath());
 }
@@ -13,12 +13,23 @@
 
 #include <solid/genericinterface.h>
 #include <solid/device.h>
+#include "solidconfig_p.h"
 
 #include <QStringList>
 #include <QDBusReply>
 
 using namespace Solid::Backends::UPower;
 
+// Minimum spacing between changed() emissions in milliseconds,
+// overridable per process with SOLID_UPOWER_CHANGE_RATE_LIMIT (0
+// disables the limiting). A charging battery reports sub-percent deltas
+// several times a second; nothing in a desktop reacts meaningfully
+// faster than this.
+static int defaultChangeRateLimit()
+{
+    return Solid::Config::snapshot()->upowerChangeRateLimitMs;
+}
+
 UPowerDevice::UPowerDevice(const QString &udi)
     : Solid::Ifaces::Device()
     , m_device(UP_DBUS_SERVICE,
@@ -26,7 +37,12 @@ UPowerDevice::UPowerDevice(const QString &udi)
                UP_DBUS_INTERFACE_DEVICE,
                QDBusConnection::systemBus())
     , m_udi(udi)
+    , m_cachePopulated(false)
+    , m_changeRateLimit(defaultChangeRateLimit())
 {
+    m_pendingChange.setSingleShot(true);
+    connect(&m_pendingChange, SIGNAL(timeout()), this, SLOT(emitPendingChange()));
+
     if (m_device.isValid()) {
         if (m_device.metaObject()->indexOfSignal("Changed()") != -1) {
             connect(&m_device, SIGNAL(Changed()), this, SLOT(slotChanged()));
@@ -178,7 +194,7 @@ QString UPowerDevice::parentUdi() const
 
 void UPowerDevice::checkCache(const QString &key) const
 {
-    if (m_cache.isEmpty()) { // recreate the cache
+    if (!m_cachePopulated) { // recreate the cache
         allProperties();
     }
 
@@ -217,8 +233,10 @@ QMap<QString, QVariant> UPowerDevice::allProperties() const
 
     if (reply.isValid()) {
         m_cache = reply.value();
+        m_cachePopulated = true;
     } else {
         m_cache.clear();
+        m_cachePopulated = false;
     }
 
     return m_cache;
@@ -226,18 +244,56 @@ QMap<QString, QVariant> UPowerDevice::allProperties() const
 
 void UPowerDevice::onPropertiesChanged(const QString &ifaceName, const QVariantMap &changedProps, const QStringList &invalidatedProps)
 {
-    Q_UNUSED(changedProps);
-    Q_UNUSED(invalidatedProps);
+    if (ifaceName != UP_DBUS_INTERFACE_DEVICE) {
+        return;
+    }
 
-    if (ifaceName == UP_DBUS_INTERFACE_DEVICE) {
-        slotChanged(); // TODO maybe process the properties separately?
+    // the signal carries the new values; patch them into the cache instead
+    // of throwing it away, so steady-state polling (battery charge, rates,
+    // times) is served from memory without any D-Bus reads
+    for (auto it = changedProps.constBegin(); it != changedProps.constEnd(); ++it) {
+        m_cache[it.key()] = it.value();
     }
+    for (const QString &propName : invalidatedProps) {
+        m_cache.remove(propName);
+    }
+
+    scheduleChanged();
 }
 
 void UPowerDevice::slotChanged()
 {
     // given we cannot know which property/ies changed, clear the cache
     m_cache.clear();
+    m_cachePopulated = false;
+    scheduleChanged();
+}
+
+void UPowerDevice::scheduleChanged()
+{
+    if (m_changeRateLimit <= 0) {
+        Q_EMIT changed();
+        return;
+    }
+
+    // An isolated event (plugging the charger in) passes through
+    // immediately; only a sustained burst gets coalesced, into one
+    // trailing emission per rate-limit window.
+    const qint64 elapsed = m_sinceLastChange.isValid() ? m_sinceLastChange.elapsed() : -1;
+    if (elapsed < 0 || elapsed >= m_changeRateLimit) {
+        m_sinceLastChange.start();
+        Q_EMIT changed();
+        return;
+    }
+
+    if (!m_pendingChange.isActive()) {
+        m_pendingChange.start(m_changeRateLimit - static_cast<int>(elapsed));
+    }
+}
+
+void UPowerDevice::emitPendingChange()
+{
+    m_sinceLastChange.start();
     Q_EMIT changed();
 }
 
@@ -13,6 +13,8 @@
 #include <solid/deviceinterface.h>
 
 #include <QDBusInterface>
+#include <QElapsedTimer>
+#include <QTimer>
 
 namespace Solid
 {
@@ -48,13 +50,24 @@ Q_SIGNALS:
 private Q_SLOTS:
     void onPropertiesChanged(const QString &ifaceName, const QVariantMap &changedProps, const QStringList &invalidatedProps);
     void slotChanged();
+    void emitPendingChange();
     void login1Resuming(bool active);
 
 private:
     QString batteryTechnology() const;
+    void scheduleChanged();
+
     mutable QDBusInterface m_device;
     QString m_udi;
     mutable QVariantMap m_cache;
+    mutable bool m_cachePopulated;
+
+    // Rate limiting of the changed() signal; the cache is patched before
+    // scheduling, so a consumer woken by the coalesced emission always
+    // reads the newest values (last-value-wins).
+    int m_changeRateLimit;
+    QElapsedTimer m_sinceLastChange;
+    QTimer m_pendingChange;
 
     void checkCache(const QString &key) const;
 };
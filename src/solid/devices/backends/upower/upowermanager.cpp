@@ -57,9 +57,9 @@ UPowerManager::UPowerManager(QObject *parent)
                     this, SLOT(onDeviceRemoved(QDBusObjectPath)));
         } else {
             connect(&m_manager, SIGNAL(DeviceAdded(QString)),
-                    this, SIGNAL(deviceAdded(QString)));
+                    this, SLOT(onDeviceAdded(QString)));
             connect(&m_manager, SIGNAL(DeviceRemoved(QString)),
-                    this, SIGNAL(deviceRemoved(QString)));
+                    this, SLOT(onDeviceRemoved(QString)));
         }
     }
 }
@@ -125,6 +125,14 @@ QStringList UPowerManager::devicesFromQuery(const QString &parentUdi, Solid::Dev
 
 QStringList UPowerManager::allDevices()
 {
+    // One EnumerateDevices round trip primes the cache; afterwards the
+    // DeviceAdded/DeviceRemoved subscription keeps it current, so the
+    // per-status-tick enumerations of the power consumers are answered
+    // from memory.
+    if (m_cachePrimed) {
+        return m_deviceCache;
+    }
+
     QDBusReply<QList<QDBusObjectPath> > reply = m_manager.call("EnumerateDevices");
 
     if (!reply.isValid()) {
@@ -140,6 +148,9 @@ QStringList UPowerManager::allDevices()
         retList << path.path();
     }
 
+    m_deviceCache = retList;
+    m_cachePrimed = true;
+
     return retList;
 }
 
@@ -155,11 +166,27 @@ QString UPowerManager::udiPrefix() const
 
 void UPowerManager::onDeviceAdded(const QDBusObjectPath &path)
 {
-    Q_EMIT deviceAdded(path.path());
+    onDeviceAdded(path.path());
 }
 
 void UPowerManager::onDeviceRemoved(const QDBusObjectPath &path)
 {
-    Q_EMIT deviceRemoved(path.path());
+    onDeviceRemoved(path.path());
+}
+
+void UPowerManager::onDeviceAdded(const QString &udi)
+{
+    if (m_cachePrimed && !m_deviceCache.contains(udi)) {
+        m_deviceCache.append(udi);
+    }
+    Q_EMIT deviceAdded(udi);
+}
+
+void UPowerManager::onDeviceRemoved(const QString &udi)
+{
+    if (m_cachePrimed) {
+        m_deviceCache.removeAll(udi);
+    }
+    Q_EMIT deviceRemoved(udi);
 }
 
@@ -37,10 +37,17 @@ public:
 private Q_SLOTS:
     void onDeviceAdded(const QDBusObjectPath &path);
     void onDeviceRemoved(const QDBusObjectPath &path);
+    void onDeviceAdded(const QString &udi);
+    void onDeviceRemoved(const QString &udi);
 
 private:
     QSet<Solid::DeviceInterface::Type> m_supportedInterfaces;
     QDBusInterface m_manager;
+
+    // Device list enumerated once and maintained from the DeviceAdded/
+    // DeviceRemoved signals afterwards, so allDevices() is a memory read.
+    QStringList m_deviceCache;
+    bool m_cachePrimed = false;
 };
 
 }
@@ -17,7 +17,9 @@ QMap<QString, WinBattery::Battery> WinBattery::m_udiToGDI = QMap<QString, WinBat
 
 WinBattery::WinBattery(WinDevice *device) :
     WinInterface(device),
-    m_state(Solid::Battery::NoCharge)
+    m_state(Solid::Battery::NoCharge),
+    m_staticInfoValid(false),
+    m_staticInfoTag(0)
 {
     powerChanged();
     connect(SolidWinEventFilter::instance(), SIGNAL(powerChanged()), this, SLOT(powerChanged()));
@@ -115,24 +117,19 @@ const WinBattery::Battery WinBattery::batteryInfoFromUdi(const QString &udi)
     return m_udiToGDI[udi];
 }
 
-void WinBattery::powerChanged()
+// Fetches the data that only changes when the battery itself changes:
+// chemistry, capabilities, capacities and the serial number. The battery
+// tag identifies one physical battery attachment, so the inquiry IOCTLs
+// are only reissued when the tag differs from the one last seen; the
+// per-event refresh in powerChanged() is then limited to the status
+// query.
+void WinBattery::initStaticInfo(const Battery &b)
 {
-
-    const int old_charge  = m_charge;
-    const int old_capacity = m_capacity;
-    const Solid::Battery::ChargeState old_state = m_state;
-    const bool old_isPowerSupply = m_isPowerSupply;
-    const double old_energy = m_energy;
-    const double old_energyFull = m_energyFull;
-    const double old_energyFullDesign = m_energyFullDesign;
-    const double old_energyRate = m_energyRate;
-    const double old_voltage = m_voltage;
-
-    BATTERY_WAIT_STATUS batteryStatusQuery;
-    ZeroMemory(&batteryStatusQuery, sizeof(batteryStatusQuery));
-    Battery b =  m_udiToGDI[m_device->udi()];
-    batteryStatusQuery.BatteryTag = b.second;
-    BATTERY_STATUS status = WinDeviceManager::getDeviceInfo<BATTERY_STATUS, BATTERY_WAIT_STATUS>(b.first, IOCTL_BATTERY_QUERY_STATUS, &batteryStatusQuery);
+    if (m_staticInfoValid && m_staticInfoTag == b.second) {
+        return;
+    }
+    m_staticInfoValid = true;
+    m_staticInfoTag = b.second;
 
     BATTERY_QUERY_INFORMATION batteryInformationQuery;
     ZeroMemory(&batteryInformationQuery, sizeof(batteryInformationQuery));
@@ -141,10 +138,6 @@ void WinBattery::powerChanged()
     BATTERY_INFORMATION info = WinDeviceManager::getDeviceInfo<BATTERY_INFORMATION, BATTERY_QUERY_INFORMATION>(b.first, IOCTL_BATTERY_QUERY_INFORMATION, &batteryInformationQuery);
 
     initSerial(b);
-    updateBatteryTemp(b);
-    updateTimeToEmpty(b);
-
-    m_isPowerSupply = !(status.PowerState & BATTERY_POWER_ON_LINE);
 
     QString tech = QString::fromUtf8((const char *)info.Chemistry, 4);
 
@@ -160,18 +153,55 @@ void WinBattery::powerChanged()
         m_technology = Solid::Battery::UnknownTechnology;
     }
 
-    m_energy = status.Capacity / 1000.0;//provided in mWh
+    m_fullChargedCapacity = info.FullChargedCapacity;
+    m_designedCapacity = info.DesignedCapacity;
     m_energyFull = info.FullChargedCapacity / 1000.0; // provided in mWh
     m_energyFullDesign = info.DesignedCapacity / 1000.0; // provided in mWh
+
+    if (info.Capabilities & BATTERY_SYSTEM_BATTERY) {
+        m_type = Solid::Battery::PrimaryBattery;
+    } else {
+        m_type = Solid::Battery::UnknownBattery;
+    }
+
+    m_rechargeable = info.Technology == 1;
+}
+
+void WinBattery::powerChanged()
+{
+
+    const int old_charge  = m_charge;
+    const int old_capacity = m_capacity;
+    const Solid::Battery::ChargeState old_state = m_state;
+    const bool old_isPowerSupply = m_isPowerSupply;
+    const double old_energy = m_energy;
+    const double old_energyFull = m_energyFull;
+    const double old_energyFullDesign = m_energyFullDesign;
+    const double old_energyRate = m_energyRate;
+    const double old_voltage = m_voltage;
+
+    BATTERY_WAIT_STATUS batteryStatusQuery;
+    ZeroMemory(&batteryStatusQuery, sizeof(batteryStatusQuery));
+    Battery b =  m_udiToGDI[m_device->udi()];
+    batteryStatusQuery.BatteryTag = b.second;
+    BATTERY_STATUS status = WinDeviceManager::getDeviceInfo<BATTERY_STATUS, BATTERY_WAIT_STATUS>(b.first, IOCTL_BATTERY_QUERY_STATUS, &batteryStatusQuery);
+
+    initStaticInfo(b);
+    updateBatteryTemp(b);
+    updateTimeToEmpty(b);
+
+    m_isPowerSupply = !(status.PowerState & BATTERY_POWER_ON_LINE);
+
+    m_energy = status.Capacity / 1000.0;//provided in mWh
     m_energyRate = status.Rate / 1000.0;//provided in mW
     m_voltage = status.Voltage / 1000.0;//provided in mV
 
-    if (info.FullChargedCapacity != 0) {
-        m_charge = (float)status.Capacity / info.FullChargedCapacity * 100.0;
+    if (m_fullChargedCapacity != 0) {
+        m_charge = (float)status.Capacity / m_fullChargedCapacity * 100.0;
     }
 
-    if (info.DesignedCapacity != 0) {
-        m_capacity = (float)info.FullChargedCapacity / info.DesignedCapacity * 100.0;
+    if (m_designedCapacity != 0) {
+        m_capacity = (float)m_fullChargedCapacity / m_designedCapacity * 100.0;
     }
 
     if (status.PowerState == 0) {
@@ -186,14 +216,6 @@ void WinBattery::powerChanged()
 
     //    }
 
-    if (info.Capabilities & BATTERY_SYSTEM_BATTERY) {
-        m_type = Solid::Battery::PrimaryBattery;
-    } else {
-        m_type = Solid::Battery::UnknownBattery;
-    }
-
-    m_rechargeable = info.Technology == 1;
-
     if (m_charge != old_charge) {
         Q_EMIT chargePercentChanged(m_charge, m_device->udi());
     }
@@ -100,6 +100,7 @@ private Q_SLOTS:
     void powerChanged();
 
 private:
+    void initStaticInfo(const Battery &b);
     void initSerial(const Battery &b);
     void updateTimeToEmpty(const Battery &b);
     void updateBatteryTemp(const Battery &b);
@@ -122,6 +123,13 @@ private:
     ulong m_temperature;
     ulong m_timeUntilEmpty;
 
+    // static inquiry data (chemistry, capacities, serial) is only
+    // re-read when the battery tag changes; see initStaticInfo()
+    bool m_staticInfoValid;
+    ulong m_staticInfoTag;
+    ulong m_fullChargedCapacity;
+    ulong m_designedCapacity;
+
 
 };
 }
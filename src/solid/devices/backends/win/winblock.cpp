@@ -17,6 +17,7 @@ using namespace Solid::Backends::Win;
 QMap<QString, QString> WinBlock::m_driveLetters = QMap<QString, QString>();
 QMap<QString, QSet<QString> > WinBlock::m_driveUDIS = QMap<QString, QSet<QString> >();
 QMap<QString, QString> WinBlock::m_virtualDrives = QMap<QString, QString>();
+QMap<QString, QPair<int, int> > WinBlock::m_deviceNumbers = QMap<QString, QPair<int, int> >();
 
 WinBlock::WinBlock(WinDevice *device):
     WinInterface(device),
@@ -24,9 +25,17 @@ WinBlock::WinBlock(WinDevice *device):
     m_minor(-1)
 {
     if (m_device->type() == Solid::DeviceInterface::StorageVolume) {
-        STORAGE_DEVICE_NUMBER info = WinDeviceManager::getDeviceInfo<STORAGE_DEVICE_NUMBER>(driveLetterFromUdi(m_device->udi()), IOCTL_STORAGE_GET_DEVICE_NUMBER);
-        m_major = info.DeviceNumber;
-        m_minor = info.PartitionNumber;
+        if (m_deviceNumbers.contains(m_device->udi())) {
+            const QPair<int, int> numbers = m_deviceNumbers[m_device->udi()];
+            m_major = numbers.first;
+            m_minor = numbers.second;
+        } else {
+            // not seen by updateUdiFromBitMask() yet; resolve and remember
+            STORAGE_DEVICE_NUMBER info = WinDeviceManager::getDeviceInfo<STORAGE_DEVICE_NUMBER>(driveLetterFromUdi(m_device->udi()), IOCTL_STORAGE_GET_DEVICE_NUMBER);
+            m_major = info.DeviceNumber;
+            m_minor = info.PartitionNumber;
+            m_deviceNumbers[m_device->udi()] = qMakePair(m_major, m_minor);
+        }
     } else if (m_device->type() == Solid::DeviceInterface::StorageDrive ||
                m_device->type() == Solid::DeviceInterface::OpticalDrive ||
                m_device->type() == Solid::DeviceInterface::OpticalDisc) {
@@ -109,6 +118,12 @@ QSet<QString> WinBlock::updateUdiFromBitMask(const DWORD unitmask)
     QString dosPath;
     for (const QString &drive : drives) {
         QSet<QString> udis;
+        // this drive's previous generation of UDIs is being re-resolved,
+        // so any device numbers remembered for them are stale
+        const QSet<QString> oldUdis = m_driveUDIS.value(drive);
+        for (const QString &oldUdi : oldUdis) {
+            m_deviceNumbers.remove(oldUdi);
+        }
         driveWCHAR[drive.toWCharArray(driveWCHAR)] = 0;
         if (GetDriveType(driveWCHAR) == DRIVE_REMOTE) { //network drive
             QSettings settings(QLatin1String("HKEY_CURRENT_USER\\Network\\") + drive.at(0), QSettings::NativeFormat);
@@ -132,9 +147,12 @@ QSet<QString> WinBlock::updateUdiFromBitMask(const DWORD unitmask)
 
                 switch (info.DeviceType) {
                 case FILE_DEVICE_DISK: {
-                    udis << QString("/org/kde/solid/win/volume/disk#%1,partition#%2").arg(info.DeviceNumber).arg(info.PartitionNumber);
+                    const QString volumeUdi = QString("/org/kde/solid/win/volume/disk#%1,partition#%2").arg(info.DeviceNumber).arg(info.PartitionNumber);
+                    udis << volumeUdi;
                     udis << QString("/org/kde/solid/win/storage/disk#%1").arg(info.DeviceNumber);
-
+                    // remember the numbers so WinBlock doesn't have to
+                    // reissue the IOCTL for this volume
+                    m_deviceNumbers[volumeUdi] = qMakePair<int, int>(info.DeviceNumber, info.PartitionNumber);
                 }
                 break;
                 case FILE_DEVICE_CD_ROM:
@@ -42,6 +42,9 @@ private:
     static QMap<QString, QString> m_driveLetters;
     static QMap<QString, QSet<QString> > m_driveUDIS;
     static QMap<QString, QString> m_virtualDrives;
+    // device/partition numbers per volume UDI, learned while resolving
+    // the UDIs so constructing a WinBlock doesn't reopen the device
+    static QMap<QString, QPair<int, int> > m_deviceNumbers;
 
     int m_major;
     int m_minor;
@@ -28,6 +28,8 @@ SolidWinEventFilter *SolidWinEventFilter::instance()
 SolidWinEventFilter::SolidWinEventFilter():
     QObject()
     {
+        ZeroMemory(m_powerNotifications, sizeof(m_powerNotifications));
+
         wchar_t title[] = L"KDEWinDeviceManager";
 
         WNDCLASSEX wcex;
@@ -49,10 +51,22 @@ SolidWinEventFilter::SolidWinEventFilter():
             return;
         }
         ShowWindow(m_windowID, SW_HIDE);
+
+        // without explicit registrations WM_POWERBROADCAST only delivers
+        // the legacy AC/battery transitions; these make the system push
+        // battery level and power source changes to our window as they
+        // happen, so nothing has to poll for them
+        m_powerNotifications[0] = RegisterPowerSettingNotification(m_windowID, &GUID_BATTERY_PERCENTAGE_REMAINING, DEVICE_NOTIFY_WINDOW_HANDLE);
+        m_powerNotifications[1] = RegisterPowerSettingNotification(m_windowID, &GUID_ACDC_POWER_SOURCE, DEVICE_NOTIFY_WINDOW_HANDLE);
     }
 
     SolidWinEventFilter::~SolidWinEventFilter()
     {
+        for (HPOWERNOTIFY notification : m_powerNotifications) {
+            if (notification) {
+                UnregisterPowerSettingNotification(notification);
+            }
+        }
         PostMessage(m_windowID, WM_CLOSE, 0, 0);
     }
 
@@ -161,23 +175,44 @@ QStringList WinDeviceManager::devicesFromQuery(const QString &parentUdi, Solid::
 {
 
     QStringList list;
-    const QStringList deviceList = allDevices();
     if (!parentUdi.isEmpty()) {
-        for (const QString &udi : deviceList) {
+        // only devices of the requested main type can match, so the
+        // candidates come straight from the snapshot index
+        const QStringList candidates = m_devicesByType.value(type);
+        for (const QString &udi : candidates) {
             WinDevice device(udi);
-            if (device.type() == type && device.parentUdi() == parentUdi) {
+            if (device.parentUdi() == parentUdi) {
                 list << udi;
             }
         }
+    } else if (type == Solid::DeviceInterface::GenericInterface) {
+        list << m_devicesList;
     } else if (type != Solid::DeviceInterface::Unknown) {
-        for (const QString &udi : deviceList) {
-            WinDevice device(udi);
-            if (device.queryDeviceInterface(type)) {
-                list << udi;
-            }
+        // a device also answers queries for the interfaces its main type
+        // implies; this mirrors WinDevice::queryDeviceInterface()
+        list << m_devicesByType.value(type);
+        switch (type) {
+        case Solid::DeviceInterface::Block:
+            list << m_devicesByType.value(Solid::DeviceInterface::OpticalDrive)
+                 << m_devicesByType.value(Solid::DeviceInterface::StorageVolume)
+                 << m_devicesByType.value(Solid::DeviceInterface::OpticalDisc);
+            break;
+        case Solid::DeviceInterface::StorageDrive:
+            list << m_devicesByType.value(Solid::DeviceInterface::OpticalDrive);
+            break;
+        case Solid::DeviceInterface::StorageAccess:
+            list << m_devicesByType.value(Solid::DeviceInterface::StorageVolume)
+                 << m_devicesByType.value(Solid::DeviceInterface::OpticalDisc);
+            break;
+        case Solid::DeviceInterface::StorageVolume:
+            list << m_devicesByType.value(Solid::DeviceInterface::OpticalDisc);
+            break;
+        default:
+            break;
         }
+        std::sort(list.begin(), list.end());
     } else {
-        list << deviceList;
+        list << m_devicesList;
     }
     return list;
 
@@ -198,6 +233,7 @@ void WinDeviceManager::slotDeviceAdded(const QSet<QString> &udi)
     m_devices += tmp;
     m_devicesList = QStringList(m_devices.begin(), m_devices.end());
     std::sort(m_devicesList.begin(), m_devicesList.end());
+    rebuildTypeIndex();
     for (const QString &str : tmp) {
         Q_EMIT deviceAdded(str);
     }
@@ -208,6 +244,7 @@ void WinDeviceManager::slotDeviceRemoved(const QSet<QString> &udi)
     m_devices -= udi;
     m_devicesList = QStringList(m_devices.begin(), m_devices.end());
     std::sort(m_devicesList.begin(), m_devicesList.end());
+    rebuildTypeIndex();
     for (const QString &str : udi) {
         Q_EMIT deviceRemoved(str);
     }
@@ -222,6 +259,41 @@ void WinDeviceManager::updateDeviceList()
     m_devices = devices;
     m_devicesList = QStringList(m_devices.begin(), m_devices.end());
     std::sort(m_devicesList.begin(), m_devicesList.end());
+    rebuildTypeIndex();
+}
+
+// the UDI encodes the device's main type (see the WinDevice
+// constructor), so the snapshot can be classified with pure string
+// parsing, without constructing devices or issuing DeviceIoControl
+static Solid::DeviceInterface::Type typeFromUdi(const QString &udi)
+{
+    const QString type = udi.section(QLatin1Char('/'), 5, 5);
+
+    if (type == QLatin1String("storage")) {
+        return Solid::DeviceInterface::StorageDrive;
+    } else if (type == QLatin1String("volume")) {
+        return Solid::DeviceInterface::StorageVolume;
+    } else if (type == QLatin1String("storage.cdrom")) {
+        return Solid::DeviceInterface::OpticalDrive;
+    } else if (type == QLatin1String("volume.cdrom")) {
+        return Solid::DeviceInterface::OpticalDisc;
+    } else if (type == QLatin1String("cpu")) {
+        return Solid::DeviceInterface::Processor;
+    } else if (type == QLatin1String("power.battery")) {
+        return Solid::DeviceInterface::Battery;
+    } else if (type == QLatin1String("volume.virtual")) {
+        return Solid::DeviceInterface::StorageAccess;
+    }
+    return Solid::DeviceInterface::Unknown;
+}
+
+void WinDeviceManager::rebuildTypeIndex()
+{
+    m_devicesByType.clear();
+    // m_devicesList is sorted, so each bucket stays sorted too
+    for (const QString &udi : qAsConst(m_devicesList)) {
+        m_devicesByType[typeFromUdi(udi)] << udi;
+    }
 }
 
 
@@ -9,6 +9,7 @@
 
 #include <solid/devices/ifaces/devicemanager.h>
 
+#include <QHash>
 #include <QSet>
 #include <QDebug>
 
@@ -98,9 +99,14 @@ private Q_SLOTS:
 private:
     friend class SolidWinEventFilter;
 
+    void rebuildTypeIndex();
 
     QSet<QString> m_devices;
     QStringList m_devicesList;
+    // snapshot of m_devicesList bucketed by main device type, rebuilt
+    // whenever the device list changes; lets typed queries be answered
+    // without constructing any WinDevice
+    QHash<Solid::DeviceInterface::Type, QStringList> m_devicesByType;
     QSet<Solid::DeviceInterface::Type> m_supportedInterfaces;
 
     template< class INFO, class QUERY>
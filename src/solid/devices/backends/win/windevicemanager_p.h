@@ -40,6 +40,9 @@ Q_SIGNALS:
 
 private:
     HWND m_windowID;
+    // power setting registrations driving battery updates; see the
+    // constructor
+    HPOWERNOTIFY m_powerNotifications[2];
 
 };
 }
@@ -13,6 +13,8 @@
 
 #cmakedefine01 HAVE_MNTENT_H
 
+#cmakedefine01 HAVE_SYS_SDT_H
+
 #cmakedefine01   HAVE_GETMNTINFO
 #cmakedefine01   HAVE_SETMNTENT
 
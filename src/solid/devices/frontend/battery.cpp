@@ -9,53 +9,90 @@
 #include "battery.h"
 #include "battery_p.h"
 
-#include "soliddefs_p.h"
 #include <solid/devices/ifaces/battery.h>
 
+// Fills the whole mirror from the backend on the first read; afterwards
+// the change signals keep the individual fields current.
+static void ensureMirror(const Solid::BatteryPrivate *d)
+{
+    if (d->mirrorFilled) {
+        return;
+    }
+
+    Solid::Ifaces::Battery *iface = d->backendIface<Solid::Ifaces::Battery>();
+    if (iface == nullptr) {
+        return;
+    }
+
+    d->present = iface->isPresent();
+    d->type = iface->type();
+    d->chargePercent = iface->chargePercent();
+    d->capacity = iface->capacity();
+    d->rechargeable = iface->isRechargeable();
+    d->powerSupply = iface->isPowerSupply();
+    d->chargeState = iface->chargeState();
+    d->timeToEmpty = iface->timeToEmpty();
+    d->timeToFull = iface->timeToFull();
+    d->technology = iface->technology();
+    d->energy = iface->energy();
+    d->energyFull = iface->energyFull();
+    d->energyFullDesign = iface->energyFullDesign();
+    d->energyRate = iface->energyRate();
+    d->voltage = iface->voltage();
+    d->temperature = iface->temperature();
+    d->recalled = iface->isRecalled();
+    d->recallVendor = iface->recallVendor();
+    d->recallUrl = iface->recallUrl();
+    d->serial = iface->serial();
+    d->remainingTime = iface->remainingTime();
+
+    d->mirrorFilled = true;
+}
+
 Solid::Battery::Battery(QObject *backendObject)
     : DeviceInterface(*new BatteryPrivate(), backendObject)
 {
     connect(backendObject, SIGNAL(presentStateChanged(bool,QString)),
-            this, SIGNAL(presentStateChanged(bool,QString)));
+            this, SLOT(_k_presentStateChanged(bool,QString)));
 
     connect(backendObject, SIGNAL(chargePercentChanged(int,QString)),
-            this, SIGNAL(chargePercentChanged(int,QString)));
+            this, SLOT(_k_chargePercentChanged(int,QString)));
 
     connect(backendObject, SIGNAL(capacityChanged(int,QString)),
-            this, SIGNAL(capacityChanged(int,QString)));
+            this, SLOT(_k_capacityChanged(int,QString)));
 
     connect(backendObject, SIGNAL(powerSupplyStateChanged(bool,QString)),
-            this, SIGNAL(powerSupplyStateChanged(bool,QString)));
+            this, SLOT(_k_powerSupplyStateChanged(bool,QString)));
 
     connect(backendObject, SIGNAL(chargeStateChanged(int,QString)),
-            this, SIGNAL(chargeStateChanged(int,QString)));
+            this, SLOT(_k_chargeStateChanged(int,QString)));
 
     connect(backendObject, SIGNAL(timeToEmptyChanged(qlonglong,QString)),
-            this, SIGNAL(timeToEmptyChanged(qlonglong,QString)));
+            this, SLOT(_k_timeToEmptyChanged(qlonglong,QString)));
 
     connect(backendObject, SIGNAL(timeToFullChanged(qlonglong,QString)),
-            this, SIGNAL(timeToFullChanged(qlonglong,QString)));
+            this, SLOT(_k_timeToFullChanged(qlonglong,QString)));
 
     connect(backendObject, SIGNAL(energyChanged(double,QString)),
-            this, SIGNAL(energyChanged(double,QString)));
+            this, SLOT(_k_energyChanged(double,QString)));
 
     connect(backendObject, SIGNAL(energyFullChanged(double,QString)),
-            this, SIGNAL(energyFullChanged(double,QString)));
+            this, SLOT(_k_energyFullChanged(double,QString)));
 
     connect(backendObject, SIGNAL(energyFullDesignChanged(double,QString)),
-            this, SIGNAL(energyFullDesignChanged(double,QString)));
+            this, SLOT(_k_energyFullDesignChanged(double,QString)));
 
     connect(backendObject, SIGNAL(energyRateChanged(double,QString)),
-            this, SIGNAL(energyRateChanged(double,QString)));
+            this, SLOT(_k_energyRateChanged(double,QString)));
 
     connect(backendObject, SIGNAL(voltageChanged(double,QString)),
-            this, SIGNAL(voltageChanged(double,QString)));
+            this, SLOT(_k_voltageChanged(double,QString)));
 
     connect(backendObject, SIGNAL(temperatureChanged(double,QString)),
-            this, SIGNAL(temperatureChanged(double,QString)));
+            this, SLOT(_k_temperatureChanged(double,QString)));
 
     connect(backendObject, SIGNAL(remainingTimeChanged(qlonglong,QString)),
-            this, SIGNAL(remainingTimeChanged(qlonglong,QString)));
+            this, SLOT(_k_remainingTimeChanged(qlonglong,QString)));
 }
 
 Solid::Battery::~Battery()
@@ -66,125 +103,244 @@ Solid::Battery::~Battery()
 bool Solid::Battery::isPresent() const
 {
     Q_D(const Battery);
-    return_SOLID_CALL(Ifaces::Battery *, d->backendObject(), false, isPresent());
+    ensureMirror(d);
+    return d->present;
 }
 
 Solid::Battery::BatteryType Solid::Battery::type() const
 {
     Q_D(const Battery);
-    return_SOLID_CALL(Ifaces::Battery *, d->backendObject(), UnknownBattery, type());
+    ensureMirror(d);
+    return d->type;
 }
 
 int Solid::Battery::chargePercent() const
 {
     Q_D(const Battery);
-    return_SOLID_CALL(Ifaces::Battery *, d->backendObject(), 0, chargePercent());
+    ensureMirror(d);
+    return d->chargePercent;
 }
 
 int Solid::Battery::capacity() const
 {
     Q_D(const Battery);
-    return_SOLID_CALL(Ifaces::Battery *, d->backendObject(), 100, capacity());
+    ensureMirror(d);
+    return d->capacity;
 }
 
 bool Solid::Battery::isRechargeable() const
 {
     Q_D(const Battery);
-    return_SOLID_CALL(Ifaces::Battery *, d->backendObject(), false, isRechargeable());
+    ensureMirror(d);
+    return d->rechargeable;
 }
 
 bool Solid::Battery::isPowerSupply() const
 {
     Q_D(const Battery);
-    return_SOLID_CALL(Ifaces::Battery *, d->backendObject(), true, isPowerSupply());
+    ensureMirror(d);
+    return d->powerSupply;
 }
 
 Solid::Battery::ChargeState Solid::Battery::chargeState() const
 {
     Q_D(const Battery);
-    return_SOLID_CALL(Ifaces::Battery *, d->backendObject(), NoCharge, chargeState());
+    ensureMirror(d);
+    return d->chargeState;
 }
 
 qlonglong Solid::Battery::timeToEmpty() const
 {
     Q_D(const Battery);
-    return_SOLID_CALL(Ifaces::Battery *, d->backendObject(), 0, timeToEmpty());
+    ensureMirror(d);
+    return d->timeToEmpty;
 }
 
 qlonglong Solid::Battery::timeToFull() const
 {
     Q_D(const Battery);
-    return_SOLID_CALL(Ifaces::Battery *, d->backendObject(), 0, timeToFull());
+    ensureMirror(d);
+    return d->timeToFull;
 }
 
 Solid::Battery::Technology Solid::Battery::technology() const
 {
     Q_D(const Battery);
-    return_SOLID_CALL(Ifaces::Battery *, d->backendObject(), UnknownTechnology, technology());
+    ensureMirror(d);
+    return d->technology;
 }
 
 double Solid::Battery::energy() const
 {
     Q_D(const Battery);
-    return_SOLID_CALL(Ifaces::Battery *, d->backendObject(), 0.0, energy());
+    ensureMirror(d);
+    return d->energy;
 }
 
 double Solid::Battery::energyFull() const
 {
     Q_D(const Battery);
-    return_SOLID_CALL(Ifaces::Battery *, d->backendObject(), 0.0, energyFull());
+    ensureMirror(d);
+    return d->energyFull;
 }
 
 double Solid::Battery::energyFullDesign() const
 {
     Q_D(const Battery);
-    return_SOLID_CALL(Ifaces::Battery *, d->backendObject(), 0.0, energyFullDesign());
+    ensureMirror(d);
+    return d->energyFullDesign;
 }
 
 double Solid::Battery::energyRate() const
 {
     Q_D(const Battery);
-    return_SOLID_CALL(Ifaces::Battery *, d->backendObject(), 0.0, energyRate());
+    ensureMirror(d);
+    return d->energyRate;
 }
 
 double Solid::Battery::voltage() const
 {
     Q_D(const Battery);
-    return_SOLID_CALL(Ifaces::Battery *, d->backendObject(), 0.0, voltage());
+    ensureMirror(d);
+    return d->voltage;
 }
 
 double Solid::Battery::temperature() const
 {
     Q_D(const Battery);
-    return_SOLID_CALL(Ifaces::Battery *, d->backendObject(), 0.0, temperature());
+    ensureMirror(d);
+    return d->temperature;
 }
 
 bool Solid::Battery::isRecalled() const
 {
     Q_D(const Battery);
-    return_SOLID_CALL(Ifaces::Battery *, d->backendObject(), false, isRecalled());
+    ensureMirror(d);
+    return d->recalled;
 }
 
 QString Solid::Battery::recallVendor() const
 {
     Q_D(const Battery);
-    return_SOLID_CALL(Ifaces::Battery *, d->backendObject(), QString(), recallVendor());
+    ensureMirror(d);
+    return d->recallVendor;
 }
 
 QString Solid::Battery::recallUrl() const
 {
     Q_D(const Battery);
-    return_SOLID_CALL(Ifaces::Battery *, d->backendObject(), QString(), recallUrl());
+    ensureMirror(d);
+    return d->recallUrl;
 }
 
 QString Solid::Battery::serial() const
 {
     Q_D(const Battery);
-    return_SOLID_CALL(Ifaces::Battery *, d->backendObject(), QString(), serial());
+    ensureMirror(d);
+    return d->serial;
 }
 
 qlonglong Solid::Battery::remainingTime() const
 {
     Q_D(const Battery);
-    return_SOLID_CALL(Ifaces::Battery *, d->backendObject(), -1, remainingTime());
+    ensureMirror(d);
+    return d->remainingTime;
+}
+
+void Solid::Battery::_k_presentStateChanged(bool newState, const QString &udi)
+{
+    Q_D(Battery);
+    d->present = newState;
+    Q_EMIT presentStateChanged(newState, udi);
+}
+
+void Solid::Battery::_k_chargePercentChanged(int value, const QString &udi)
+{
+    Q_D(Battery);
+    d->chargePercent = value;
+    Q_EMIT chargePercentChanged(value, udi);
+}
+
+void Solid::Battery::_k_capacityChanged(int value, const QString &udi)
+{
+    Q_D(Battery);
+    d->capacity = value;
+    Q_EMIT capacityChanged(value, udi);
+}
+
+void Solid::Battery::_k_powerSupplyStateChanged(bool newState, const QString &udi)
+{
+    Q_D(Battery);
+    d->powerSupply = newState;
+    Q_EMIT powerSupplyStateChanged(newState, udi);
+}
+
+void Solid::Battery::_k_chargeStateChanged(int newState, const QString &udi)
+{
+    Q_D(Battery);
+    d->chargeState = static_cast<ChargeState>(newState);
+    Q_EMIT chargeStateChanged(newState, udi);
+}
+
+void Solid::Battery::_k_timeToEmptyChanged(qlonglong time, const QString &udi)
+{
+    Q_D(Battery);
+    d->timeToEmpty = time;
+    Q_EMIT timeToEmptyChanged(time, udi);
+}
+
+void Solid::Battery::_k_timeToFullChanged(qlonglong time, const QString &udi)
+{
+    Q_D(Battery);
+    d->timeToFull = time;
+    Q_EMIT timeToFullChanged(time, udi);
+}
+
+void Solid::Battery::_k_energyChanged(double energy, const QString &udi)
+{
+    Q_D(Battery);
+    d->energy = energy;
+    Q_EMIT energyChanged(energy, udi);
+}
+
+void Solid::Battery::_k_energyFullChanged(double energyFull, const QString &udi)
+{
+    Q_D(Battery);
+    d->energyFull = energyFull;
+    Q_EMIT energyFullChanged(energyFull, udi);
+}
+
+void Solid::Battery::_k_energyFullDesignChanged(double energyFullDesign, const QString &udi)
+{
+    Q_D(Battery);
+    d->energyFullDesign = energyFullDesign;
+    Q_EMIT energyFullDesignChanged(energyFullDesign, udi);
+}
+
+void Solid::Battery::_k_energyRateChanged(double energyRate, const QString &udi)
+{
+    Q_D(Battery);
+    d->energyRate = energyRate;
+    Q_EMIT energyRateChanged(energyRate, udi);
+}
+
+void Solid::Battery::_k_voltageChanged(double voltage, const QString &udi)
+{
+    Q_D(Battery);
+    d->voltage = voltage;
+    Q_EMIT voltageChanged(voltage, udi);
+}
+
+void Solid::Battery::_k_temperatureChanged(double temperature, const QString &udi)
+{
+    Q_D(Battery);
+    d->temperature = temperature;
+    Q_EMIT temperatureChanged(temperature, udi);
+}
+
+void Solid::Battery::_k_remainingTimeChanged(qlonglong time, const QString &udi)
+{
+    Q_D(Battery);
+    d->remainingTime = time;
+    Q_EMIT remainingTimeChanged(time, udi);
 }
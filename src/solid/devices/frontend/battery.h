@@ -442,6 +442,28 @@ Q_SIGNALS:
       * @since 5.8
       */
      void remainingTimeChanged(qlonglong time, const QString &udi);
+
+private Q_SLOTS:
+    /**
+     * @internal
+     *
+     * These keep the local property mirror current before the public
+     * signals are re-emitted.
+     */
+    void _k_presentStateChanged(bool newState, const QString &udi);
+    void _k_chargePercentChanged(int value, const QString &udi);
+    void _k_capacityChanged(int value, const QString &udi);
+    void _k_powerSupplyStateChanged(bool newState, const QString &udi);
+    void _k_chargeStateChanged(int newState, const QString &udi);
+    void _k_timeToEmptyChanged(qlonglong time, const QString &udi);
+    void _k_timeToFullChanged(qlonglong time, const QString &udi);
+    void _k_energyChanged(double energy, const QString &udi);
+    void _k_energyFullChanged(double energyFull, const QString &udi);
+    void _k_energyFullDesignChanged(double energyFullDesign, const QString &udi);
+    void _k_energyRateChanged(double energyRate, const QString &udi);
+    void _k_voltageChanged(double voltage, const QString &udi);
+    void _k_temperatureChanged(double temperature, const QString &udi);
+    void _k_remainingTimeChanged(qlonglong time, const QString &udi);
 };
 }
 
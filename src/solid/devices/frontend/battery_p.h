@@ -7,6 +7,7 @@
 #ifndef SOLID_BATTERY_P_H
 #define SOLID_BATTERY_P_H
 
+#include "battery.h"
 #include "deviceinterface_p.h"
 
 namespace Solid
@@ -16,6 +17,35 @@ class BatteryPrivate : public DeviceInterfacePrivate
 public:
     BatteryPrivate()
         : DeviceInterfacePrivate() { }
+
+    // Local mirror of the backend properties, filled once on the first
+    // getter call and kept current by the backend change signals, so
+    // polling consumers read plain members instead of round-tripping to
+    // the backend. The initializers match the getters' fallback values
+    // for the backendless case.
+    mutable bool mirrorFilled = false;
+
+    mutable bool present = false;
+    mutable Battery::BatteryType type = Battery::UnknownBattery;
+    mutable int chargePercent = 0;
+    mutable int capacity = 100;
+    mutable bool rechargeable = false;
+    mutable bool powerSupply = true;
+    mutable Battery::ChargeState chargeState = Battery::NoCharge;
+    mutable qlonglong timeToEmpty = 0;
+    mutable qlonglong timeToFull = 0;
+    mutable Battery::Technology technology = Battery::UnknownTechnology;
+    mutable double energy = 0.0;
+    mutable double energyFull = 0.0;
+    mutable double energyFullDesign = 0.0;
+    mutable double energyRate = 0.0;
+    mutable double voltage = 0.0;
+    mutable double temperature = 0.0;
+    mutable bool recalled = false;
+    mutable QString recallVendor;
+    mutable QString recallUrl;
+    mutable QString serial;
+    mutable qlonglong remainingTime = -1;
 };
 }
 
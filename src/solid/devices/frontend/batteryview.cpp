@@ -0,0 +1,58 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include "batteryview.h"
+#include "device_p.h"
+
+#include <solid/devices/ifaces/battery.h>
+#include <solid/devices/ifaces/device.h>
+
+Solid::BatteryView::BatteryView(const Device &device)
+    : m_device(device)
+    , m_object(nullptr)
+    , m_iface(nullptr)
+{
+    Ifaces::Device *backend = m_device.d->backendObject();
+    if (backend) {
+        m_object = backend->createDeviceInterface(DeviceInterface::Battery);
+        m_iface = qobject_cast<Ifaces::Battery *>(m_object);
+    }
+}
+
+Solid::BatteryView::~BatteryView()
+{
+    delete m_object;
+}
+
+bool Solid::BatteryView::isValid() const
+{
+    return m_iface != nullptr;
+}
+
+bool Solid::BatteryView::isPresent() const
+{
+    return m_iface ? m_iface->isPresent() : false;
+}
+
+Solid::Battery::BatteryType Solid::BatteryView::type() const
+{
+    return m_iface ? m_iface->type() : Battery::UnknownBattery;
+}
+
+int Solid::BatteryView::chargePercent() const
+{
+    return m_iface ? m_iface->chargePercent() : 0;
+}
+
+bool Solid::BatteryView::isPowerSupply() const
+{
+    return m_iface ? m_iface->isPowerSupply() : false;
+}
+
+Solid::Battery::ChargeState Solid::BatteryView::chargeState() const
+{
+    return m_iface ? m_iface->chargeState() : Battery::NoCharge;
+}
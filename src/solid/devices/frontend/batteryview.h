@@ -0,0 +1,101 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#ifndef SOLID_BATTERYVIEW_H
+#define SOLID_BATTERYVIEW_H
+
+#include <solid/solid_export.h>
+
+#include <solid/battery.h>
+#include <solid/device.h>
+
+namespace Solid
+{
+namespace Ifaces
+{
+class Battery;
+}
+
+/**
+ * Lightweight read-only view on the Battery interface of a device.
+ *
+ * Unlike Device::as<Battery>(), constructing a view doesn't create a
+ * frontend QObject or register it with the device handle; it reads
+ * straight through the backend. Use it in enumeration loops that only
+ * inspect state — anything that wants the change signals, or reads the
+ * same device repeatedly, is better served by the full interface, which
+ * is cached on the device.
+ *
+ * The view is a plain stack object tied to the device handle it was
+ * created from and is not copyable.
+ *
+ * @since 5.79
+ */
+class SOLID_EXPORT BatteryView
+{
+public:
+    explicit BatteryView(const Device &device);
+    ~BatteryView();
+
+    BatteryView(const BatteryView &) = delete;
+    BatteryView &operator=(const BatteryView &) = delete;
+
+    /**
+     * Indicates whether the device actually provides Battery; the
+     * accessors below return their documented defaults when it doesn't.
+     *
+     * @return true if the device has the Battery interface
+     */
+    bool isValid() const;
+
+    /**
+     * Indicates if this battery is currently present in its bay.
+     *
+     * @return true if the battery is present
+     * @see Solid::Battery::isPresent()
+     */
+    bool isPresent() const;
+
+    /**
+     * Retrieves the type of device holding this battery.
+     *
+     * @return the type of device holding this battery
+     * @see Solid::Battery::type()
+     */
+    Battery::BatteryType type() const;
+
+    /**
+     * Retrieves the current charge level of this battery as a percentage.
+     *
+     * @return the current charge level
+     * @see Solid::Battery::chargePercent()
+     */
+    int chargePercent() const;
+
+    /**
+     * Indicates if the battery is powering the machine.
+     *
+     * @return true if the battery is a power supply
+     * @see Solid::Battery::isPowerSupply()
+     */
+    bool isPowerSupply() const;
+
+    /**
+     * Retrieves the current charge state of this battery.
+     *
+     * @return the current charge state
+     * @see Solid::Battery::chargeState()
+     */
+    Battery::ChargeState chargeState() const;
+
+private:
+    Device m_device;
+    QObject *m_object;
+    Ifaces::Battery *m_iface;
+};
+}
+
+#endif
@@ -23,18 +23,18 @@ Solid::Block::~Block()
 int Solid::Block::deviceMajor() const
 {
     Q_D(const Block);
-    return_SOLID_CALL(Ifaces::Block *, d->backendObject(), 0, deviceMajor());
+    return_SOLID_IFACE_CALL(Ifaces::Block, d, 0, deviceMajor());
 }
 
 int Solid::Block::deviceMinor() const
 {
     Q_D(const Block);
-    return_SOLID_CALL(Ifaces::Block *, d->backendObject(), 0, deviceMinor());
+    return_SOLID_IFACE_CALL(Ifaces::Block, d, 0, deviceMinor());
 }
 
 QString Solid::Block::device() const
 {
     Q_D(const Block);
-    return_SOLID_CALL(Ifaces::Block *, d->backendObject(), QString(), device());
+    return_SOLID_IFACE_CALL(Ifaces::Block, d, QString(), device());
 }
 
@@ -23,18 +23,43 @@ Solid::Camera::~Camera()
 QStringList Solid::Camera::supportedProtocols() const
 {
     Q_D(const Camera);
-    return_SOLID_CALL(Ifaces::Camera *, d->backendObject(), QStringList(), supportedProtocols());
+
+    if (d->supportedProtocolsCached) {
+        return d->supportedProtocols;
+    }
+
+    Ifaces::Camera *iface = d->backendIface<Ifaces::Camera>();
+    if (iface == nullptr) {
+        return QStringList();
+    }
+
+    d->supportedProtocols = iface->supportedProtocols();
+    d->supportedProtocolsCached = true;
+    return d->supportedProtocols;
 }
 
 QStringList Solid::Camera::supportedDrivers(QString protocol) const
 {
     Q_D(const Camera);
-    return_SOLID_CALL(Ifaces::Camera *, d->backendObject(), QStringList(), supportedDrivers(protocol));
+
+    auto it = d->supportedDrivers.constFind(protocol);
+    if (it != d->supportedDrivers.constEnd()) {
+        return it.value();
+    }
+
+    Ifaces::Camera *iface = d->backendIface<Ifaces::Camera>();
+    if (iface == nullptr) {
+        return QStringList();
+    }
+
+    const QStringList drivers = iface->supportedDrivers(protocol);
+    d->supportedDrivers.insert(protocol, drivers);
+    return drivers;
 }
 
 QVariant Solid::Camera::driverHandle(const QString &driver) const
 {
     Q_D(const Camera);
-    return_SOLID_CALL(Ifaces::Camera *, d->backendObject(), QVariant(), driverHandle(driver));
+    return_SOLID_IFACE_CALL(Ifaces::Camera, d, QVariant(), driverHandle(driver));
 }
 
@@ -9,6 +9,9 @@
 
 #include "deviceinterface_p.h"
 
+#include <QHash>
+#include <QStringList>
+
 namespace Solid
 {
 class CameraPrivate : public DeviceInterfacePrivate
@@ -16,6 +19,13 @@ class CameraPrivate : public DeviceInterfacePrivate
 public:
     CameraPrivate()
         : DeviceInterfacePrivate() { }
+
+    // The protocol and driver lists are immutable for a given device, so
+    // they are built once and handed out as shared QStringList data
+    // afterwards.
+    mutable QStringList supportedProtocols;
+    mutable bool supportedProtocolsCached = false;
+    mutable QHash<QString, QStringList> supportedDrivers;
 };
 }
 
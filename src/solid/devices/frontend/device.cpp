@@ -51,6 +51,11 @@ Solid::Device::Device(const Device &device)
 {
 }
 
+Solid::Device::Device(Device &&device) noexcept
+    : d(std::move(device.d))
+{
+}
+
 Solid::Device::~Device()
 {
 }
@@ -61,6 +66,12 @@ Solid::Device &Solid::Device::operator=(const Solid::Device &device)
     return *this;
 }
 
+Solid::Device &Solid::Device::operator=(Solid::Device &&device) noexcept
+{
+    d = std::move(device.d);
+    return *this;
+}
+
 bool Solid::Device::isValid() const
 {
     return d->backendObject() != nullptr;
@@ -73,7 +84,18 @@ QString Solid::Device::udi() const
 
 QString Solid::Device::parentUdi() const
 {
-    return_SOLID_CALL(Ifaces::Device *, d->backendObject(), QString(), parentUdi());
+    if (d->parentUdiCached()) {
+        return d->cachedParentUdi();
+    }
+
+    Ifaces::Device *device = qobject_cast<Ifaces::Device *>(d->backendObject());
+    if (device == nullptr) {
+        return QString();
+    }
+
+    const QString udi = device->parentUdi();
+    d->cacheParentUdi(udi);
+    return udi;
 }
 
 Solid::Device Solid::Device::parent() const
@@ -99,12 +121,34 @@ QString Solid::Device::product() const
 
 QString Solid::Device::icon() const
 {
-    return_SOLID_CALL(Ifaces::Device *, d->backendObject(), QString(), icon());
+    if (d->iconCached()) {
+        return d->cachedIcon();
+    }
+
+    Ifaces::Device *device = qobject_cast<Ifaces::Device *>(d->backendObject());
+    if (device == nullptr) {
+        return QString();
+    }
+
+    const QString icon = device->icon();
+    d->cacheIcon(icon);
+    return icon;
 }
 
 QStringList Solid::Device::emblems() const
 {
-    return_SOLID_CALL(Ifaces::Device *, d->backendObject(), QStringList(), emblems());
+    if (d->emblemsCached()) {
+        return d->cachedEmblems();
+    }
+
+    Ifaces::Device *device = qobject_cast<Ifaces::Device *>(d->backendObject());
+    if (device == nullptr) {
+        return QStringList();
+    }
+
+    const QStringList emblems = device->emblems();
+    d->cacheEmblems(emblems);
+    return emblems;
 }
 
 QString Solid::Device::displayName() const
@@ -114,7 +158,37 @@ QString Solid::Device::displayName() const
 
 QString Solid::Device::description() const
 {
-    return_SOLID_CALL(Ifaces::Device *, d->backendObject(), QString(), description());
+    if (d->descriptionCached()) {
+        return d->cachedDescription();
+    }
+
+    Ifaces::Device *device = qobject_cast<Ifaces::Device *>(d->backendObject());
+    if (device == nullptr) {
+        return QString();
+    }
+
+    const QString description = device->description();
+    d->cacheDescription(description);
+    return description;
+}
+
+QVariantMap Solid::Device::propertySnapshot() const
+{
+    QVariantMap snapshot;
+    snapshot.insert(QStringLiteral("udi"), d->udi());
+
+    Ifaces::Device *device = qobject_cast<Ifaces::Device *>(d->backendObject());
+    if (device != nullptr) {
+        snapshot.insert(QStringLiteral("parentUdi"), device->parentUdi());
+        snapshot.insert(QStringLiteral("vendor"), device->vendor());
+        snapshot.insert(QStringLiteral("product"), device->product());
+        snapshot.insert(QStringLiteral("icon"), device->icon());
+        snapshot.insert(QStringLiteral("emblems"), device->emblems());
+        snapshot.insert(QStringLiteral("displayName"), device->displayName());
+        snapshot.insert(QStringLiteral("description"), device->description());
+    }
+
+    return snapshot;
 }
 
 bool Solid::Device::isDeviceInterface(const DeviceInterface::Type &type) const
@@ -218,25 +292,84 @@ void Solid::DevicePrivate::_k_destroyed(QObject *object)
     setBackendObject(nullptr);
 }
 
+void Solid::DevicePrivate::_k_backendChanged()
+{
+    m_description.clear();
+    m_descriptionCached = false;
+    m_icon.clear();
+    m_iconCached = false;
+    m_emblems.clear();
+    m_emblemsCached = false;
+}
+
+void Solid::DevicePrivate::_k_accessibilityChanged()
+{
+    // mount state only shows up in the emblems; icon and description
+    // stay valid across mount/unmount
+    m_emblems.clear();
+    m_emblemsCached = false;
+}
+
 void Solid::DevicePrivate::setBackendObject(Ifaces::Device *object)
+{
+    replaceBackendObject(object, false);
+}
+
+void Solid::DevicePrivate::detachBackendObject()
+{
+    replaceBackendObject(nullptr, true);
+}
+
+void Solid::DevicePrivate::replaceBackendObject(Ifaces::Device *object, bool deferDeletes)
 {
 
     if (m_backendObject) {
         m_backendObject.data()->disconnect(this);
     }
 
-    delete m_backendObject.data();
+    if (deferDeletes) {
+        if (Ifaces::Device *previous = m_backendObject.data()) {
+            previous->deleteLater();
+        }
+    } else {
+        delete m_backendObject.data();
+    }
     m_backendObject = object;
 
+    m_parentUdi.clear();
+    m_parentUdiCached = false;
+    m_description.clear();
+    m_descriptionCached = false;
+    m_icon.clear();
+    m_iconCached = false;
+    m_emblems.clear();
+    m_emblemsCached = false;
+
     if (object) {
         connect(object, SIGNAL(destroyed(QObject*)),
                 this, SLOT(_k_destroyed(QObject*)));
+
+        // not all backends have one; for those that announce property
+        // changes this way, drop the cached description
+        if (object->metaObject()->indexOfSignal("changed()") != -1) {
+            connect(object, SIGNAL(changed()),
+                    this, SLOT(_k_backendChanged()));
+        }
     }
 
-    if (!m_ifaces.isEmpty()) {
-        qDeleteAll(m_ifaces);
+    if (m_ifaceCount > 0) {
+        for (QPointer<DeviceInterface> &iface : m_ifaces) {
+            if (deferDeletes) {
+                if (DeviceInterface *wrapper = iface.data()) {
+                    wrapper->deleteLater();
+                }
+            } else {
+                delete iface.data();
+            }
+            iface.clear();
+        }
+        m_ifaceCount = 0;
 
-        m_ifaces.clear();
         if (!ref.deref()) {
             deleteLater();
         }
@@ -245,14 +378,30 @@ void Solid::DevicePrivate::setBackendObject(Ifaces::Device *object)
 
 Solid::DeviceInterface *Solid::DevicePrivate::interface(const DeviceInterface::Type &type) const
 {
-    return m_ifaces[type];
+    if (type < 0 || size_t(type) >= m_ifaces.size()) {
+        return nullptr;
+    }
+    return m_ifaces[type].data();
 }
 
 void Solid::DevicePrivate::setInterface(const DeviceInterface::Type &type, DeviceInterface *interface)
 {
-    if (m_ifaces.isEmpty()) {
+    if (type < 0 || size_t(type) >= m_ifaces.size()) {
+        return;
+    }
+    if (m_ifaceCount == 0) {
         ref.ref();
     }
+    if (!m_ifaces[type]) {
+        ++m_ifaceCount;
+    }
     m_ifaces[type] = interface;
+
+    // backends without a changed() signal still announce mount state
+    // transitions through StorageAccess; use them to refresh the emblems
+    if (type == DeviceInterface::StorageAccess && interface) {
+        connect(interface, SIGNAL(accessibilityChanged(bool,QString)),
+                this, SLOT(_k_accessibilityChanged()));
+    }
 }
 
@@ -8,8 +8,11 @@
 #define SOLID_DEVICE_H
 
 
+#include <QFuture>
 #include <QList>
 #include <QSharedData>
+#include <QStringList>
+#include <QVariant>
 
 #include <solid/solid_export.h>
 
@@ -39,6 +42,85 @@ public:
      */
     static QList<Device> allDevices();
 
+    /**
+     * Ordering of the devices returned by allDevices(SortOrder).
+     * @since 5.79
+     */
+    enum SortOrder {
+        NoOrder = 0,  /**< whatever order the backends report, cheapest */
+        DisplayOrder, /**< sorted by user-visible description, locale-aware */
+    };
+
+    /**
+     * Retrieves all the devices available in the underlying system in
+     * the requested order.
+     *
+     * DisplayOrder enumerations walk an ordered view maintained by the
+     * device manager: the locale-aware collation key of each device's
+     * description is computed once and reused until the description
+     * changes, and hotplug events reposition single devices instead of
+     * re-sorting. Consumers which sort for display after every change
+     * get a pre-sorted walk instead of paying an N log N locale-aware
+     * sort each.
+     *
+     * @param order the order to enumerate in
+     * @return the list of the devices available
+     * @since 5.79
+     */
+    static QList<Device> allDevices(SortOrder order);
+
+    /**
+     * Retrieves all the devices available in the underlying system,
+     * without blocking the calling thread.
+     *
+     * The backends are enumerated on a thread from the global thread pool,
+     * so the D-Bus round trips triggered by enumeration stay off the hot
+     * path. Only the resulting Device handles are created back on the
+     * calling thread, which therefore needs to run an event loop for the
+     * future to finish. Device properties are still resolved lazily, on
+     * first access.
+     *
+     * @return a future delivering the list of the devices available
+     * @since 5.79
+     */
+    static QFuture<QList<Device>> allDevicesAsync();
+
+    /**
+     * Constructs devices for a list of UDIs in one go.
+     *
+     * This is equivalent to constructing a Device for each UDI, but the
+     * backend responsible for consecutive UDIs is resolved only once per
+     * run of UDIs sharing a prefix, so turning a whole enumeration
+     * snapshot into devices does not pay the backend lookup per device.
+     *
+     * @param udis the UDIs of the devices to construct
+     * @return the list of devices corresponding to the given UDIs
+     * @since 5.79
+     */
+    static QList<Device> listFromUdis(const QStringList &udis);
+
+    /**
+     * Resolves and memoizes the icons of the given devices in the
+     * background.
+     *
+     * Icon resolution can walk a fallback chain over media type,
+     * connection bus and drive properties, which on a cold cache means
+     * backend round trips. This warms the per-device icon memo — empty
+     * results included, so unknown devices don't re-run the chain
+     * either — on a thread from the global thread pool, against that
+     * worker's own backends. A view model calling this for the devices
+     * about to scroll into view then answers every icon() from the memo.
+     *
+     * Devices whose icon is already memoized are skipped. The calling
+     * thread needs to run an event loop for the seeding to land and the
+     * future to finish.
+     *
+     * @param devices the devices whose icons to resolve
+     * @return a future resolving once the icons are memoized
+     * @since 5.79
+     */
+    static QFuture<void> prefetchIcons(const QList<Device> &devices);
+
     /**
      * Retrieves a list of devices of the system given matching the given
      * constraints (parent and device interface type)
@@ -75,7 +157,29 @@ public:
      */
     static QList<Device> listFromQuery(const QString &predicate,
                                        const QString &parentUdi = QString());
-    
+
+    /**
+     * Retrieves the UDIs of the devices matching the given constraints,
+     * without materializing Device handles for them.
+     *
+     * This is the cheap form of listFromQuery() for consumers which
+     * only need the identifiers — models and views which resolve rows
+     * to devices lazily. For an invalid (match-everything) predicate
+     * the backend's device list travels to the caller as one shared
+     * list, so a full refresh moves no strings at all; an equality
+     * check is answered from the device manager's result index the
+     * same way.
+     *
+     * @param predicate Predicate that the devices we're searching for must verify
+     * @param parentUdi UDI of the parent of the devices we're searching for, or QString()
+     * if there's no constraint on the parent
+     * @return the UDIs of the devices corresponding to the given constraints
+     * @see listFromQuery()
+     * @since 5.79
+     */
+    static QStringList udisFromQuery(const Predicate &predicate,
+                                     const QString &parentUdi = QString());
+
     /**
      * Returns storage volume for given canonical path to file stored on that device
      * 
@@ -85,6 +189,41 @@ public:
      */
     static Device storageAccessFromPath(const QString &path);
 
+    /**
+     * Returns the device holding the block device with the given
+     * major/minor numbers, as read for instance from /proc/diskstats
+     * or a stat() st_rdev field.
+     *
+     * The lookup goes through an index maintained by the device
+     * manager, so resolving a device node doesn't require enumerating
+     * and comparing all block devices.
+     *
+     * @param major the major number of the block device
+     * @param minor the minor number of the block device
+     * @return the matching Block Device, or an invalid Device if no
+     * block device with these numbers exists
+     * @since 5.79
+     */
+    static Device fromBlockDevice(int major, int minor);
+
+    /**
+     * Returns the storage volume with the given filesystem UUID, as
+     * stored for instance in a bookmark or fstab entry.
+     *
+     * The lookup goes through an index maintained by the device
+     * manager, so resolving a UUID doesn't require enumerating all
+     * storage volumes and reading their properties.
+     *
+     * The comparison is case-insensitive, matching what
+     * StorageVolume::uuid() reports.
+     *
+     * @param uuid the filesystem UUID to look for
+     * @return the matching StorageVolume Device, or an invalid Device
+     * if no volume with this UUID exists
+     * @since 5.79
+     */
+    static Device fromUuid(const QString &uuid);
+
     /**
      * Constructs a device for a given Universal Device Identifier (UDI).
      *
@@ -99,6 +238,17 @@ public:
      */
     Device(const Device &device);
 
+    /**
+     * Move-constructs a device from another one.
+     *
+     * The moved-from device is left in a state where it can only be
+     * destroyed or assigned to.
+     *
+     * @param device the device to move from
+     * @since 5.79
+     */
+    Device(Device &&device) noexcept;
+
     /**
      * Destroys the device.
      */
@@ -112,6 +262,15 @@ public:
      */
     Device &operator=(const Device &device);
 
+    /**
+     * Move-assigns a device to this device and returns a reference to it.
+     *
+     * @param device the device to move from
+     * @return a reference to the device
+     * @since 5.79
+     */
+    Device &operator=(Device &&device) noexcept;
+
     /**
      * Indicates if this device is valid.
      * A device is considered valid if it's available in the system.
@@ -198,6 +357,23 @@ public:
      */
     QString description() const;
 
+    /**
+     * Retrieves the general purpose properties of the device in one go.
+     *
+     * Each accessor of this class dispatches to the backend object
+     * individually. Consumers needing several properties at once (for
+     * instance to display a device) can use this snapshot instead, which
+     * resolves the backend object a single time.
+     *
+     * The returned map contains the values of udi(), parentUdi(),
+     * vendor(), product(), icon(), emblems(), displayName() and
+     * description() under keys of the same names.
+     *
+     * @return the device properties keyed by accessor name
+     * @since 5.79
+     */
+    QVariantMap propertySnapshot() const;
+
     /**
      * Tests if a device interface is available from the device.
      *
@@ -263,7 +439,13 @@ public:
 private:
     QExplicitlySharedDataPointer<DevicePrivate> d;
     friend class DeviceManagerPrivate;
+    friend class BatteryView;
+    friend class StorageAccessView;
 };
 }
 
+// Device just wraps a shared data pointer, so containers can relocate it
+// with a plain memcpy instead of a ref/deref pair per element.
+Q_DECLARE_TYPEINFO(Solid::Device, Q_MOVABLE_TYPE);
+
 #endif
@@ -10,7 +10,9 @@
 #include <QObject>
 #include <QSharedData>
 #include <QPointer>
-#include <QMap>
+#include <QStringList>
+
+#include <array>
 
 #include <ifaces/device.h>
 
@@ -38,16 +40,108 @@ public:
     }
     void setBackendObject(Ifaces::Device *object);
 
+    /**
+     * Like setBackendObject(nullptr), but hands the previous backend
+     * object and the cached interface wrappers to the event loop for
+     * deletion instead of destroying them in place. The device reports
+     * as invalid immediately either way; the removal notification path
+     * uses this so an unplug storm doesn't run one synchronous deletion
+     * cascade per device between signal emissions.
+     */
+    void detachBackendObject();
+
     DeviceInterface *interface(const DeviceInterface::Type &type) const;
     void setInterface(const DeviceInterface::Type &type, DeviceInterface *interface);
 
+    // The parent UDI is immutable for the lifetime of a backend object, so
+    // it is resolved once and reused for repeated parent-chain traversals.
+    bool parentUdiCached() const
+    {
+        return m_parentUdiCached;
+    }
+    QString cachedParentUdi() const
+    {
+        return m_parentUdi;
+    }
+    void cacheParentUdi(const QString &udi)
+    {
+        m_parentUdi = udi;
+        m_parentUdiCached = true;
+    }
+
+    // The description is rebuilt from several localized fragments by the
+    // backends, so it is cached here once built. Backends announcing
+    // property changes through a changed() signal invalidate it.
+    bool descriptionCached() const
+    {
+        return m_descriptionCached;
+    }
+    QString cachedDescription() const
+    {
+        return m_description;
+    }
+    void cacheDescription(const QString &description)
+    {
+        m_description = description;
+        m_descriptionCached = true;
+    }
+
+    // Icon and emblems are derived by the backends from mount state and
+    // media type on every call, so both results are cached here. A
+    // changed() signal invalidates both; accessibilityChanged() from a
+    // StorageAccess interface only invalidates the emblems, which are
+    // the sole part depending on mount state.
+    bool iconCached() const
+    {
+        return m_iconCached;
+    }
+    QString cachedIcon() const
+    {
+        return m_icon;
+    }
+    void cacheIcon(const QString &icon)
+    {
+        m_icon = icon;
+        m_iconCached = true;
+    }
+
+    bool emblemsCached() const
+    {
+        return m_emblemsCached;
+    }
+    QStringList cachedEmblems() const
+    {
+        return m_emblems;
+    }
+    void cacheEmblems(const QStringList &emblems)
+    {
+        m_emblems = emblems;
+        m_emblemsCached = true;
+    }
+
 public Q_SLOTS:
     void _k_destroyed(QObject *object);
+    void _k_backendChanged();
+    void _k_accessibilityChanged();
 
 private:
+    void replaceBackendObject(Ifaces::Device *object, bool deferDeletes);
+
     QString m_udi;
     QPointer<Ifaces::Device> m_backendObject;
-    QMap<DeviceInterface::Type, QPointer<DeviceInterface>> m_ifaces;
+    // flat per-type slots instead of an associative container: interface()
+    // sits on the Device::as() hot path and the slots save one node
+    // allocation per cached interface
+    std::array<QPointer<DeviceInterface>, DeviceInterface::NetworkShare + 1> m_ifaces;
+    int m_ifaceCount = 0;
+    QString m_parentUdi;
+    bool m_parentUdiCached = false;
+    QString m_description;
+    bool m_descriptionCached = false;
+    QString m_icon;
+    bool m_iconCached = false;
+    QStringList m_emblems;
+    bool m_emblemsCached = false;
 };
 }
 
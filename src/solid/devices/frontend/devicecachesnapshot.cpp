@@ -0,0 +1,90 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include "devicecachesnapshot_p.h"
+
+#include "devicestoreformat_p.h"
+#include "solidconfig_p.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+static QString snapshotFilePath()
+{
+    const QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation);
+    if (cacheDir.isEmpty()) {
+        return QString();
+    }
+    return cacheDir + QStringLiteral("/solid/typeindex");
+}
+
+static bool snapshotDisabled()
+{
+    // The fake backend serves test fixtures; persisting those would leak
+    // synthetic devices into real sessions (and between test runs).
+    return !Solid::Config::snapshot()->fakeHwPath.isEmpty();
+}
+
+QHash<Solid::DeviceInterface::Type, QStringList> Solid::DeviceCacheSnapshot::load()
+{
+    QHash<DeviceInterface::Type, QStringList> result;
+
+    if (snapshotDisabled()) {
+        return result;
+    }
+
+    const QString path = snapshotFilePath();
+    if (path.isEmpty()) {
+        return result;
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return result;
+    }
+
+    // Map the file and consume the table in place; magic, version and
+    // bounds are validated by the format module, and a bad file is
+    // discarded wholesale.
+    uchar *mapped = file.map(0, file.size());
+    if (mapped == nullptr) {
+        return result;
+    }
+
+    bool ok = false;
+    result = DeviceStoreFormat::deserialize(mapped, int(file.size()), &ok);
+    if (!ok) {
+        result.clear();
+    }
+
+    return result;
+}
+
+void Solid::DeviceCacheSnapshot::save(const QHash<DeviceInterface::Type, QStringList> &typeIndex)
+{
+    if (snapshotDisabled() || typeIndex.isEmpty()) {
+        return;
+    }
+
+    const QString path = snapshotFilePath();
+    if (path.isEmpty()) {
+        return;
+    }
+    QDir().mkpath(QFileInfo(path).absolutePath());
+
+    // QSaveFile commits atomically, so a crash mid-write leaves the
+    // previous snapshot intact rather than a truncated one.
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return;
+    }
+
+    file.write(DeviceStoreFormat::serialize(typeIndex));
+    file.commit();
+}
@@ -0,0 +1,38 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#ifndef SOLID_DEVICECACHESNAPSHOT_P_H
+#define SOLID_DEVICECACHESNAPSHOT_P_H
+
+#include "deviceinterface.h"
+
+#include <QHash>
+#include <QStringList>
+
+namespace Solid
+{
+/**
+ * Persists the device manager's per-type UDI index across process runs.
+ *
+ * The snapshot is written to the per-user cache directory on clean
+ * shutdown and memory-mapped back in at startup, so the first typed
+ * query of the next run can be answered from the previous run's result
+ * instead of waiting out the backend enumeration. The served entries
+ * are reconciled asynchronously against the live backends afterwards;
+ * see DeviceManagerPrivate::reconcileSnapshotType().
+ *
+ * The file carries a magic and a format version and is discarded
+ * wholesale on any mismatch or truncation — a stale or corrupt snapshot
+ * only ever costs the enumeration it would have saved.
+ */
+namespace DeviceCacheSnapshot
+{
+QHash<DeviceInterface::Type, QStringList> load();
+void save(const QHash<DeviceInterface::Type, QStringList> &typeIndex);
+}
+}
+
+#endif
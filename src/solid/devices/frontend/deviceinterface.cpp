@@ -100,6 +100,7 @@ QObject *Solid::DeviceInterfacePrivate::backendObject() const
 void Solid::DeviceInterfacePrivate::setBackendObject(QObject *object)
 {
     m_backendObject = object;
+    m_ifaceCache.fill({nullptr, nullptr});
 }
 
 Solid::DevicePrivate *Solid::DeviceInterfacePrivate::devicePrivate() const
@@ -7,8 +7,11 @@
 #ifndef SOLID_DEVICEINTERFACE_P_H
 #define SOLID_DEVICEINTERFACE_P_H
 
+#include <QObject>
 #include <QPointer>
 
+#include <array>
+
 namespace Solid
 {
 class DeviceInterfacePrivate
@@ -22,9 +25,43 @@ public:
     DevicePrivate *devicePrivate() const;
     void setDevicePrivate(DevicePrivate *devicePrivate);
 
+    /**
+     * Returns the backend object cast to the given backend interface.
+     *
+     * The qobject_cast result is cached per interface type, so repeated
+     * getter calls don't pay the RTTI walk again. Liveness still follows
+     * the QPointer on the backend object: once it is destroyed this
+     * returns nullptr, like the uncached cast did.
+     */
+    template<typename IfaceType>
+    IfaceType *backendIface() const
+    {
+        QObject *object = m_backendObject.data();
+        if (!object) {
+            return nullptr;
+        }
+
+        const char *iid = qobject_interface_iid<IfaceType *>();
+        for (auto &entry : m_ifaceCache) {
+            if (entry.first == iid) {
+                return static_cast<IfaceType *>(entry.second);
+            }
+            if (entry.first == nullptr) {
+                IfaceType *iface = qobject_cast<IfaceType *>(object);
+                entry.first = iid;
+                entry.second = iface;
+                return iface;
+            }
+        }
+        return qobject_cast<IfaceType *>(object);
+    }
+
 private:
     QPointer<QObject> m_backendObject;
     DevicePrivate *m_devicePrivate;
+    // a frontend casts to its own backend interface plus the ones of its
+    // base classes, so a few slots cover every class in the tree
+    mutable std::array<std::pair<const char *, void *>, 4> m_ifaceCache{};
 };
 }
 
@@ -0,0 +1,162 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include "deviceiterator.h"
+
+#include "devicemanager_p.h"
+#include "devicenotifier.h"
+
+#include "ifaces/devicemanager.h"
+
+#include <QSet>
+#include <QStringList>
+
+namespace Solid
+{
+class DeviceIteratorPrivate
+{
+public:
+    void init();
+    bool fetchNext();
+
+    Predicate predicate;
+    QString parentUdi;
+    DeviceInterface::Type type = DeviceInterface::Unknown;
+
+    QList<Ifaces::DeviceManager *> backends;
+    // The interface types worth asking the backends for; one entry of
+    // Unknown means a full scan.
+    QList<DeviceInterface::Type> queryTypes;
+
+    int backendCursor = 0;
+    int typeCursor = 0;
+    QStringList currentUdis;
+    int udiIndex = 0;
+    bool currentStageIsFullScan = false;
+    // Only needed when several candidate types are queried: a device
+    // implementing more than one of them is listed once per type.
+    QSet<QString> seenUdis;
+
+    Device pendingDevice;
+    bool hasPending = false;
+};
+}
+
+using namespace Solid;
+
+void DeviceIteratorPrivate::init()
+{
+    auto *manager = static_cast<DeviceManagerPrivate *>(DeviceNotifier::instance());
+    backends = manager->deviceBackends();
+
+    if (type != DeviceInterface::Unknown) {
+        queryTypes.append(type);
+    } else if (predicate.isValid()) {
+        const QSet<DeviceInterface::Type> candidates = predicate.candidateTypes();
+        for (DeviceInterface::Type candidate : candidates) {
+            queryTypes.append(candidate);
+        }
+    }
+    if (queryTypes.isEmpty()) {
+        queryTypes.append(DeviceInterface::Unknown);
+    }
+}
+
+bool DeviceIteratorPrivate::fetchNext()
+{
+    while (true) {
+        while (udiIndex < currentUdis.size()) {
+            const QString udi = currentUdis.at(udiIndex++);
+
+            if (queryTypes.size() > 1) {
+                if (seenUdis.contains(udi)) {
+                    continue;
+                }
+                seenUdis.insert(udi);
+            }
+
+            Device device(udi);
+            // devicesFromQuery() filters on the parent in the backend; a
+            // full scan has to do it here.
+            if (currentStageIsFullScan && !parentUdi.isEmpty() && device.parentUdi() != parentUdi) {
+                continue;
+            }
+            if (predicate.isValid() && !predicate.matches(device)) {
+                continue;
+            }
+
+            pendingDevice = device;
+            hasPending = true;
+            return true;
+        }
+
+        // The current listing is drained; pull the next backend/type
+        // stage. This is the lazy part: stages the caller never reaches
+        // are never queried.
+        for (;;) {
+            if (typeCursor >= queryTypes.size()) {
+                typeCursor = 0;
+                ++backendCursor;
+            }
+            if (backendCursor >= backends.size()) {
+                return false;
+            }
+
+            Ifaces::DeviceManager *backend = backends.at(backendCursor);
+            const DeviceInterface::Type stageType = queryTypes.at(typeCursor++);
+
+            if (stageType != DeviceInterface::Unknown
+                    && !backend->supportedInterfaces().contains(stageType)) {
+                continue;
+            }
+
+            currentStageIsFullScan = (stageType == DeviceInterface::Unknown);
+            currentUdis = currentStageIsFullScan
+                          ? backend->allDevices()
+                          : backend->devicesFromQuery(parentUdi, stageType);
+            udiIndex = 0;
+            break;
+        }
+    }
+}
+
+DeviceIterator::DeviceIterator(const Predicate &predicate, const QString &parentUdi)
+    : d(new DeviceIteratorPrivate)
+{
+    d->predicate = predicate;
+    d->parentUdi = parentUdi;
+    d->init();
+}
+
+DeviceIterator::DeviceIterator(DeviceInterface::Type type, const QString &parentUdi)
+    : d(new DeviceIteratorPrivate)
+{
+    d->type = type;
+    d->parentUdi = parentUdi;
+    d->init();
+}
+
+DeviceIterator::~DeviceIterator()
+{
+    delete d;
+}
+
+bool DeviceIterator::hasNext()
+{
+    if (d->hasPending) {
+        return true;
+    }
+    return d->fetchNext();
+}
+
+Device DeviceIterator::next()
+{
+    if (!d->hasPending && !d->fetchNext()) {
+        return Device(QString());
+    }
+    d->hasPending = false;
+    return d->pendingDevice;
+}
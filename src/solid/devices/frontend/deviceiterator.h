@@ -0,0 +1,86 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#ifndef SOLID_DEVICEITERATOR_H
+#define SOLID_DEVICEITERATOR_H
+
+#include <solid/device.h>
+#include <solid/deviceinterface.h>
+#include <solid/predicate.h>
+#include <solid/solid_export.h>
+
+namespace Solid
+{
+class DeviceIteratorPrivate;
+
+/**
+ * Lazily enumerates devices, in the style of QDirIterator.
+ *
+ * Device::allDevices() and listFromQuery() materialize the complete
+ * device list before returning, which on dense storage nodes (hundreds
+ * to thousands of block devices) is a multi-second operation even when
+ * the caller only displays the first page. The iterator instead pulls
+ * UDIs from the backends one backend (and one candidate interface type)
+ * at a time and constructs each Device on demand, so a caller rendering
+ * the first screenful pays only for the devices it consumed — and
+ * destroying the iterator abandons the rest of the enumeration,
+ * backends included.
+ *
+ * @code
+ * Solid::DeviceIterator it(Solid::Predicate::fromString("IS StorageDrive"));
+ * while (it.hasNext() && rows < pageSize) {
+ *     show(it.next());
+ *     ++rows;
+ * }
+ * @endcode
+ *
+ * The devices delivered for a given predicate are the same ones
+ * Device::listFromQuery() returns, though not necessarily in the same
+ * order. The iterator works on per-backend snapshots: devices appearing
+ * or disappearing while iterating show up no earlier than the next
+ * backend's listing.
+ *
+ * @since 5.79
+ */
+class SOLID_EXPORT DeviceIterator
+{
+public:
+    /**
+     * Creates an iterator over the devices matching @p predicate,
+     * optionally restricted to children of @p parentUdi. An invalid
+     * predicate matches all devices.
+     */
+    explicit DeviceIterator(const Predicate &predicate = Predicate(), const QString &parentUdi = QString());
+
+    /**
+     * Creates an iterator over the devices implementing @p type,
+     * optionally restricted to children of @p parentUdi.
+     */
+    explicit DeviceIterator(DeviceInterface::Type type, const QString &parentUdi = QString());
+
+    ~DeviceIterator();
+
+    DeviceIterator(const DeviceIterator &) = delete;
+    DeviceIterator &operator=(const DeviceIterator &) = delete;
+
+    /**
+     * Whether another matching device is available. This is where the
+     * next backend is consulted when the current one is drained.
+     */
+    bool hasNext();
+
+    /**
+     * The next matching device, or an invalid Device when the
+     * enumeration is exhausted.
+     */
+    Device next();
+
+private:
+    DeviceIteratorPrivate *const d;
+};
+} // Solid namespace
+
+#endif // SOLID_DEVICEITERATOR_H
@@ -7,9 +7,13 @@
 #include "devicenotifier.h"
 #include "devicemanager_p.h" //krazy:exclude=includes (devicenotifier.h is the header file for this class)
 
+#include "block.h"
 #include "device.h"
+#include "devicecachesnapshot_p.h"
+#include "devicetableipc_p.h"
 #include "device_p.h"
 #include "devices_debug.h"
+#include "genericinterface.h"
 #include "predicate.h"
 #include "storageaccess.h"
 #include "storagevolume.h"
@@ -18,16 +22,102 @@
 #include "ifaces/device.h"
 
 #include "soliddefs_p.h"
+#include "solidconfig_p.h"
+#include "solidcounters_p.h"
+#include "solidstartupprofiler_p.h"
+#include "solidtrace_p.h"
 
+#include <config-backends.h>
+
+#include <QtAlgorithms>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QFileInfo>
+#include <QFutureInterface>
 #include <QLoggingCategory>
+#include <QMetaEnum>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThreadPool>
+#include <QVector>
+
+#include <algorithm>
 
 Q_GLOBAL_STATIC(Solid::DeviceManagerStorage, globalDeviceStorage)
+Q_GLOBAL_STATIC(Solid::SharedDeviceCache, globalSharedDeviceCache)
+
+Solid::SharedDeviceCache::SharedDeviceCache()
+    : m_table(std::make_shared<const Table>())
+{
+}
+
+Solid::DevicePrivate *Solid::SharedDeviceCache::find(const QString &udi) const
+{
+    // Wait-free: grab whichever table version is currently published and
+    // traverse it; a concurrent writer publishes a new version without
+    // touching this one.
+    const std::shared_ptr<const Table> table = std::atomic_load(&m_table);
+
+    auto it = table->constFind(udi);
+    if (it != table->constEnd()) {
+        return it.value().data();
+    }
+    return nullptr;
+}
+
+void Solid::SharedDeviceCache::insert(const QString &udi, DevicePrivate *device)
+{
+    QMutexLocker locker(&m_writeMutex);
+
+    auto newTable = std::make_shared<Table>(*std::atomic_load(&m_table));
+    newTable->insert(udi, QPointer<DevicePrivate>(device));
+    std::atomic_store(&m_table, std::shared_ptr<const Table>(std::move(newTable)));
+}
+
+void Solid::SharedDeviceCache::remove(const QString &udi, QObject *device)
+{
+    QMutexLocker locker(&m_writeMutex);
+
+    const std::shared_ptr<const Table> current = std::atomic_load(&m_table);
+    auto it = current->constFind(udi);
+    if (it == current->constEnd() || (!it.value().isNull() && it.value().data() != device)) {
+        return;
+    }
+
+    auto newTable = std::make_shared<Table>(*current);
+    newTable->remove(udi);
+    std::atomic_store(&m_table, std::shared_ptr<const Table>(std::move(newTable)));
+}
+
+// How long additions and removals are accumulated before one
+// devicesAdded()/devicesRemoved() batch is delivered. Long enough to cover
+// the burst of UDIs a multi-partition disk or a vanishing hub produces,
+// short enough not to delay the UI noticeably.
+static const int coalesceWindowMs = 20;
 
 Solid::DeviceManagerPrivate::DeviceManagerPrivate()
     : m_nullDevice(new DevicePrivate(QString()))
 {
+    // The backends are loaded lazily, on the first query or when someone
+    // subscribes to the notifier signals; see ensureBackendsLoaded().
+
+    m_addedCoalesceTimer.setSingleShot(true);
+    m_addedCoalesceTimer.setInterval(coalesceWindowMs);
+    connect(&m_addedCoalesceTimer, SIGNAL(timeout()),
+            this, SLOT(_k_emitBatchedAdditions()));
+
+    m_removedCoalesceTimer.setSingleShot(true);
+    m_removedCoalesceTimer.setInterval(coalesceWindowMs);
+    connect(&m_removedCoalesceTimer, SIGNAL(timeout()),
+            this, SLOT(_k_emitBatchedRemovals()));
+}
+
+void Solid::DeviceManagerPrivate::ensureBackendsLoaded()
+{
+    if (backendsLoaded()) {
+        return;
+    }
+
     loadBackends();
 
     const QList<QObject *> backends = managerBackends();
@@ -36,46 +126,437 @@ Solid::DeviceManagerPrivate::DeviceManagerPrivate()
                 this, SLOT(_k_deviceAdded(QString)));
         connect(backend, SIGNAL(deviceRemoved(QString)),
                 this, SLOT(_k_deviceRemoved(QString)));
+
+        Ifaces::DeviceManager *manager = qobject_cast<Ifaces::DeviceManager *>(backend);
+        if (manager) {
+            m_udiPrefixes.append(manager->udiPrefix());
+            m_deviceBackends.append(manager);
+        }
+    }
+
+    buildUdiRoutes();
+
+    if (DeviceTableIpc::serveModeEnabled()) {
+        startTablePublisher();
+    }
+}
+
+void Solid::DeviceManagerPrivate::buildUdiRoutes()
+{
+    m_routesByChar.clear();
+    m_routeFallback.clear();
+    m_routeDiscriminant = 0;
+
+    if (m_deviceBackends.isEmpty()) {
+        return;
+    }
+
+    // Longest common head of all the prefixes; the character right after
+    // it is what tells the backends apart.
+    const QString &reference = m_udiPrefixes.first();
+    int lcp = reference.size();
+    for (const QString &prefix : qAsConst(m_udiPrefixes)) {
+        int common = 0;
+        const int limit = qMin(lcp, prefix.size());
+        while (common < limit && prefix.at(common) == reference.at(common)) {
+            ++common;
+        }
+        lcp = common;
+    }
+    m_routeDiscriminant = lcp;
+
+    for (int i = 0; i < m_deviceBackends.size(); ++i) {
+        const BackendRoute route{m_udiPrefixes.at(i), m_deviceBackends.at(i)};
+        if (route.prefix.size() > lcp) {
+            m_routesByChar[route.prefix.at(lcp).unicode()].append(route);
+        } else {
+            m_routeFallback.append(route);
+        }
+    }
+}
+
+Solid::Ifaces::DeviceManager *Solid::DeviceManagerPrivate::routeUdi(const QString &udi) const
+{
+    if (udi.size() > m_routeDiscriminant) {
+        const auto it = m_routesByChar.constFind(udi.at(m_routeDiscriminant).unicode());
+        if (it != m_routesByChar.constEnd()) {
+            for (const BackendRoute &route : *it) {
+                if (udi.startsWith(route.prefix)) {
+                    return route.backend;
+                }
+            }
+        }
+    }
+
+    for (const BackendRoute &route : m_routeFallback) {
+        if (udi.startsWith(route.prefix)) {
+            return route.backend;
+        }
+    }
+
+    return nullptr;
+}
+
+void Solid::DeviceManagerPrivate::startTablePublisher()
+{
+    m_tablePublisher.reset(new DeviceTablePublisher);
+    if (!m_tablePublisher->start()) {
+        m_tablePublisher.reset();
+        return;
+    }
+
+    // The serving process pays the full enumeration once, up front, so
+    // clients never have to.
+    const QMetaEnum typeEnum = QMetaEnum::fromType<DeviceInterface::Type>();
+    for (int i = 0; i < typeEnum.keyCount(); ++i) {
+        const auto type = static_cast<DeviceInterface::Type>(typeEnum.value(i));
+        if (type == DeviceInterface::Unknown || type == DeviceInterface::Last) {
+            continue;
+        }
+        udisFromType(type);
+    }
+
+    m_tablePublisher->publish(m_typeIndex);
+}
+
+bool Solid::DeviceManagerPrivate::udiMatchesKnownPrefix(const QString &udi)
+{
+    ensureBackendsLoaded();
+
+    return routeUdi(udi) != nullptr;
+}
+
+void Solid::DeviceManagerPrivate::connectNotify(const QMetaMethod &signal)
+{
+    // Hotplug events can only be delivered once the backends exist, so a
+    // subscription to the notifier forces them into existence.
+    if (signal == QMetaMethod::fromSignal(&DeviceNotifier::deviceAdded)
+            || signal == QMetaMethod::fromSignal(&DeviceNotifier::deviceRemoved)) {
+        ensureBackendsLoaded();
     }
+
+    DeviceNotifier::connectNotify(signal);
 }
 
 Solid::DeviceManagerPrivate::~DeviceManagerPrivate()
 {
-    const QList<QObject *> backends = managerBackends();
+    // Don't force the backends into existence just to tear them down.
+    const QList<QObject *> backends = ManagerBasePrivate::managerBackends();
     for (QObject *backend : backends) {
         disconnect(backend, nullptr, this, nullptr);
     }
 
     // take a copy as m_devicesMap is changed by Solid::DeviceManagerPrivate::_k_destroyed
     const auto deviceMap = m_devicesMap;
-    for (QPointer<DevicePrivate> dev : deviceMap) {
-        if (!dev.data()->ref.deref()) {
-            delete dev.data();
+    for (DevicePrivate *dev : deviceMap) {
+        if (!dev->ref.deref()) {
+            delete dev;
         }
     }
 
     m_devicesMap.clear();
+
+    // Persist the per-type index for the next run; whichever thread's
+    // manager is torn down last wins, which is fine — the snapshots only
+    // differ in which types happened to be queried.
+    if (m_snapshotDirty && !m_typeIndex.isEmpty()) {
+        DeviceCacheSnapshot::save(m_typeIndex);
+    }
+}
+
+// A build compiling a single device backend has nothing to fan out, so
+// the enumeration pool and its task class are dropped entirely.
+#if SOLID_DEVICE_BACKENDS_COUNT > 1
+namespace
+{
+// Dedicated small pool for the per-backend enumeration fan-out; kept
+// separate from the global pool so an application saturating that one
+// can't serialize the fan-out again.
+QThreadPool *enumerationPool()
+{
+    static QThreadPool pool;
+    static const bool initialized = []() {
+        pool.setMaxThreadCount(4);
+        return true;
+    }();
+    Q_UNUSED(initialized)
+    return &pool;
+}
+
+// Enumerates the backend at one fixed index on a pool thread. The pool
+// thread queries its own thread's backend instance; loadBackends()
+// composes the list identically on every thread, so the index describes
+// the same backend everywhere and merging the slots in index order
+// keeps the result deterministic.
+class BackendEnumerateTask : public QRunnable
+{
+public:
+    BackendEnumerateTask(int index, QStringList *slot, QSemaphore *done)
+        : m_index(index)
+        , m_slot(slot)
+        , m_done(done)
+    {
+    }
+
+    void run() override
+    {
+        const QList<Solid::Ifaces::DeviceManager *> backends = globalDeviceStorage->deviceBackends();
+
+        if (m_index < backends.count()) {
+            Solid::Ifaces::DeviceManager *backend = backends.at(m_index);
+            QElapsedTimer profileTimer;
+            profileTimer.start();
+            *m_slot = backend->allDevices();
+            Solid::StartupProfiler::recordOnce("firstEnumeration",
+                                               QString::fromLatin1(backend->metaObject()->className()),
+                                               profileTimer.nsecsElapsed());
+        }
+
+        m_done->release();
+    }
+
+private:
+    int m_index;
+    QStringList *m_slot;
+    QSemaphore *m_done;
+};
+}
+#endif
+
+namespace
+{
+// Gathers the UDIs of every backend's devices. With a single backend —
+// the common case — the backend's list is handed on as one shared
+// QStringList, so a full enumeration moves list handles, not strings.
+QStringList enumerateAllUdis()
+{
+    QStringList udis;
+    const QList<Solid::Ifaces::DeviceManager *> backends = globalDeviceStorage->deviceBackends();
+
+#if SOLID_DEVICE_BACKENDS_COUNT > 1
+    if (backends.count() < 2) {
+#endif
+        for (Solid::Ifaces::DeviceManager *backend : backends) {
+            QElapsedTimer profileTimer;
+            profileTimer.start();
+            const QStringList backendUdis = backend->allDevices();
+            Solid::StartupProfiler::recordOnce("firstEnumeration",
+                                               QString::fromLatin1(backend->metaObject()->className()),
+                                               profileTimer.nsecsElapsed());
+            if (udis.isEmpty()) {
+                udis = backendUdis;
+            } else {
+                udis += backendUdis;
+            }
+        }
+#if SOLID_DEVICE_BACKENDS_COUNT > 1
+    } else {
+        // Fan the per-backend calls out across the pool, so the total
+        // latency is that of the slowest backend instead of the sum of
+        // all of them.
+        QVector<QStringList> results(backends.count());
+        QSemaphore done;
+
+        for (int i = 0; i < backends.count(); ++i) {
+            enumerationPool()->start(new BackendEnumerateTask(i, &results[i], &done));
+        }
+        done.acquire(backends.count());
+
+        for (const QStringList &backendUdis : qAsConst(results)) {
+            if (udis.isEmpty()) {
+                udis = backendUdis;
+            } else {
+                udis += backendUdis;
+            }
+        }
+    }
+#endif
+
+    return udis;
+}
 }
 
 QList<Solid::Device> Solid::Device::allDevices()
 {
-    QList<Device> list;
-    const QList<QObject *> backends = globalDeviceStorage->managerBackends();
+    const QStringList udis = enumerateAllUdis();
 
-    for (QObject *backendObj : backends) {
-        Ifaces::DeviceManager *backend = qobject_cast<Ifaces::DeviceManager *>(backendObj);
+    Counters::add(Counters::DevicesEnumerated, udis.size());
 
-        if (backend == nullptr) {
-            continue;
+    return listFromUdis(udis);
+}
+
+QList<Solid::Device> Solid::Device::allDevices(SortOrder order)
+{
+    if (order != DisplayOrder) {
+        return allDevices();
+    }
+
+    DeviceManagerPrivate *manager
+        = static_cast<DeviceManagerPrivate *>(Solid::DeviceNotifier::instance());
+    const QStringList udis = manager->displayOrderedUdis();
+    Counters::add(Counters::DevicesEnumerated, udis.size());
+    return manager->findRegisteredDevices(udis);
+}
+
+QList<Solid::Device> Solid::Device::listFromUdis(const QStringList &udis)
+{
+    DeviceManagerPrivate *manager
+        = static_cast<DeviceManagerPrivate *>(Solid::DeviceNotifier::instance());
+    return manager->findRegisteredDevices(udis);
+}
+
+namespace
+{
+class AllDevicesEnumerator : public QRunnable
+{
+public:
+    AllDevicesEnumerator(const QFutureInterface<QList<Solid::Device>> &futureInterface, Solid::DeviceNotifier *notifier)
+        : m_futureInterface(futureInterface)
+        , m_notifier(notifier)
+    {
+    }
+
+    void run() override
+    {
+        // Enumeration happens against this worker thread's own backends,
+        // so the expensive backend round trips stay off the caller's thread.
+        const QStringList udis = enumerateAllUdis();
+
+        // The Device handles are created back on the caller's thread so
+        // they keep the usual per-thread backend affinity.
+        QFutureInterface<QList<Solid::Device>> futureInterface = m_futureInterface;
+        QMetaObject::invokeMethod(m_notifier, [futureInterface, udis]() mutable {
+            futureInterface.reportResult(Solid::Device::listFromUdis(udis));
+            futureInterface.reportFinished();
+        }, Qt::QueuedConnection);
+    }
+
+private:
+    QFutureInterface<QList<Solid::Device>> m_futureInterface;
+    Solid::DeviceNotifier *m_notifier;
+};
+}
+
+QFuture<QList<Solid::Device>> Solid::Device::allDevicesAsync()
+{
+    QFutureInterface<QList<Device>> futureInterface;
+    futureInterface.reportStarted();
+
+    QThreadPool::globalInstance()->start(new AllDevicesEnumerator(futureInterface, DeviceNotifier::instance()));
+
+    return futureInterface.future();
+}
+
+namespace
+{
+class IconPrefetcher : public QRunnable
+{
+public:
+    IconPrefetcher(const QFutureInterface<void> &futureInterface, Solid::DeviceNotifier *notifier, const QStringList &udis)
+        : m_futureInterface(futureInterface)
+        , m_notifier(notifier)
+        , m_udis(udis)
+    {
+    }
+
+    void run() override
+    {
+        // Resolution happens against this worker thread's own backends,
+        // so the backend round trips of cold fallback chains stay off
+        // the caller's thread.
+        QHash<QString, QString> icons;
+        icons.reserve(m_udis.size());
+        for (const QString &udi : qAsConst(m_udis)) {
+            icons.insert(udi, Solid::Device(udi).icon());
         }
 
-        const QStringList udis = backend->allDevices();
-        for (const QString &udi : udis) {
-            list.append(Device(udi));
+        // The memos are seeded back on the caller's thread, where its
+        // Device handles live.
+        QFutureInterface<void> futureInterface = m_futureInterface;
+        Solid::DeviceNotifier *notifier = m_notifier;
+        const QStringList udis = m_udis;
+        QMetaObject::invokeMethod(m_notifier, [futureInterface, notifier, udis, icons]() mutable {
+            auto *manager = static_cast<Solid::DeviceManagerPrivate *>(notifier);
+            for (const QString &udi : udis) {
+                Solid::DevicePrivate *device = manager->findRegisteredDevice(udi);
+                if (device != nullptr && !device->iconCached()) {
+                    device->cacheIcon(icons.value(udi));
+                }
+            }
+            futureInterface.reportFinished();
+        }, Qt::QueuedConnection);
+    }
+
+private:
+    QFutureInterface<void> m_futureInterface;
+    Solid::DeviceNotifier *m_notifier;
+    QStringList m_udis;
+};
+}
+
+QFuture<void> Solid::Device::prefetchIcons(const QList<Device> &devices)
+{
+    // Only the devices whose memo is cold need resolving.
+    QStringList udis;
+    udis.reserve(devices.size());
+    for (const Device &device : devices) {
+        if (!device.d->iconCached() && !device.d->udi().isEmpty()) {
+            udis.append(device.d->udi());
         }
     }
 
-    return list;
+    QFutureInterface<void> futureInterface;
+    futureInterface.reportStarted();
+
+    if (udis.isEmpty()) {
+        futureInterface.reportFinished();
+        return futureInterface.future();
+    }
+
+    QThreadPool::globalInstance()->start(new IconPrefetcher(futureInterface, DeviceNotifier::instance(), udis));
+    return futureInterface.future();
+}
+
+namespace
+{
+/*
+ * Per-invocation memory attribution for the query paths. Interposing the
+ * allocator process-wide is not something a library can do, so the scope
+ * instead counts the temporary UDI strings a query materialises and
+ * estimates their heap footprint from the string capacities — which is
+ * where the bulk of a query's transient memory goes. The totals feed the
+ * cumulative counters, the per-invocation estimate pushes the peak
+ * high-water mark, and a tracepoint carries the raw pair so individual
+ * query shapes can be attributed with perf or bpftrace.
+ */
+class QueryMemoryScope
+{
+public:
+    void noteString(const QString &string)
+    {
+        ++m_strings;
+        m_bytes += qint64(sizeof(QString)) + qint64(string.capacity()) * qint64(sizeof(QChar));
+    }
+
+    void noteStrings(const QStringList &strings)
+    {
+        for (const QString &string : strings) {
+            noteString(string);
+        }
+    }
+
+    ~QueryMemoryScope()
+    {
+        Solid::Counters::add(Solid::Counters::QueryTempStrings, m_strings);
+        Solid::Counters::add(Solid::Counters::QueryBytesEstimated, m_bytes);
+        Solid::Counters::raise(Solid::Counters::QueryPeakBytes, m_bytes);
+        SOLID_PROBE2(query_memory, m_strings, m_bytes);
+    }
+
+private:
+    qint64 m_strings = 0;
+    qint64 m_bytes = 0;
+};
 }
 
 QList<Solid::Device> Solid::Device::listFromQuery(const QString &predicate,
@@ -94,19 +575,16 @@ QList<Solid::Device> Solid::Device::listFromType(const DeviceInterface::Type &ty
         const QString &parentUdi)
 {
     QList<Device> list;
-    const QList<QObject *> backends = globalDeviceStorage->managerBackends();
-
-    for (QObject *backendObj : backends) {
-        Ifaces::DeviceManager *backend = qobject_cast<Ifaces::DeviceManager *>(backendObj);
+    QueryMemoryScope memoryScope;
+    const QList<Ifaces::DeviceManager *> backends = globalDeviceStorage->deviceBackends();
 
-        if (backend == nullptr) {
-            continue;
-        }
+    for (Ifaces::DeviceManager *backend : backends) {
         if (!backend->supportedInterfaces().contains(type)) {
             continue;
         }
 
         const QStringList udis = backend->devicesFromQuery(parentUdi, type);
+        memoryScope.noteStrings(udis);
         for (const QString &udi : udis) {
             list.append(Device(udi));
         }
@@ -118,38 +596,75 @@ QList<Solid::Device> Solid::Device::listFromType(const DeviceInterface::Type &ty
 QList<Solid::Device> Solid::Device::listFromQuery(const Predicate &predicate,
         const QString &parentUdi)
 {
-    QList<Device> list;
-    const QSet<DeviceInterface::Type> usedTypes = predicate.usedTypes();
-    const QList<QObject *> backends = globalDeviceStorage->managerBackends();
-    for (QObject *backendObj : backends) {
-        Ifaces::DeviceManager *backend = qobject_cast<Ifaces::DeviceManager *>(backendObj);
-
-        if (backend == nullptr) {
-            continue;
-        }
+    QueryMemoryScope memoryScope;
+
+    // Plain equality checks are frequent enough (mount state queries and
+    // the like) to warrant their own result index.
+    if (parentUdi.isEmpty() && predicate.isValid()
+            && predicate.type() == Predicate::PropertyCheck
+            && predicate.comparisonOperator() == Predicate::Equals) {
+        DeviceManagerPrivate *manager
+            = static_cast<DeviceManagerPrivate *>(Solid::DeviceNotifier::instance());
+        const QStringList udis = manager->udisFromEqualityCheck(predicate);
+        memoryScope.noteStrings(udis);
+        return listFromUdis(udis);
+    }
 
+    QList<Device> list;
+    const quint32 usedTypesMask = predicate.candidateTypesMask();
+    DeviceManagerPrivate *manager
+        = static_cast<DeviceManagerPrivate *>(Solid::DeviceNotifier::instance());
+    const QString predicateKey = predicate.isValid() ? predicate.toString() : QString();
+    const QSet<QString> usedProperties = predicate.isValid() ? predicate.usedProperties() : QSet<QString>();
+    const QList<Ifaces::DeviceManager *> backends = globalDeviceStorage->deviceBackends();
+    for (Ifaces::DeviceManager *backend : backends) {
         QStringList udis;
         if (predicate.isValid()) {
-            QSet<DeviceInterface::Type> supportedTypes = backend->supportedInterfaces();
-            if (supportedTypes.intersect(usedTypes).isEmpty()) {
+            // One AND covers the set intersection; iterating the mask from
+            // the low bit up visits the types in ascending order.
+            const quint32 relevantTypes = manager->supportedInterfacesMask(backend) & usedTypesMask;
+            if (relevantTypes == 0) {
                 continue;
             }
 
-            QList<DeviceInterface::Type> sortedTypes = supportedTypes.values();
-            std::sort(sortedTypes.begin(), sortedTypes.end());
-            for (DeviceInterface::Type type : qAsConst(sortedTypes)) {
-                udis += backend->devicesFromQuery(parentUdi, type);
+            if (parentUdi.isEmpty()) {
+                // Global queries go through the per-type index, so only the
+                // candidate UDIs for each type are visited rather than a
+                // full backend enumeration on every call.
+                const QString udiPrefix = backend->udiPrefix();
+                for (quint32 bits = relevantTypes; bits != 0; bits &= bits - 1) {
+                    const auto type = static_cast<DeviceInterface::Type>(qCountTrailingZeroBits(bits));
+                    const QStringList candidates = manager->udisFromType(type);
+                    for (const QString &udi : candidates) {
+                        if (udi.startsWith(udiPrefix)) {
+                            udis += udi;
+                        }
+                    }
+                }
+            } else {
+                for (quint32 bits = relevantTypes; bits != 0; bits &= bits - 1) {
+                    const auto type = static_cast<DeviceInterface::Type>(qCountTrailingZeroBits(bits));
+                    udis += backend->devicesFromQuery(parentUdi, type);
+                }
             }
         } else {
-            udis += backend->allDevices();
+            // Shared handle; the candidate loop below never modifies it.
+            udis = backend->allDevices();
         }
 
+        memoryScope.noteStrings(udis);
+
         QSet<QString> seen;
         for (const QString &udi : qAsConst(udis)) {
             if (seen.contains(udi)) {
                 continue;
             }
             seen.insert(udi);
+
+            if (predicate.isValid() && manager->isKnownNonMatch(predicateKey, udi)) {
+                continue;
+            }
+
             Device dev(udi);
 
             bool matches = false;
@@ -158,10 +673,14 @@ QList<Solid::Device> Solid::Device::listFromQuery(const Predicate &predicate,
                 matches = true;
             } else {
                 matches = predicate.matches(dev);
+                if (!matches) {
+                    manager->recordNonMatch(predicateKey, udi, usedProperties);
+                    manager->watchPropertyChanges(udi);
+                }
             }
 
             if (matches) {
-                list.append(dev);
+                list.append(std::move(dev));
             }
         }
     }
@@ -169,6 +688,40 @@ QList<Solid::Device> Solid::Device::listFromQuery(const Predicate &predicate,
     return list;
 }
 
+QStringList Solid::Device::udisFromQuery(const Predicate &predicate,
+        const QString &parentUdi)
+{
+    // The match-everything refresh is what models do: the backend list
+    // travels to the caller as one shared handle, without materializing
+    // a Device per row.
+    if (!predicate.isValid() && parentUdi.isEmpty()) {
+        const QStringList udis = enumerateAllUdis();
+        Counters::add(Counters::DevicesEnumerated, udis.size());
+        return udis;
+    }
+
+    // Equality checks are answered from the result index, which already
+    // stores the answer as a list.
+    if (parentUdi.isEmpty()
+            && predicate.type() == Predicate::PropertyCheck
+            && predicate.comparisonOperator() == Predicate::Equals) {
+        DeviceManagerPrivate *manager
+            = static_cast<DeviceManagerPrivate *>(Solid::DeviceNotifier::instance());
+        return manager->udisFromEqualityCheck(predicate);
+    }
+
+    // Anything else has to evaluate the predicate against the device
+    // handles anyway; the UDI list is built once here and shared with
+    // the caller from then on.
+    const QList<Device> devices = listFromQuery(predicate, parentUdi);
+    QStringList udis;
+    udis.reserve(devices.size());
+    for (const Device &device : devices) {
+        udis.append(device.udi());
+    }
+    return udis;
+}
+
 Solid::Device Solid::Device::storageAccessFromPath(const QString &path)
 {
     if (!QFileInfo::exists(path)) {
@@ -198,119 +751,1133 @@ Solid::Device Solid::Device::storageAccessFromPath(const QString &path)
     return match;
 }
 
+Solid::Device Solid::Device::fromBlockDevice(int major, int minor)
+{
+    DeviceManagerPrivate *manager
+        = static_cast<DeviceManagerPrivate *>(Solid::DeviceNotifier::instance());
+    return Device(manager->udiFromBlockDevice(major, minor));
+}
+
+Solid::Device Solid::Device::fromUuid(const QString &uuid)
+{
+    DeviceManagerPrivate *manager
+        = static_cast<DeviceManagerPrivate *>(Solid::DeviceNotifier::instance());
+    return Device(manager->udiFromUuid(uuid));
+}
+
 Solid::DeviceNotifier *Solid::DeviceNotifier::instance()
 {
     return globalDeviceStorage->notifier();
 }
 
-void Solid::DeviceManagerPrivate::_k_deviceAdded(const QString &udi)
+QMap<QString, qulonglong> Solid::DeviceNotifier::performanceCounters()
 {
-    if (m_devicesMap.contains(udi)) {
-        DevicePrivate *dev = m_devicesMap[udi].data();
+    return Counters::snapshot();
+}
 
-        // Ok, this one was requested somewhere was invalid
-        // and now becomes magically valid!
+QVariantMap Solid::DeviceNotifier::diagnosticState()
+{
+    return static_cast<DeviceManagerPrivate *>(instance())->diagnosticState();
+}
 
-        if (dev && dev->backendObject() == nullptr) {
-            dev->setBackendObject(createBackendObject(udi));
-            Q_ASSERT(dev->backendObject() != nullptr);
-        }
-    }
+quint64 Solid::DeviceNotifier::lastEventSequence()
+{
+    return static_cast<DeviceManagerPrivate *>(instance())->lastEventSequence();
+}
 
-    Q_EMIT deviceAdded(udi);
+bool Solid::DeviceNotifier::eventsSince(quint64 sequence, QList<Event> *events)
+{
+    return static_cast<DeviceManagerPrivate *>(instance())->eventsSince(sequence, events);
 }
 
-void Solid::DeviceManagerPrivate::_k_deviceRemoved(const QString &udi)
+void Solid::DeviceNotifier::setChangeJournalEnabled(bool enabled)
 {
-    if (m_devicesMap.contains(udi)) {
-        DevicePrivate *dev = m_devicesMap[udi].data();
+    static_cast<DeviceManagerPrivate *>(instance())->setChangeJournalEnabled(enabled);
+}
 
-        // Ok, this one was requested somewhere was valid
-        // and now becomes magically invalid!
+quint32 Solid::DeviceManagerPrivate::supportedInterfacesMask(Ifaces::DeviceManager *backend)
+{
+    auto it = m_supportedMaskByBackend.constFind(backend);
+    if (it != m_supportedMaskByBackend.constEnd()) {
+        return it.value();
+    }
 
-        if (dev) {
-            Q_ASSERT(dev->backendObject() != nullptr);
-            dev->setBackendObject(nullptr);
-            Q_ASSERT(dev->backendObject() == nullptr);
+    quint32 mask = 0;
+    const QSet<DeviceInterface::Type> types = backend->supportedInterfaces();
+    for (DeviceInterface::Type type : types) {
+        if (type >= 0 && type < 32) {
+            mask |= quint32(1) << type;
         }
     }
-
-    Q_EMIT deviceRemoved(udi);
+    m_supportedMaskByBackend.insert(backend, mask);
+    return mask;
 }
 
-void Solid::DeviceManagerPrivate::_k_destroyed(QObject *object)
+QStringList Solid::DeviceManagerPrivate::udisFromType(DeviceInterface::Type type)
 {
-    QString udi = m_reverseMap.take(object);
+    auto it = m_typeIndex.constFind(type);
+    if (it != m_typeIndex.constEnd()) {
+        return it.value();
+    }
 
-    if (!udi.isEmpty()) {
-        m_devicesMap.remove(udi);
+    // A serving process on this desktop is authoritative and live, so a
+    // published table beats both the backends and the snapshot. Serving
+    // processes never read the table back.
+    if (!m_tablePublisher) {
+        bool served = false;
+        const auto table = DeviceTableIpc::fetch(&served);
+        if (served) {
+            auto tableIt = table.constFind(type);
+            if (tableIt != table.constEnd()) {
+                m_typeIndex.insert(type, tableIt.value());
+                return tableIt.value();
+            }
+        }
     }
-}
 
-Solid::DevicePrivate *Solid::DeviceManagerPrivate::findRegisteredDevice(const QString &udi)
-{
-    if (udi.isEmpty()) {
-        return m_nullDevice.data();
-    } else if (m_devicesMap.contains(udi)) {
-        return m_devicesMap[udi].data();
-    } else {
-        Ifaces::Device *iface = createBackendObject(udi);
+    if (!m_snapshotLoaded) {
+        m_snapshotTypeIndex = DeviceCacheSnapshot::load();
+        m_snapshotLoaded = true;
+    }
 
-        DevicePrivate *devData = new DevicePrivate(udi);
-        devData->setBackendObject(iface);
+    auto snapIt = m_snapshotTypeIndex.constFind(type);
+    if (snapIt != m_snapshotTypeIndex.constEnd()) {
+        // Serve the previous run's result right away and check it against
+        // the live backends asynchronously; any hardware change since last
+        // shutdown is then delivered through the usual deviceAdded and
+        // deviceRemoved notifications.
+        m_typeIndex.insert(type, snapIt.value());
+        QTimer::singleShot(0, this, [this, type]() {
+            reconcileSnapshotType(type);
+        });
+        return snapIt.value();
+    }
+
+    const QStringList udis = enumerateTypeFromBackends(type);
 
-        QPointer<DevicePrivate> ptr(devData);
-        m_devicesMap[udi] = ptr;
-        m_reverseMap[devData] = udi;
+    m_typeIndex.insert(type, udis);
+    m_snapshotDirty = true;
+    return udis;
+}
 
-        connect(devData, SIGNAL(destroyed(QObject*)),
-                this, SLOT(_k_destroyed(QObject*)));
+QStringList Solid::DeviceManagerPrivate::enumerateTypeFromBackends(DeviceInterface::Type type)
+{
+    QStringList udis;
+    const QList<Ifaces::DeviceManager *> backends = deviceBackends();
+    for (Ifaces::DeviceManager *backend : backends) {
+        if (!backend->supportedInterfaces().contains(type)) {
+            continue;
+        }
 
-        return devData;
+        QElapsedTimer profileTimer;
+        profileTimer.start();
+        udis += backend->devicesFromQuery(QString(), type);
+        StartupProfiler::recordOnce("firstEnumeration",
+                                    QString::fromLatin1(backend->metaObject()->className()),
+                                    profileTimer.nsecsElapsed());
     }
+
+    return udis;
 }
 
-Solid::Ifaces::Device *Solid::DeviceManagerPrivate::createBackendObject(const QString &udi)
+void Solid::DeviceManagerPrivate::reconcileSnapshotType(DeviceInterface::Type type)
 {
-    const QList<QObject *> backends = globalDeviceStorage->managerBackends();
+    auto it = m_typeIndex.constFind(type);
+    if (it == m_typeIndex.constEnd()) {
+        return;
+    }
 
-    for (QObject *backendObj : backends) {
-        Ifaces::DeviceManager *backend = qobject_cast<Ifaces::DeviceManager *>(backendObj);
+    const QStringList snapshotUdis = it.value();
+    const QStringList liveUdis = enumerateTypeFromBackends(type);
 
-        if (backend == nullptr) {
-            continue;
+    // Route the differences through the regular addition/removal paths so
+    // every index and every subscribed consumer is corrected the same way
+    // a real hotplug event would correct them.
+    for (const QString &udi : snapshotUdis) {
+        if (!liveUdis.contains(udi)) {
+            _k_deviceRemoved(udi);
         }
-        if (!udi.startsWith(backend->udiPrefix())) {
-            continue;
+    }
+    for (const QString &udi : liveUdis) {
+        if (!snapshotUdis.contains(udi)) {
+            _k_deviceAdded(udi);
         }
+    }
 
-        Ifaces::Device *iface = nullptr;
+    m_snapshotTypeIndex.remove(type);
+    m_snapshotDirty = true;
+}
 
-        QObject *object = backend->createDevice(udi);
-        iface = qobject_cast<Ifaces::Device *>(object);
+QStringList Solid::DeviceManagerPrivate::udisFromEqualityCheck(const Predicate &predicate)
+{
+    const QString key = predicate.toString();
+    auto it = m_equalityIndex.constFind(key);
+    if (it != m_equalityIndex.constEnd()) {
+        return it->udis;
+    }
 
-        if (iface == nullptr) {
-            delete object;
-        }
+    EqualityIndexEntry entry;
+    entry.predicate = predicate;
+    entry.foldedProperty = predicate.propertyName().toLower();
 
-        return iface;
+    const QStringList candidates = udisFromType(predicate.interfaceType());
+    for (const QString &udi : candidates) {
+        Device dev(udi);
+        if (predicate.matches(dev)) {
+            entry.udis.append(udi);
+        }
+        watchPropertyChanges(udi);
     }
 
-    return nullptr;
+    m_equalityIndex.insert(key, entry);
+    return entry.udis;
 }
 
-Solid::DeviceManagerStorage::DeviceManagerStorage()
+static quint64 blockDeviceKey(int major, int minor)
 {
-
+    return (quint64(quint32(major)) << 32) | quint32(minor);
 }
 
-QList<QObject *> Solid::DeviceManagerStorage::managerBackends()
+QString Solid::DeviceManagerPrivate::udiFromBlockDevice(int major, int minor)
 {
-    ensureManagerCreated();
-    return m_storage.localData()->managerBackends();
+    if (!m_blockIndexBuilt) {
+        m_blockIndexBuilt = true;
+
+        const QStringList udis = udisFromType(DeviceInterface::Block);
+        for (const QString &udi : udis) {
+            indexBlockDevice(udi);
+        }
+    }
+
+    return m_blockIndex.value(blockDeviceKey(major, minor));
 }
 
-Solid::DeviceNotifier *Solid::DeviceManagerStorage::notifier()
+void Solid::DeviceManagerPrivate::indexBlockDevice(const QString &udi)
+{
+    Device dev(udi);
+    const Block *block = dev.as<Block>();
+    if (block == nullptr) {
+        return;
+    }
+
+    const quint64 key = blockDeviceKey(block->deviceMajor(), block->deviceMinor());
+    m_blockIndex.insert(key, udi);
+    m_blockKeyByUdi.insert(udi, key);
+}
+
+void Solid::DeviceManagerPrivate::unindexBlockDevice(const QString &udi)
+{
+    auto it = m_blockKeyByUdi.find(udi);
+    if (it == m_blockKeyByUdi.end()) {
+        return;
+    }
+
+    auto indexIt = m_blockIndex.find(it.value());
+    if (indexIt != m_blockIndex.end() && indexIt.value() == udi) {
+        m_blockIndex.erase(indexIt);
+    }
+    m_blockKeyByUdi.erase(it);
+}
+
+QString Solid::DeviceManagerPrivate::udiFromUuid(const QString &uuid)
+{
+    if (!m_uuidIndexBuilt) {
+        m_uuidIndexBuilt = true;
+
+        const QStringList udis = udisFromType(DeviceInterface::StorageVolume);
+        for (const QString &udi : udis) {
+            indexVolumeUuid(udi);
+        }
+    }
+
+    return m_uuidIndex.value(uuid.toLower());
+}
+
+void Solid::DeviceManagerPrivate::indexVolumeUuid(const QString &udi)
+{
+    Device dev(udi);
+    const StorageVolume *volume = dev.as<StorageVolume>();
+    if (volume == nullptr) {
+        return;
+    }
+
+    const QString uuid = volume->uuid();
+    if (uuid.isEmpty()) {
+        return;
+    }
+
+    m_uuidIndex.insert(uuid, udi);
+    m_uuidByUdi.insert(udi, uuid);
+}
+
+void Solid::DeviceManagerPrivate::unindexVolumeUuid(const QString &udi)
+{
+    auto it = m_uuidByUdi.find(udi);
+    if (it == m_uuidByUdi.end()) {
+        return;
+    }
+
+    auto indexIt = m_uuidIndex.find(it.value());
+    if (indexIt != m_uuidIndex.end() && indexIt.value() == udi) {
+        m_uuidIndex.erase(indexIt);
+    }
+    m_uuidByUdi.erase(it);
+}
+
+QStringList Solid::DeviceManagerPrivate::childUdisFromParent(const QString &parentUdi)
+{
+    if (!m_parentIndexBuilt) {
+        m_parentIndexBuilt = true;
+
+        const QList<Ifaces::DeviceManager *> backends = deviceBackends();
+        for (Ifaces::DeviceManager *backend : backends) {
+            const QStringList udis = backend->allDevices();
+            for (const QString &udi : udis) {
+                indexParent(udi);
+            }
+        }
+    }
+
+    return m_parentIndex.values(parentUdi);
+}
+
+void Solid::DeviceManagerPrivate::indexParent(const QString &udi)
+{
+    Device dev(udi);
+    const QString parent = dev.parentUdi();
+    if (parent.isEmpty()) {
+        return;
+    }
+
+    m_parentIndex.insert(parent, udi);
+    m_parentByUdi.insert(udi, parent);
+}
+
+void Solid::DeviceManagerPrivate::unindexParent(const QString &udi)
+{
+    auto it = m_parentByUdi.find(udi);
+    if (it == m_parentByUdi.end()) {
+        return;
+    }
+
+    m_parentIndex.remove(it.value(), udi);
+    m_parentByUdi.erase(it);
+}
+
+bool Solid::DeviceManagerPrivate::displayEntryLess(const DisplayEntry &left, const DisplayEntry &right) const
+{
+    const int order = left.key.compare(right.key);
+    if (order != 0) {
+        return order < 0;
+    }
+    // Identical descriptions happen (several equal drives); the UDI
+    // tie-breaker keeps the order deterministic across rebuilds.
+    return left.udi < right.udi;
+}
+
+QStringList Solid::DeviceManagerPrivate::displayOrderedUdis()
+{
+    if (!m_displayOrderBuilt) {
+        m_displayCollator.setNumericMode(true);
+
+        const QStringList udis = enumerateAllUdis();
+
+        m_displayOrder.clear();
+        m_displayOrder.reserve(udis.size());
+        for (const QString &udi : qAsConst(udis)) {
+            Device dev(udi);
+            const QString description = dev.description();
+            m_displayOrder.push_back(DisplayEntry{udi, description, m_displayCollator.sortKey(description)});
+            // A description is derived from properties, so the entry has
+            // to follow their changes.
+            watchPropertyChanges(udi);
+        }
+        std::sort(m_displayOrder.begin(), m_displayOrder.end(),
+                  [this](const DisplayEntry &left, const DisplayEntry &right) {
+            return displayEntryLess(left, right);
+        });
+        m_displayOrderBuilt = true;
+    }
+
+    QStringList result;
+    result.reserve(int(m_displayOrder.size()));
+    for (const DisplayEntry &entry : m_displayOrder) {
+        result.append(entry.udi);
+    }
+    return result;
+}
+
+void Solid::DeviceManagerPrivate::indexDisplayEntry(const QString &udi)
+{
+    if (!m_displayOrderBuilt) {
+        return;
+    }
+
+    Device dev(udi);
+    const QString description = dev.description();
+    DisplayEntry entry{udi, description, m_displayCollator.sortKey(description)};
+    const auto it = std::lower_bound(m_displayOrder.begin(), m_displayOrder.end(), entry,
+                                     [this](const DisplayEntry &left, const DisplayEntry &right) {
+        return displayEntryLess(left, right);
+    });
+    m_displayOrder.insert(it, std::move(entry));
+    watchPropertyChanges(udi);
+}
+
+void Solid::DeviceManagerPrivate::unindexDisplayEntry(const QString &udi)
+{
+    for (auto it = m_displayOrder.begin(); it != m_displayOrder.end(); ++it) {
+        if (it->udi == udi) {
+            m_displayOrder.erase(it);
+            return;
+        }
+    }
+}
+
+void Solid::DeviceManagerPrivate::refreshDisplayEntry(const QString &udi)
+{
+    if (!m_displayOrderBuilt) {
+        return;
+    }
+
+    for (auto it = m_displayOrder.begin(); it != m_displayOrder.end(); ++it) {
+        if (it->udi != udi) {
+            continue;
+        }
+
+        Device dev(udi);
+        const QString description = dev.description();
+        if (description == it->description) {
+            // The change didn't touch the description; the cached
+            // collation key stays valid and nothing moves.
+            return;
+        }
+
+        m_displayOrder.erase(it);
+        DisplayEntry entry{udi, description, m_displayCollator.sortKey(description)};
+        const auto pos = std::lower_bound(m_displayOrder.begin(), m_displayOrder.end(), entry,
+                                          [this](const DisplayEntry &left, const DisplayEntry &right) {
+            return displayEntryLess(left, right);
+        });
+        m_displayOrder.insert(pos, std::move(entry));
+        return;
+    }
+}
+
+bool Solid::DeviceManagerPrivate::isKnownNonMatch(const QString &predicateKey, const QString &udi) const
+{
+    auto it = m_negativeMatchCache.constFind(predicateKey);
+    return it != m_negativeMatchCache.constEnd() && it->udis.contains(udi);
+}
+
+QSet<QString> Solid::DeviceManagerPrivate::foldedPropertyNames(const QSet<QString> &properties)
+{
+    // Predicates name Qt properties ("size"), the backends report the
+    // D-Bus spelling ("Size"); folding both sides to lowercase lets the
+    // dependency test work across the boundary.
+    QSet<QString> folded;
+    folded.reserve(properties.size());
+    for (const QString &property : properties) {
+        folded.insert(property.toLower());
+    }
+    return folded;
+}
+
+void Solid::DeviceManagerPrivate::recordNonMatch(const QString &predicateKey, const QString &udi, const QSet<QString> &usedProperties)
+{
+    NegativeMatchEntry &entry = m_negativeMatchCache[predicateKey];
+    if (entry.udis.isEmpty()) {
+        entry.foldedProperties = foldedPropertyNames(usedProperties);
+    }
+    entry.udis.insert(udi);
+}
+
+void Solid::DeviceManagerPrivate::invalidateNegativeMatches(const QString &udi)
+{
+    for (auto it = m_negativeMatchCache.begin(); it != m_negativeMatchCache.end(); ++it) {
+        it.value().udis.remove(udi);
+    }
+}
+
+void Solid::DeviceManagerPrivate::invalidateNegativeMatches(const QString &udi, const QMap<QString, int> &changes)
+{
+    if (changes.isEmpty()) {
+        // A notification that doesn't name its properties could have
+        // touched anything.
+        invalidateNegativeMatches(udi);
+        return;
+    }
+
+    for (auto it = m_negativeMatchCache.begin(); it != m_negativeMatchCache.end(); ++it) {
+        const QSet<QString> &dependencies = it.value().foldedProperties;
+        bool affected = false;
+        for (auto change = changes.constBegin(); change != changes.constEnd(); ++change) {
+            if (dependencies.contains(change.key().toLower())) {
+                affected = true;
+                break;
+            }
+        }
+        if (affected) {
+            it.value().udis.remove(udi);
+        }
+    }
+}
+
+void Solid::DeviceManagerPrivate::watchPropertyChanges(const QString &udi)
+{
+    if (m_watchedUdis.contains(udi)) {
+        return;
+    }
+
+    Device dev(udi);
+    GenericInterface *generic = dev.as<GenericInterface>();
+    if (generic == nullptr) {
+        return;
+    }
+
+    m_watchedUdis.insert(udi);
+    connect(generic, &GenericInterface::propertyChanged,
+            this, [this, udi](const QMap<QString, int> &changes) {
+        reevaluateEqualityIndex(udi, changes);
+        invalidateNegativeMatches(udi, changes);
+        refreshDisplayEntry(udi);
+        if (m_changeJournalEnabled) {
+            recordEvent(udi, DeviceNotifier::Event::DeviceChanged);
+        }
+    });
+}
+
+void Solid::DeviceManagerPrivate::reevaluateEqualityIndex(const QString &udi)
+{
+    if (m_equalityIndex.isEmpty()) {
+        return;
+    }
+
+    Device dev(udi);
+    for (auto it = m_equalityIndex.begin(); it != m_equalityIndex.end(); ++it) {
+        const bool matches = it.value().predicate.matches(dev);
+        const bool indexed = it.value().udis.contains(udi);
+
+        if (matches && !indexed) {
+            it.value().udis.append(udi);
+        } else if (!matches && indexed) {
+            it.value().udis.removeAll(udi);
+        }
+    }
+}
+
+void Solid::DeviceManagerPrivate::reevaluateEqualityIndex(const QString &udi, const QMap<QString, int> &changes)
+{
+    if (m_equalityIndex.isEmpty()) {
+        return;
+    }
+    if (changes.isEmpty()) {
+        reevaluateEqualityIndex(udi);
+        return;
+    }
+
+    Device dev(udi);
+    for (auto it = m_equalityIndex.begin(); it != m_equalityIndex.end(); ++it) {
+        // An equality entry reads exactly one property; when the change
+        // didn't touch it, the recorded verdict still holds.
+        bool affected = false;
+        for (auto change = changes.constBegin(); change != changes.constEnd(); ++change) {
+            if (it.value().foldedProperty == change.key().toLower()) {
+                affected = true;
+                break;
+            }
+        }
+        if (!affected) {
+            continue;
+        }
+
+        const bool matches = it.value().predicate.matches(dev);
+        const bool indexed = it.value().udis.contains(udi);
+
+        if (matches && !indexed) {
+            it.value().udis.append(udi);
+        } else if (!matches && indexed) {
+            it.value().udis.removeAll(udi);
+        }
+    }
+}
+
+void Solid::DeviceManagerPrivate::indexDevice(const QString &udi)
+{
+    if (m_typeIndex.isEmpty()) {
+        return;
+    }
+
+    // Backends which know the interface lists from their enumeration
+    // payload answer through the capability mask, so index maintenance
+    // instantiates nothing for them.
+    if (Ifaces::DeviceManager *backend = routeUdi(udi)) {
+        const quint32 mask = backend->deviceInterfacesMask(udi);
+        if (mask != 0) {
+            for (auto it = m_typeIndex.begin(); it != m_typeIndex.end(); ++it) {
+                if (it.key() >= 0 && it.key() < 32
+                        && (mask & (quint32(1) << it.key()))
+                        && !it.value().contains(udi)) {
+                    it.value().append(udi);
+                }
+            }
+            return;
+        }
+    }
+
+    Ifaces::Device *iface = nullptr;
+    bool ownIface = false;
+
+    auto devIt = m_devicesMap.constFind(udi);
+    if (devIt != m_devicesMap.constEnd()) {
+        iface = devIt.value()->backendObject();
+    }
+    if (iface == nullptr) {
+        iface = createBackendObject(udi);
+        ownIface = true;
+    }
+    if (iface == nullptr) {
+        return;
+    }
+
+    for (auto it = m_typeIndex.begin(); it != m_typeIndex.end(); ++it) {
+        if (iface->queryDeviceInterface(it.key()) && !it.value().contains(udi)) {
+            it.value().append(udi);
+        }
+    }
+
+    if (ownIface) {
+        delete iface;
+    }
+}
+
+void Solid::DeviceManagerPrivate::unindexDevice(const QString &udi)
+{
+    for (auto it = m_typeIndex.begin(); it != m_typeIndex.end(); ++it) {
+        it.value().removeAll(udi);
+    }
+}
+
+QVariantMap Solid::DeviceManagerPrivate::diagnosticState()
+{
+    ensureBackendsLoaded();
+
+    QVariantMap frontend;
+    frontend.insert(QStringLiteral("registeredDevices"), m_devicesMap.count());
+    frontend.insert(QStringLiteral("watchedUdis"), m_watchedUdis.count());
+
+    int typeIndexUdis = 0;
+    for (auto it = m_typeIndex.constBegin(); it != m_typeIndex.constEnd(); ++it) {
+        typeIndexUdis += it.value().count();
+    }
+    frontend.insert(QStringLiteral("typeIndexTypes"), m_typeIndex.count());
+    frontend.insert(QStringLiteral("typeIndexUdis"), typeIndexUdis);
+
+    int equalityIndexUdis = 0;
+    for (auto it = m_equalityIndex.constBegin(); it != m_equalityIndex.constEnd(); ++it) {
+        equalityIndexUdis += it.value().udis.count();
+    }
+    frontend.insert(QStringLiteral("equalityIndexPredicates"), m_equalityIndex.count());
+    frontend.insert(QStringLiteral("equalityIndexUdis"), equalityIndexUdis);
+
+    int negativeMatchUdis = 0;
+    for (auto it = m_negativeMatchCache.constBegin(); it != m_negativeMatchCache.constEnd(); ++it) {
+        negativeMatchUdis += it.value().udis.count();
+    }
+    frontend.insert(QStringLiteral("negativeMatchPredicates"), m_negativeMatchCache.count());
+    frontend.insert(QStringLiteral("negativeMatchUdis"), negativeMatchUdis);
+
+    frontend.insert(QStringLiteral("blockIndexEntries"), m_blockIndex.count());
+    frontend.insert(QStringLiteral("uuidIndexEntries"), m_uuidIndex.count());
+    frontend.insert(QStringLiteral("parentIndexEntries"), m_parentIndex.count());
+    frontend.insert(QStringLiteral("displayOrderEntries"), int(m_displayOrder.size()));
+    frontend.insert(QStringLiteral("flapRecords"), m_flapRecords.count());
+    frontend.insert(QStringLiteral("journaledEvents"), int(m_eventBuffer.size()));
+    frontend.insert(QStringLiteral("eventSequence"), qulonglong(m_eventSequence));
+
+    /* The backends report their own tables; backends without notable
+     * internal state show up with an empty entry, which still documents
+     * they were loaded. */
+    QVariantMap backends;
+    const QList<Ifaces::DeviceManager *> backendList = deviceBackends();
+    for (Ifaces::DeviceManager *backend : backendList) {
+        backends.insert(backend->udiPrefix(), backend->diagnosticState());
+    }
+
+    QVariantMap counters;
+    const QMap<QString, qulonglong> snapshot = Counters::snapshot();
+    for (auto it = snapshot.constBegin(); it != snapshot.constEnd(); ++it) {
+        counters.insert(it.key(), it.value());
+    }
+
+    QVariantMap state;
+    state.insert(QStringLiteral("frontend"), frontend);
+    state.insert(QStringLiteral("backends"), backends);
+    state.insert(QStringLiteral("counters"), counters);
+    return state;
+}
+
+// Enough to cover a plugin reload spanning a dock hotplug; a listener
+// away for longer than this many events re-enumerates anyway.
+static const int s_eventBufferCapacity = 256;
+
+void Solid::DeviceManagerPrivate::recordEvent(const QString &udi, DeviceNotifier::Event::Kind kind)
+{
+    if (kind == DeviceNotifier::Event::DeviceChanged && m_eventSequence > 0) {
+        // Collapse consecutive change records of the same device: a
+        // mirror re-reads the device once per sync anyway, and a chatty
+        // device must not flush the bounded journal on its own.
+        const DeviceNotifier::Event &newest
+            = m_eventBuffer.at(static_cast<int>((m_eventSequence - 1) % s_eventBufferCapacity));
+        if (newest.kind == DeviceNotifier::Event::DeviceChanged && newest.udi == udi) {
+            return;
+        }
+    }
+
+    ++m_eventSequence;
+    const int slot = static_cast<int>((m_eventSequence - 1) % s_eventBufferCapacity);
+
+    DeviceNotifier::Event event{m_eventSequence, kind, udi};
+    if (slot < m_eventBuffer.size()) {
+        m_eventBuffer[slot] = event;
+    } else {
+        m_eventBuffer.append(event);
+    }
+}
+
+quint64 Solid::DeviceManagerPrivate::lastEventSequence() const
+{
+    return m_eventSequence;
+}
+
+bool Solid::DeviceManagerPrivate::eventsSince(quint64 sequence, QList<DeviceNotifier::Event> *events) const
+{
+    if (sequence >= m_eventSequence) {
+        // nothing happened since; a sequence from the future can only be
+        // a caller bug, and there is nothing to replay for it either
+        return sequence == m_eventSequence;
+    }
+
+    const quint64 oldestRetained = m_eventSequence > quint64(s_eventBufferCapacity)
+                                   ? m_eventSequence - s_eventBufferCapacity + 1 : 1;
+    if (sequence + 1 < oldestRetained) {
+        // the buffer wrapped past the requested point, events were lost
+        return false;
+    }
+
+    if (events) {
+        for (quint64 seq = sequence + 1; seq <= m_eventSequence; ++seq) {
+            events->append(m_eventBuffer.at(static_cast<int>((seq - 1) % s_eventBufferCapacity)));
+        }
+    }
+    return true;
+}
+
+void Solid::DeviceManagerPrivate::setChangeJournalEnabled(bool enabled)
+{
+    if (m_changeJournalEnabled == enabled) {
+        return;
+    }
+    m_changeJournalEnabled = enabled;
+
+    if (enabled) {
+        // Cover the devices registered so far; later arrivals get their
+        // subscription from _k_deviceAdded. The property subscriptions
+        // stay in place when the journal is disabled again — they are
+        // shared with the equality index and harmless on their own.
+        const QStringList udis = m_devicesMap.keys();
+        for (const QString &udi : udis) {
+            watchPropertyChanges(udi);
+        }
+    }
+}
+
+// How long one admission-control window lasts, how long the first
+// quarantine of a flapping device is, and how long a quarantine may grow
+// to under the exponential backoff.
+static const int s_flapWindowMs = 10000;
+static const int s_flapBasePenaltyMs = 10000;
+static const int s_flapMaxPenaltyMs = 10 * 60 * 1000;
+
+bool Solid::DeviceManagerPrivate::admitDeviceEvent(const QString &udi, bool added)
+{
+    // Add/remove events a single UDI may produce within one window
+    // before it is quarantined; 0 disables admission control. Served
+    // from the configuration snapshot, so toggling at runtime takes a
+    // Config::reload().
+    const int budget = Config::snapshot()->deviceEventBudget;
+    if (budget <= 0) {
+        return true;
+    }
+
+    auto it = m_flapRecords.find(udi);
+    if (it == m_flapRecords.end()) {
+        FlapRecord record;
+        record.window.start();
+        record.events = 1;
+        m_flapRecords.insert(udi, record);
+        return true;
+    }
+
+    FlapRecord &record = it.value();
+
+    if (record.quarantined) {
+        if (record.window.elapsed() < record.penaltyMs) {
+            ++record.suppressed;
+            return false;
+        }
+
+        // Quarantine over; summarize what was swallowed and double the
+        // penalty for the next round in case the device keeps flapping.
+        qCWarning(Frontend::DeviceManager::DEVICEMANAGER)
+                << "Device" << udi << "leaves quarantine after suppressing"
+                << record.suppressed << "events in" << record.penaltyMs << "ms";
+        record.quarantined = false;
+        record.suppressed = 0;
+        record.penaltyMs = qMin(record.penaltyMs * 2, s_flapMaxPenaltyMs);
+        record.window.restart();
+        record.events = 1;
+        // The last state clients saw was "removed": deliver the addition
+        // that makes the device visible again, swallow a redundant removal.
+        return added;
+    }
+
+    if (record.window.elapsed() > s_flapWindowMs) {
+        // A well-behaved stretch. Devices without backoff history don't
+        // need a record at all; for the others the accumulated penalty is
+        // kept so a device alternating between calm and storm still backs
+        // off exponentially.
+        if (record.penaltyMs == 0) {
+            m_flapRecords.erase(it);
+        } else {
+            record.window.restart();
+            record.events = 1;
+        }
+        return true;
+    }
+
+    if (++record.events <= budget) {
+        return true;
+    }
+
+    // Over budget: quarantine the UDI. Events alternate, so when the
+    // culprit is an addition the device is already announced as removed
+    // and the add is swallowed; when it is a removal it goes through as
+    // the final event, so clients see the device disappear exactly once
+    // and the rest of the device table stays responsive.
+    record.quarantined = true;
+    if (record.penaltyMs == 0) {
+        record.penaltyMs = s_flapBasePenaltyMs;
+    }
+    record.window.restart();
+    qCWarning(Frontend::DeviceManager::DEVICEMANAGER)
+            << "Device" << udi << "produced" << record.events
+            << "add/remove events within" << s_flapWindowMs
+            << "ms, quarantining for" << record.penaltyMs << "ms";
+    if (added) {
+        record.suppressed = 1;
+        return false;
+    }
+    record.suppressed = 0;
+    return true;
+}
+
+void Solid::DeviceManagerPrivate::_k_deviceAdded(const QString &udi)
+{
+    SOLID_TRACE_TIMER(traceTimer);
+
+    if (!admitDeviceEvent(udi, true)) {
+        return;
+    }
+
+    auto it = m_devicesMap.constFind(udi);
+    if (it != m_devicesMap.constEnd()) {
+        DevicePrivate *dev = it.value();
+
+        // Ok, this one was requested somewhere was invalid
+        // and now becomes magically valid!
+
+        if (dev->backendObject() == nullptr) {
+            dev->setBackendObject(createBackendObject(udi));
+            Q_ASSERT(dev->backendObject() != nullptr);
+        }
+    }
+
+    indexDevice(udi);
+    if (m_blockIndexBuilt) {
+        indexBlockDevice(udi);
+    }
+    if (m_uuidIndexBuilt) {
+        indexVolumeUuid(udi);
+    }
+    if (m_parentIndexBuilt) {
+        indexParent(udi);
+    }
+    indexDisplayEntry(udi);
+    if (!m_typeIndex.isEmpty()) {
+        m_snapshotDirty = true;
+    }
+    if (m_tablePublisher) {
+        m_tablePublisher->publish(m_typeIndex);
+    }
+
+    if (!m_equalityIndex.isEmpty()) {
+        reevaluateEqualityIndex(udi);
+        watchPropertyChanges(udi);
+    }
+    if (m_changeJournalEnabled) {
+        watchPropertyChanges(udi);
+    }
+    invalidateNegativeMatches(udi);
+    recordEvent(udi, DeviceNotifier::Event::DeviceAdded);
+
+    Counters::add(Counters::SignalsEmitted);
+    Q_EMIT deviceAdded(udi);
+
+    // A device that went away and came back within one window (the
+    // backends do remove-and-readd cycles on interface changes) isn't
+    // reported as removed.
+    m_pendingRemovedUdis.removeAll(udi);
+
+    if (m_pendingAddedUdis.isEmpty()) {
+        // Sized for the burst a multi-partition disk produces, so the
+        // common case grows the list exactly once.
+        m_pendingAddedUdis.reserve(16);
+    }
+    m_pendingAddedUdis.append(udi);
+    if (!m_addedCoalesceTimer.isActive()) {
+        m_addedCoalesceTimer.start();
+    }
+
+    SOLID_PROBE2(device_added, qPrintable(udi), SOLID_TRACE_NSECS(traceTimer));
+}
+
+void Solid::DeviceManagerPrivate::_k_emitBatchedAdditions()
+{
+    // Swap instead of copy-and-clear: a coldplug burst then performs no
+    // allocation here beyond the one list the signal argument needs.
+    QStringList udis;
+    udis.swap(m_pendingAddedUdis);
+
+    if (!udis.isEmpty()) {
+        Q_EMIT devicesAdded(udis);
+    }
+}
+
+void Solid::DeviceManagerPrivate::_k_emitBatchedRemovals()
+{
+    QStringList udis;
+    udis.swap(m_pendingRemovedUdis);
+
+    if (!udis.isEmpty()) {
+        Q_EMIT devicesRemoved(udis);
+    }
+}
+
+void Solid::DeviceManagerPrivate::_k_deviceRemoved(const QString &udi)
+{
+    SOLID_TRACE_TIMER(traceTimer);
+
+    if (!admitDeviceEvent(udi, false)) {
+        return;
+    }
+
+    auto it = m_devicesMap.constFind(udi);
+    if (it != m_devicesMap.constEnd()) {
+        DevicePrivate *dev = it.value();
+
+        // Ok, this one was requested somewhere was valid
+        // and now becomes magically invalid!
+
+        // Detach instead of tearing down in place: the device reports
+        // invalid immediately, but the defunct backend object and the
+        // cached interface wrappers are destroyed from the event loop.
+        // Unplugging a hub then costs one pass over the removal set here
+        // and the deletion cascades run at idle, between signal
+        // deliveries instead of inside them.
+        Q_ASSERT(dev->backendObject() != nullptr);
+        dev->detachBackendObject();
+        Q_ASSERT(dev->backendObject() == nullptr);
+    }
+
+    unindexDevice(udi);
+    unindexBlockDevice(udi);
+    unindexVolumeUuid(udi);
+    unindexParent(udi);
+    unindexDisplayEntry(udi);
+    if (!m_typeIndex.isEmpty()) {
+        m_snapshotDirty = true;
+    }
+    if (m_tablePublisher) {
+        m_tablePublisher->publish(m_typeIndex);
+    }
+
+    for (auto it = m_equalityIndex.begin(); it != m_equalityIndex.end(); ++it) {
+        it.value().udis.removeAll(udi);
+    }
+    m_watchedUdis.remove(udi);
+    invalidateNegativeMatches(udi);
+
+    // Don't announce devices that came and went within one window.
+    m_pendingAddedUdis.removeAll(udi);
+
+    recordEvent(udi, DeviceNotifier::Event::DeviceRemoved);
+
+    Counters::add(Counters::SignalsEmitted);
+    Q_EMIT deviceRemoved(udi);
+
+    if (m_pendingRemovedUdis.isEmpty()) {
+        // Sized for the burst a hub disconnect produces, so the common
+        // case grows the list exactly once.
+        m_pendingRemovedUdis.reserve(16);
+    }
+    m_pendingRemovedUdis.append(udi);
+    if (!m_removedCoalesceTimer.isActive()) {
+        m_removedCoalesceTimer.start();
+    }
+
+    SOLID_PROBE2(device_removed, qPrintable(udi), SOLID_TRACE_NSECS(traceTimer));
+}
+
+void Solid::DeviceManagerPrivate::_k_destroyed(QObject *object)
+{
+    QString udi = m_reverseMap.take(object);
+
+    if (!udi.isEmpty()) {
+        m_devicesMap.remove(udi);
+        globalSharedDeviceCache->remove(udi, object);
+        Counters::recordDevicePrivateDestroyed();
+    }
+}
+
+Solid::DevicePrivate *Solid::DeviceManagerPrivate::findRegisteredDevice(const QString &udi)
+{
+    if (udi.isEmpty()) {
+        return m_nullDevice.data();
+    }
+
+    auto it = m_devicesMap.constFind(udi);
+    if (it != m_devicesMap.constEnd()) {
+        return it.value();
+    }
+
+    // Read-mostly fast path: reuse the device data another thread already
+    // created instead of rebuilding it and re-subscribing to the backends.
+    // The backend signal subscriptions stay with the creating thread.
+    if (DevicePrivate *shared = globalSharedDeviceCache->find(udi)) {
+        return shared;
+    }
+
+    // UDIs no backend feels responsible for can't become valid devices, so
+    // don't bother the backends; an invalid entry is registered so repeated
+    // lookups of the same bogus UDI stay cheap too.
+    if (!udiMatchesKnownPrefix(udi)) {
+        return registerDevice(udi, nullptr);
+    }
+
+    return registerDevice(udi, createBackendObject(udi));
+}
+
+QList<Solid::Device> Solid::DeviceManagerPrivate::findRegisteredDevices(const QStringList &udis)
+{
+    QList<Device> list;
+    list.reserve(udis.size());
+
+    Ifaces::DeviceManager *lastBackend = nullptr;
+    QString lastPrefix;
+
+    for (const QString &udi : udis) {
+        Device dev;
+
+        if (udi.isEmpty()) {
+            list.append(dev);
+            continue;
+        }
+
+        auto it = m_devicesMap.constFind(udi);
+        if (it != m_devicesMap.constEnd()) {
+            dev.d = it.value();
+            list.append(dev);
+            continue;
+        }
+
+        if (DevicePrivate *shared = globalSharedDeviceCache->find(udi)) {
+            dev.d = shared;
+            list.append(dev);
+            continue;
+        }
+
+        // Enumeration snapshots deliver the UDIs of one backend in a row,
+        // so the responsible backend is resolved once per prefix run
+        // instead of once per device.
+        if (lastBackend == nullptr || !udi.startsWith(lastPrefix)) {
+            lastBackend = routeUdi(udi);
+            lastPrefix = lastBackend ? lastBackend->udiPrefix() : QString();
+        }
+
+        Ifaces::Device *iface = nullptr;
+        if (lastBackend) {
+            QObject *object = lastBackend->createDevice(udi);
+            iface = qobject_cast<Ifaces::Device *>(object);
+            if (iface == nullptr) {
+                delete object;
+            }
+        }
+
+        dev.d = registerDevice(udi, iface);
+        list.append(std::move(dev));
+    }
+
+    return list;
+}
+
+Solid::DevicePrivate *Solid::DeviceManagerPrivate::registerDevice(const QString &udi, Ifaces::Device *iface)
+{
+    DevicePrivate *devData = new DevicePrivate(udi);
+    devData->setBackendObject(iface);
+    Counters::recordDevicePrivateCreated();
+
+    m_devicesMap.insert(udi, devData);
+    m_reverseMap[devData] = udi;
+    globalSharedDeviceCache->insert(udi, devData);
+
+    connect(devData, SIGNAL(destroyed(QObject*)),
+            this, SLOT(_k_destroyed(QObject*)));
+
+    return devData;
+}
+
+Solid::Ifaces::Device *Solid::DeviceManagerPrivate::createBackendObject(const QString &udi)
+{
+    Ifaces::DeviceManager *backend = routeUdi(udi);
+    if (!backend) {
+        return nullptr;
+    }
+
+    Ifaces::Device *iface = nullptr;
+
+    QObject *object = backend->createDevice(udi);
+    iface = qobject_cast<Ifaces::Device *>(object);
+
+    if (iface == nullptr) {
+        delete object;
+    }
+
+    return iface;
+}
+
+Solid::DeviceManagerStorage::DeviceManagerStorage()
+{
+
+}
+
+QList<QObject *> Solid::DeviceManagerStorage::managerBackends()
+{
+    ensureManagerCreated();
+    return m_storage.localData()->managerBackends();
+}
+
+Solid::DeviceNotifier *Solid::DeviceManagerStorage::notifier()
 {
     ensureManagerCreated();
     return m_storage.localData();
@@ -323,6 +1890,24 @@ void Solid::DeviceManagerStorage::ensureManagerCreated()
     }
 }
 
+QList<QObject *> Solid::DeviceManagerPrivate::managerBackends()
+{
+    ensureBackendsLoaded();
+    return ManagerBasePrivate::managerBackends();
+}
+
+QList<Solid::Ifaces::DeviceManager *> Solid::DeviceManagerPrivate::deviceBackends()
+{
+    ensureBackendsLoaded();
+    return m_deviceBackends;
+}
+
+QList<Solid::Ifaces::DeviceManager *> Solid::DeviceManagerStorage::deviceBackends()
+{
+    ensureManagerCreated();
+    return m_storage.localData()->deviceBackends();
+}
+
 #include "moc_devicemanager_p.cpp"
 #include "moc_devicenotifier.cpp"
 
@@ -10,19 +10,67 @@
 #include "managerbase_p.h"
 
 #include "devicenotifier.h"
+#include "deviceinterface.h"
+#include "predicate.h"
 
+#include <QCollator>
+#include <QElapsedTimer>
 #include <QHash>
+#include <QMetaMethod>
+#include <QMutex>
 #include <QPointer>
+#include <QScopedPointer>
 #include <QSharedData>
 #include <QThreadStorage>
+#include <QTimer>
+#include <QVector>
+
+#include <memory>
+#include <vector>
 
 namespace Solid
 {
 namespace Ifaces
 {
 class Device;
+class DeviceManager;
 }
+class Device;
 class DevicePrivate;
+class DeviceTablePublisher;
+
+/**
+ * Process-wide registry of DevicePrivate objects, shared between the
+ * per-thread device managers.
+ *
+ * The per-thread managers consult it before creating a DevicePrivate of
+ * their own, so worker threads issuing queries reuse the device data (and
+ * the backend signal subscriptions of the thread which created it) instead
+ * of rebuilding the full device map per thread.
+ *
+ * The table is managed RCU-style: writers copy the current table, apply
+ * their change and atomically publish the new version; readers atomically
+ * load whichever version is current and traverse it without taking any
+ * lock. A hotplug event (a write) therefore never stalls the query
+ * threads — at worst they observe the previous table for one lookup.
+ * Writers serialize among themselves on a mutex, which is fine since
+ * writes only happen when a device is first seen or goes away.
+ */
+class SharedDeviceCache
+{
+public:
+    SharedDeviceCache();
+
+    DevicePrivate *find(const QString &udi) const;
+    void insert(const QString &udi, DevicePrivate *device);
+    void remove(const QString &udi, QObject *device);
+
+private:
+    using Table = QHash<QString, QPointer<DevicePrivate> >;
+
+    QMutex m_writeMutex;
+    std::shared_ptr<const Table> m_table;
+};
 
 class DeviceManagerPrivate : public DeviceNotifier, public ManagerBasePrivate
 {
@@ -32,18 +80,219 @@ public:
     ~DeviceManagerPrivate();
 
     DevicePrivate *findRegisteredDevice(const QString &udi);
+    QList<Device> findRegisteredDevices(const QStringList &udis);
+
+    void ensureBackendsLoaded();
+    QList<QObject *> managerBackends();
+    QList<Ifaces::DeviceManager *> deviceBackends();
+
+    quint32 supportedInterfacesMask(Ifaces::DeviceManager *backend);
+    QStringList udisFromType(DeviceInterface::Type type);
+    void reconcileSnapshotType(DeviceInterface::Type type);
+    QStringList udisFromEqualityCheck(const Predicate &predicate);
+    QString udiFromBlockDevice(int major, int minor);
+    QString udiFromUuid(const QString &uuid);
+    QStringList childUdisFromParent(const QString &parentUdi);
+
+    QStringList displayOrderedUdis();
+    QVariantMap diagnosticState();
+    quint64 lastEventSequence() const;
+    bool eventsSince(quint64 sequence, QList<DeviceNotifier::Event> *events) const;
+    void setChangeJournalEnabled(bool enabled);
+
+    bool isKnownNonMatch(const QString &predicateKey, const QString &udi) const;
+    void recordNonMatch(const QString &predicateKey, const QString &udi, const QSet<QString> &usedProperties);
+    void watchPropertyChanges(const QString &udi);
+
+protected:
+    void connectNotify(const QMetaMethod &signal) override;
 
 private Q_SLOTS:
     void _k_deviceAdded(const QString &udi);
     void _k_deviceRemoved(const QString &udi);
     void _k_destroyed(QObject *object);
+    void _k_emitBatchedAdditions();
+    void _k_emitBatchedRemovals();
 
 private:
     Ifaces::Device *createBackendObject(const QString &udi);
+    DevicePrivate *registerDevice(const QString &udi, Ifaces::Device *iface);
+    bool udiMatchesKnownPrefix(const QString &udi);
+    void buildUdiRoutes();
+    Ifaces::DeviceManager *routeUdi(const QString &udi) const;
+    void reevaluateEqualityIndex(const QString &udi);
+    void reevaluateEqualityIndex(const QString &udi, const QMap<QString, int> &changes);
+    void invalidateNegativeMatches(const QString &udi);
+    void invalidateNegativeMatches(const QString &udi, const QMap<QString, int> &changes);
+    static QSet<QString> foldedPropertyNames(const QSet<QString> &properties);
+    QStringList enumerateTypeFromBackends(DeviceInterface::Type type);
+    void startTablePublisher();
+    void indexDevice(const QString &udi);
+    void unindexDevice(const QString &udi);
+    void indexBlockDevice(const QString &udi);
+    void unindexBlockDevice(const QString &udi);
+    void indexVolumeUuid(const QString &udi);
+    void unindexVolumeUuid(const QString &udi);
+    void indexParent(const QString &udi);
+    void unindexParent(const QString &udi);
+    void indexDisplayEntry(const QString &udi);
+    void unindexDisplayEntry(const QString &udi);
+    void refreshDisplayEntry(const QString &udi);
+    void recordEvent(const QString &udi, DeviceNotifier::Event::Kind kind);
+    bool admitDeviceEvent(const QString &udi, bool added);
 
     QExplicitlySharedDataPointer<DevicePrivate> m_nullDevice;
-    QHash<QString, QPointer<DevicePrivate> > m_devicesMap;
+    // Raw pointers: every registered DevicePrivate has its destroyed()
+    // signal wired to _k_destroyed, which drops the entry, so no QPointer
+    // guard needs to be checked on this hot lookup path.
+    QHash<QString, DevicePrivate *> m_devicesMap;
     QHash<QObject *, QString> m_reverseMap;
+
+    // Per-type candidate index, built lazily on the first typed query and
+    // kept up to date from _k_deviceAdded/_k_deviceRemoved afterwards.
+    QHash<DeviceInterface::Type, QStringList> m_typeIndex;
+
+    // The previous run's type index, loaded lazily from the persisted
+    // snapshot. Entries served from it are reconciled asynchronously
+    // against the live backends; see reconcileSnapshotType().
+    QHash<DeviceInterface::Type, QStringList> m_snapshotTypeIndex;
+    bool m_snapshotLoaded = false;
+    bool m_snapshotDirty = false;
+
+    // Set when this process serves the shared device table; see
+    // devicetableipc_p.h. Serving processes never read the table back.
+    QScopedPointer<DeviceTablePublisher> m_tablePublisher;
+
+    // Reverse index from a block device's major/minor pair to its UDI,
+    // built lazily on the first fromBlockDevice() lookup and kept up to
+    // date from _k_deviceAdded/_k_deviceRemoved afterwards. The by-UDI
+    // map exists so removal doesn't have to query the vanished device.
+    QHash<quint64, QString> m_blockIndex;
+    QHash<QString, quint64> m_blockKeyByUdi;
+    bool m_blockIndexBuilt = false;
+
+    // Reverse index from a volume's filesystem UUID to its UDI, built
+    // lazily on the first fromUuid() lookup and kept up to date from
+    // _k_deviceAdded/_k_deviceRemoved afterwards. Keys are lowercase,
+    // matching what StorageVolume::uuid() reports.
+    QHash<QString, QString> m_uuidIndex;
+    QHash<QString, QString> m_uuidByUdi;
+    bool m_uuidIndexBuilt = false;
+
+    // Parent-to-children adjacency map, built lazily on the first
+    // childUdisFromParent() lookup and kept up to date from
+    // _k_deviceAdded/_k_deviceRemoved afterwards. The by-UDI map exists
+    // so removal doesn't have to query the vanished device.
+    QMultiHash<QString, QString> m_parentIndex;
+    QHash<QString, QString> m_parentByUdi;
+    bool m_parentIndexBuilt = false;
+
+    // Ring buffer of the most recent device events, so listeners which
+    // were disconnected for a while can catch up from a sequence point
+    // instead of re-enumerating; see DeviceNotifier::eventsSince().
+    // Sequence numbers are contiguous, so slot (sequence - 1) % capacity
+    // holds the event and the buffer retains the last capacity() events.
+    // Change records are only journaled on request; see
+    // setChangeJournalEnabled().
+    QVector<DeviceNotifier::Event> m_eventBuffer;
+    quint64 m_eventSequence = 0;
+    bool m_changeJournalEnabled = false;
+
+    // Additions waiting to be delivered as one devicesAdded() batch, and
+    // removals waiting for one devicesRemoved() batch.
+    QStringList m_pendingAddedUdis;
+    QTimer m_addedCoalesceTimer;
+    QStringList m_pendingRemovedUdis;
+    QTimer m_removedCoalesceTimer;
+
+    // The UDI prefixes of the loaded backends; UDIs matching none of them
+    // can be rejected without asking any backend.
+    QStringList m_udiPrefixes;
+
+    // The backends pre-cast to the Ifaces interface, resolved once at
+    // load time instead of one qobject_cast metaobject walk per loop
+    // iteration on every query. In a build compiling a single backend
+    // (SOLID_DEVICE_BACKENDS_COUNT == 1 in config-backends.h) the query
+    // loops collapse to one direct call through this cached pointer.
+    QList<Ifaces::DeviceManager *> m_deviceBackends;
+
+    // Bitmask of each backend's supported interface types ((1 << type) per
+    // type), computed once per backend; supportedInterfaces() allocates a
+    // fresh QSet per call and the support never changes after load.
+    QHash<QObject *, quint32> m_supportedMaskByBackend;
+
+    // UDI-to-backend routing, built once in ensureBackendsLoaded(). All
+    // backend prefixes share a common head ("/org/..."), so a lookup
+    // reads the one character past that head to pick its candidate
+    // routes and only then runs the full prefix comparison — one char
+    // test plus one vectorized string compare instead of a startsWith
+    // against every backend per lookup. Prefixes no longer than the
+    // common head (single-backend processes) sit in the fallback list.
+    struct BackendRoute {
+        QString prefix;
+        Ifaces::DeviceManager *backend;
+    };
+    int m_routeDiscriminant = 0;
+    QHash<ushort, QVector<BackendRoute>> m_routesByChar;
+    QVector<BackendRoute> m_routeFallback;
+
+    // Result index for equality property checks, keyed by the canonical
+    // predicate string. Entries are maintained on device addition/removal
+    // and on property changes of the indexed devices. The folded (lowered)
+    // property name lets a change notification that names its properties
+    // skip entries whose input didn't change.
+    struct EqualityIndexEntry {
+        Predicate predicate;
+        QString foldedProperty;
+        QStringList udis;
+    };
+    QHash<QString, EqualityIndexEntry> m_equalityIndex;
+    QSet<QString> m_watchedUdis;
+
+    // Per-predicate sets of UDIs known not to match, so repeated identical
+    // queries skip evaluation for them. Entries of a UDI are dropped when
+    // it is added or removed, and on property changes touching one of the
+    // properties the predicate actually reads (stored folded, since the
+    // backends report D-Bus property names whose case differs from the
+    // Qt property names predicates are written against). A verdict that
+    // reads no property at all — pure interface checks — cannot flip on
+    // a property change and survives the storm untouched.
+    struct NegativeMatchEntry {
+        QSet<QString> foldedProperties;
+        QSet<QString> udis;
+    };
+    QHash<QString, NegativeMatchEntry> m_negativeMatchCache;
+
+    // Display-order view of the device population, built lazily on the
+    // first DisplayOrder enumeration and maintained incrementally from
+    // _k_deviceAdded/_k_deviceRemoved and the property watches
+    // afterwards. The collation key of a description is computed once;
+    // the cached description tells whether a property change moved the
+    // device at all. Kept sorted, so enumeration is a plain walk and a
+    // hotplug repositions one entry instead of re-sorting.
+    struct DisplayEntry {
+        QString udi;
+        QString description;
+        QCollatorSortKey key;
+    };
+    bool displayEntryLess(const DisplayEntry &left, const DisplayEntry &right) const;
+    QCollator m_displayCollator;
+    std::vector<DisplayEntry> m_displayOrder;
+    bool m_displayOrderBuilt = false;
+
+    // Admission control for flapping hardware: per-UDI event counters over
+    // a rolling window. A UDI exceeding its budget is quarantined — its
+    // events are suppressed and summarized in one log line — with the
+    // penalty doubling on every further quarantine; see admitDeviceEvent().
+    // While quarantined, window marks the quarantine start instead.
+    struct FlapRecord {
+        QElapsedTimer window;
+        int events = 0;
+        int penaltyMs = 0;
+        int suppressed = 0;
+        bool quarantined = false;
+    };
+    QHash<QString, FlapRecord> m_flapRecords;
 };
 
 class DeviceManagerStorage
@@ -52,6 +301,7 @@ public:
     DeviceManagerStorage();
 
     QList<QObject *> managerBackends();
+    QList<Ifaces::DeviceManager *> deviceBackends();
     DeviceNotifier *notifier();
 
 private:
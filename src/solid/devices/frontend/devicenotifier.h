@@ -7,7 +7,10 @@
 #ifndef SOLID_DEVICENOTIFIER_H
 #define SOLID_DEVICENOTIFIER_H
 
+#include <QMap>
 #include <QObject>
+#include <QStringList>
+#include <QVariant>
 
 #include <solid/solid_export.h>
 
@@ -30,6 +33,116 @@ class SOLID_EXPORT DeviceNotifier : public QObject //krazy:exclude=dpointer (int
 public:
     static DeviceNotifier *instance();
 
+    /**
+     * Returns a snapshot of Solid's process-wide performance counters
+     * (devices enumerated, backend D-Bus calls, property cache hit/miss
+     * ratios, notification signals emitted, live and peak registered
+     * device count), keyed by stable lowerCamelCase names.
+     *
+     * The counters are maintained with relaxed atomic increments on the
+     * hot paths, so querying them is safe from any thread and cheap
+     * enough for periodic telemetry collection.
+     *
+     * @return the counter values at the time of the call
+     * @since 5.79
+     */
+    static QMap<QString, qulonglong> performanceCounters();
+
+    /**
+     * Returns a serializable snapshot of Solid's internal bookkeeping
+     * in this thread: the sizes of the frontend's device registry,
+     * query indexes and caches, the performance counters, and whatever
+     * each loaded backend reports about its own tables (cache sizes,
+     * subscription counts).
+     *
+     * All values are plain numbers, booleans or strings, so the
+     * snapshot can be written to disk and two snapshots taken at
+     * different times can be compared to spot growth — cache leaks,
+     * accumulating subscriptions — in the field without a debugger.
+     * The solid-hardware tool exposes this as its dump-state and
+     * diff-state commands.
+     *
+     * Keys are stable within a release but not part of the API
+     * contract; consumers should treat the snapshot as opaque
+     * key/value data.
+     *
+     * @return the diagnostic values, grouped by subsystem
+     * @since 5.79
+     */
+    static QVariantMap diagnosticState();
+
+    /**
+     * One device event recorded for catch-up; see eventsSince().
+     * @since 5.79
+     */
+    struct Event {
+        /**
+         * What happened to the device.
+         */
+        enum Kind {
+            DeviceAdded,   /**< the device appeared */
+            DeviceRemoved, /**< the device disappeared */
+            DeviceChanged, /**< properties of the device changed; see setChangeJournalEnabled() */
+        };
+
+        quint64 sequence; /**< position in this thread's event stream, starting at 1 */
+        Kind kind;        /**< what happened */
+        QString udi;      /**< the UDI of the affected device */
+    };
+
+    /**
+     * Returns the sequence number of the most recent add/remove event
+     * seen by this thread's notifier, or 0 if none happened yet.
+     *
+     * Remember it before disconnecting from the notifier and pass it to
+     * eventsSince() later to catch up without a full re-enumeration.
+     *
+     * @since 5.79
+     */
+    static quint64 lastEventSequence();
+
+    /**
+     * Retrieves the device events which happened after the event with
+     * the given sequence number, in order.
+     *
+     * The notifier only retains a bounded number of recent events. When
+     * @p sequence is older than the retained window the events between
+     * are lost, nothing is appended to @p events and false is returned;
+     * the caller has to fall back to a full re-enumeration.
+     *
+     * Together with the monotonic sequence numbers this forms a change
+     * journal: a consumer mirroring device state externally remembers
+     * the sequence it last synced to and retrieves just the records
+     * after it, at a cost proportional to the changes rather than to
+     * the device population.
+     *
+     * @param sequence the sequence number to catch up from, as returned
+     * by lastEventSequence(), or 0 for "since this thread started"
+     * @param events where the missed events get appended
+     * @return true if @p events now covers everything after @p sequence
+     * @since 5.79
+     */
+    static bool eventsSince(quint64 sequence, QList<Event> *events);
+
+    /**
+     * Controls whether property changes of registered devices get
+     * recorded in the event journal as Event::DeviceChanged records.
+     *
+     * Off by default: journaling changes means subscribing to the
+     * property notifications of every registered device, which most
+     * applications don't need. Consumers mirroring device state (and
+     * therefore needing to know which devices to re-read between two
+     * eventsSince() calls) enable it once after their initial
+     * enumeration; devices appearing later are covered automatically.
+     *
+     * Consecutive change records for the same device are collapsed, so
+     * a chatty device cannot flush the bounded journal on its own.
+     *
+     * @param enabled whether to journal property changes
+     * @since 5.79
+     */
+    static void setChangeJournalEnabled(bool enabled);
+
 Q_SIGNALS:
     /**
      * This signal is emitted when a new device appear in the underlying system.
@@ -38,12 +151,42 @@ Q_SIGNALS:
      */
     void deviceAdded(const QString &udi);
 
+    /**
+     * This signal is emitted when one or more devices appeared in the
+     * underlying system within a short time window.
+     *
+     * Additions are coalesced, so consumers rebuilding expensive state
+     * (models, indexes) on hotplug get a single notification when e.g. a
+     * multi-partition disk shows up, instead of one rebuild per UDI. Each
+     * UDI of the batch is also delivered through deviceAdded()
+     * individually, before this signal is emitted.
+     *
+     * @param udis the UDIs of the new devices
+     * @since 5.79
+     */
+    void devicesAdded(const QStringList &udis);
+
     /**
      * This signal is emitted when a device disappear from the underlying system.
      *
      * @param udi the old device UDI
      */
     void deviceRemoved(const QString &udi);
+
+    /**
+     * This signal is emitted when one or more devices disappeared from
+     * the underlying system within a short time window.
+     *
+     * Removals are coalesced like additions, so unplugging a hub or a
+     * dock produces a single notification covering every vanished device
+     * instead of one rebuild per UDI. Each UDI of the batch is also
+     * delivered through deviceRemoved() individually, before this signal
+     * is emitted.
+     *
+     * @param udis the UDIs of the vanished devices
+     * @since 5.79
+     */
+    void devicesRemoved(const QStringList &udis);
 };
 }
 
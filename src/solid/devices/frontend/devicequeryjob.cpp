@@ -0,0 +1,233 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include "devicequeryjob.h"
+#include "devicequeryjob_p.h"
+
+#include "devicemanager_p.h"
+#include "devicenotifier.h"
+
+#include "ifaces/devicemanager.h"
+
+#include <QPointer>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QTimer>
+
+using namespace Solid;
+
+DeviceQueryJobPrivate::DeviceQueryJobPrivate(const QString &query)
+    : query(query)
+{
+}
+
+namespace
+{
+class QueryEnumerator : public QRunnable
+{
+public:
+    QueryEnumerator(const QSharedPointer<DeviceQueryJobPrivate::WorkerState> &state,
+                    DeviceNotifier *notifier,
+                    const QPointer<DeviceQueryJob> &job,
+                    DeviceInterface::Type type)
+        : m_state(state)
+        , m_notifier(notifier)
+        , m_job(job)
+        , m_type(type)
+    {
+    }
+
+    void run() override
+    {
+        // Enumeration happens against this worker thread's own backends,
+        // so a stuck backend only ever blocks the pool thread. Results
+        // are appended per backend, which is what makes a partial answer
+        // available when the job's deadline fires mid-enumeration.
+        auto *manager = static_cast<DeviceManagerPrivate *>(DeviceNotifier::instance());
+        const QList<QObject *> backends = manager->managerBackends();
+
+        for (QObject *backendObj : backends) {
+            if (m_state->abandoned.load(std::memory_order_relaxed)) {
+                return;
+            }
+
+            Ifaces::DeviceManager *backend = qobject_cast<Ifaces::DeviceManager *>(backendObj);
+            if (backend == nullptr) {
+                continue;
+            }
+
+            QStringList backendUdis;
+            if (m_type != DeviceInterface::Unknown) {
+                if (!backend->supportedInterfaces().contains(m_type)) {
+                    continue;
+                }
+                backendUdis = backend->devicesFromQuery(QString(), m_type);
+            } else {
+                backendUdis = backend->allDevices();
+            }
+
+            QMutexLocker locker(&m_state->mutex);
+            if (m_state->udis.isEmpty()) {
+                m_state->udis = backendUdis; // shared handle, no per-UDI copies
+            } else {
+                m_state->udis += backendUdis;
+            }
+        }
+
+        if (m_state->abandoned.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        // Deliver on the caller's thread; the notifier outlives the job,
+        // and the QPointer is checked there where the job can no longer
+        // be concurrently deleted.
+        QStringList udis;
+        {
+            QMutexLocker locker(&m_state->mutex);
+            udis = m_state->udis;
+        }
+        const QPointer<DeviceQueryJob> job = m_job;
+        QMetaObject::invokeMethod(m_notifier, [job, udis]() {
+            if (job) {
+                QMetaObject::invokeMethod(job, "_k_workerFinished", Qt::DirectConnection,
+                                          Q_ARG(QStringList, udis));
+            }
+        }, Qt::QueuedConnection);
+    }
+
+private:
+    QSharedPointer<DeviceQueryJobPrivate::WorkerState> m_state;
+    DeviceNotifier *m_notifier;
+    QPointer<DeviceQueryJob> m_job;
+    DeviceInterface::Type m_type;
+};
+}
+
+DeviceQueryJob::DeviceQueryJob(const QString &query, QObject *parent)
+    : Job(*new DeviceQueryJobPrivate(query), parent)
+{
+}
+
+void DeviceQueryJob::setDeadline(int msecs)
+{
+    Q_D(DeviceQueryJob);
+    d->deadlineMsecs = msecs;
+}
+
+void DeviceQueryJob::setPriority(Priority priority)
+{
+    Q_D(DeviceQueryJob);
+    d->priority = priority;
+}
+
+// Single thread for all background-class queries: bulk scans queue up
+// behind each other there instead of fanning out across the global pool
+// and competing with interactive work.
+static QThreadPool *backgroundQueryPool()
+{
+    static QThreadPool pool;
+    static const bool initialized = []() {
+        pool.setMaxThreadCount(1);
+        return true;
+    }();
+    Q_UNUSED(initialized)
+    return &pool;
+}
+
+void DeviceQueryJob::doStart()
+{
+    Q_D(DeviceQueryJob);
+
+    if (!d->query.isEmpty()) {
+        d->predicate = Predicate::fromString(d->query);
+        if (!d->predicate.isValid()) {
+            setError(InvalidPredicate);
+            setErrorText(d->query);
+            emitResult();
+            return;
+        }
+    }
+
+    d->workerState = QSharedPointer<DeviceQueryJobPrivate::WorkerState>::create();
+
+    if (d->deadlineMsecs >= 0) {
+        QTimer::singleShot(d->deadlineMsecs, this, [this, d]() {
+            if (d->finished) {
+                return;
+            }
+            d->workerState->abandoned.store(true, std::memory_order_relaxed);
+            {
+                QMutexLocker locker(&d->workerState->mutex);
+                d->udis = d->workerState->udis;
+            }
+            d->finished = true;
+            d->partial = true;
+            setError(DeadlineExceeded);
+            setErrorText(tr("Device query exceeded its deadline of %1 ms").arg(d->deadlineMsecs));
+            emitResult();
+        });
+    }
+
+    const DeviceInterface::Type type = d->predicate.isValid()
+        ? d->predicate.interfaceType() : DeviceInterface::Unknown;
+    auto *enumerator = new QueryEnumerator(d->workerState, DeviceNotifier::instance(), QPointer<DeviceQueryJob>(this), type);
+
+    if (d->priority == BackgroundPriority) {
+        backgroundQueryPool()->start(enumerator);
+    } else {
+        // Jump ahead of any queued pool work a bulk consumer put there.
+        QThreadPool::globalInstance()->start(enumerator, 1);
+    }
+}
+
+void DeviceQueryJob::cancel()
+{
+    Q_D(DeviceQueryJob);
+
+    if (d->finished) {
+        return;
+    }
+    if (d->workerState) {
+        d->workerState->abandoned.store(true, std::memory_order_relaxed);
+        QMutexLocker locker(&d->workerState->mutex);
+        d->udis = d->workerState->udis;
+    }
+    d->finished = true;
+    d->partial = true;
+    setError(Cancelled);
+    emitResult();
+}
+
+void DeviceQueryJob::_k_workerFinished(const QStringList &udis)
+{
+    Q_D(DeviceQueryJob);
+
+    if (d->finished) {
+        return;
+    }
+    d->finished = true;
+    d->udis = udis;
+    emitResult();
+}
+
+QList<Device> DeviceQueryJob::devices() const
+{
+    const DeviceQueryJobPrivate *d = d_func();
+
+    QList<Device> result;
+    for (const QString &udi : d->udis) {
+        Device device(udi);
+        if (!d->predicate.isValid() || d->predicate.matches(device)) {
+            result.append(device);
+        }
+    }
+    return result;
+}
+
+bool DeviceQueryJob::isPartial() const
+{
+    return d_func()->partial;
+}
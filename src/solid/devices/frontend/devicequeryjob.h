@@ -0,0 +1,119 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#ifndef SOLID_DEVICEQUERYJOB_H
+#define SOLID_DEVICEQUERYJOB_H
+
+#include <Solid/Job>
+
+#include <solid/device.h>
+#include <solid/solid_export.h>
+
+#include <QList>
+
+namespace Solid
+{
+class DeviceQueryJobPrivate;
+
+/**
+ * Asynchronous, cancellable version of Device::listFromQuery().
+ *
+ * The backend enumeration runs on a worker thread, so a backend that
+ * stops responding (typically a hung udisksd) never blocks the calling
+ * thread. A deadline can be set before start(); when it expires the
+ * job finishes with DeadlineExceeded and devices() returns whatever
+ * the backends delivered up to that point, letting the caller render a
+ * partial device list instead of freezing. The abandoned backend call
+ * keeps running on the worker thread but its result is discarded.
+ *
+ * Like the other Solid jobs this one is fire-and-forget: connect to
+ * result(), call start(), and the job deletes itself after the result
+ * is emitted.
+ *
+ * @since 5.79
+ */
+class SOLID_EXPORT DeviceQueryJob : public Job
+{
+    Q_OBJECT
+
+public:
+    enum Error {
+        /** The query string could not be compiled into a predicate. */
+        InvalidPredicate = Job::UserDefinedError,
+        /** The deadline expired; devices() holds a partial result. */
+        DeadlineExceeded,
+        /** cancel() was called; devices() holds a partial result. */
+        Cancelled,
+    };
+    Q_ENUM(Error)
+
+    /**
+     * Creates a job matching devices against @p query, using the same
+     * predicate language as Device::listFromQuery(). An empty query
+     * matches all devices.
+     */
+    explicit DeviceQueryJob(const QString &query = QString(), QObject *parent = nullptr);
+
+    /**
+     * How the job's enumeration is scheduled against other queries.
+     */
+    enum Priority {
+        /**
+         * For queries a user is waiting on. The enumeration is queued
+         * ahead of other pending pool work. This is the default.
+         */
+        InteractivePriority,
+        /**
+         * For bulk consumers such as indexers. Background enumerations
+         * are serialized on a single dedicated thread, so any number of
+         * queued scans occupies one set of backend connections and
+         * never delays interactive queries.
+         */
+        BackgroundPriority,
+    };
+    Q_ENUM(Priority)
+
+    /**
+     * Sets the scheduling class; must be called before start().
+     */
+    void setPriority(Priority priority);
+
+    /**
+     * Finishes the job with DeadlineExceeded and a partial result when
+     * no complete result arrived within @p msecs. Must be called before
+     * start(); without a deadline the job waits indefinitely.
+     */
+    void setDeadline(int msecs);
+
+    /**
+     * The matched devices. Call once result() has been emitted; the
+     * list is partial when error() is DeadlineExceeded or Cancelled.
+     */
+    QList<Device> devices() const;
+
+    /**
+     * Whether the result was cut short by the deadline or cancel().
+     */
+    bool isPartial() const;
+
+public Q_SLOTS:
+    /**
+     * Finishes the job now with the Cancelled error and whatever
+     * devices were already collected; the in-flight backend calls are
+     * abandoned.
+     */
+    void cancel();
+
+private Q_SLOTS:
+    void doStart() override;
+    void _k_workerFinished(const QStringList &udis);
+
+private:
+    Q_DECLARE_PRIVATE(DeviceQueryJob)
+};
+} // Solid namespace
+
+#endif // SOLID_DEVICEQUERYJOB_H
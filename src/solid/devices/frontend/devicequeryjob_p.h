@@ -0,0 +1,53 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#ifndef SOLID_DEVICEQUERYJOB_P_H
+#define SOLID_DEVICEQUERYJOB_P_H
+
+#include "devicequeryjob.h"
+#include "predicate.h"
+
+#include "solid/power/job_p.h"
+
+#include <QMutex>
+#include <QSharedPointer>
+#include <QStringList>
+
+#include <atomic>
+
+namespace Solid
+{
+class DeviceQueryJobPrivate : public JobPrivate
+{
+public:
+    explicit DeviceQueryJobPrivate(const QString &query);
+
+    /**
+     * State shared with the worker thread. The worker appends each
+     * backend's UDIs under the mutex as they arrive, so the deadline
+     * path can take whatever is there; once abandoned is set the worker
+     * stops enumerating and discards its delivery.
+     */
+    struct WorkerState {
+        QMutex mutex;
+        QStringList udis;
+        std::atomic<bool> abandoned{false};
+    };
+
+    QString query;
+    Predicate predicate;
+    DeviceQueryJob::Priority priority = DeviceQueryJob::InteractivePriority;
+    int deadlineMsecs = -1;
+    bool finished = false;
+    bool partial = false;
+    QStringList udis;
+    QSharedPointer<WorkerState> workerState;
+
+    Q_DECLARE_PUBLIC(DeviceQueryJob)
+};
+}
+
+#endif // SOLID_DEVICEQUERYJOB_P_H
@@ -0,0 +1,128 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include "devicestoreformat_p.h"
+
+#include <QVector>
+
+#include <cstring>
+
+static const quint32 storeMagic = 0x534c4453; // "SLDS"
+static const quint32 storeVersion = 1;
+
+namespace
+{
+struct Header {
+    quint32 magic;
+    quint32 version;
+    quint32 recordCount;
+    quint32 stringTableOffset;
+    quint32 stringTableSize;
+};
+
+struct DeviceRecord {
+    quint32 udiOffset;
+    quint32 udiLength;
+    quint32 interfaceMask;
+    quint32 reserved; // future per-record payload; written as zero
+};
+}
+
+// The interface mask packs the DeviceInterface::Type values (1..14,
+// excluding Unknown and Last) as single bits.
+static quint32 typeBit(Solid::DeviceInterface::Type type)
+{
+    return 1u << uint(type);
+}
+
+QByteArray Solid::DeviceStoreFormat::serialize(const QHash<DeviceInterface::Type, QStringList> &typeIndex)
+{
+    // One record per device; collect the interface mask across types.
+    QHash<QString, quint32> maskByUdi;
+    for (auto it = typeIndex.constBegin(); it != typeIndex.constEnd(); ++it) {
+        const quint32 bit = typeBit(it.key());
+        for (const QString &udi : it.value()) {
+            maskByUdi[udi] |= bit;
+        }
+    }
+
+    QByteArray stringTable;
+    QVector<DeviceRecord> records;
+    records.reserve(maskByUdi.size());
+
+    for (auto it = maskByUdi.constBegin(); it != maskByUdi.constEnd(); ++it) {
+        const QByteArray utf8 = it.key().toUtf8();
+
+        DeviceRecord record;
+        record.udiOffset = quint32(stringTable.size());
+        record.udiLength = quint32(utf8.size());
+        record.interfaceMask = it.value();
+        record.reserved = 0;
+        records.append(record);
+
+        stringTable.append(utf8);
+    }
+
+    Header header;
+    header.magic = storeMagic;
+    header.version = storeVersion;
+    header.recordCount = quint32(records.size());
+    header.stringTableOffset = quint32(sizeof(Header) + records.size() * sizeof(DeviceRecord));
+    header.stringTableSize = quint32(stringTable.size());
+
+    QByteArray result;
+    result.reserve(int(header.stringTableOffset) + stringTable.size());
+    result.append(reinterpret_cast<const char *>(&header), sizeof(Header));
+    result.append(reinterpret_cast<const char *>(records.constData()),
+                  records.size() * sizeof(DeviceRecord));
+    result.append(stringTable);
+
+    return result;
+}
+
+QHash<Solid::DeviceInterface::Type, QStringList> Solid::DeviceStoreFormat::deserialize(const uchar *data, int size, bool *ok)
+{
+    *ok = false;
+    QHash<DeviceInterface::Type, QStringList> result;
+
+    if (data == nullptr || size < int(sizeof(Header))) {
+        return result;
+    }
+
+    Header header;
+    memcpy(&header, data, sizeof(Header));
+
+    if (header.magic != storeMagic || header.version != storeVersion) {
+        return result;
+    }
+    if (quint64(header.stringTableOffset) + header.stringTableSize > quint64(size)
+            || quint64(sizeof(Header)) + quint64(header.recordCount) * sizeof(DeviceRecord)
+               != header.stringTableOffset) {
+        return result;
+    }
+
+    const char *stringTable = reinterpret_cast<const char *>(data) + header.stringTableOffset;
+
+    for (quint32 i = 0; i < header.recordCount; ++i) {
+        DeviceRecord record;
+        memcpy(&record, data + sizeof(Header) + i * sizeof(DeviceRecord), sizeof(DeviceRecord));
+
+        if (quint64(record.udiOffset) + record.udiLength > header.stringTableSize) {
+            return QHash<DeviceInterface::Type, QStringList>();
+        }
+
+        const QString udi = QString::fromUtf8(stringTable + record.udiOffset, record.udiLength);
+
+        for (uint type = 1; type < 32; ++type) {
+            if (record.interfaceMask & (1u << type)) {
+                result[static_cast<DeviceInterface::Type>(type)].append(udi);
+            }
+        }
+    }
+
+    *ok = true;
+    return result;
+}
@@ -0,0 +1,60 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#ifndef SOLID_DEVICESTOREFORMAT_P_H
+#define SOLID_DEVICESTOREFORMAT_P_H
+
+#include "deviceinterface.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QStringList>
+
+namespace Solid
+{
+/**
+ * Compact binary layout for the device table, shared by the warm-start
+ * snapshot (devicecachesnapshot.cpp) and the cross-process shared
+ * memory table (devicetableipc.cpp).
+ *
+ * The layout is designed to be consumed in place from a memory mapping
+ * or a shared memory segment:
+ *
+ *   Header            { magic, version, recordCount,
+ *                       stringTableOffset, stringTableSize }
+ *   DeviceRecord[N]   fixed-width, one per device:
+ *                       UDI as (offset, length) into the string table,
+ *                       the device's interfaces as a bitmask of
+ *                       DeviceInterface::Type values, and a reserved
+ *                       slot for future per-record payload (key
+ *                       property references)
+ *   string table      deduplicated UTF-8 bytes
+ *
+ * A reader walks the record array with pointer arithmetic only; no
+ * per-field stream parsing happens, and the string table is touched
+ * just for the records actually consumed. Every device appears exactly
+ * once regardless of how many interface types it advertises, so the
+ * payload stays smaller than the per-type list serialization it
+ * replaces.
+ */
+namespace DeviceStoreFormat
+{
+/**
+ * Serializes the per-type UDI index. The inverse of deserialize().
+ */
+QByteArray serialize(const QHash<DeviceInterface::Type, QStringList> &typeIndex);
+
+/**
+ * Reconstructs the per-type UDI index from a serialized table, reading
+ * @p data in place. Returns an empty hash and sets @p ok to false on a
+ * magic or version mismatch, or when any record or string reference
+ * points outside @p size.
+ */
+QHash<DeviceInterface::Type, QStringList> deserialize(const uchar *data, int size, bool *ok);
+}
+}
+
+#endif
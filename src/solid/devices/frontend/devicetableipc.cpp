@@ -0,0 +1,125 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include "devicetableipc_p.h"
+
+#include "devices_debug.h"
+#include "devicestoreformat_p.h"
+#include "solidconfig_p.h"
+
+#include <QLoggingCategory>
+
+#include <cstring>
+
+#ifdef Q_OS_UNIX
+#include <unistd.h>
+#endif
+
+static const quint32 tableMagic = 0x534c4454; // "SLDT"
+static const quint32 tableVersion = 1;
+
+// Fixed segment capacity; generous for the UDI lists of any desktop
+// machine, and a publish that would not fit is skipped, not truncated.
+static const int tableCapacity = 256 * 1024;
+
+// Header preceding the serialized payload in the segment.
+struct TableHeader {
+    quint32 magic;
+    quint32 version;
+    quint32 sequence;
+    quint32 payloadSize;
+};
+
+static QString segmentKey()
+{
+#ifdef Q_OS_UNIX
+    const QString user = QString::number(::getuid());
+#else
+    const QString user = QString::fromLocal8Bit(qgetenv("USERNAME"));
+#endif
+    return QStringLiteral("solid-devicetable-") + user;
+}
+
+bool Solid::DeviceTableIpc::serveModeEnabled()
+{
+    return Solid::Config::snapshot()->serveDeviceTable;
+}
+
+Solid::DeviceTablePublisher::DeviceTablePublisher()
+{
+    m_segment.setKey(segmentKey());
+}
+
+bool Solid::DeviceTablePublisher::start()
+{
+    if (m_segment.create(tableCapacity)) {
+        return true;
+    }
+
+    // A previous server may have crashed and left the segment behind;
+    // attaching writable takes it over.
+    if (m_segment.error() == QSharedMemory::AlreadyExists && m_segment.attach()) {
+        return true;
+    }
+
+    qCWarning(Solid::Frontend::DeviceManager::DEVICEMANAGER)
+        << "cannot create device table segment:" << m_segment.errorString();
+    return false;
+}
+
+void Solid::DeviceTablePublisher::publish(const QHash<DeviceInterface::Type, QStringList> &typeIndex)
+{
+    if (!m_segment.isAttached()) {
+        return;
+    }
+
+    const QByteArray payload = DeviceStoreFormat::serialize(typeIndex);
+
+    if (int(sizeof(TableHeader)) + payload.size() > m_segment.size()) {
+        qCWarning(Solid::Frontend::DeviceManager::DEVICEMANAGER)
+            << "device table too large for segment, not publishing";
+        return;
+    }
+
+    m_segment.lock();
+
+    TableHeader *header = static_cast<TableHeader *>(m_segment.data());
+    header->magic = tableMagic;
+    header->version = tableVersion;
+    header->sequence = ++m_sequence;
+    header->payloadSize = quint32(payload.size());
+    memcpy(static_cast<char *>(m_segment.data()) + sizeof(TableHeader),
+           payload.constData(), payload.size());
+
+    m_segment.unlock();
+}
+
+QHash<Solid::DeviceInterface::Type, QStringList> Solid::DeviceTableIpc::fetch(bool *found)
+{
+    *found = false;
+    QHash<DeviceInterface::Type, QStringList> result;
+
+    QSharedMemory segment(segmentKey());
+    if (!segment.attach(QSharedMemory::ReadOnly)) {
+        return result;
+    }
+
+    segment.lock();
+
+    const TableHeader *header = static_cast<const TableHeader *>(segment.constData());
+    if (header->magic == tableMagic && header->version == tableVersion
+            && int(sizeof(TableHeader) + header->payloadSize) <= segment.size()) {
+        // The payload is consumed straight out of the segment; record and
+        // string table validation happens in the format module.
+        const uchar *payload = static_cast<const uchar *>(segment.constData()) + sizeof(TableHeader);
+        result = DeviceStoreFormat::deserialize(payload, int(header->payloadSize), found);
+    }
+
+    segment.unlock();
+    segment.detach();
+
+    return result;
+}
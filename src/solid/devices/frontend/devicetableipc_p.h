@@ -0,0 +1,69 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#ifndef SOLID_DEVICETABLEIPC_P_H
+#define SOLID_DEVICETABLEIPC_P_H
+
+#include "deviceinterface.h"
+
+#include <QHash>
+#include <QSharedMemory>
+#include <QStringList>
+
+namespace Solid
+{
+/**
+ * Cross-process publication of the device manager's per-type UDI table
+ * through a per-user shared memory segment.
+ *
+ * One long-lived Solid process — started with SOLID_DEVICE_TABLE_SERVE
+ * set, e.g. `SOLID_DEVICE_TABLE_SERVE=1 solid-hardware listen` — owns
+ * the segment and republishes the table with a bumped sequence number
+ * on every device addition and removal. Every other Solid process on
+ * the desktop maps the segment read-only when it builds its type index,
+ * so only the serving process pays the backend enumeration round trips.
+ *
+ * Clients keep their own backend connections for hotplug signals and
+ * property access; the segment only replaces the enumeration. When no
+ * server is running, attaching fails and clients silently fall back to
+ * enumerating the backends themselves.
+ */
+class DeviceTablePublisher
+{
+public:
+    DeviceTablePublisher();
+
+    /**
+     * Creates or takes over the per-user segment. Returns false when
+     * shared memory is unavailable; publishing is then disabled.
+     */
+    bool start();
+
+    /**
+     * Writes the given table into the segment under the segment lock,
+     * with the sequence number bumped so readers can detect changes.
+     * Tables exceeding the segment capacity are skipped with a warning.
+     */
+    void publish(const QHash<DeviceInterface::Type, QStringList> &typeIndex);
+
+private:
+    QSharedMemory m_segment;
+    quint32 m_sequence = 0;
+};
+
+namespace DeviceTableIpc
+{
+bool serveModeEnabled();
+
+/**
+ * Attaches to the per-user segment read-only and returns the published
+ * table. @p found is set to false when no valid table is being served.
+ */
+QHash<DeviceInterface::Type, QStringList> fetch(bool *found);
+}
+}
+
+#endif
@@ -18,6 +18,13 @@ Solid::GenericInterface::GenericInterface(QObject *backendObject)
                 this, SIGNAL(propertyChanged(QMap<QString,int>)));
         connect(backendObject, SIGNAL(conditionRaised(QString,QString)),
                 this, SIGNAL(conditionRaised(QString,QString)));
+
+        // not all backends can provide values with their change
+        // notifications; only relay the richer signal where it exists
+        if (backendObject->metaObject()->indexOfSignal("propertyValuesChanged(QVariantMap)") != -1) {
+            connect(backendObject, SIGNAL(propertyValuesChanged(QVariantMap)),
+                    this, SIGNAL(propertyValuesChanged(QVariantMap)));
+        }
     }
 }
 
@@ -29,18 +36,36 @@ Solid::GenericInterface::~GenericInterface()
 QVariant Solid::GenericInterface::property(const QString &key) const
 {
     Q_D(const GenericInterface);
-    return_SOLID_CALL(Ifaces::GenericInterface *, d->backendObject(), QVariant(), property(key));
+    return_SOLID_IFACE_CALL(Ifaces::GenericInterface, d, QVariant(), property(key));
 }
 
 QMap<QString, QVariant> Solid::GenericInterface::allProperties() const
 {
     Q_D(const GenericInterface);
-    return_SOLID_CALL(Ifaces::GenericInterface *, d->backendObject(), QVariantMap(), allProperties());
+    return_SOLID_IFACE_CALL(Ifaces::GenericInterface, d, QVariantMap(), allProperties());
 }
 
 bool Solid::GenericInterface::propertyExists(const QString &key) const
 {
     Q_D(const GenericInterface);
-    return_SOLID_CALL(Ifaces::GenericInterface *, d->backendObject(), false, propertyExists(key));
+    return_SOLID_IFACE_CALL(Ifaces::GenericInterface, d, false, propertyExists(key));
+}
+
+int Solid::GenericInterface::propertyInt(const QString &key, int defaultValue) const
+{
+    Q_D(const GenericInterface);
+    return_SOLID_IFACE_CALL(Ifaces::GenericInterface, d, defaultValue, propertyInt(key, defaultValue));
+}
+
+bool Solid::GenericInterface::propertyBool(const QString &key, bool defaultValue) const
+{
+    Q_D(const GenericInterface);
+    return_SOLID_IFACE_CALL(Ifaces::GenericInterface, d, defaultValue, propertyBool(key, defaultValue));
+}
+
+QString Solid::GenericInterface::propertyString(const QString &key) const
+{
+    Q_D(const GenericInterface);
+    return_SOLID_IFACE_CALL(Ifaces::GenericInterface, d, QString(), propertyString(key));
 }
 
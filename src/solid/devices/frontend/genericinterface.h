@@ -32,6 +32,7 @@ class SOLID_EXPORT GenericInterface : public DeviceInterface
     Q_OBJECT
     Q_DECLARE_PRIVATE(GenericInterface)
     friend class Device;
+    friend class PropertyWatcher;
 
 public:
     /**
@@ -113,6 +114,45 @@ public:
      */
     bool propertyExists(const QString &key) const;
 
+    /**
+     * Retrieves an integral property of the device without boxing the
+     * value in a returned QVariant. Useful for callers polling numeric
+     * properties at a high rate.
+     *
+     * The same portability warning as for property() applies.
+     *
+     * @param key the property key
+     * @param defaultValue the value returned if the property is unknown
+     * or not convertible to an integer
+     * @since 5.79
+     */
+    int propertyInt(const QString &key, int defaultValue = 0) const;
+
+    /**
+     * Retrieves a boolean property of the device without boxing the
+     * value in a returned QVariant.
+     *
+     * The same portability warning as for property() applies.
+     *
+     * @param key the property key
+     * @param defaultValue the value returned if the property is unknown
+     * @since 5.79
+     */
+    bool propertyBool(const QString &key, bool defaultValue = false) const;
+
+    /**
+     * Retrieves a string property of the device without boxing the
+     * value in a returned QVariant.
+     *
+     * The same portability warning as for property() applies.
+     *
+     * @param key the property key
+     * @return the property value, or an empty string if the property
+     * is unknown
+     * @since 5.79
+     */
+    QString propertyString(const QString &key) const;
+
 Q_SIGNALS:
     /**
      * This signal is emitted when a property is changed in the device.
@@ -121,9 +161,32 @@ Q_SIGNALS:
      * occurred in the device, keys are property name and values
      * describe the kind of change done on the device property
      * (added/removed/modified), it's one of the type Solid::Device::PropertyChange
+     *
+     * @note The map is implicitly shared: all receivers, including those
+     * reached through queued connections from other threads, reference
+     * the one payload the backend built. Take the parameter by const
+     * reference (and don't call detaching members on it) to keep the
+     * delivery copy-free.
      */
     void propertyChanged(const QMap<QString, int> &changes);
 
+    /**
+     * This signal is emitted when properties change and the backend
+     * already knows their new values, so listeners can update exactly
+     * the fields that changed instead of re-reading them.
+     *
+     * Not every backend can provide the values with its change
+     * notifications; where it can't, only propertyChanged() is emitted.
+     * When both are emitted, propertyChanged() describes the same set
+     * of keys.
+     *
+     * @param changedValues map from property name to its new value;
+     * properties whose new value isn't known (invalidated or removed)
+     * are reported with an invalid QVariant
+     * @since 5.79
+     */
+    void propertyValuesChanged(const QVariantMap &changedValues);
+
     /**
      * This signal is emitted when an event occurred in the device.
      * For example when a button is pressed.
@@ -7,6 +7,7 @@
 #include "networkshare.h"
 #include "networkshare_p.h"
 
+#include "device.h"
 #include "soliddefs_p.h"
 #include <solid/devices/ifaces/networkshare.h>
 
@@ -23,12 +24,28 @@ Solid::NetworkShare::~NetworkShare()
 Solid::NetworkShare::ShareType Solid::NetworkShare::type() const
 {
     Q_D(const NetworkShare);
-    return_SOLID_CALL(Ifaces::NetworkShare *, d->backendObject(), Solid::NetworkShare::Unknown, type());
+    return_SOLID_IFACE_CALL(Ifaces::NetworkShare, d, Solid::NetworkShare::Unknown, type());
 }
 
 QUrl Solid::NetworkShare::url() const
 {
     Q_D(const NetworkShare);
-    return_SOLID_CALL(Ifaces::NetworkShare *, d->backendObject(), QUrl(), url());
+    return_SOLID_IFACE_CALL(Ifaces::NetworkShare, d, QUrl(), url());
+}
+
+QList<Solid::NetworkShare::Share> Solid::NetworkShare::allShares()
+{
+    QList<Share> shares;
+
+    const QList<Device> devices = Device::listFromType(DeviceInterface::NetworkShare);
+    shares.reserve(devices.size());
+    for (const Device &device : devices) {
+        const NetworkShare *share = device.as<NetworkShare>();
+        if (share && share->type() != Unknown) {
+            shares.append({device.udi(), share->type(), share->url()});
+        }
+    }
+
+    return shares;
 }
 
@@ -86,6 +86,28 @@ public:
      */
     QUrl url() const;
 
+    /**
+     * One entry of allShares().
+     * @since 5.79
+     */
+    struct Share {
+        QString udi;    /**< UDI of the device exporting the share */
+        ShareType type; /**< protocol of the share */
+        QUrl url;       /**< URL of the share */
+    };
+
+    /**
+     * Lists every network share known to the system in one call.
+     *
+     * Cheaper than querying the devices one by one when only the share
+     * type and URL are needed, e.g. to populate a network places view.
+     *
+     * @return the shares of all devices with a NetworkShare interface,
+     * skipping those of unknown type
+     * @since 5.79
+     */
+    static QList<Share> allShares();
+
 };
 }
 
@@ -29,30 +29,30 @@ Solid::OpticalDrive::~OpticalDrive()
 Solid::OpticalDrive::MediumTypes Solid::OpticalDrive::supportedMedia() const
 {
     Q_D(const OpticalDrive);
-    return_SOLID_CALL(Ifaces::OpticalDrive *, d->backendObject(), MediumTypes(), supportedMedia());
+    return_SOLID_IFACE_CALL(Ifaces::OpticalDrive, d, MediumTypes(), supportedMedia());
 }
 
 int Solid::OpticalDrive::readSpeed() const
 {
     Q_D(const OpticalDrive);
-    return_SOLID_CALL(Ifaces::OpticalDrive *, d->backendObject(), 0, readSpeed());
+    return_SOLID_IFACE_CALL(Ifaces::OpticalDrive, d, 0, readSpeed());
 }
 
 int Solid::OpticalDrive::writeSpeed() const
 {
     Q_D(const OpticalDrive);
-    return_SOLID_CALL(Ifaces::OpticalDrive *, d->backendObject(), 0, writeSpeed());
+    return_SOLID_IFACE_CALL(Ifaces::OpticalDrive, d, 0, writeSpeed());
 }
 
 QList<int> Solid::OpticalDrive::writeSpeeds() const
 {
     Q_D(const OpticalDrive);
-    return_SOLID_CALL(Ifaces::OpticalDrive *, d->backendObject(), QList<int>(), writeSpeeds());
+    return_SOLID_IFACE_CALL(Ifaces::OpticalDrive, d, QList<int>(), writeSpeeds());
 }
 
 bool Solid::OpticalDrive::eject()
 {
     Q_D(OpticalDrive);
-    return_SOLID_CALL(Ifaces::OpticalDrive *, d->backendObject(), false, eject());
+    return_SOLID_IFACE_CALL(Ifaces::OpticalDrive, d, false, eject());
 }
 
@@ -25,18 +25,43 @@ Solid::PortableMediaPlayer::~PortableMediaPlayer()
 QStringList Solid::PortableMediaPlayer::supportedProtocols() const
 {
     Q_D(const PortableMediaPlayer);
-    return_SOLID_CALL(Ifaces::PortableMediaPlayer *, d->backendObject(), QStringList(), supportedProtocols());
+
+    if (d->supportedProtocolsCached) {
+        return d->supportedProtocols;
+    }
+
+    Ifaces::PortableMediaPlayer *iface = d->backendIface<Ifaces::PortableMediaPlayer>();
+    if (iface == nullptr) {
+        return QStringList();
+    }
+
+    d->supportedProtocols = iface->supportedProtocols();
+    d->supportedProtocolsCached = true;
+    return d->supportedProtocols;
 }
 
 QStringList Solid::PortableMediaPlayer::supportedDrivers(QString protocol) const
 {
     Q_D(const PortableMediaPlayer);
-    return_SOLID_CALL(Ifaces::PortableMediaPlayer *, d->backendObject(), QStringList(), supportedDrivers(protocol));
+
+    auto it = d->supportedDrivers.constFind(protocol);
+    if (it != d->supportedDrivers.constEnd()) {
+        return it.value();
+    }
+
+    Ifaces::PortableMediaPlayer *iface = d->backendIface<Ifaces::PortableMediaPlayer>();
+    if (iface == nullptr) {
+        return QStringList();
+    }
+
+    const QStringList drivers = iface->supportedDrivers(protocol);
+    d->supportedDrivers.insert(protocol, drivers);
+    return drivers;
 }
 
 QVariant Solid::PortableMediaPlayer::driverHandle(const QString &driver) const
 {
     Q_D(const PortableMediaPlayer);
-    return_SOLID_CALL(Ifaces::PortableMediaPlayer *, d->backendObject(), QVariant(), driverHandle(driver));
+    return_SOLID_IFACE_CALL(Ifaces::PortableMediaPlayer, d, QVariant(), driverHandle(driver));
 }
 
@@ -10,6 +10,9 @@
 
 #include "deviceinterface_p.h"
 
+#include <QHash>
+#include <QStringList>
+
 namespace Solid
 {
 class PortableMediaPlayerPrivate : public DeviceInterfacePrivate
@@ -17,6 +20,13 @@ class PortableMediaPlayerPrivate : public DeviceInterfacePrivate
 public:
     PortableMediaPlayerPrivate()
         : DeviceInterfacePrivate() { }
+
+    // The protocol and driver lists are immutable for a given device, so
+    // they are built once and handed out as shared QStringList data
+    // afterwards.
+    mutable QStringList supportedProtocols;
+    mutable bool supportedProtocolsCached = false;
+    mutable QHash<QString, QStringList> supportedDrivers;
 };
 }
 
@@ -5,10 +5,81 @@
 */
 
 #include "predicate.h"
+#include "solidtrace_p.h"
 
 #include <solid/device.h>
-#include <QStringList>
+#include <QtAlgorithms>
+#include <QElapsedTimer>
 #include <QMetaEnum>
+#include <QMutex>
+#include <QStringList>
+#include <QVarLengthArray>
+#include <QVector>
+
+namespace
+{
+// Fixed-size block arena for predicate AST nodes. Parsing and the
+// composition operators churn through many short-lived nodes of identical
+// size, so they are served from a chunked free list instead of paying a
+// general-purpose heap round trip per node. Freed blocks are recycled;
+// the chunks themselves live until program exit.
+class PredicateNodeArena
+{
+public:
+    ~PredicateNodeArena()
+    {
+        for (char *chunk : qAsConst(m_chunks)) {
+            ::operator delete(chunk);
+        }
+    }
+
+    void *allocate(size_t size)
+    {
+        QMutexLocker locker(&m_mutex);
+
+        if (m_freeList) {
+            FreeBlock *block = m_freeList;
+            m_freeList = block->next;
+            return block;
+        }
+
+        if (m_blockSize == 0) {
+            m_blockSize = qMax(size, sizeof(FreeBlock));
+        }
+
+        if (m_chunks.isEmpty() || m_chunkUsed == BlocksPerChunk) {
+            m_chunks.append(static_cast<char *>(::operator new(BlocksPerChunk * m_blockSize)));
+            m_chunkUsed = 0;
+        }
+
+        return m_chunks.last() + (m_chunkUsed++) * m_blockSize;
+    }
+
+    void deallocate(void *ptr)
+    {
+        QMutexLocker locker(&m_mutex);
+
+        FreeBlock *block = static_cast<FreeBlock *>(ptr);
+        block->next = m_freeList;
+        m_freeList = block;
+    }
+
+private:
+    struct FreeBlock {
+        FreeBlock *next;
+    };
+
+    static const int BlocksPerChunk = 64;
+
+    QMutex m_mutex;
+    QVector<char *> m_chunks;
+    size_t m_blockSize = 0;
+    int m_chunkUsed = 0;
+    FreeBlock *m_freeList = nullptr;
+};
+}
+
+Q_GLOBAL_STATIC(PredicateNodeArena, s_predicateNodeArena)
 
 namespace Solid
 {
@@ -20,6 +91,23 @@ public:
         compOperator(Predicate::Equals),
         operand1(nullptr), operand2(nullptr) {}
 
+    static void *operator new(size_t size)
+    {
+        if (s_predicateNodeArena.isDestroyed()) {
+            return ::operator new(size);
+        }
+        return s_predicateNodeArena->allocate(size);
+    }
+
+    static void operator delete(void *ptr)
+    {
+        // After static destruction the blocks are gone anyway; leaking the
+        // few exit-time nodes is preferable to touching a dead arena.
+        if (ptr && !s_predicateNodeArena.isDestroyed()) {
+            s_predicateNodeArena->deallocate(ptr);
+        }
+    }
+
     bool isValid;
     Type type;
 
@@ -30,7 +118,66 @@ public:
 
     Predicate *operand1;
     Predicate *operand2;
+
+    // Compiled state of a property check, resolved on the first match and
+    // reused as long as the interface meta-object stays the same. The
+    // property index lookup and the enum key conversion of the expected
+    // value are invariant across all devices of one interface class, so
+    // they are paid once per predicate instead of once per evaluation.
+    const QMetaObject *cachedMetaObject = nullptr;
+    int cachedPropertyIndex = -1;
+    QVariant cachedExpected;
+
+    // Composite predicates are flattened into a linear program with
+    // short-circuit jumps, so evaluation runs without recursion and each
+    // atom can consult the per-evaluation interface presence cache.
+    struct Instruction {
+        enum Op { EvalAtom, JumpIfFalse, JumpIfTrue };
+        Op op;
+        int target;
+        const Predicate *atom;
+    };
+    QVector<Instruction> program;
+    bool programCompiled = false;
+
+    static void compileNode(const Predicate *node, QVector<Instruction> &program);
+    static bool explainNode(const Predicate *node, const Device &device, int depth, QString &text);
+
+    void invalidateCompiledState()
+    {
+        cachedMetaObject = nullptr;
+        cachedPropertyIndex = -1;
+        cachedExpected = QVariant();
+        program.clear();
+        programCompiled = false;
+    }
 };
+
+void Predicate::Private::compileNode(const Predicate *node, QVector<Instruction> &program)
+{
+    switch (node->d->type) {
+    case Conjunction: {
+        compileNode(node->d->operand1, program);
+        const int jumpIndex = program.size();
+        program.append({Instruction::JumpIfFalse, 0, nullptr});
+        compileNode(node->d->operand2, program);
+        program[jumpIndex].target = program.size();
+        break;
+    }
+    case Disjunction: {
+        compileNode(node->d->operand1, program);
+        const int jumpIndex = program.size();
+        program.append({Instruction::JumpIfTrue, 0, nullptr});
+        compileNode(node->d->operand2, program);
+        program[jumpIndex].target = program.size();
+        break;
+    }
+    case PropertyCheck:
+    case InterfaceCheck:
+        program.append({Instruction::EvalAtom, 0, node});
+        break;
+    }
+}
 }
 
 Solid::Predicate::Predicate()
@@ -121,6 +268,8 @@ Solid::Predicate &Solid::Predicate::operator=(const Predicate &other)
         d->compOperator = other.d->compOperator;
     }
 
+    d->invalidateCompiledState();
+
     return *this;
 }
 
@@ -171,32 +320,95 @@ bool Solid::Predicate::matches(const Device &device) const
         return false;
     }
 
+    SOLID_PROBE2(predicate_match, qPrintable(device.udi()), int(d->type));
+
     switch (d->type) {
     case Disjunction:
-        return d->operand1->matches(device)
-               || d->operand2->matches(device);
-    case Conjunction:
-        return d->operand1->matches(device)
-               && d->operand2->matches(device);
+    case Conjunction: {
+        if (!d->programCompiled) {
+            d->program.clear();
+            Private::compileNode(this, d->program);
+            d->programCompiled = true;
+        }
+
+        // Tri-state cache of interface presence, so one evaluation asks
+        // the backend at most once per device interface type even when
+        // several atoms check the same type.
+        QVarLengthArray<qint8, DeviceInterface::NetworkShare + 1> typeState(DeviceInterface::NetworkShare + 1);
+        typeState.fill(-1);
+
+        bool result = false;
+        const int size = d->program.size();
+        for (int ip = 0; ip < size;) {
+            const Private::Instruction &instr = d->program.at(ip);
+            switch (instr.op) {
+            case Private::Instruction::EvalAtom: {
+                const Predicate *atom = instr.atom;
+                if (!atom->d->isValid) {
+                    result = false;
+                    ++ip;
+                    break;
+                }
+
+                const int type = atom->d->ifaceType;
+                bool hasInterface;
+                if (type >= 0 && type < typeState.size()) {
+                    if (typeState[type] < 0) {
+                        typeState[type] = device.isDeviceInterface(atom->d->ifaceType) ? 1 : 0;
+                    }
+                    hasInterface = (typeState[type] != 0);
+                } else {
+                    hasInterface = device.isDeviceInterface(atom->d->ifaceType);
+                }
+
+                if (!hasInterface) {
+                    result = false;
+                } else if (atom->d->type == InterfaceCheck) {
+                    result = true;
+                } else {
+                    result = atom->matches(device);
+                }
+                ++ip;
+                break;
+            }
+            case Private::Instruction::JumpIfFalse:
+                ip = result ? ip + 1 : instr.target;
+                break;
+            case Private::Instruction::JumpIfTrue:
+                ip = result ? instr.target : ip + 1;
+                break;
+            }
+        }
+
+        return result;
+    }
     case PropertyCheck: {
         const DeviceInterface *iface = device.asDeviceInterface(d->ifaceType);
 
         if (iface != nullptr) {
-            const int index = iface->metaObject()->indexOfProperty(d->property.toLatin1());
-            QMetaProperty metaProp = iface->metaObject()->property(index);
-            QVariant value = metaProp.isReadable() ? metaProp.read(iface) : QVariant();
-            QVariant expected = d->value;
-
-            if (metaProp.isEnumType() && expected.type() == QVariant::String) {
-                QMetaEnum metaEnum = metaProp.enumerator();
-                int value = metaEnum.keysToValue(d->value.toString().toLatin1());
-                if (value >= 0) { // No value found for these keys, resetting expected to invalid
-                    expected = value;
-                } else {
-                    expected = QVariant();
+            if (iface->metaObject() != d->cachedMetaObject) {
+                d->cachedMetaObject = iface->metaObject();
+                d->cachedPropertyIndex = d->cachedMetaObject->indexOfProperty(d->property.toLatin1());
+                QMetaProperty metaProp = d->cachedMetaObject->property(d->cachedPropertyIndex);
+                QVariant expected = d->value;
+
+                if (metaProp.isEnumType() && expected.type() == QVariant::String) {
+                    QMetaEnum metaEnum = metaProp.enumerator();
+                    int value = metaEnum.keysToValue(d->value.toString().toLatin1());
+                    if (value >= 0) { // No value found for these keys, resetting expected to invalid
+                        expected = value;
+                    } else {
+                        expected = QVariant();
+                    }
                 }
+
+                d->cachedExpected = expected;
             }
 
+            QMetaProperty metaProp = d->cachedMetaObject->property(d->cachedPropertyIndex);
+            QVariant value = metaProp.isReadable() ? metaProp.read(iface) : QVariant();
+            const QVariant &expected = d->cachedExpected;
+
             if (d->compOperator == Mask) {
                 bool v_ok;
                 int v = value.toInt(&v_ok);
@@ -217,21 +429,119 @@ bool Solid::Predicate::matches(const Device &device) const
     return false;
 }
 
+bool Solid::Predicate::Private::explainNode(const Predicate *node, const Device &device, int depth, QString &text)
+{
+    const QString indent(depth * 2, QLatin1Char(' '));
+
+    if (!node->d->isValid) {
+        text += indent + QLatin1String("<invalid> => false\n");
+        return false;
+    }
+
+    switch (node->d->type) {
+    case Conjunction:
+    case Disjunction: {
+        const bool isConjunction = (node->d->type == Conjunction);
+
+        QElapsedTimer timer;
+        timer.start();
+
+        QString operandText;
+        const bool first = explainNode(node->d->operand1, device, depth + 1, operandText);
+        const bool shortCircuit = (isConjunction ? !first : first);
+
+        bool result = first;
+        if (shortCircuit) {
+            operandText += QString((depth + 1) * 2, QLatin1Char(' '))
+                           + QLatin1String("<skipped, short-circuit>\n");
+        } else {
+            result = explainNode(node->d->operand2, device, depth + 1, operandText);
+        }
+
+        text += indent + QLatin1String(isConjunction ? "AND" : "OR")
+                + QLatin1String(" => ") + QLatin1String(result ? "true" : "false")
+                + QLatin1String(" (") + QString::number(timer.nsecsElapsed() / 1000) + QLatin1String(" µs)\n")
+                + operandText;
+        return result;
+    }
+    case PropertyCheck:
+    case InterfaceCheck: {
+        QElapsedTimer timer;
+        timer.start();
+        const bool result = node->matches(device);
+        text += indent + node->toString()
+                + QLatin1String(" => ") + QLatin1String(result ? "true" : "false")
+                + QLatin1String(" (") + QString::number(timer.nsecsElapsed() / 1000) + QLatin1String(" µs)\n");
+        return result;
+    }
+    }
+
+    return false;
+}
+
+QString Solid::Predicate::explainMatch(const Device &device) const
+{
+    QString text;
+    Private::explainNode(this, device, 0, text);
+    return text;
+}
+
+QStringList Solid::Predicate::matchingUdis(const QStringList &udis) const
+{
+    QStringList result;
+
+    if (!d->isValid) {
+        return result;
+    }
+
+    const QList<Device> devices = Device::listFromUdis(udis);
+    for (const Device &device : devices) {
+        if (matches(device)) {
+            result.append(device.udi());
+        }
+    }
+
+    return result;
+}
+
+static quint32 typeBit(Solid::DeviceInterface::Type type)
+{
+    // Every real interface type fits in 32 bits; the Last sentinel (or a
+    // garbage value) contributes nothing rather than shifting out of range.
+    if (type < 0 || type >= 32) {
+        return 0;
+    }
+    return quint32(1) << type;
+}
+
+static QSet<Solid::DeviceInterface::Type> typeSetFromMask(quint32 mask)
+{
+    QSet<Solid::DeviceInterface::Type> res;
+    for (quint32 bits = mask; bits != 0; bits &= bits - 1) {
+        res << static_cast<Solid::DeviceInterface::Type>(qCountTrailingZeroBits(bits));
+    }
+    return res;
+}
+
 QSet<Solid::DeviceInterface::Type> Solid::Predicate::usedTypes() const
 {
-    QSet<DeviceInterface::Type> res;
+    return typeSetFromMask(usedTypesMask());
+}
+
+quint32 Solid::Predicate::usedTypesMask() const
+{
+    quint32 res = 0;
 
     if (d->isValid) {
 
         switch (d->type) {
         case Disjunction:
         case Conjunction:
-            res += d->operand1->usedTypes();
-            res += d->operand2->usedTypes();
+            res = d->operand1->usedTypesMask() | d->operand2->usedTypesMask();
             break;
         case PropertyCheck:
         case InterfaceCheck:
-            res << d->ifaceType;
+            res = typeBit(d->ifaceType);
             break;
         }
 
@@ -240,6 +550,142 @@ QSet<Solid::DeviceInterface::Type> Solid::Predicate::usedTypes() const
     return res;
 }
 
+QSet<Solid::DeviceInterface::Type> Solid::Predicate::candidateTypes() const
+{
+    return typeSetFromMask(candidateTypesMask());
+}
+
+quint32 Solid::Predicate::candidateTypesMask() const
+{
+    quint32 res = 0;
+
+    if (d->isValid) {
+
+        switch (d->type) {
+        case Disjunction:
+            res = d->operand1->candidateTypesMask() | d->operand2->candidateTypesMask();
+            break;
+        case Conjunction: {
+            // Matching devices advertise the types of both operands, so
+            // the candidates of the smaller side already cover them all.
+            const quint32 first = d->operand1->candidateTypesMask();
+            const quint32 second = d->operand2->candidateTypesMask();
+            res = (qPopulationCount(second) < qPopulationCount(first)) ? second : first;
+            break;
+        }
+        case PropertyCheck:
+        case InterfaceCheck:
+            res = typeBit(d->ifaceType);
+            break;
+        }
+
+    }
+
+    return res;
+}
+
+QSet<QString> Solid::Predicate::usedProperties() const
+{
+    QSet<QString> res;
+
+    if (d->isValid) {
+
+        switch (d->type) {
+        case Disjunction:
+        case Conjunction:
+            res = d->operand1->usedProperties() + d->operand2->usedProperties();
+            break;
+        case PropertyCheck:
+            res << d->property;
+            break;
+        case InterfaceCheck:
+            break;
+        }
+
+    }
+
+    return res;
+}
+
+namespace
+{
+// Collects the operands of an unbroken chain of one operator, undoing
+// the pairwise tree the composition operators build.
+void flattenOperands(const Solid::Predicate &node, Solid::Predicate::Type op, QList<Solid::Predicate> *operands)
+{
+    if (node.type() == op) {
+        flattenOperands(node.firstOperand(), op, operands);
+        flattenOperands(node.secondOperand(), op, operands);
+    } else {
+        operands->append(node);
+    }
+}
+}
+
+Solid::Predicate Solid::Predicate::normalized() const
+{
+    if (!d->isValid) {
+        return Predicate();
+    }
+    if (d->type == PropertyCheck || d->type == InterfaceCheck) {
+        return *this;
+    }
+
+    const Type op = d->type;
+    QList<Predicate> operands;
+    flattenOperands(*this, op, &operands);
+
+    // Deduplicate on the canonical string form; toString() is injective
+    // enough for terms which evaluate identically.
+    QList<Predicate> kept;
+    QSet<QString> seen;
+    quint32 propertyCheckTypes = 0;
+    bool anyUnmatchable = false;
+    for (const Predicate &rawOperand : qAsConst(operands)) {
+        const Predicate operand = rawOperand.normalized();
+        if (!operand.isValid()) {
+            anyUnmatchable = true;
+            continue;
+        }
+
+        const QString key = operand.toString();
+        if (seen.contains(key)) {
+            continue;
+        }
+        seen.insert(key);
+
+        if (op == Conjunction && operand.type() == PropertyCheck) {
+            propertyCheckTypes |= typeBit(operand.interfaceType());
+        }
+        kept.append(operand);
+    }
+
+    if (op == Conjunction) {
+        // One conjunct which can never match makes the whole conjunction
+        // unmatchable.
+        if (anyUnmatchable) {
+            return Predicate();
+        }
+
+        // A property check only matches devices having the interface, so
+        // it implies the corresponding interface check.
+        if (propertyCheckTypes != 0) {
+            for (int i = kept.size() - 1; i >= 0; --i) {
+                if (kept.at(i).type() == InterfaceCheck
+                        && (propertyCheckTypes & typeBit(kept.at(i).interfaceType()))) {
+                    kept.removeAt(i);
+                }
+            }
+        }
+
+        return allOf(kept);
+    }
+
+    // Unmatchable disjuncts contribute nothing; if none is left the
+    // disjunction itself can never match.
+    return anyOf(kept);
+}
+
 QString Solid::Predicate::toString() const
 {
     if (!d->isValid) {
@@ -309,6 +755,51 @@ QString Solid::Predicate::toString() const
     }
 }
 
+Solid::Predicate Solid::Predicate::fromTypes(const QList<DeviceInterface::Type> &types)
+{
+    Predicate result;
+
+    for (DeviceInterface::Type type : types) {
+        if (result.isValid()) {
+            result |= Predicate(type);
+        } else {
+            result = Predicate(type);
+        }
+    }
+
+    return result;
+}
+
+Solid::Predicate Solid::Predicate::allOf(const QList<Predicate> &predicates)
+{
+    Predicate result;
+
+    for (const Predicate &predicate : predicates) {
+        if (result.isValid()) {
+            result &= predicate;
+        } else {
+            result = predicate;
+        }
+    }
+
+    return result;
+}
+
+Solid::Predicate Solid::Predicate::anyOf(const QList<Predicate> &predicates)
+{
+    Predicate result;
+
+    for (const Predicate &predicate : predicates) {
+        if (result.isValid()) {
+            result |= predicate;
+        } else {
+            result = predicate;
+        }
+    }
+
+    return result;
+}
+
 Solid::Predicate::Type Solid::Predicate::type() const
 {
     return d->type;
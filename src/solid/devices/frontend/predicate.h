@@ -163,6 +163,39 @@ public:
      */
     bool matches(const Device &device) const;
 
+    /**
+     * Evaluates the predicate against a device like matches(), but
+     * returns a human-readable trace of the evaluation instead of the
+     * verdict.
+     *
+     * The trace contains one line per predicate node with its result and
+     * the time spent evaluating it, including operands skipped due to
+     * short-circuiting. This is meant for profiling slow queries and for
+     * understanding why a device does or does not match; it is not meant
+     * to be parsed.
+     *
+     * @param device the device to match against the predicate
+     * @return a multi-line evaluation trace
+     * @since 5.79
+     */
+    QString explainMatch(const Device &device) const;
+
+    /**
+     * Evaluates the predicate against a whole batch of devices given by
+     * UDI.
+     *
+     * The devices are constructed through the bulk path of
+     * Device::listFromUdis() and all evaluations share this predicate's
+     * compiled state, which makes this noticeably cheaper than one
+     * matches() call per hand-constructed Device when filtering large
+     * UDI lists.
+     *
+     * @param udis the UDIs of the devices to check
+     * @return the subset of @p udis whose devices match the predicate
+     * @since 5.79
+     */
+    QStringList matchingUdis(const QStringList &udis) const;
+
     /**
      * Retrieves the device interface types used in this predicate.
      *
@@ -170,6 +203,76 @@ public:
      */
     QSet<DeviceInterface::Type> usedTypes() const;
 
+    /**
+     * The bitmask form of usedTypes(): bit (1 << type) is set for every
+     * device interface type used in this predicate. All interface types
+     * fit in 32 bits, so set operations on masks are single instructions
+     * and nothing is heap-allocated.
+     *
+     * @return the used device interface types as a bitmask
+     * @since 5.79
+     */
+    quint32 usedTypesMask() const;
+
+    /**
+     * Retrieves a reduced set of device interface types which together
+     * still cover every device this predicate can match.
+     *
+     * Contrary to usedTypes(), which reports every type mentioned in the
+     * predicate, a conjunction contributes only one of its operands here:
+     * a device matching both operands has to advertise the types of
+     * either one, so enumerating the candidates of the smaller side is
+     * enough. This is what Device::listFromQuery() uses to prune backend
+     * enumeration.
+     *
+     * @return a covering set of device interface types
+     * @since 5.79
+     */
+    QSet<DeviceInterface::Type> candidateTypes() const;
+
+    /**
+     * The bitmask form of candidateTypes(); see usedTypesMask() for the
+     * bit layout. This is what Device::listFromQuery() works with
+     * internally.
+     *
+     * @return a covering set of device interface types as a bitmask
+     * @since 5.79
+     */
+    quint32 candidateTypesMask() const;
+
+    /**
+     * Retrieves the property names this predicate's verdict depends on.
+     *
+     * Only PropertyCheck terms contribute; an interface check depends on
+     * the device's interface set, which is fixed for a registered device,
+     * rather than on any property. The change-driven caches use this to
+     * skip re-evaluating a predicate when only unrelated properties
+     * changed.
+     *
+     * @return the property names compared by this predicate
+     * @since 5.79
+     */
+    QSet<QString> usedProperties() const;
+
+    /**
+     * Returns a simplified predicate matching exactly the same devices.
+     *
+     * Chains of one operator are flattened, duplicate terms are dropped,
+     * terms which can never match are folded away (an unmatchable
+     * conjunct makes the whole conjunction invalid, an unmatchable
+     * disjunct just disappears), and an interface check is removed from
+     * a conjunction which also contains a property check on the same
+     * interface, since the property check already implies it.
+     *
+     * Programmatically assembled queries tend to accumulate such
+     * redundancy; normalizing them once before repeated evaluation makes
+     * every distinct check get visited once.
+     *
+     * @return the simplified predicate
+     * @since 5.79
+     */
+    Predicate normalized() const;
+
     /**
      * Converts the predicate to its string form.
      *
@@ -186,6 +289,41 @@ public:
      */
     static Predicate fromString(const QString &predicate);
 
+    /**
+     * Constructs a predicate matching devices advertising any of the given
+     * device interface types.
+     *
+     * This is the parser-free way for C++ callers to build the common
+     * "IS A OR IS B" disjunctions which are otherwise assembled as strings
+     * and run through fromString() on every call.
+     *
+     * @param types the device interface types to match
+     * @return a disjunction of interface checks, or an invalid predicate
+     * if the list is empty
+     * @since 5.79
+     */
+    static Predicate fromTypes(const QList<DeviceInterface::Type> &types);
+
+    /**
+     * Combines a list of predicates into one conjunction.
+     *
+     * @param predicates the predicates every device has to match
+     * @return the conjunction of the given predicates, or an invalid
+     * predicate if the list is empty
+     * @since 5.79
+     */
+    static Predicate allOf(const QList<Predicate> &predicates);
+
+    /**
+     * Combines a list of predicates into one disjunction.
+     *
+     * @param predicates the predicates of which a device has to match one
+     * @return the disjunction of the given predicates, or an invalid
+     * predicate if the list is empty
+     * @since 5.79
+     */
+    static Predicate anyOf(const QList<Predicate> &predicates);
+
     /**
     * Retrieves the predicate type, used to determine how to handle the predicate
     *
@@ -23,24 +23,24 @@ Solid::Processor::~Processor()
 int Solid::Processor::number() const
 {
     Q_D(const Processor);
-    return_SOLID_CALL(Ifaces::Processor *, d->backendObject(), 0, number());
+    return_SOLID_IFACE_CALL(Ifaces::Processor, d, 0, number());
 }
 
 int Solid::Processor::maxSpeed() const
 {
     Q_D(const Processor);
-    return_SOLID_CALL(Ifaces::Processor *, d->backendObject(), 0, maxSpeed());
+    return_SOLID_IFACE_CALL(Ifaces::Processor, d, 0, maxSpeed());
 }
 
 bool Solid::Processor::canChangeFrequency() const
 {
     Q_D(const Processor);
-    return_SOLID_CALL(Ifaces::Processor *, d->backendObject(), false, canChangeFrequency());
+    return_SOLID_IFACE_CALL(Ifaces::Processor, d, false, canChangeFrequency());
 }
 
 Solid::Processor::InstructionSets Solid::Processor::instructionSets() const
 {
     Q_D(const Processor);
-    return_SOLID_CALL(Ifaces::Processor *, d->backendObject(), InstructionSets(), instructionSets());
+    return_SOLID_IFACE_CALL(Ifaces::Processor, d, InstructionSets(), instructionSets());
 }
 
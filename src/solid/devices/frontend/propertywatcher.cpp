@@ -0,0 +1,114 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include "propertywatcher.h"
+
+#include "device.h"
+#include "deviceinterface_p.h"
+#include "genericinterface.h"
+
+#include <solid/devices/ifaces/genericinterface.h>
+
+#include <QSet>
+
+namespace Solid
+{
+
+class PropertyWatcher::Private
+{
+public:
+    /* Holding the Device keeps its registration (and with it the
+     * backend interface objects) alive for the watcher's lifetime. */
+    Device device;
+    QSet<QString> properties;
+    /* Set while the backend evaluates the filter itself; used to drop
+     * the subscription again, and cleared if the backend object goes
+     * away first (device removal). */
+    Ifaces::GenericInterface *backendIface = nullptr;
+};
+
+}
+
+Solid::PropertyWatcher::PropertyWatcher(const QString &udi, const QStringList &properties, QObject *parent)
+    : QObject(parent), d(new Private)
+{
+    d->device = Device(udi);
+    for (const QString &property : properties) {
+        d->properties.insert(property);
+    }
+
+    GenericInterface *iface = d->device.as<GenericInterface>();
+    if (iface == nullptr) {
+        return;
+    }
+
+    QObject *backendObject = iface->d_ptr->backendObject();
+    Ifaces::GenericInterface *backendIface = qobject_cast<Ifaces::GenericInterface *>(backendObject);
+
+    if (backendIface && backendIface->watchProperties(d->properties, this, "_k_backendDelivery")) {
+        /* The backend discards uninteresting changes at its demultiplex
+         * point; nothing reaches this thread for them. */
+        d->backendIface = backendIface;
+        connect(backendObject, &QObject::destroyed, this, [this]() {
+            d->backendIface = nullptr;
+        });
+        return;
+    }
+
+    /* Client-side fallback: every change of the device still arrives
+     * here, but only those touching a watched property are re-read and
+     * re-emitted. */
+    connect(iface, &GenericInterface::propertyChanged,
+            this, &PropertyWatcher::_k_unfilteredChange);
+}
+
+Solid::PropertyWatcher::~PropertyWatcher()
+{
+    if (d->backendIface) {
+        d->backendIface->unwatchProperties(this);
+    }
+    delete d;
+}
+
+QString Solid::PropertyWatcher::udi() const
+{
+    return d->device.udi();
+}
+
+QStringList Solid::PropertyWatcher::properties() const
+{
+    return d->properties.values();
+}
+
+void Solid::PropertyWatcher::_k_backendDelivery(const QVariantMap &changedValues)
+{
+    /* Already filtered where it was demultiplexed; just fan out. */
+    Q_EMIT propertiesChanged(changedValues);
+}
+
+void Solid::PropertyWatcher::_k_unfilteredChange(const QMap<QString, int> &changes)
+{
+    GenericInterface *iface = d->device.as<GenericInterface>();
+    if (iface == nullptr) {
+        return;
+    }
+
+    QVariantMap interesting;
+    for (auto it = changes.constBegin(); it != changes.constEnd(); ++it) {
+        if (!d->properties.contains(it.key())) {
+            continue;
+        }
+        if (it.value() == GenericInterface::PropertyRemoved) {
+            interesting.insert(it.key(), QVariant());
+        } else {
+            interesting.insert(it.key(), iface->property(it.key()));
+        }
+    }
+
+    if (!interesting.isEmpty()) {
+        Q_EMIT propertiesChanged(interesting);
+    }
+}
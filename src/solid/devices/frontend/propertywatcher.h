@@ -0,0 +1,87 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#ifndef SOLID_PROPERTYWATCHER_H
+#define SOLID_PROPERTYWATCHER_H
+
+#include <QMap>
+#include <QObject>
+#include <QStringList>
+#include <QVariant>
+
+#include <solid/solid_export.h>
+
+namespace Solid
+{
+/**
+ * A subscription to changes of selected device properties.
+ *
+ * GenericInterface::propertyChanged() fires for every property of the
+ * device, so a monitor interested in one attribute wakes on every
+ * unrelated change — under I/O load that can be dozens of wakeups per
+ * second. A PropertyWatcher names the properties it cares about up
+ * front; where the backend supports it the filter is evaluated at the
+ * backend's change demultiplex point, before the notification is
+ * queued to this thread, so uninteresting changes don't wake the
+ * subscriber at all. Elsewhere the filter is applied on arrival,
+ * which still spares the consumer the uninteresting emissions.
+ *
+ * @since 5.79
+ */
+class SOLID_EXPORT PropertyWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Creates a watcher for changes of @p properties on the device
+     * with the given @p udi.
+     *
+     * @param udi the UDI of the device to watch
+     * @param properties the names of the properties to watch
+     * @param parent the parent object
+     */
+    PropertyWatcher(const QString &udi, const QStringList &properties, QObject *parent = nullptr);
+
+    /**
+     * Destroys a PropertyWatcher object and drops its subscription.
+     */
+    ~PropertyWatcher() override;
+
+    /**
+     * Retrieves the UDI of the watched device.
+     */
+    QString udi() const;
+
+    /**
+     * Retrieves the names of the watched properties, in no particular
+     * order.
+     */
+    QStringList properties() const;
+
+Q_SIGNALS:
+    /**
+     * This signal is emitted when at least one watched property
+     * changes.
+     *
+     * @param changedValues map from watched property name to its new
+     * value; only watched properties appear, and properties whose new
+     * value isn't known (invalidated or removed) are reported with an
+     * invalid QVariant
+     */
+    void propertiesChanged(const QVariantMap &changedValues);
+
+private Q_SLOTS:
+    void _k_backendDelivery(const QVariantMap &changedValues);
+    void _k_unfilteredChange(const QMap<QString, int> &changes);
+
+private:
+    class Private;
+    Private *const d;
+};
+}
+
+#endif
@@ -0,0 +1,85 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include "querywatcher.h"
+
+#include "device.h"
+#include "devicenotifier.h"
+
+#include <QSet>
+
+namespace Solid
+{
+
+class QueryWatcher::Private
+{
+public:
+    Predicate predicate;
+    QSet<QString> matches;
+};
+
+}
+
+Solid::QueryWatcher::QueryWatcher(const Predicate &predicate, QObject *parent)
+    : QObject(parent), d(new Private)
+{
+    d->predicate = predicate;
+
+    // Seed from a full query once; everything after this is per-device.
+    const QList<Device> devices = Device::listFromQuery(predicate);
+    d->matches.reserve(devices.size());
+    for (const Device &device : devices) {
+        d->matches.insert(device.udi());
+    }
+
+    DeviceNotifier *notifier = DeviceNotifier::instance();
+    connect(notifier, SIGNAL(deviceAdded(QString)),
+            this, SLOT(_k_deviceAdded(QString)));
+    connect(notifier, SIGNAL(deviceRemoved(QString)),
+            this, SLOT(_k_deviceRemoved(QString)));
+}
+
+Solid::QueryWatcher::~QueryWatcher()
+{
+    delete d;
+}
+
+Solid::Predicate Solid::QueryWatcher::predicate() const
+{
+    return d->predicate;
+}
+
+QStringList Solid::QueryWatcher::matches() const
+{
+    return d->matches.values();
+}
+
+void Solid::QueryWatcher::_k_deviceAdded(const QString &udi)
+{
+    if (d->matches.contains(udi)) {
+        return;
+    }
+
+    // Only the new device is evaluated; the rest of the result set
+    // can't have changed. The evaluation hits the manager's match
+    // caches, so watchers sharing a predicate share the work.
+    if (d->predicate.isValid()) {
+        Device device(udi);
+        if (!d->predicate.matches(device)) {
+            return;
+        }
+    }
+
+    d->matches.insert(udi);
+    Q_EMIT deviceEntered(udi);
+}
+
+void Solid::QueryWatcher::_k_deviceRemoved(const QString &udi)
+{
+    if (d->matches.remove(udi)) {
+        Q_EMIT deviceLeft(udi);
+    }
+}
@@ -0,0 +1,97 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#ifndef SOLID_QUERYWATCHER_H
+#define SOLID_QUERYWATCHER_H
+
+#include <QObject>
+#include <QStringList>
+
+#include <solid/solid_export.h>
+#include <solid/predicate.h>
+
+namespace Solid
+{
+/**
+ * A standing device query maintained incrementally.
+ *
+ * Applications watching for a class of devices used to run
+ * Device::listFromQuery() and re-run the full query on every
+ * deviceAdded()/deviceRemoved() notification. A QueryWatcher runs the
+ * query once when constructed and afterwards evaluates its predicate
+ * only against the device each notification is about, emitting
+ * deviceEntered()/deviceLeft() deltas instead of forcing consumers to
+ * diff complete result lists.
+ *
+ * The single-device evaluations go through the device manager's
+ * regular match caches, so several watchers over the same predicate
+ * share the evaluation work.
+ *
+ * @since 5.79
+ */
+class SOLID_EXPORT QueryWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Creates a watcher for the devices matching @p predicate and
+     * seeds it with the current matches; these are available from
+     * matches() right away and are not announced through
+     * deviceEntered().
+     *
+     * An invalid predicate matches every device, like it does in
+     * Device::listFromQuery().
+     *
+     * @param predicate the predicate the watched devices must match
+     * @param parent the parent object
+     */
+    explicit QueryWatcher(const Predicate &predicate, QObject *parent = nullptr);
+
+    /**
+     * Destroys a QueryWatcher object.
+     */
+    ~QueryWatcher() override;
+
+    /**
+     * Retrieves the predicate this watcher evaluates.
+     */
+    Predicate predicate() const;
+
+    /**
+     * Retrieves the UDIs of the devices currently matching the
+     * predicate, in no particular order.
+     */
+    QStringList matches() const;
+
+Q_SIGNALS:
+    /**
+     * This signal is emitted when a device matching the predicate
+     * appears in the underlying system.
+     *
+     * @param udi the UDI of the new matching device
+     */
+    void deviceEntered(const QString &udi);
+
+    /**
+     * This signal is emitted when a previously matching device
+     * disappears from the underlying system.
+     *
+     * @param udi the UDI of the device that left the result set
+     */
+    void deviceLeft(const QString &udi);
+
+private Q_SLOTS:
+    void _k_deviceAdded(const QString &udi);
+    void _k_deviceRemoved(const QString &udi);
+
+private:
+    class Private;
+    Private *const d;
+};
+}
+
+#endif
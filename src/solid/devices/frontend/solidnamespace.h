@@ -17,7 +17,8 @@ enum ErrorType {
     OperationFailed,
     UserCanceled,
     InvalidOption,
-    MissingDriver
+    MissingDriver,
+    BackendUnavailable /**< the backend service stopped responding; the operation failed fast instead of waiting out a timeout. @since 5.79 */
 };
 }
 
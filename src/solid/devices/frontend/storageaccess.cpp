@@ -7,9 +7,13 @@
 #include "storageaccess.h"
 #include "storageaccess_p.h"
 
+#include "device.h"
 #include "soliddefs_p.h"
 #include <solid/devices/ifaces/storageaccess.h>
 
+#include <QFutureInterface>
+#include <QSharedPointer>
+
 Solid::StorageAccess::StorageAccess(QObject *backendObject)
     : DeviceInterface(*new StorageAccessPrivate(), backendObject)
 {
@@ -23,7 +27,7 @@ Solid::StorageAccess::StorageAccess(QObject *backendObject)
             this, SIGNAL(teardownRequested(QString)));
 
     connect(backendObject, SIGNAL(accessibilityChanged(bool,QString)),
-            this, SIGNAL(accessibilityChanged(bool,QString)));
+            this, SLOT(_k_accessibilityChanged(bool,QString)));
 }
 
 Solid::StorageAccess::StorageAccess(StorageAccessPrivate &dd, QObject *backendObject)
@@ -39,7 +43,7 @@ Solid::StorageAccess::StorageAccess(StorageAccessPrivate &dd, QObject *backendOb
             this, SIGNAL(teardownRequested(QString)));
 
     connect(backendObject, SIGNAL(accessibilityChanged(bool,QString)),
-            this, SIGNAL(accessibilityChanged(bool,QString)));
+            this, SLOT(_k_accessibilityChanged(bool,QString)));
 }
 
 Solid::StorageAccess::~StorageAccess()
@@ -50,30 +54,197 @@ Solid::StorageAccess::~StorageAccess()
 bool Solid::StorageAccess::isAccessible() const
 {
     Q_D(const StorageAccess);
-    return_SOLID_CALL(Ifaces::StorageAccess *, d->backendObject(), false, isAccessible());
+
+    if (d->accessibleCached) {
+        return d->accessible;
+    }
+
+    Ifaces::StorageAccess *iface = d->backendIface<Ifaces::StorageAccess>();
+    if (iface == nullptr) {
+        return false;
+    }
+
+    d->accessible = iface->isAccessible();
+    d->accessibleCached = true;
+    return d->accessible;
+}
+
+void Solid::StorageAccess::_k_accessibilityChanged(bool accessible, const QString &udi)
+{
+    Q_D(StorageAccess);
+    d->accessible = accessible;
+    d->accessibleCached = true;
+    Q_EMIT accessibilityChanged(accessible, udi);
 }
 
 QString Solid::StorageAccess::filePath() const
 {
     Q_D(const StorageAccess);
-    return_SOLID_CALL(Ifaces::StorageAccess *, d->backendObject(), QString(), filePath());
+    return_SOLID_IFACE_CALL(Ifaces::StorageAccess, d, QString(), filePath());
 }
 
 bool Solid::StorageAccess::setup()
 {
     Q_D(StorageAccess);
-    return_SOLID_CALL(Ifaces::StorageAccess *, d->backendObject(), false, setup());
+    return_SOLID_IFACE_CALL(Ifaces::StorageAccess, d, false, setup());
 }
 
 bool Solid::StorageAccess::teardown()
 {
     Q_D(StorageAccess);
-    return_SOLID_CALL(Ifaces::StorageAccess *, d->backendObject(), false, teardown());
+    return_SOLID_IFACE_CALL(Ifaces::StorageAccess, d, false, teardown());
+}
+
+// Resolves a future from the next emission of the given done signal.
+// The signal is connected before the operation is started, so backends
+// finishing (and emitting) synchronously are not missed. The connection
+// lives on this object, so it is torn down with it; the future is then
+// canceled rather than left pending forever.
+template<typename DoneSignal, typename Starter>
+static QFuture<Solid::StorageAccess::AccessResult> futureFromDoneSignal(Solid::StorageAccess *access, DoneSignal doneSignal, Starter starter)
+{
+    using AccessResult = Solid::StorageAccess::AccessResult;
+
+    QFutureInterface<AccessResult> futureInterface;
+    futureInterface.reportStarted();
+
+    struct Connections {
+        QMetaObject::Connection done;
+        QMetaObject::Connection destroyed;
+    };
+    auto connections = QSharedPointer<Connections>::create();
+
+    connections->done = QObject::connect(access, doneSignal, access,
+        [futureInterface, connections](Solid::ErrorType error, const QVariant &errorData, const QString &) mutable {
+            QObject::disconnect(connections->done);
+            QObject::disconnect(connections->destroyed);
+            futureInterface.reportResult(AccessResult{error, errorData});
+            futureInterface.reportFinished();
+        });
+    connections->destroyed = QObject::connect(access, &QObject::destroyed, access,
+        [futureInterface, connections]() mutable {
+            QObject::disconnect(connections->done);
+            QObject::disconnect(connections->destroyed);
+            futureInterface.reportCanceled();
+            futureInterface.reportFinished();
+        });
+
+    if (!starter()) {
+        QObject::disconnect(connections->done);
+        QObject::disconnect(connections->destroyed);
+        if (!futureInterface.isFinished()) {
+            futureInterface.reportResult(AccessResult{Solid::OperationFailed, QVariant()});
+            futureInterface.reportFinished();
+        }
+    }
+
+    return futureInterface.future();
+}
+
+QFuture<Solid::StorageAccess::AccessResult> Solid::StorageAccess::setupAsync()
+{
+    return futureFromDoneSignal(this, &StorageAccess::setupDone, [this]() {
+        return setup();
+    });
+}
+
+QFuture<Solid::StorageAccess::AccessResult> Solid::StorageAccess::teardownAsync()
+{
+    return futureFromDoneSignal(this, &StorageAccess::teardownDone, [this]() {
+        return teardown();
+    });
+}
+
+// Starts the given operation on every device before waiting on any of
+// them and resolves one future with the aggregated per-UDI outcomes.
+// The backends issue their mount/unmount requests asynchronously, so
+// the bus round trips overlap and the batch finishes with the slowest
+// device rather than with the sum of all of them.
+static QFuture<QMap<QString, Solid::StorageAccess::AccessResult>> batchFromDoneSignals(
+    const QList<Solid::Device> &devices,
+    void (Solid::StorageAccess::*doneSignal)(Solid::ErrorType, QVariant, const QString &),
+    bool (Solid::StorageAccess::*start)())
+{
+    using AccessResult = Solid::StorageAccess::AccessResult;
+
+    QFutureInterface<QMap<QString, AccessResult>> futureInterface;
+    futureInterface.reportStarted();
+
+    if (devices.isEmpty()) {
+        futureInterface.reportResult(QMap<QString, AccessResult>());
+        futureInterface.reportFinished();
+        return futureInterface.future();
+    }
+
+    struct BatchState {
+        QMap<QString, AccessResult> results;
+        int outstanding = 0;
+    };
+    auto state = QSharedPointer<BatchState>::create();
+    state->outstanding = devices.size();
+
+    auto recordResult = [futureInterface, state](const QString &udi, const AccessResult &result) mutable {
+        state->results.insert(udi, result);
+        if (--state->outstanding == 0) {
+            futureInterface.reportResult(state->results);
+            futureInterface.reportFinished();
+        }
+    };
+
+    for (Solid::Device device : devices) {
+        const QString udi = device.udi();
+        Solid::StorageAccess *access = device.as<Solid::StorageAccess>();
+        if (access == nullptr) {
+            recordResult(udi, AccessResult{Solid::OperationFailed, QVariant()});
+            continue;
+        }
+
+        // Same signal discipline as futureFromDoneSignal(): connect
+        // before starting so synchronously completing backends are not
+        // missed, and resolve the slot on destruction so a vanishing
+        // device cannot leave the batch pending forever.
+        struct Connections {
+            QMetaObject::Connection done;
+            QMetaObject::Connection destroyed;
+        };
+        auto connections = QSharedPointer<Connections>::create();
+
+        connections->done = QObject::connect(access, doneSignal, access,
+            [recordResult, connections](Solid::ErrorType error, const QVariant &errorData, const QString &udi) mutable {
+                QObject::disconnect(connections->done);
+                QObject::disconnect(connections->destroyed);
+                recordResult(udi, AccessResult{error, errorData});
+            });
+        connections->destroyed = QObject::connect(access, &QObject::destroyed, access,
+            [recordResult, connections, udi]() mutable {
+                QObject::disconnect(connections->done);
+                QObject::disconnect(connections->destroyed);
+                recordResult(udi, AccessResult{Solid::OperationFailed, QVariant()});
+            });
+
+        if (!(access->*start)()) {
+            QObject::disconnect(connections->done);
+            QObject::disconnect(connections->destroyed);
+            recordResult(udi, AccessResult{Solid::OperationFailed, QVariant()});
+        }
+    }
+
+    return futureInterface.future();
+}
+
+QFuture<QMap<QString, Solid::StorageAccess::AccessResult>> Solid::StorageAccess::teardownAll(const QList<Device> &devices)
+{
+    return batchFromDoneSignals(devices, &StorageAccess::teardownDone, &StorageAccess::teardown);
+}
+
+QFuture<QMap<QString, Solid::StorageAccess::AccessResult>> Solid::StorageAccess::setupAll(const QList<Device> &devices)
+{
+    return batchFromDoneSignals(devices, &StorageAccess::setupDone, &StorageAccess::setup);
 }
 
 bool Solid::StorageAccess::isIgnored() const
 {
     Q_D(const StorageAccess);
-    return_SOLID_CALL(Ifaces::StorageAccess *, d->backendObject(), true, isIgnored());
+    return_SOLID_IFACE_CALL(Ifaces::StorageAccess, d, true, isIgnored());
 }
 
@@ -11,6 +11,8 @@
 
 #include <solid/solidnamespace.h>
 #include <solid/deviceinterface.h>
+#include <QFuture>
+#include <QMap>
 #include <QVariant>
 
 namespace Solid
@@ -104,6 +106,70 @@ public:
      */
     bool teardown();
 
+    /**
+     * The outcome of a setupAsync() or teardownAsync() request.
+     */
+    struct AccessResult {
+        /** Type of error that occurred, if any. */
+        Solid::ErrorType error;
+        /** More information about the error, if any. */
+        QVariant errorData;
+    };
+
+    /**
+     * Mounts the volume and reports the outcome through the returned
+     * future, resolved when this object's setupDone() signal arrives.
+     *
+     * Compared to connecting to setupDone() manually this composes:
+     * several mounts can be started concurrently and collected with
+     * QFutureWatcher, QtConcurrent, or a coroutine adapter awaiting
+     * the future. When the operation is not supported the future is
+     * resolved immediately with OperationFailed.
+     *
+     * Like setupDone() itself, the result may be triggered by another
+     * process acting on the same volume.
+     *
+     * @since 5.79
+     */
+    QFuture<AccessResult> setupAsync();
+
+    /**
+     * Unmounts the volume and reports the outcome through the returned
+     * future, resolved when this object's teardownDone() signal
+     * arrives; otherwise behaves like setupAsync().
+     *
+     * @since 5.79
+     */
+    QFuture<AccessResult> teardownAsync();
+
+    /**
+     * Unmounts a whole batch of volumes and reports one aggregated
+     * result through the returned future.
+     *
+     * Every unmount is started before the first outcome is awaited, so
+     * the backend requests overlap on the bus and tearing down N
+     * volumes takes roughly as long as the slowest single unmount
+     * instead of their sum. The future resolves once every device has
+     * reported, with a map from UDI to outcome. Devices in the list
+     * without the StorageAccess interface report OperationFailed, like
+     * an unsupported teardownAsync() does.
+     *
+     * @param devices the devices to unmount
+     * @return a future resolving to the outcome per UDI
+     * @since 5.79
+     */
+    static QFuture<QMap<QString, AccessResult>> teardownAll(const QList<Device> &devices);
+
+    /**
+     * Mounts a whole batch of volumes; the setup counterpart of
+     * teardownAll().
+     *
+     * @param devices the devices to mount
+     * @return a future resolving to the outcome per UDI
+     * @since 5.79
+     */
+    static QFuture<QMap<QString, AccessResult>> setupAll(const QList<Device> &devices);
+
 Q_SIGNALS:
     /**
      * This signal is emitted when the accessiblity of this device
@@ -159,6 +225,12 @@ protected:
      * @internal
      */
     StorageAccess(StorageAccessPrivate &dd, QObject *backendObject);
+
+private Q_SLOTS:
+    /**
+     * @internal
+     */
+    void _k_accessibilityChanged(bool accessible, const QString &udi);
 };
 }
 
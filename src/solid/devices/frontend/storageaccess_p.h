@@ -16,6 +16,12 @@ class StorageAccessPrivate : public DeviceInterfacePrivate
 public:
     StorageAccessPrivate()
         : DeviceInterfacePrivate() { }
+
+    // Mirror of the backend's accessibility state, filled on the first
+    // isAccessible() call and kept current by accessibilityChanged, so
+    // per-paint polling doesn't re-query the backend.
+    mutable bool accessible = false;
+    mutable bool accessibleCached = false;
 };
 }
 
@@ -0,0 +1,48 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include "storageaccessview.h"
+#include "device_p.h"
+
+#include <solid/devices/ifaces/device.h>
+#include <solid/devices/ifaces/storageaccess.h>
+
+Solid::StorageAccessView::StorageAccessView(const Device &device)
+    : m_device(device)
+    , m_object(nullptr)
+    , m_iface(nullptr)
+{
+    Ifaces::Device *backend = m_device.d->backendObject();
+    if (backend) {
+        m_object = backend->createDeviceInterface(DeviceInterface::StorageAccess);
+        m_iface = qobject_cast<Ifaces::StorageAccess *>(m_object);
+    }
+}
+
+Solid::StorageAccessView::~StorageAccessView()
+{
+    delete m_object;
+}
+
+bool Solid::StorageAccessView::isValid() const
+{
+    return m_iface != nullptr;
+}
+
+bool Solid::StorageAccessView::isAccessible() const
+{
+    return m_iface ? m_iface->isAccessible() : false;
+}
+
+QString Solid::StorageAccessView::filePath() const
+{
+    return m_iface ? m_iface->filePath() : QString();
+}
+
+bool Solid::StorageAccessView::isIgnored() const
+{
+    return m_iface ? m_iface->isIgnored() : true;
+}
@@ -0,0 +1,85 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#ifndef SOLID_STORAGEACCESSVIEW_H
+#define SOLID_STORAGEACCESSVIEW_H
+
+#include <solid/solid_export.h>
+
+#include <solid/device.h>
+
+namespace Solid
+{
+namespace Ifaces
+{
+class StorageAccess;
+}
+
+/**
+ * Lightweight read-only view on the StorageAccess interface of a device.
+ *
+ * Unlike Device::as<StorageAccess>(), constructing a view doesn't create
+ * a frontend QObject or register it with the device handle; it reads
+ * straight through the backend. Use it in enumeration loops that only
+ * inspect state — anything that wants the change signals, or reads the
+ * same device repeatedly, is better served by the full interface, which
+ * is cached on the device.
+ *
+ * The view is a plain stack object tied to the device handle it was
+ * created from and is not copyable.
+ *
+ * @since 5.79
+ */
+class SOLID_EXPORT StorageAccessView
+{
+public:
+    explicit StorageAccessView(const Device &device);
+    ~StorageAccessView();
+
+    StorageAccessView(const StorageAccessView &) = delete;
+    StorageAccessView &operator=(const StorageAccessView &) = delete;
+
+    /**
+     * Indicates whether the device actually provides StorageAccess; the
+     * accessors below return their documented defaults when it doesn't.
+     *
+     * @return true if the device has the StorageAccess interface
+     */
+    bool isValid() const;
+
+    /**
+     * Indicates if this volume is mounted.
+     *
+     * @return true if the volume is mounted
+     * @see Solid::StorageAccess::isAccessible()
+     */
+    bool isAccessible() const;
+
+    /**
+     * Retrieves the absolute path of this volume mountpoint.
+     *
+     * @return the absolute path to the mount point if the volume is
+     * mounted, QString() otherwise
+     * @see Solid::StorageAccess::filePath()
+     */
+    QString filePath() const;
+
+    /**
+     * Indicates if this volume should be ignored by applications.
+     *
+     * @return true if the volume should be ignored
+     * @see Solid::StorageAccess::isIgnored()
+     */
+    bool isIgnored() const;
+
+private:
+    Device m_device;
+    QObject *m_object;
+    Ifaces::StorageAccess *m_iface;
+};
+}
+
+#endif
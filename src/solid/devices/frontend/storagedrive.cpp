@@ -9,8 +9,10 @@
 
 #include "soliddefs_p.h"
 #include <solid/devices/ifaces/storagedrive.h>
+#include "devicemanager_p.h"
 #include "predicate.h"
 #include "storageaccess.h"
+#include "storagevolume.h"
 #include "device.h"
 #include "device_p.h"
 
@@ -33,31 +35,31 @@ Solid::StorageDrive::~StorageDrive()
 Solid::StorageDrive::Bus Solid::StorageDrive::bus() const
 {
     Q_D(const StorageDrive);
-    return_SOLID_CALL(Ifaces::StorageDrive *, d->backendObject(), Platform, bus());
+    return_SOLID_IFACE_CALL(Ifaces::StorageDrive, d, Platform, bus());
 }
 
 Solid::StorageDrive::DriveType Solid::StorageDrive::driveType() const
 {
     Q_D(const StorageDrive);
-    return_SOLID_CALL(Ifaces::StorageDrive *, d->backendObject(), HardDisk, driveType());
+    return_SOLID_IFACE_CALL(Ifaces::StorageDrive, d, HardDisk, driveType());
 }
 
 bool Solid::StorageDrive::isRemovable() const
 {
     Q_D(const StorageDrive);
-    return_SOLID_CALL(Ifaces::StorageDrive *, d->backendObject(), false, isRemovable());
+    return_SOLID_IFACE_CALL(Ifaces::StorageDrive, d, false, isRemovable());
 }
 
 bool Solid::StorageDrive::isHotpluggable() const
 {
     Q_D(const StorageDrive);
-    return_SOLID_CALL(Ifaces::StorageDrive *, d->backendObject(), false, isHotpluggable());
+    return_SOLID_IFACE_CALL(Ifaces::StorageDrive, d, false, isHotpluggable());
 }
 
 qulonglong Solid::StorageDrive::size() const
 {
     Q_D(const StorageDrive);
-    return_SOLID_CALL(Ifaces::StorageDrive *, d->backendObject(), false, size());
+    return_SOLID_IFACE_CALL(Ifaces::StorageDrive, d, false, size());
 }
 
 bool Solid::StorageDrive::isInUse() const
@@ -76,3 +78,26 @@ bool Solid::StorageDrive::isInUse() const
     return inUse;
 }
 
+QList<Solid::Device> Solid::StorageDrive::volumes() const
+{
+    Q_D(const StorageDrive);
+    DeviceManagerPrivate *manager
+        = static_cast<DeviceManagerPrivate *>(Solid::DeviceNotifier::instance());
+
+    // Partitions hang off the block device which hangs off the drive, so
+    // the subtree is walked breadth first and filtered down to the volumes.
+    QList<Device> result;
+    QStringList queue{d->devicePrivate()->udi()};
+    while (!queue.isEmpty()) {
+        const QStringList children = manager->childUdisFromParent(queue.takeFirst());
+        for (const QString &udi : children) {
+            Device dev(udi);
+            if (dev.is<Solid::StorageVolume>()) {
+                result.append(dev);
+            }
+            queue.append(udi);
+        }
+    }
+    return result;
+}
+
@@ -11,6 +11,8 @@
 
 #include <solid/deviceinterface.h>
 
+#include <QList>
+
 namespace Solid
 {
 class StorageDrivePrivate;
@@ -143,6 +145,18 @@ public:
      */
     bool isInUse() const;
 
+    /**
+     * Retrieves the storage volumes this drive contains.
+     *
+     * The lookup is answered from a parent-child adjacency map the device
+     * manager maintains from hotplug events, so rendering a drive tree
+     * doesn't re-probe the parent of every volume in the system.
+     *
+     * @return the volumes contained by this drive
+     * @since 5.79
+     */
+    QList<Device> volumes() const;
+
 protected:
     /**
      * @internal
@@ -0,0 +1,233 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include "storageoperationjob.h"
+#include "storageoperationjob_p.h"
+
+#include "devicemanager_p.h"
+#include "devicenotifier.h"
+#include "opticaldrive.h"
+#include "storageaccess.h"
+
+#include "ifaces/devicemanager.h"
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+
+using namespace Solid;
+
+namespace
+{
+/**
+ * Process-wide registry of operations submitted to the backends but not
+ * yet answered, one queue per backend UDI prefix. Entries stay in the
+ * queue as long as the backend stays silent, which is exactly what
+ * queueState() needs to surface: a stuck daemon shows up as a constant
+ * depth with a growing oldest-pending age.
+ */
+struct PendingOperation {
+    quint64 id;
+    QElapsedTimer started;
+};
+
+struct OperationQueues {
+    QMutex mutex;
+    QHash<QString, QList<PendingOperation> > pending;
+    QHash<QString, qint64> lastCompleted;
+    quint64 nextId = 1;
+    int limit = 0;
+};
+}
+
+Q_GLOBAL_STATIC(OperationQueues, s_operationQueues)
+
+// The queue key of the backend serving the UDI; operations on devices of
+// the same backend wait on the same daemon, so that is the granularity
+// at which congestion is visible.
+static QString backendKeyForUdi(const QString &udi)
+{
+    auto *manager = static_cast<DeviceManagerPrivate *>(DeviceNotifier::instance());
+    const QList<Ifaces::DeviceManager *> backends = manager->deviceBackends();
+    for (Ifaces::DeviceManager *backend : backends) {
+        const QString prefix = backend->udiPrefix();
+        if (udi.startsWith(prefix)) {
+            return prefix;
+        }
+    }
+    return QString();
+}
+
+static void finishPendingOperation(const QString &key, quint64 id)
+{
+    OperationQueues *queues = s_operationQueues();
+    QMutexLocker locker(&queues->mutex);
+
+    auto it = queues->pending.find(key);
+    if (it == queues->pending.end()) {
+        return;
+    }
+    for (int i = 0; i < it.value().size(); ++i) {
+        if (it.value().at(i).id == id) {
+            queues->lastCompleted.insert(key, it.value().at(i).started.elapsed());
+            it.value().removeAt(i);
+            break;
+        }
+    }
+    if (it.value().isEmpty()) {
+        queues->pending.erase(it);
+    }
+}
+
+StorageOperationJobPrivate::StorageOperationJobPrivate(const Device &device, StorageOperationJob::Operation operation)
+    : device(device)
+    , operation(operation)
+{
+}
+
+StorageOperationJob::StorageOperationJob(const Device &device, Operation operation, QObject *parent)
+    : Job(*new StorageOperationJobPrivate(device, operation), parent)
+{
+}
+
+Device StorageOperationJob::device() const
+{
+    return d_func()->device;
+}
+
+StorageOperationJob::Operation StorageOperationJob::operation() const
+{
+    return d_func()->operation;
+}
+
+Solid::ErrorType StorageOperationJob::errorType() const
+{
+    return d_func()->backendError;
+}
+
+QVariant StorageOperationJob::errorData() const
+{
+    return d_func()->backendErrorData;
+}
+
+StorageOperationJob::QueueState StorageOperationJob::queueState(const QString &udi)
+{
+    const QString key = backendKeyForUdi(udi);
+
+    OperationQueues *queues = s_operationQueues();
+    QMutexLocker locker(&queues->mutex);
+
+    QueueState state;
+    const QList<PendingOperation> pending = queues->pending.value(key);
+    state.depth = pending.size();
+    for (const PendingOperation &operation : pending) {
+        state.oldestPendingMsecs = qMax(state.oldestPendingMsecs, qint64(operation.started.elapsed()));
+    }
+    state.lastCompletedMsecs = queues->lastCompleted.value(key);
+    return state;
+}
+
+void StorageOperationJob::setQueueLimit(int limit)
+{
+    OperationQueues *queues = s_operationQueues();
+    QMutexLocker locker(&queues->mutex);
+    queues->limit = qMax(0, limit);
+}
+
+void StorageOperationJob::doStart()
+{
+    Q_D(StorageOperationJob);
+
+    StorageAccess *access = nullptr;
+    OpticalDrive *drive = nullptr;
+    if (d->operation == Eject) {
+        drive = d->device.as<OpticalDrive>();
+    } else {
+        access = d->device.as<StorageAccess>();
+    }
+
+    if (access == nullptr && drive == nullptr) {
+        setError(UnsupportedOperation);
+        setErrorText(tr("Device %1 does not support this operation").arg(d->device.udi()));
+        emitResult();
+        return;
+    }
+
+    d->backendKey = backendKeyForUdi(d->device.udi());
+
+    {
+        OperationQueues *queues = s_operationQueues();
+        QMutexLocker locker(&queues->mutex);
+
+        QList<PendingOperation> &pending = queues->pending[d->backendKey];
+        if (queues->limit > 0 && pending.size() >= queues->limit) {
+            locker.unlock();
+            setError(QueueOverloaded);
+            setErrorText(tr("The storage backend already has %1 pending operations").arg(pending.size()));
+            emitResult();
+            return;
+        }
+
+        PendingOperation operation;
+        operation.id = queues->nextId++;
+        operation.started.start();
+        d->pendingId = operation.id;
+        pending.append(operation);
+    }
+
+    bool started = false;
+    switch (d->operation) {
+    case Setup:
+        connect(access, &StorageAccess::setupDone,
+                this, &StorageOperationJob::_k_operationDone);
+        started = access->setup();
+        break;
+    case Teardown:
+        connect(access, &StorageAccess::teardownDone,
+                this, &StorageOperationJob::_k_operationDone);
+        started = access->teardown();
+        break;
+    case Eject:
+        connect(drive, &OpticalDrive::ejectDone,
+                this, &StorageOperationJob::_k_operationDone);
+        started = drive->eject();
+        break;
+    }
+
+    if (!started) {
+        // The backend refused the call outright (for example an unmount
+        // of something that isn't mounted); no completion signal will
+        // follow for it.
+        finishPendingOperation(d->backendKey, d->pendingId);
+        d->pendingId = 0;
+        setError(OperationFailed);
+        setErrorText(tr("The device refused the operation"));
+        emitResult();
+    }
+}
+
+void StorageOperationJob::_k_operationDone(Solid::ErrorType error, QVariant errorData, const QString &udi)
+{
+    Q_D(StorageOperationJob);
+
+    if (udi != d->device.udi()) {
+        return;
+    }
+
+    if (d->pendingId != 0) {
+        finishPendingOperation(d->backendKey, d->pendingId);
+        d->pendingId = 0;
+    }
+
+    d->backendError = error;
+    d->backendErrorData = errorData;
+    if (error != Solid::NoError) {
+        setError(OperationFailed);
+        setErrorText(errorData.toString());
+    }
+    emitResult();
+}
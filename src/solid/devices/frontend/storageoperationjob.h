@@ -0,0 +1,132 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#ifndef SOLID_STORAGEOPERATIONJOB_H
+#define SOLID_STORAGEOPERATIONJOB_H
+
+#include <Solid/Job>
+
+#include <solid/device.h>
+#include <solid/solid_export.h>
+#include <solid/solidnamespace.h>
+
+#include <QVariant>
+
+namespace Solid
+{
+class StorageOperationJobPrivate;
+
+/**
+ * Runs a storage device operation (mount, unmount, eject) as a
+ * Solid::Job instead of through the bare StorageAccess/OpticalDrive
+ * signal pairs.
+ *
+ * Besides the uniform result() interface, the jobs account every
+ * submitted operation in one pending queue per backend: queueState()
+ * reports the queue's depth and how long its oldest operation has been
+ * running, which is how a stuck daemon shows up — today a hung unmount
+ * silently queues everything behind it. An optional queue limit turns
+ * that detection into load shedding by failing new jobs immediately
+ * with QueueOverloaded instead of submitting them.
+ *
+ * Like the other Solid jobs this one is fire-and-forget: connect to
+ * result(), call start(), and the job deletes itself after the result
+ * is emitted.
+ *
+ * @since 5.79
+ */
+class SOLID_EXPORT StorageOperationJob : public Job
+{
+    Q_OBJECT
+
+public:
+    /**
+     * The operation the job performs.
+     */
+    enum Operation {
+        /** Mount the device; requires StorageAccess. */
+        Setup,
+        /** Unmount the device; requires StorageAccess. */
+        Teardown,
+        /** Eject the medium; requires OpticalDrive. */
+        Eject,
+    };
+    Q_ENUM(Operation)
+
+    enum Error {
+        /** The device doesn't support the requested operation. */
+        UnsupportedOperation = Job::UserDefinedError,
+        /** The backend reported a failure; errorType() has the reason. */
+        OperationFailed,
+        /** The backend's queue was at its limit; nothing was submitted. */
+        QueueOverloaded,
+    };
+    Q_ENUM(Error)
+
+    /**
+     * Snapshot of one backend's pending operations.
+     */
+    struct QueueState {
+        /** Operations submitted but not yet finished. */
+        int depth = 0;
+        /** Milliseconds the oldest pending operation has been running. */
+        qint64 oldestPendingMsecs = 0;
+        /** Duration of the most recently finished operation. */
+        qint64 lastCompletedMsecs = 0;
+    };
+
+    /**
+     * Creates a job performing @p operation on @p device.
+     */
+    StorageOperationJob(const Device &device, Operation operation, QObject *parent = nullptr);
+
+    /**
+     * The device the job operates on.
+     */
+    Device device() const;
+
+    /**
+     * The operation the job performs.
+     */
+    Operation operation() const;
+
+    /**
+     * The backend's failure reason when error() is OperationFailed,
+     * Solid::NoError otherwise.
+     */
+    Solid::ErrorType errorType() const;
+
+    /**
+     * Extra error information from the backend, typically a message
+     * string; only meaningful when error() is OperationFailed.
+     */
+    QVariant errorData() const;
+
+    /**
+     * The pending-operation queue of the backend serving @p udi.
+     *
+     * A growing depth together with a growing oldestPendingMsecs means
+     * the backend daemon has stopped answering.
+     */
+    static QueueState queueState(const QString &udi);
+
+    /**
+     * Fails new jobs with QueueOverloaded when their backend already
+     * has @p limit pending operations. 0 (the default) disables the
+     * limit. The limit is process-wide.
+     */
+    static void setQueueLimit(int limit);
+
+private Q_SLOTS:
+    void doStart() override;
+    void _k_operationDone(Solid::ErrorType error, QVariant errorData, const QString &udi);
+
+private:
+    Q_DECLARE_PRIVATE(StorageOperationJob)
+};
+} // Solid namespace
+
+#endif // SOLID_STORAGEOPERATIONJOB_H
@@ -0,0 +1,34 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#ifndef SOLID_STORAGEOPERATIONJOB_P_H
+#define SOLID_STORAGEOPERATIONJOB_P_H
+
+#include "storageoperationjob.h"
+
+#include "solid/power/job_p.h"
+
+namespace Solid
+{
+class StorageOperationJobPrivate : public JobPrivate
+{
+public:
+    StorageOperationJobPrivate(const Device &device, StorageOperationJob::Operation operation);
+
+    Device device;
+    StorageOperationJob::Operation operation;
+    // The backend's pending-queue key and this job's entry in it; see
+    // the queue registry in storageoperationjob.cpp.
+    QString backendKey;
+    quint64 pendingId = 0;
+    Solid::ErrorType backendError = Solid::NoError;
+    QVariant backendErrorData;
+
+    Q_DECLARE_PUBLIC(StorageOperationJob)
+};
+}
+
+#endif // SOLID_STORAGEOPERATIONJOB_P_H
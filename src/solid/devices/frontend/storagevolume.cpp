@@ -29,37 +29,37 @@ Solid::StorageVolume::~StorageVolume()
 bool Solid::StorageVolume::isIgnored() const
 {
     Q_D(const StorageVolume);
-    return_SOLID_CALL(Ifaces::StorageVolume *, d->backendObject(), true, isIgnored());
+    return_SOLID_IFACE_CALL(Ifaces::StorageVolume, d, true, isIgnored());
 }
 
 Solid::StorageVolume::UsageType Solid::StorageVolume::usage() const
 {
     Q_D(const StorageVolume);
-    return_SOLID_CALL(Ifaces::StorageVolume *, d->backendObject(), Unused, usage());
+    return_SOLID_IFACE_CALL(Ifaces::StorageVolume, d, Unused, usage());
 }
 
 QString Solid::StorageVolume::fsType() const
 {
     Q_D(const StorageVolume);
-    return_SOLID_CALL(Ifaces::StorageVolume *, d->backendObject(), QString(), fsType());
+    return_SOLID_IFACE_CALL(Ifaces::StorageVolume, d, QString(), fsType());
 }
 
 QString Solid::StorageVolume::label() const
 {
     Q_D(const StorageVolume);
-    return_SOLID_CALL(Ifaces::StorageVolume *, d->backendObject(), QString(), label());
+    return_SOLID_IFACE_CALL(Ifaces::StorageVolume, d, QString(), label());
 }
 
 QString Solid::StorageVolume::uuid() const
 {
     Q_D(const StorageVolume);
-    return_SOLID_CALL(Ifaces::StorageVolume *, d->backendObject(), QString(), uuid().toLower());
+    return_SOLID_IFACE_CALL(Ifaces::StorageVolume, d, QString(), uuid().toLower());
 }
 
 qulonglong Solid::StorageVolume::size() const
 {
     Q_D(const StorageVolume);
-    return_SOLID_CALL(Ifaces::StorageVolume *, d->backendObject(), 0, size());
+    return_SOLID_IFACE_CALL(Ifaces::StorageVolume, d, 0, size());
 }
 
 Solid::Device Solid::StorageVolume::encryptedContainer() const
@@ -17,3 +17,14 @@ Solid::Ifaces::DeviceManager::~DeviceManager()
 
 }
 
+quint32 Solid::Ifaces::DeviceManager::deviceInterfacesMask(const QString &udi)
+{
+    Q_UNUSED(udi);
+    return 0;
+}
+
+QVariantMap Solid::Ifaces::DeviceManager::diagnosticState() const
+{
+    return QVariantMap();
+}
+
@@ -10,6 +10,7 @@
 #include <QObject>
 
 #include <QStringList>
+#include <QVariant>
 
 #include <solid/deviceinterface.h>
 
@@ -50,6 +51,36 @@ public:
      */
     virtual QSet<Solid::DeviceInterface::Type> supportedInterfaces() const = 0;
 
+    /**
+     * Retrieves the device interface types available on one device, as a
+     * bitmask with bit (1 << type) set for every supported type.
+     *
+     * Backends which learn the interface lists during enumeration anyway
+     * report them here, so typed queries and index maintenance can be
+     * answered from the enumeration payload without instantiating the
+     * device. The default implementation returns 0, meaning unknown:
+     * callers then fall back to instantiating the device and probing it.
+     *
+     * @param udi the identifier of the device
+     * @returns the supported device interface types as a bitmask, or 0
+     * if the backend cannot tell without instantiating the device
+     */
+    virtual quint32 deviceInterfacesMask(const QString &udi);
+
+    /**
+     * Retrieves a snapshot of the backend's internal bookkeeping for
+     * diagnostics: cache sizes, subscription counts, whatever the
+     * backend keeps per process. The values must be plain serializable
+     * types (numbers, booleans, strings), so the snapshot can be
+     * written to disk and compared across runs.
+     *
+     * The default implementation returns an empty map; backends
+     * without notable internal state don't need to report anything.
+     *
+     * @returns the backend's diagnostic values by name
+     */
+    virtual QVariantMap diagnosticState() const;
+
     /**
      * Retrieves the Universal Device Identifier (UDI) of all the devices
      * available in the system. This identifier is unique for each device
@@ -10,3 +10,38 @@ Solid::Ifaces::GenericInterface::~GenericInterface()
 {
 }
 
+int Solid::Ifaces::GenericInterface::propertyInt(const QString &key, int defaultValue) const
+{
+    const QVariant value = property(key);
+    bool ok = false;
+    const int result = value.toInt(&ok);
+    return ok ? result : defaultValue;
+}
+
+bool Solid::Ifaces::GenericInterface::propertyBool(const QString &key, bool defaultValue) const
+{
+    const QVariant value = property(key);
+    if (!value.isValid()) {
+        return defaultValue;
+    }
+    return value.toBool();
+}
+
+QString Solid::Ifaces::GenericInterface::propertyString(const QString &key) const
+{
+    return property(key).toString();
+}
+
+bool Solid::Ifaces::GenericInterface::watchProperties(const QSet<QString> &properties, QObject *receiver, const char *member)
+{
+    Q_UNUSED(properties)
+    Q_UNUSED(receiver)
+    Q_UNUSED(member)
+    return false;
+}
+
+void Solid::Ifaces::GenericInterface::unwatchProperties(QObject *receiver)
+{
+    Q_UNUSED(receiver)
+}
+
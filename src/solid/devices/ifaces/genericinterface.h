@@ -10,6 +10,7 @@
 #include <QObject>
 
 #include <QMap>
+#include <QSet>
 #include <QVariant>
 
 namespace Solid
@@ -56,6 +57,69 @@ public:
      */
     virtual bool propertyExists(const QString &key) const = 0;
 
+    /**
+     * Retrieves the value of an integral property without going through
+     * QVariant at the call site.
+     *
+     * The default implementation converts the result of property();
+     * backends holding properties in native form should override it to
+     * skip the boxing entirely.
+     *
+     * @param key the property name
+     * @param defaultValue the value returned if the property doesn't
+     * exist or isn't convertible
+     */
+    virtual int propertyInt(const QString &key, int defaultValue = 0) const;
+
+    /**
+     * Retrieves the value of a boolean property without going through
+     * QVariant at the call site.
+     *
+     * @param key the property name
+     * @param defaultValue the value returned if the property doesn't
+     * exist or isn't convertible
+     */
+    virtual bool propertyBool(const QString &key, bool defaultValue = false) const;
+
+    /**
+     * Retrieves the value of a string property without going through
+     * QVariant at the call site.
+     *
+     * @param key the property name
+     * @returns the property value, or an empty string if the property
+     * doesn't exist
+     */
+    virtual QString propertyString(const QString &key) const;
+
+    /**
+     * Installs a filtered change subscription for @p receiver.
+     *
+     * When the backend supports it, changes touching none of
+     * @p properties are discarded at the backend's own change
+     * demultiplex point, before anything is queued towards the
+     * receiver's thread. Changes that pass are delivered by invoking
+     * the receiver's @p member — an invokable taking a QVariantMap —
+     * with only the watched properties present, following the value
+     * conventions of propertyValuesChanged().
+     *
+     * The default implementation doesn't subscribe anything and
+     * returns false; callers then filter the regular change
+     * notifications on arrival instead.
+     *
+     * @param properties the property names the receiver cares about
+     * @param receiver the object to deliver filtered changes to
+     * @param member the name of the receiver's invokable to deliver
+     * through
+     * @returns true if the backend evaluates the filter itself
+     */
+    virtual bool watchProperties(const QSet<QString> &properties, QObject *receiver, const char *member);
+
+    /**
+     * Drops the filtered subscriptions previously installed for
+     * @p receiver with watchProperties().
+     */
+    virtual void unwatchProperties(QObject *receiver);
+
 protected:
     //Q_SIGNALS:
     /**
@@ -68,6 +132,25 @@ protected:
      */
     virtual void propertyChanged(const QMap<QString, int> &changes) = 0;
 
+    /**
+     * This signal is emitted when properties change and the backend
+     * already knows their new values, so listeners can update without
+     * re-reading the properties they care about.
+     *
+     * It is optional: backends whose change notifications carry the new
+     * values (like a D-Bus PropertiesChanged payload) declare it as a
+     * real signal; the frontend only connects to it when present. It is
+     * always emitted together with propertyChanged().
+     *
+     * @param changedValues map from property name to its new value;
+     * properties whose new value isn't known (invalidated or removed)
+     * are reported with an invalid QVariant
+     */
+    virtual void propertyValuesChanged(const QVariantMap &changedValues)
+    {
+        Q_UNUSED(changedValues)
+    }
+
     /**
      * This signal is emitted when an event occurred in the device.
      * For example when a button is pressed.
@@ -6,6 +6,11 @@
 
 #include "managerbase_p.h"
 
+#include "solidconfig_p.h"
+#include "solidstartupprofiler_p.h"
+
+#include <QElapsedTimer>
+
 #include <stdlib.h>
 
 #include <config-backends.h>
@@ -49,46 +54,82 @@ Solid::ManagerBasePrivate::~ManagerBasePrivate()
     qDeleteAll(m_backends);
 }
 
+// A process that only cares about one subsystem (a battery applet, say)
+// can restrict which backends get constructed at all: every skipped
+// backend is one less manager object, one less set of D-Bus match rules
+// and no startup enumeration for a subsystem the process never queries.
+static bool backendAllowed(const QStringList &allowList, const char *name)
+{
+    return allowList.isEmpty() || allowList.contains(QLatin1String(name));
+}
+
+// Times one backend constructor for the startup profiler; a plain
+// append when SOLID_STARTUP_PROFILE is unset. Backends outside the
+// allow list are not constructed at all.
+#define SOLID_LOAD_BACKEND(name, expr) \
+    do { \
+        if (backendAllowed(allowList, name)) { \
+            QElapsedTimer timer; \
+            timer.start(); \
+            m_backends << (expr); \
+            StartupProfiler::record("loadBackend", QStringLiteral(name), timer.nsecsElapsed()); \
+        } \
+    } while (false)
+
 // do *not* use other defines than BUILD_DEVICE_BACKEND_$backend to add
 // the managers, and keep an alphabetical order
 void Solid::ManagerBasePrivate::loadBackends()
 {
-    QString solidFakeXml(QString::fromLocal8Bit(qgetenv("SOLID_FAKEHW")));
+    if (m_backendsLoaded) {
+        return;
+    }
+    m_backendsLoaded = true;
+
+    const auto config = Solid::Config::snapshot();
+    const QString solidFakeXml = config->fakeHwPath;
+    const QStringList allowList = config->backendAllowList;
 
     if (!solidFakeXml.isEmpty()) {
 #ifdef BUILD_DEVICE_BACKEND_fakehw
-        m_backends << new Solid::Backends::Fake::FakeManager(nullptr, solidFakeXml);
+        SOLID_LOAD_BACKEND("fakehw", new Solid::Backends::Fake::FakeManager(nullptr, solidFakeXml));
 #endif
     } else {
 #ifdef BUILD_DEVICE_BACKEND_fstab
-        m_backends << new Solid::Backends::Fstab::FstabManager(nullptr);
+        SOLID_LOAD_BACKEND("fstab", new Solid::Backends::Fstab::FstabManager(nullptr));
 #endif
 #ifdef BUILD_DEVICE_BACKEND_hal
-        m_backends << new Solid::Backends::Hal::HalManager(nullptr);
+        SOLID_LOAD_BACKEND("hal", new Solid::Backends::Hal::HalManager(nullptr));
 #endif
 #ifdef BUILD_DEVICE_BACKEND_imobile
-        m_backends << new Solid::Backends::IMobile::Manager(nullptr);
+        SOLID_LOAD_BACKEND("imobile", new Solid::Backends::IMobile::Manager(nullptr));
 #endif
 #ifdef BUILD_DEVICE_BACKEND_iokit
-        m_backends << new Solid::Backends::IOKit::IOKitManager(nullptr);
+        SOLID_LOAD_BACKEND("iokit", new Solid::Backends::IOKit::IOKitManager(nullptr));
 #endif
 #ifdef BUILD_DEVICE_BACKEND_udev
-        m_backends << new Solid::Backends::UDev::UDevManager(nullptr);
+        SOLID_LOAD_BACKEND("udev", new Solid::Backends::UDev::UDevManager(nullptr));
 #endif
 #ifdef BUILD_DEVICE_BACKEND_udisks2
-        m_backends << new Solid::Backends::UDisks2::Manager(nullptr);
+        SOLID_LOAD_BACKEND("udisks2", new Solid::Backends::UDisks2::Manager(nullptr));
 #endif
 #ifdef BUILD_DEVICE_BACKEND_upower
-        m_backends << new Solid::Backends::UPower::UPowerManager(nullptr);
+        SOLID_LOAD_BACKEND("upower", new Solid::Backends::UPower::UPowerManager(nullptr));
 #endif
 #ifdef BUILD_DEVICE_BACKEND_win
-        m_backends << new Solid::Backends::Win::WinDeviceManager(nullptr);
+        SOLID_LOAD_BACKEND("win", new Solid::Backends::Win::WinDeviceManager(nullptr));
 #endif
     }
 }
 
+#undef SOLID_LOAD_BACKEND
+
 QList<QObject *> Solid::ManagerBasePrivate::managerBackends() const
 {
     return m_backends;
 }
 
+bool Solid::ManagerBasePrivate::backendsLoaded() const
+{
+    return m_backendsLoaded;
+}
+
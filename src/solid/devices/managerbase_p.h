@@ -22,8 +22,12 @@ public:
 
     QList<QObject *> managerBackends() const;
 
+protected:
+    bool backendsLoaded() const;
+
 private:
     QList<QObject *> m_backends;
+    bool m_backendsLoaded = false;
 };
 }
 
@@ -13,11 +13,12 @@ extern "C"
 
 #include "predicate.h"
 #include "soliddefs_p.h"
+#include "solidstartupprofiler_p.h"
 
 #include <stdlib.h>
 
+#include <QElapsedTimer>
 #include <QStringList>
-#include <QThreadStorage>
 
 namespace Solid
 {
@@ -36,38 +37,48 @@ struct ParsingData {
 }
 }
 
-Q_GLOBAL_STATIC(QThreadStorage<Solid::PredicateParse::ParsingData *>, s_parsingData)
+// The scanner itself is generated reentrant; the parsing data of the
+// innermost running parse is tracked per thread, so concurrent and nested
+// fromString() calls can't clobber each other's state.
+static thread_local Solid::PredicateParse::ParsingData *s_parsingData = nullptr;
 
 Solid::Predicate Solid::Predicate::fromString(const QString &predicate)
 {
-    Solid::PredicateParse::ParsingData *data = new Solid::PredicateParse::ParsingData();
-    s_parsingData->setLocalData(data);
-    data->buffer = predicate.toLatin1();
-    PredicateParse_mainParse(data->buffer.constData());
+    QElapsedTimer profileTimer;
+    profileTimer.start();
+
+    Solid::PredicateParse::ParsingData data;
+    data.buffer = predicate.toLatin1();
+
+    Solid::PredicateParse::ParsingData *previousData = s_parsingData;
+    s_parsingData = &data;
+    PredicateParse_mainParse(data.buffer.constData());
+    s_parsingData = previousData;
+
+    StartupProfiler::recordOnce("predicateCompile", predicate, profileTimer.nsecsElapsed());
+
     Predicate result;
-    if (data->result) {
-        result = Predicate(*data->result);
-        delete data->result;
+    if (data.result) {
+        result = Predicate(*data.result);
+        delete data.result;
     }
-    s_parsingData->setLocalData(nullptr);
     return result;
 }
 
 void PredicateParse_setResult(void *result)
 {
-    Solid::PredicateParse::ParsingData *data = s_parsingData->localData();
-    data->result = (Solid::Predicate *) result;
+    s_parsingData->result = (Solid::Predicate *) result;
 }
 
 void PredicateParse_errorDetected(const char *s)
 {
     qWarning("ERROR from solid predicate parser: %s", s);
-    s_parsingData->localData()->result = nullptr;
+    s_parsingData->result = nullptr;
 }
 
 void PredicateParse_destroy(void *pred)
 {
-    Solid::PredicateParse::ParsingData *data = s_parsingData->localData();
+    Solid::PredicateParse::ParsingData *data = s_parsingData;
     Solid::Predicate *p = (Solid::Predicate *) pred;
     if (p != data->result) {
         delete p;
@@ -119,7 +130,7 @@ void *PredicateParse_newAnd(void *pred1, void *pred2)
 {
     Solid::Predicate *result = new Solid::Predicate();
 
-    Solid::PredicateParse::ParsingData *data = s_parsingData->localData();
+    Solid::PredicateParse::ParsingData *data = s_parsingData;
     Solid::Predicate *p1 = (Solid::Predicate *)pred1;
     Solid::Predicate *p2 = (Solid::Predicate *)pred2;
 
@@ -139,7 +150,7 @@ void *PredicateParse_newOr(void *pred1, void *pred2)
 {
     Solid::Predicate *result = new Solid::Predicate();
 
-    Solid::PredicateParse::ParsingData *data = s_parsingData->localData();
+    Solid::PredicateParse::ParsingData *data = s_parsingData;
     Solid::Predicate *p1 = (Solid::Predicate *)pred1;
     Solid::Predicate *p2 = (Solid::Predicate *)pred2;
 
@@ -212,5 +223,5 @@ void *PredicateParse_appendStringListValue(char *name, void *list)
 void PredicateLexer_unknownToken(const char *text)
 {
     qWarning("ERROR from solid predicate parser: unrecognized token '%s' in predicate '%s'\n",
-             text, s_parsingData->localData()->buffer.constData());
+             text, s_parsingData->buffer.constData());
 }
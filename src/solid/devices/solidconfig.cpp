@@ -0,0 +1,64 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include "solidconfig_p.h"
+
+#include <QByteArray>
+
+namespace
+{
+struct ConfigHolder {
+    std::shared_ptr<const Solid::Config::Snapshot> current;
+};
+}
+
+Q_GLOBAL_STATIC(ConfigHolder, s_configHolder)
+
+static int intFromEnvironment(const char *name, int defaultValue)
+{
+    bool ok = false;
+    const int value = qEnvironmentVariableIntValue(name, &ok);
+    return ok && value >= 0 ? value : defaultValue;
+}
+
+static std::shared_ptr<const Solid::Config::Snapshot> loadSnapshot()
+{
+    auto snapshot = std::make_shared<Solid::Config::Snapshot>();
+    snapshot->fakeHwPath = QString::fromLocal8Bit(qgetenv("SOLID_FAKEHW"));
+    snapshot->backendAllowList = QString::fromLatin1(qgetenv("SOLID_BACKENDS")).toLower()
+                                     .split(QLatin1Char(','), QString::SkipEmptyParts);
+    snapshot->serveDeviceTable = !qEnvironmentVariableIsEmpty("SOLID_DEVICE_TABLE_SERVE");
+    snapshot->deviceEventBudget = intFromEnvironment("SOLID_DEVICE_EVENT_BUDGET", 20);
+    snapshot->udisks2ChangeDebounceMs = intFromEnvironment("SOLID_UDISKS2_CHANGE_DEBOUNCE", 20);
+    snapshot->udisks2ServiceGraceMs = intFromEnvironment("SOLID_UDISKS2_SERVICE_GRACE", 5000);
+    snapshot->udisks2TripThreshold = intFromEnvironment("SOLID_UDISKS2_TRIP_THRESHOLD", 3);
+    snapshot->udisks2PropertyTimeoutMs = intFromEnvironment("SOLID_UDISKS2_PROPERTY_TIMEOUT", 100);
+    snapshot->udisks2CacheIdleEvictMs = intFromEnvironment("SOLID_UDISKS2_CACHE_IDLE_EVICT", 300000);
+    snapshot->upowerChangeRateLimitMs = intFromEnvironment("SOLID_UPOWER_CHANGE_RATE_LIMIT", 200);
+    return snapshot;
+}
+
+std::shared_ptr<const Solid::Config::Snapshot> Solid::Config::snapshot()
+{
+    ConfigHolder *holder = s_configHolder();
+    std::shared_ptr<const Snapshot> current = std::atomic_load(&holder->current);
+    if (!current) {
+        /* Concurrent first readers may both load; atomic exchange keeps
+         * exactly one of the (identical) snapshots. */
+        current = loadSnapshot();
+        std::shared_ptr<const Snapshot> expected;
+        if (!std::atomic_compare_exchange_strong(&holder->current, &expected, current)) {
+            current = expected;
+        }
+    }
+    return current;
+}
+
+void Solid::Config::reload()
+{
+    ConfigHolder *holder = s_configHolder();
+    std::atomic_store(&holder->current, loadSnapshot());
+}
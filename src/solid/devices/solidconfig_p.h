@@ -0,0 +1,81 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#ifndef SOLID_SOLIDCONFIG_P_H
+#define SOLID_SOLIDCONFIG_P_H
+
+#include <QString>
+#include <QStringList>
+
+#include <memory>
+
+namespace Solid
+{
+/**
+ * Read-mostly snapshot of Solid's process configuration.
+ *
+ * The tuning knobs used to be read from the environment at the point of
+ * use, some of them inside per-device or per-event code paths. All of
+ * them are parsed once into an immutable Snapshot instead; readers
+ * atomically load the current snapshot and never touch getenv or the
+ * filesystem on a hot path. A new snapshot is published atomically by
+ * reload(), which the tests use after changing the environment — in
+ * production the environment is fixed at process start anyway.
+ */
+namespace Config
+{
+struct Snapshot {
+    /** Path of the fake hardware fixture (SOLID_FAKEHW); when set, only
+     * the fake backend is loaded. */
+    QString fakeHwPath;
+    /** Backends this process may load, by name (SOLID_BACKENDS, a
+     * comma-separated list like "upower,udisks2"); empty means all
+     * compiled-in backends. Lets minimal consumers such as a battery
+     * applet skip constructing the storage backends entirely. */
+    QStringList backendAllowList;
+    /** Whether this process publishes the shared device table
+     * (SOLID_DEVICE_TABLE_SERVE); see devicetableipc_p.h. */
+    bool serveDeviceTable;
+    /** Admission budget for hotplug events per device and window
+     * (SOLID_DEVICE_EVENT_BUDGET, 0 disables the quarantine). */
+    int deviceEventBudget;
+    /** Merge window for udisks2 PropertiesChanged fan-out in
+     * milliseconds (SOLID_UDISKS2_CHANGE_DEBOUNCE). */
+    int udisks2ChangeDebounceMs;
+    /** Grace period before a vanished udisks2 service tears the device
+     * cache down, in milliseconds (SOLID_UDISKS2_SERVICE_GRACE). */
+    int udisks2ServiceGraceMs;
+    /** Consecutive timeouts tripping the udisks2 circuit breaker
+     * (SOLID_UDISKS2_TRIP_THRESHOLD, 0 disables the breaker). */
+    int udisks2TripThreshold;
+    /** Upper bound for blocking udisks2 property reads in milliseconds
+     * (SOLID_UDISKS2_PROPERTY_TIMEOUT, 0 falls back to the D-Bus
+     * default). Mount/unmount/eject operations are not affected. */
+    int udisks2PropertyTimeoutMs;
+    /** Idle time after which a udisks2 backend's property cache is
+     * dropped, in milliseconds (SOLID_UDISKS2_CACHE_IDLE_EVICT,
+     * 0 disables the sweeper). */
+    int udisks2CacheIdleEvictMs;
+    /** Minimum spacing between upower changed() emissions in
+     * milliseconds (SOLID_UPOWER_CHANGE_RATE_LIMIT, 0 disables). */
+    int upowerChangeRateLimitMs;
+};
+
+/**
+ * The current configuration snapshot; one atomic load, safe from any
+ * thread. The returned snapshot stays valid even when reload() swaps
+ * in a newer one.
+ */
+std::shared_ptr<const Snapshot> snapshot();
+
+/**
+ * Re-reads the environment and atomically publishes a fresh snapshot.
+ */
+void reload();
+}
+}
+
+#endif
@@ -0,0 +1,70 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include "solidcounters_p.h"
+
+#include <atomic>
+
+namespace Solid
+{
+namespace Counters
+{
+
+static std::atomic<qint64> s_counters[CounterCount];
+
+void add(Counter counter, qint64 delta)
+{
+    s_counters[counter].fetch_add(delta, std::memory_order_relaxed);
+}
+
+void raise(Counter counter, qint64 value)
+{
+    qint64 recorded = s_counters[counter].load(std::memory_order_relaxed);
+    while (value > recorded
+           && !s_counters[counter].compare_exchange_weak(recorded, value, std::memory_order_relaxed)) {
+        // recorded was reloaded by compare_exchange_weak; retry until the
+        // stored high-water mark is at least our observed value.
+    }
+}
+
+void recordDevicePrivateCreated()
+{
+    const qint64 live = s_counters[LiveDevicePrivates].fetch_add(1, std::memory_order_relaxed) + 1;
+    raise(PeakDevicePrivates, live);
+}
+
+void recordDevicePrivateDestroyed()
+{
+    s_counters[LiveDevicePrivates].fetch_sub(1, std::memory_order_relaxed);
+}
+
+QMap<QString, qulonglong> snapshot()
+{
+    static const char *const names[CounterCount] = {
+        "devicesEnumerated",
+        "dbusCallsIssued",
+        "propertyCacheHits",
+        "propertyCacheMisses",
+        "signalsEmitted",
+        "liveDevicePrivates",
+        "peakDevicePrivates",
+        "propertyCacheBytes",
+        "propertyCachesEvicted",
+        "queryTempStrings",
+        "queryBytesEstimated",
+        "queryPeakBytes",
+    };
+
+    QMap<QString, qulonglong> result;
+    for (int i = 0; i < CounterCount; ++i) {
+        result.insert(QString::fromLatin1(names[i]),
+                      qulonglong(s_counters[i].load(std::memory_order_relaxed)));
+    }
+    return result;
+}
+
+}
+}
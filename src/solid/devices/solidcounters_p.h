@@ -0,0 +1,62 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#ifndef SOLID_SOLIDCOUNTERS_P_H
+#define SOLID_SOLIDCOUNTERS_P_H
+
+#include <QMap>
+#include <QString>
+
+namespace Solid
+{
+/**
+ * Process-wide performance counters for the hot paths, maintained with
+ * relaxed atomic increments so the accounting itself stays off the
+ * profile. The aggregated values are surfaced to applications through
+ * DeviceNotifier::performanceCounters().
+ */
+namespace Counters
+{
+enum Counter {
+    DevicesEnumerated,     // devices returned by full enumerations
+    DBusCallsIssued,       // property fetches issued to backends over D-Bus
+    PropertyCacheHits,     // udisks2 property cache hits
+    PropertyCacheMisses,   // udisks2 property cache misses
+    SignalsEmitted,        // add/remove notifications delivered
+    LiveDevicePrivates,    // currently registered DevicePrivate objects
+    PeakDevicePrivates,    // high-water mark of LiveDevicePrivates
+    PropertyCacheBytes,    // estimated live bytes held by the udisks2 property caches
+    PropertyCachesEvicted, // idle property caches dropped by the sweeper
+    QueryTempStrings,      // temporary UDI strings materialised by queries
+    QueryBytesEstimated,   // estimated transient bytes across all queries
+    QueryPeakBytes,        // largest single-query transient estimate
+    CounterCount
+};
+
+void add(Counter counter, qint64 delta = 1);
+
+/**
+ * Pushes @p counter up to @p value if the recorded value is below it;
+ * used for high-water marks like QueryPeakBytes.
+ */
+void raise(Counter counter, qint64 value);
+
+/**
+ * Increments LiveDevicePrivates and pushes PeakDevicePrivates up if the
+ * new value exceeds the recorded high-water mark.
+ */
+void recordDevicePrivateCreated();
+void recordDevicePrivateDestroyed();
+
+/**
+ * Returns a snapshot of all counters, keyed by stable lowerCamelCase
+ * names suitable for telemetry.
+ */
+QMap<QString, qulonglong> snapshot();
+}
+}
+
+#endif
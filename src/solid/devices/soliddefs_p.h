@@ -26,4 +26,26 @@
         t->Method; \
     }
 
+// Variants for frontends built on DeviceInterfacePrivate: the qobject_cast
+// is resolved once per interface type and cached in the private class, so
+// repeated getters skip the RTTI walk.
+
+#define return_SOLID_IFACE_CALL(IfaceType, Private, Default, Method) \
+    IfaceType *t = (Private)->backendIface<IfaceType>(); \
+    if (t!=nullptr) \
+    { \
+        return t->Method; \
+    } \
+    else \
+    { \
+        return Default; \
+    }
+
+#define SOLID_IFACE_CALL(IfaceType, Private, Method) \
+    IfaceType *t = (Private)->backendIface<IfaceType>(); \
+    if (t!=nullptr) \
+    { \
+        t->Method; \
+    }
+
 #endif
@@ -6,10 +6,20 @@
 
 #include <solid/solidnamespace.h>
 
+#include <QMap>
+
 static int registerSolidMetaTypes()
 {
     qRegisterMetaType<Solid::ErrorType>();
 
+    /* The property-change payload carried by GenericInterface's
+     * propertyChanged(). Queued (cross-thread) delivery needs the
+     * registration; the map itself is implicitly shared, so however many
+     * receivers are connected, their queued events all reference the one
+     * allocation the emitting backend built. Receivers keep it that way
+     * by taking the map by const reference. */
+    qRegisterMetaType<QMap<QString, int> >("QMap<QString,int>");
+
     return 0; // something
 }
 
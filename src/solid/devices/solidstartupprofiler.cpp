@@ -0,0 +1,119 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include "solidstartupprofiler_p.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSet>
+#include <QVector>
+
+#include <cstdio>
+
+namespace
+{
+struct PhaseEntry {
+    QString phase;
+    QString detail;
+    qint64 startedAtNsecs; // relative to the first recorded phase
+    qint64 durationNsecs;
+};
+
+struct ProfilerState {
+    QMutex mutex;
+    QElapsedTimer sinceFirstRecord;
+    QVector<PhaseEntry> entries;
+    QSet<QString> seenOnce;
+    bool dumpRegistered = false;
+};
+}
+
+Q_GLOBAL_STATIC(ProfilerState, s_state)
+
+bool Solid::StartupProfiler::enabled()
+{
+    static const bool value = !qEnvironmentVariableIsEmpty("SOLID_STARTUP_PROFILE");
+    return value;
+}
+
+static void dumpReport()
+{
+    const QString report = Solid::StartupProfiler::report();
+    if (!report.isEmpty()) {
+        fprintf(stderr, "%s", qPrintable(report));
+    }
+}
+
+void Solid::StartupProfiler::record(const char *phase, const QString &detail, qint64 nsecs)
+{
+    if (!enabled()) {
+        return;
+    }
+
+    ProfilerState *state = s_state();
+    QMutexLocker locker(&state->mutex);
+
+    if (!state->sinceFirstRecord.isValid()) {
+        state->sinceFirstRecord.start();
+    }
+    if (!state->dumpRegistered) {
+        state->dumpRegistered = true;
+        qAddPostRoutine(dumpReport);
+    }
+
+    PhaseEntry entry;
+    entry.phase = QString::fromLatin1(phase);
+    entry.detail = detail;
+    // The first phase began before the reference timer existed, so clamp
+    // instead of reporting a negative offset for it.
+    entry.startedAtNsecs = qMax(qint64(0), state->sinceFirstRecord.nsecsElapsed() - nsecs);
+    entry.durationNsecs = nsecs;
+    state->entries.append(entry);
+}
+
+void Solid::StartupProfiler::recordOnce(const char *phase, const QString &detail, qint64 nsecs)
+{
+    if (!enabled()) {
+        return;
+    }
+
+    ProfilerState *state = s_state();
+    {
+        QMutexLocker locker(&state->mutex);
+        const QString key = QString::fromLatin1(phase) + QLatin1Char('|') + detail;
+        if (state->seenOnce.contains(key)) {
+            return;
+        }
+        state->seenOnce.insert(key);
+    }
+
+    record(phase, detail, nsecs);
+}
+
+QString Solid::StartupProfiler::report()
+{
+    if (!enabled()) {
+        return QString();
+    }
+
+    ProfilerState *state = s_state();
+    QMutexLocker locker(&state->mutex);
+
+    if (state->entries.isEmpty()) {
+        return QString();
+    }
+
+    QString result = QStringLiteral("solid: startup profile\n");
+    for (const PhaseEntry &entry : qAsConst(state->entries)) {
+        result += QStringLiteral("solid:   +%1 ms  %2 ms  %3 (%4)\n")
+                      .arg(entry.startedAtNsecs / 1000000.0, 9, 'f', 3)
+                      .arg(entry.durationNsecs / 1000000.0, 8, 'f', 3)
+                      .arg(entry.phase, entry.detail);
+    }
+    return result;
+}
@@ -0,0 +1,53 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#ifndef SOLID_SOLIDSTARTUPPROFILER_P_H
+#define SOLID_SOLIDSTARTUPPROFILER_P_H
+
+#include <QString>
+
+namespace Solid
+{
+/**
+ * Opt-in profiler for the library's own startup phases.
+ *
+ * When SOLID_STARTUP_PROFILE is set in the environment, the hot
+ * initialization paths record how long each phase took — every backend
+ * constructor in loadBackends(), the first enumeration against each
+ * backend, the first compile of each predicate — and a summary is
+ * printed to stderr when the application exits. With the variable
+ * unset, every hook is a single early-returning function call.
+ *
+ * Timestamps are recorded relative to the first phase, so the summary
+ * reads as a timeline of where Solid's init time went without having
+ * to attach strace or a full profiler.
+ */
+namespace StartupProfiler
+{
+bool enabled();
+
+/**
+ * Records one completed phase of @p nsecs duration. Thread-safe.
+ */
+void record(const char *phase, const QString &detail, qint64 nsecs);
+
+/**
+ * Like record(), but only the first occurrence of a given
+ * (phase, detail) pair is kept — used for the per-backend first
+ * enumeration and per-query first compile, where only the cold run is
+ * interesting.
+ */
+void recordOnce(const char *phase, const QString &detail, qint64 nsecs);
+
+/**
+ * The formatted summary recorded so far; also printed automatically at
+ * application exit.
+ */
+QString report();
+}
+}
+
+#endif
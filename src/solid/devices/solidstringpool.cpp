@@ -0,0 +1,85 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include "solidstringpool_p.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSet>
+
+namespace Solid
+{
+namespace StringPool
+{
+
+// Strings longer than this pass through unpooled: duplication is a
+// short-string phenomenon (filesystem types, vendor names, bus names),
+// and pooling long one-offs would pin them for the process lifetime.
+static const int maxPooledLength = 64;
+
+// Upper bound on distinct pooled entries; the realistic working set
+// (a few strings per interface across the installed hardware) is far
+// below it.
+static const int maxPoolEntries = 4096;
+
+struct Pool {
+    QMutex mutex;
+    QSet<QString> entries;
+};
+
+Q_GLOBAL_STATIC(Pool, s_pool)
+
+QString intern(const QString &string)
+{
+    if (string.isEmpty() || string.size() > maxPooledLength || s_pool.isDestroyed()) {
+        return string;
+    }
+
+    Pool *pool = s_pool();
+    QMutexLocker locker(&pool->mutex);
+
+    const auto it = pool->entries.constFind(string);
+    if (it != pool->entries.constEnd()) {
+        // The returned copy shares the pooled buffer.
+        return *it;
+    }
+
+    if (pool->entries.size() < maxPoolEntries) {
+        pool->entries.insert(string);
+    }
+    return string;
+}
+
+QVariant internVariant(const QVariant &value)
+{
+    switch (value.userType()) {
+    case QMetaType::QString: {
+        const QString original = value.toString();
+        const QString interned = intern(original);
+        if (interned.constData() == original.constData()) {
+            return value;
+        }
+        return QVariant(interned);
+    }
+    case QMetaType::QStringList: {
+        QStringList list = value.toStringList();
+        bool changed = false;
+        for (QString &entry : list) {
+            const QString interned = intern(entry);
+            if (interned.constData() != entry.constData()) {
+                entry = interned;
+                changed = true;
+            }
+        }
+        return changed ? QVariant(list) : value;
+    }
+    default:
+        return value;
+    }
+}
+
+}
+}
@@ -0,0 +1,48 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#ifndef SOLID_SOLIDSTRINGPOOL_P_H
+#define SOLID_SOLIDSTRINGPOOL_P_H
+
+#include <QString>
+#include <QVariant>
+
+namespace Solid
+{
+/**
+ * Process-wide deduplication of property string values.
+ *
+ * The backends demarshal the same short strings over and over — "ext4",
+ * "disk", vendor and model names — once per device that carries them.
+ * Routing freshly demarshalled values through the pool makes every
+ * occurrence share one QString buffer instead of holding its own copy,
+ * which is where most of the property-cache duplication on large device
+ * populations comes from.
+ *
+ * The pool is bounded: once full it keeps deduplicating against the
+ * entries it already holds but admits no new ones, so a hostile or
+ * pathological property stream cannot grow it without limit. Long
+ * strings are passed through untouched — they are rarely repeated and
+ * pooling them would pin their memory for the process lifetime.
+ */
+namespace StringPool
+{
+/**
+ * Returns a copy of @p string sharing the pooled buffer when an equal
+ * string was seen before; otherwise returns @p string itself (and
+ * remembers it while the pool has room). Thread-safe.
+ */
+QString intern(const QString &string);
+
+/**
+ * Interns the string payloads inside @p value: QString values and the
+ * elements of QStringList values. Other types are returned unchanged.
+ */
+QVariant internVariant(const QVariant &value);
+}
+}
+
+#endif
@@ -0,0 +1,54 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#ifndef SOLID_SOLIDTRACE_P_H
+#define SOLID_SOLIDTRACE_P_H
+
+#include <config-solid.h>
+
+/*
+ * Static userspace tracepoints (USDT) for the hot paths, so perf, bpftrace
+ * and lttng can attribute hotplug and query latency on production builds
+ * without recompiling: e.g. `perf probe sdt_solid:device_added`.
+ *
+ * The probes compile to a single nop when not attached, and to nothing at
+ * all on platforms without <sys/sdt.h>. Probe string arguments must stay
+ * valid for the duration of the statement only.
+ */
+
+#if HAVE_SYS_SDT_H
+
+#include <QElapsedTimer>
+#include <sys/sdt.h>
+
+#define SOLID_PROBE1(name, a1) DTRACE_PROBE1(solid, name, a1)
+#define SOLID_PROBE2(name, a1, a2) DTRACE_PROBE2(solid, name, a1, a2)
+#define SOLID_PROBE3(name, a1, a2, a3) DTRACE_PROBE3(solid, name, a1, a2, a3)
+
+/* Starts the timer feeding a duration-carrying probe further down. */
+#define SOLID_TRACE_TIMER(timer) \
+    QElapsedTimer timer; \
+    timer.start()
+#define SOLID_TRACE_NSECS(timer) (qint64(timer.nsecsElapsed()))
+
+#else
+
+#define SOLID_PROBE1(name, a1) \
+    do { \
+    } while (false)
+#define SOLID_PROBE2(name, a1, a2) \
+    do { \
+    } while (false)
+#define SOLID_PROBE3(name, a1, a2, a3) \
+    do { \
+    } while (false)
+
+#define SOLID_TRACE_TIMER(timer)
+#define SOLID_TRACE_NSECS(timer) 0
+
+#endif
+
+#endif
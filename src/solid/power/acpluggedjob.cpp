@@ -6,6 +6,7 @@
 
 #include "acpluggedjob.h"
 #include "acpluggedjob_p.h"
+#include "power.h"
 #include "powerbackendloader.h"
 #include "backends/abstractacpluggedjob.h"
 
@@ -27,6 +28,16 @@ AcPluggedJob::AcPluggedJob(QObject* parent) : Job(*new AcPluggedJobPrivate(), pa
 void AcPluggedJob::doStart()
 {
     Q_D(AcPluggedJob);
+
+    // the Power singleton keeps the state current from the backend's change
+    // notifications; answer from memory when it already knows
+    if (Power::isAcPluggedCached()) {
+        d->plugged = Power::cachedAcPluggedState();
+        d->backendJobFinished = true;
+        emitResult();
+        return;
+    }
+
     d->backendJob = PowerBackendLoader::AcPluggedJob();
     connect(d->backendJob, &AbstractAcPluggedJob::result, [this, d]() {
         d->backendJobFinished = true;
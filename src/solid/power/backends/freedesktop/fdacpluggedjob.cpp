@@ -5,11 +5,9 @@
 */
 
 #include "fdacpluggedjob.h"
+#include "fdpowerconnection.h"
 
-
-#include <QDBusConnection>
-#include <QDBusMessage>
-#include <QDBusVariant>
+#include <QDBusError>
 
 using namespace Solid;
 
@@ -21,28 +19,36 @@ FDAcPluggedJob::FDAcPluggedJob(QObject* parent)
 
 void FDAcPluggedJob::doStart()
 {
-    QDBusMessage msg = QDBusMessage::createMethodCall(
-            QStringLiteral("org.freedesktop.UPower"),
-            QStringLiteral("/org/freedesktop/UPower"),
-            QStringLiteral("org.freedesktop.DBus.Properties"),
-            QStringLiteral("Get"));
-
-    msg << QStringLiteral("org.freedesktop.UPower");
-    msg << QStringLiteral("OnBattery");
-
-    QDBusConnection::systemBus().callWithCallback(msg, this, SLOT(slotDBusReply(QDBusMessage)), SLOT(slotDBusError(QDBusError)));
+    FDPowerConnection *connection = FDPowerConnection::instance();
+
+    // The shared connection answers from its cache once any job in the
+    // process has resolved the state; only the first one pays a bus
+    // round trip.
+    if (connection->isAcPluggedKnown()) {
+        m_isPlugged = connection->isAcPlugged();
+        emitResult();
+        return;
+    }
+
+    connect(connection, SIGNAL(acPluggedResolved(bool)),
+            this, SLOT(slotAcPluggedResolved(bool)));
+    connect(connection, SIGNAL(fetchError(QDBusError)),
+            this, SLOT(slotDBusError(QDBusError)));
+    connection->fetchAcPluggedState();
 }
 
-void FDAcPluggedJob::slotDBusReply(const QDBusMessage & msg)
+void FDAcPluggedJob::slotAcPluggedResolved(bool plugged)
 {
-    Q_ASSERT(!msg.arguments().isEmpty());
+    FDPowerConnection::instance()->disconnect(this);
 
-    m_isPlugged = !msg.arguments().first().value<QDBusVariant>().variant().toBool();
+    m_isPlugged = plugged;
     emitResult();
 }
 
 void FDAcPluggedJob::slotDBusError(const QDBusError& error)
 {
+    FDPowerConnection::instance()->disconnect(this);
+
     setError(error.type());
     setErrorText(error.message());
     emitResult();
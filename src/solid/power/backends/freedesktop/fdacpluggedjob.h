@@ -10,8 +10,6 @@
 #include "backends/abstractacpluggedjob.h"
 
 class QDBusError;
-class QDBusMessage;
-class QDBusPendingCallWatcher;
 namespace Solid
 {
 class FDAcPluggedJob : public AbstractAcPluggedJob
@@ -24,7 +22,7 @@ public:
 private Q_SLOTS:
     void doStart() override;
 
-    void slotDBusReply(const QDBusMessage &msg);
+    void slotAcPluggedResolved(bool plugged);
     void slotDBusError(const QDBusError &error);
 
 private:
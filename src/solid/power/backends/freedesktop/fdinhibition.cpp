@@ -13,25 +13,120 @@
 #include <QDebug>
 #include <QCoreApplication>
 #include <QDBusConnection>
+#include <QDBusMessage>
 #include <QDBusUnixFileDescriptor>
+#include <QHash>
+#include <QPair>
+#include <QTimer>
 
 using namespace Solid;
 
-FdInhibition::FdInhibition(Power::InhibitionTypes inhibitions, const QString &description, QObject* parent)
-    : AbstractInhibition(parent)
-    , m_state(Inhibition::Stopped)
-    , m_description(description)
-    , m_inhibitions(inhibitions)
+static int releaseGraceMs()
+{
+    if (qEnvironmentVariableIsSet("SOLID_POWER_INHIBITION_GRACE")) {
+        return qEnvironmentVariableIntValue("SOLID_POWER_INHIBITION_GRACE");
+    }
+    return 5000;
+}
+
+namespace Solid
+{
+
+/* One logind inhibitor shared by every FdInhibition asking for the same
+ * states and reason. Callers that take and drop identical inhibitions in
+ * quick succession (a media player on track transitions, say) reuse the
+ * same file descriptor instead of hammering logind, and the last release
+ * is deferred by a short grace window so an immediate re-acquire is free. */
+class FdInhibitionHolder : public QObject
 {
+    Q_OBJECT
+public:
+    typedef QPair<int, QString> Key;
+
+    static FdInhibitionHolder *acquire(Power::InhibitionTypes inhibitions, const QString &description);
+    void release();
+
+    bool isActive() const
+    {
+        return m_fd >= 0;
+    }
+
+Q_SIGNALS:
+    void activeChanged(bool active);
+    void failed();
+
+private Q_SLOTS:
+    void slotDBusReply(const QDBusMessage &msg);
+    void slotDBusError(const QDBusError &error);
+
+private:
+    FdInhibitionHolder(const Key &key, Power::InhibitionTypes inhibitions, const QString &description);
+    ~FdInhibitionHolder() override;
+
+    void startInhibit();
+
+    Key m_key;
+    Power::InhibitionTypes m_inhibitions;
+    QString m_description;
+    int m_fd = -1;
+    int m_refCount = 0;
+    QTimer m_graceTimer;
+};
 
 }
 
-FdInhibition::~FdInhibition()
+static QHash<FdInhibitionHolder::Key, FdInhibitionHolder *> s_holders;
+
+FdInhibitionHolder *FdInhibitionHolder::acquire(Power::InhibitionTypes inhibitions, const QString &description)
 {
-    close(m_fd);
+    const Key key = qMakePair(int(inhibitions), description);
+
+    FdInhibitionHolder *holder = s_holders.value(key);
+    if (!holder) {
+        holder = new FdInhibitionHolder(key, inhibitions, description);
+        s_holders.insert(key, holder);
+        holder->startInhibit();
+    }
+
+    ++holder->m_refCount;
+    holder->m_graceTimer.stop();
+    return holder;
 }
 
-void FdInhibition::start()
+void FdInhibitionHolder::release()
+{
+    if (--m_refCount > 0) {
+        return;
+    }
+
+    // keep the inhibitor alive for a moment; a matching acquire within the
+    // grace window picks it right back up
+    m_graceTimer.start();
+}
+
+FdInhibitionHolder::FdInhibitionHolder(const Key &key, Power::InhibitionTypes inhibitions, const QString &description)
+    : m_key(key)
+    , m_inhibitions(inhibitions)
+    , m_description(description)
+{
+    m_graceTimer.setSingleShot(true);
+    m_graceTimer.setInterval(releaseGraceMs());
+    connect(&m_graceTimer, &QTimer::timeout, this, [this]() {
+        if (m_refCount == 0) {
+            s_holders.remove(m_key);
+            deleteLater();
+        }
+    });
+}
+
+FdInhibitionHolder::~FdInhibitionHolder()
+{
+    if (m_fd >= 0) {
+        close(m_fd);
+    }
+}
+
+void FdInhibitionHolder::startInhibit()
 {
     QDBusMessage msg = QDBusMessage::createMethodCall(
             QStringLiteral("org.freedesktop.login1"),
@@ -49,26 +144,76 @@ void FdInhibition::start()
     QDBusConnection::systemBus().callWithCallback(msg, this, SLOT(slotDBusReply(QDBusMessage)), SLOT(slotDBusError(QDBusError)));
 }
 
+void FdInhibitionHolder::slotDBusReply(const QDBusMessage &msg)
+{
+    m_fd = msg.arguments().first().value<QDBusUnixFileDescriptor>().fileDescriptor();
+    Q_EMIT activeChanged(true);
+}
+
+void FdInhibitionHolder::slotDBusError(const QDBusError &error)
+{
+    qDebug() << error.message();
+    // the attached inhibitions drop their reference on failure, so the next
+    // start() creates a fresh holder and retries the call
+    Q_EMIT failed();
+}
+
+FdInhibition::FdInhibition(Power::InhibitionTypes inhibitions, const QString &description, QObject* parent)
+    : AbstractInhibition(parent)
+    , m_holder(nullptr)
+    , m_state(Inhibition::Stopped)
+    , m_description(description)
+    , m_inhibitions(inhibitions)
+{
+
+}
+
+FdInhibition::~FdInhibition()
+{
+    stop();
+}
+
+void FdInhibition::start()
+{
+    if (m_holder) {
+        return;
+    }
+
+    m_holder = FdInhibitionHolder::acquire(m_inhibitions, m_description);
+    if (m_holder->isActive()) {
+        setState(Inhibition::Started);
+        return;
+    }
+
+    connect(m_holder, &FdInhibitionHolder::activeChanged, this, &FdInhibition::holderActiveChanged);
+    connect(m_holder, &FdInhibitionHolder::failed, this, &FdInhibition::holderFailed);
+}
+
 void FdInhibition::stop()
 {
-    close(m_fd);
+    if (m_holder) {
+        disconnect(m_holder, nullptr, this, nullptr);
+        m_holder->release();
+        m_holder = nullptr;
+    }
     setState(Inhibition::Stopped);
 }
 
-void FdInhibition::setDescription(const QString& description)
+void FdInhibition::holderActiveChanged(bool active)
 {
-    m_description = description;
+    setState(active ? Inhibition::Started : Inhibition::Stopped);
 }
 
-void FdInhibition::slotDBusReply(const QDBusMessage& msg)
+void FdInhibition::holderFailed()
 {
-    m_fd = msg.arguments().first().value<QDBusUnixFileDescriptor>().fileDescriptor();
-    setState(Inhibition::Started);
+    disconnect(m_holder, nullptr, this, nullptr);
+    m_holder->release();
+    m_holder = nullptr;
 }
 
-void FdInhibition::slotDBusError(const QDBusError& error)
+void FdInhibition::setDescription(const QString& description)
 {
-    qDebug() << error.message();
+    m_description = description;
 }
 
 void FdInhibition::setState(const Inhibition::State& state)
@@ -86,3 +231,4 @@ Inhibition::State FdInhibition::state() const
     return m_state;
 }
 
+#include "fdinhibition.moc"
@@ -13,10 +13,11 @@
 #include "solid/power.h"
 
 #include <qglobal.h>
-#include <QDBusMessage>
 
 namespace Solid
 {
+class FdInhibitionHolder;
+
 class FdInhibition : public AbstractInhibition
 {
     Q_OBJECT
@@ -31,13 +32,13 @@ public:
     void setDescription(const QString &description);
 
 private Q_SLOTS:
-    void slotDBusReply(const QDBusMessage &msg);
-    void slotDBusError(const QDBusError &error);
+    void holderActiveChanged(bool active);
+    void holderFailed();
 
 private:
     void setState(const Inhibition::State &state);
 
-    int m_fd;
+    FdInhibitionHolder *m_holder;
     Inhibition::State m_state;
     QString m_description;
     Power::InhibitionTypes m_inhibitions;
@@ -0,0 +1,116 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include "fdpowerconnection.h"
+
+#include <QDBusConnection>
+#include <QDBusError>
+#include <QDBusMessage>
+#include <QDBusVariant>
+
+using namespace Solid;
+
+Q_GLOBAL_STATIC(FDPowerConnection, globalPowerConnection)
+
+FDPowerConnection *FDPowerConnection::instance()
+{
+    return globalPowerConnection;
+}
+
+FDPowerConnection::FDPowerConnection()
+{
+    auto conn = QDBusConnection::systemBus();
+    conn.connect(QStringLiteral("org.freedesktop.UPower"),
+                 QStringLiteral("/org/freedesktop/UPower"),
+                 QStringLiteral("org.freedesktop.DBus.Properties"),
+                 QStringLiteral("PropertiesChanged"),
+                 this,
+                 SLOT(upowerPropertiesChanged(QString,QVariantMap,QStringList))
+                 );
+
+    conn.connect(QStringLiteral("org.freedesktop.login1"),
+                 QStringLiteral("/org/freedesktop/login1"),
+                 QStringLiteral("org.freedesktop.login1.Manager"),
+                 QStringLiteral("PrepareForSleep"),
+                 this,
+                 SLOT(login1Resuming(bool))
+                 );
+}
+
+bool FDPowerConnection::isAcPluggedKnown() const
+{
+    return m_acPluggedKnown;
+}
+
+bool FDPowerConnection::isAcPlugged() const
+{
+    return m_acPlugged;
+}
+
+void FDPowerConnection::fetchAcPluggedState()
+{
+    if (m_fetchInFlight) {
+        // Every waiter is answered by the one acPluggedResolved() the
+        // in-flight call produces.
+        return;
+    }
+    m_fetchInFlight = true;
+
+    QDBusMessage msg = QDBusMessage::createMethodCall(
+            QStringLiteral("org.freedesktop.UPower"),
+            QStringLiteral("/org/freedesktop/UPower"),
+            QStringLiteral("org.freedesktop.DBus.Properties"),
+            QStringLiteral("Get"));
+
+    msg << QStringLiteral("org.freedesktop.UPower");
+    msg << QStringLiteral("OnBattery");
+
+    QDBusConnection::systemBus().callWithCallback(msg, this, SLOT(slotDBusReply(QDBusMessage)), SLOT(slotDBusError(QDBusError)));
+}
+
+void FDPowerConnection::slotDBusReply(const QDBusMessage &msg)
+{
+    Q_ASSERT(!msg.arguments().isEmpty());
+
+    m_fetchInFlight = false;
+
+    // A Get reply describes one moment, so it answers the waiting jobs
+    // without populating the cache; only change notifications do that,
+    // since UPower keeps those coming for every transition.
+    Q_EMIT acPluggedResolved(!msg.arguments().first().value<QDBusVariant>().variant().toBool());
+}
+
+void FDPowerConnection::slotDBusError(const QDBusError &error)
+{
+    m_fetchInFlight = false;
+    Q_EMIT fetchError(error);
+}
+
+void FDPowerConnection::upowerPropertiesChanged(const QString &interface, const QVariantMap &changedProperties, const QStringList &invalidated)
+{
+    Q_UNUSED(invalidated)
+
+    if (interface != QLatin1String("org.freedesktop.UPower")) {
+        return;
+    }
+
+    if (changedProperties.contains(QStringLiteral("OnBattery"))) {
+        m_acPlugged = !changedProperties.value(QStringLiteral("OnBattery")).toBool();
+        m_acPluggedKnown = true;
+
+        Q_EMIT acPluggedResolved(m_acPlugged);
+        Q_EMIT acPluggedChanged(m_acPlugged);
+    }
+}
+
+void FDPowerConnection::login1Resuming(bool active)
+{
+    if (active) {
+        Q_EMIT aboutToSuspend();
+    } else {
+        Q_EMIT resumeFromSuspend();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+/*
+    SPDX-FileCopyrightText: 2021 The KDE Solid contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#ifndef FD_POWER_CONNECTION_H
+#define FD_POWER_CONNECTION_H
+
+#include <QObject>
+#include <QVariantMap>
+
+class QDBusError;
+class QDBusMessage;
+namespace Solid
+{
+/**
+ * Process-wide subscription point for the UPower and logind bus signals,
+ * holding the power state the freedesktop backend reads.
+ *
+ * Jobs are short-lived by design — a session easily creates dozens per
+ * minute — and each FDAcPluggedJob used to issue its own property Get
+ * round trip, while every FDPowerNotifier installed its own pair of bus
+ * match rules. This object subscribes once, answers repeated state
+ * queries from its cache, and refreshes the cache from the
+ * PropertiesChanged traffic it is subscribed to anyway, so only the very
+ * first query in a process pays a bus round trip.
+ */
+class FDPowerConnection : public QObject
+{
+    Q_OBJECT
+public:
+    /* Public only so Q_GLOBAL_STATIC can construct it; use instance(). */
+    FDPowerConnection();
+
+    static FDPowerConnection *instance();
+
+    /**
+     * Whether the AC plugged state can be answered from the cache. The
+     * cache is only populated from PropertiesChanged notifications: UPower
+     * announces every change, so a value learnt that way stays valid,
+     * while a plain Get reply only describes one moment.
+     */
+    bool isAcPluggedKnown() const;
+    bool isAcPlugged() const;
+
+    /**
+     * Starts resolving the AC plugged state. Completion is announced
+     * through acPluggedResolved(); a concurrent fetch is shared, so any
+     * number of jobs asking within one round trip cost one bus call.
+     */
+    void fetchAcPluggedState();
+
+Q_SIGNALS:
+    /**
+     * The AC plugged state is known, either because a fetch completed or
+     * because a change notification arrived.
+     */
+    void acPluggedResolved(bool plugged);
+
+    /**
+     * A change notification for the AC plugged state arrived.
+     */
+    void acPluggedChanged(bool plugged);
+
+    void aboutToSuspend();
+    void resumeFromSuspend();
+
+    void fetchError(const QDBusError &error);
+
+private Q_SLOTS:
+    void slotDBusReply(const QDBusMessage &msg);
+    void slotDBusError(const QDBusError &error);
+    void upowerPropertiesChanged(const QString &interface, const QVariantMap &changedProperties, const QStringList &invalidated);
+    void login1Resuming(bool active);
+
+private:
+    Q_DISABLE_COPY(FDPowerConnection)
+
+    bool m_acPlugged = false;
+    bool m_acPluggedKnown = false;
+    bool m_fetchInFlight = false;
+};
+}
+
+#endif // FD_POWER_CONNECTION_H
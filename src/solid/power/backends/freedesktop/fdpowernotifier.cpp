@@ -6,51 +6,18 @@
 */
 
 #include "fdpowernotifier.h"
-
-#include <QDebug>
-#include <QDBusConnection>
+#include "fdpowerconnection.h"
 
 Solid::FDPowerNotifier::FDPowerNotifier(QObject* parent): PowerNotifier(parent)
 {
-    auto conn = QDBusConnection::systemBus();
-    conn.connect(QStringLiteral("org.freedesktop.UPower"),
-                 QStringLiteral("/org/freedesktop/UPower"),
-                 QStringLiteral("org.freedesktop.DBus.Properties"),
-                 QStringLiteral("PropertiesChanged"),
-                 this,
-                 SLOT(upowerPropertiesChanged(QString,QVariantMap,QStringList))
-                 );
-
-    conn.connect(QStringLiteral("org.freedesktop.login1"),
-                 QStringLiteral("/org/freedesktop/login1"),
-                 QStringLiteral("org.freedesktop.login1.Manager"),
-                 QStringLiteral("PrepareForSleep"),
-                 this,
-                 SLOT(login1Resuming(bool))
-                 );
-}
-
-void Solid::FDPowerNotifier::upowerPropertiesChanged(const QString &interface, const QVariantMap &changedProperties, const QStringList &invalidated)
-{
-    if (interface != QStringLiteral("org.freedesktop.UPower")) {
-        return;
-    }
-
-    if (changedProperties.contains(QStringLiteral("OnBattery"))) {
-        Q_EMIT acPluggedChanged(!changedProperties.value(QStringLiteral("OnBattery")).toBool());
-    }
-
-    //Just for debug purposes
-    if (!invalidated.isEmpty()) {
-        qDebug() << "Invalidated" << invalidated;
-    }
-}
-
-void Solid::FDPowerNotifier::login1Resuming(bool active)
-{
-    if (active) {
-        Q_EMIT aboutToSuspend();
-    } else {
-        Q_EMIT resumeFromSuspend();
-    }
+    // The shared connection owns the bus match rules and the state cache;
+    // the notifier merely relays its change signals, so additional
+    // notifier instances don't multiply the subscriptions.
+    FDPowerConnection *connection = FDPowerConnection::instance();
+    connect(connection, &FDPowerConnection::acPluggedChanged,
+            this, &PowerNotifier::acPluggedChanged);
+    connect(connection, &FDPowerConnection::aboutToSuspend,
+            this, &PowerNotifier::aboutToSuspend);
+    connect(connection, &FDPowerConnection::resumeFromSuspend,
+            this, &PowerNotifier::resumeFromSuspend);
 }
@@ -8,7 +8,6 @@
 #define SOLID_FD_POWER_NOTIFIER_H
 
 #include "backends/powernotifier.h"
-#include <QStringList>
 
 namespace Solid
 {
@@ -17,10 +16,6 @@ class FDPowerNotifier : public PowerNotifier
     Q_OBJECT
 public:
     explicit FDPowerNotifier(QObject* parent = nullptr);
-
-private Q_SLOTS:
-    void upowerPropertiesChanged(const QString& interface, const QVariantMap& changedProperties, const QStringList& invalidated);
-    void login1Resuming(bool active);
 };
 }
 
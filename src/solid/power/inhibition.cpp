@@ -7,12 +7,19 @@
 #include "inhibition.h"
 #include "backends/abstractinhibition.h"
 
+#include <QAtomicInt>
+
 using namespace Solid;
 
+// Atomic since Inhibition objects may live on different threads; each
+// instance contributes at most one to the count.
+static QAtomicInt s_activeInhibitions;
+
 class Solid::InhibitionPrivate
 {
 public:
     AbstractInhibition *backendObject;
+    bool counted = false;
 };
 
 Inhibition::Inhibition(AbstractInhibition* backend, QObject* parent)
@@ -20,11 +27,29 @@ Inhibition::Inhibition(AbstractInhibition* backend, QObject* parent)
     , d_ptr(new InhibitionPrivate)
 {
     d_ptr->backendObject = backend;
+
+    if (backend->state() == Started) {
+        d_ptr->counted = true;
+        s_activeInhibitions.ref();
+    }
+    connect(d_ptr->backendObject, &AbstractInhibition::stateChanged, this, [this](Inhibition::State state) {
+        if (state == Started && !d_ptr->counted) {
+            d_ptr->counted = true;
+            s_activeInhibitions.ref();
+        } else if (state == Stopped && d_ptr->counted) {
+            d_ptr->counted = false;
+            s_activeInhibitions.deref();
+        }
+    });
+
     connect(d_ptr->backendObject, &AbstractInhibition::stateChanged, this, &Inhibition::stateChanged);
 }
 
 Inhibition::~Inhibition()
 {
+    if (d_ptr->counted) {
+        s_activeInhibitions.deref();
+    }
     delete d_ptr->backendObject;
     delete d_ptr;
 }
@@ -44,3 +69,7 @@ Inhibition::State Inhibition::state() const
     return d_ptr->backendObject->state();
 }
 
+int Inhibition::activeCount()
+{
+    return s_activeInhibitions.loadAcquire();
+}
@@ -53,6 +53,17 @@ public:
      */
     State state() const;
 
+    /**
+     * Returns how many Inhibition objects of this process are currently
+     * in the Started state.
+     *
+     * The count is maintained from the state transitions of the
+     * instances, so reading it is free of any backend round trip.
+     *
+     * @since 5.79
+     */
+    static int activeCount();
+
 public Q_SLOTS:
     /**
      * Stops the inhibition
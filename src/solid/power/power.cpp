@@ -13,6 +13,7 @@
 #include "powerbackendloader.h"
 
 #include "backends/powernotifier.h"
+#include "backends/abstractacpluggedjob.h"
 
 Q_GLOBAL_STATIC(Solid::Power, globalPowerObject)
 
@@ -22,6 +23,8 @@ class Power::Private
 {
 public:
     PowerNotifier *notifier;
+    bool acPluggedCacheValid = false;
+    bool acPlugged = false;
 };
 
 Power* Power::self()
@@ -33,9 +36,33 @@ Power::Power(QObject* parent) : QObject(parent), d(new Private)
 {
     qRegisterMetaType<Solid::Inhibition::State>("Inhibition::State");
     d->notifier = PowerBackendLoader::notifier();
-    connect(d->notifier, &PowerNotifier::acPluggedChanged, this, &Power::acPluggedChanged);
+    // The cache is updated before the public signal fires so slots
+    // connected to acPluggedChanged() already see the new state through
+    // the cached getters. Re-announcements of an unchanged state are
+    // swallowed: a resume from suspend makes the backends re-report
+    // everything, and relaying those would send every client off to its
+    // own re-queries for a transition that never happened.
+    connect(d->notifier, &PowerNotifier::acPluggedChanged, this, [this](bool plugged) {
+        const bool announcement = !d->acPluggedCacheValid || d->acPlugged != plugged;
+        d->acPlugged = plugged;
+        d->acPluggedCacheValid = true;
+        if (announcement) {
+            Q_EMIT acPluggedChanged(plugged);
+        }
+    });
     connect(d->notifier, &PowerNotifier::aboutToSuspend, this, &Power::aboutToSuspend);
     connect(d->notifier, &PowerNotifier::resumeFromSuspend, this, &Power::resumeFromSuspend);
+
+    // prime the cache once; afterwards the notifier keeps it current and
+    // AcPluggedJob can answer from memory
+    AbstractAcPluggedJob *job = PowerBackendLoader::AcPluggedJob();
+    connect(job, &AbstractAcPluggedJob::result, this, [this, job]() {
+        if (!d->acPluggedCacheValid) {
+            d->acPlugged = job->isPlugged();
+            d->acPluggedCacheValid = true;
+        }
+    });
+    job->start();
 }
 
 AcPluggedJob* Power::isAcPlugged(QObject* parent)
@@ -43,6 +70,22 @@ AcPluggedJob* Power::isAcPlugged(QObject* parent)
     return new AcPluggedJob(parent);
 }
 
+bool Power::isAcPluggedCached()
+{
+    return self()->d->acPluggedCacheValid;
+}
+
+bool Power::cachedAcPluggedState()
+{
+    return self()->d->acPlugged;
+}
+
+Power::StateSnapshot Power::stateSnapshot()
+{
+    const Private *d = self()->d;
+    return {d->acPluggedCacheValid, d->acPlugged, Inhibition::activeCount()};
+}
+
 InhibitionJob* Power::inhibit(Power::InhibitionTypes states, const QString& description, QObject* parent)
 {
     InhibitionJob *job = new InhibitionJob(parent);
@@ -70,6 +70,56 @@ public:
      */
     static AcPluggedJob* isAcPlugged(QObject *parent = nullptr);
 
+    /**
+     * Returns whether the AC plugged state is already known.
+     *
+     * The singleton keeps the state current from the backend's change
+     * notifications once it has been determined, so after the first
+     * AcPluggedJob (or shortly after the singleton is created) this
+     * returns true and cachedAcPluggedState() can be used instead of
+     * a job round trip.
+     *
+     * @since 5.79
+     */
+    static bool isAcPluggedCached();
+
+    /**
+     * Returns the last known AC plugged state.
+     *
+     * Only meaningful when isAcPluggedCached() returns true; before the
+     * state has been determined this returns false.
+     *
+     * @since 5.79
+     */
+    static bool cachedAcPluggedState();
+
+    /**
+     * One coherent view of the power state this process knows about.
+     *
+     * @see stateSnapshot()
+     * @since 5.79
+     */
+    struct StateSnapshot {
+        /** Whether acPlugged reflects a determined state; see isAcPluggedCached(). */
+        bool acPluggedKnown;
+        /** The last known AC plugged state. */
+        bool acPlugged;
+        /** How many inhibitions this process currently holds; see Inhibition::activeCount(). */
+        int activeInhibitions;
+    };
+
+    /**
+     * Returns a snapshot of the cached power state.
+     *
+     * All fields are read in one call from the singleton's cache, which
+     * the backend notifications keep current — no backend round trip is
+     * performed. Clients reacting to the signal bursts a resume produces
+     * can read the state from here instead of re-querying the system.
+     *
+     * @since 5.79
+     */
+    static StateSnapshot stateSnapshot();
+
     /**
      * Returns an InhibitionJob
      *
@@ -102,6 +152,11 @@ public:
 Q_SIGNALS:
     /**
      * Emitted when the system changes the power source
+     *
+     * Re-announcements of an unchanged state — the bursts a resume from
+     * suspend produces — are filtered out once the state is known, so
+     * every emission reports an actual transition.
+     *
      * @param plugged whether the system runs on AC
      */
     void acPluggedChanged(bool plugged);
@@ -17,9 +17,17 @@
 
 using namespace Solid;
 
+// resolved once on first use and shared by every job factory, so creating a
+// job doesn't re-inspect the environment each time
+static bool useDummyBackend()
+{
+    static const bool dummy = qgetenv("SOLID_POWER_BACKEND") == "DUMMY";
+    return dummy;
+}
+
 AbstractAcPluggedJob* PowerBackendLoader::AcPluggedJob()
 {
-    if (qgetenv("SOLID_POWER_BACKEND") == "DUMMY") {
+    if (useDummyBackend()) {
         return new DummyAcPluggedJob();
     }
     return new FDAcPluggedJob();
@@ -27,7 +35,7 @@ AbstractAcPluggedJob* PowerBackendLoader::AcPluggedJob()
 
 AbstractInhibitionJob* PowerBackendLoader::addInhibitionJob(Power::InhibitionTypes inhibitions, const QString &description)
 {
-    if (qgetenv("SOLID_POWER_BACKEND") == "DUMMY") {
+    if (useDummyBackend()) {
         return new DummyInhibitionJob(inhibitions, description);
     }
     return new FdInhibitionJob(inhibitions, description);
@@ -45,7 +53,7 @@ AbstractRequestStateJob* PowerBackendLoader::requestState()
 
 PowerNotifier* PowerBackendLoader::notifier()
 {
-    if (qgetenv("SOLID_POWER_BACKEND") == "DUMMY") {
+    if (useDummyBackend()) {
         return new DummyPowerNotifier();
     }
     return new FDPowerNotifier();
@@ -13,6 +13,11 @@
 
 using namespace Solid;
 
+// the set of supported states doesn't change at runtime, so it is resolved
+// once per process and every later job answers from memory
+static bool s_statesCached = false;
+static Power::InhibitionTypes s_cachedStates;
+
 StatesJobPrivate::StatesJobPrivate()
 {
     backendJob = nullptr;
@@ -25,8 +30,16 @@ StatesJob::StatesJob(QObject* parent) : Job(*new StatesJobPrivate(), parent)
 void StatesJob::doStart()
 {
     Q_D(StatesJob);
+
+    if (s_statesCached) {
+        emitResult();
+        return;
+    }
+
     d->backendJob = PowerBackendLoader::statesJob();
-    connect(d->backendJob, &AbstractStatesJob::result, [this]() {
+    connect(d->backendJob, &AbstractStatesJob::result, [this, d]() {
+        s_cachedStates = d->backendJob->states();
+        s_statesCached = true;
         emitResult();
     });
 
@@ -35,6 +48,9 @@ void StatesJob::doStart()
 
 Power::InhibitionTypes StatesJob::states() const
 {
+    if (s_statesCached) {
+        return s_cachedStates;
+    }
     if(d_func()->backendJob) {
         return d_func()->backendJob->states();
     }
@@ -8,11 +8,19 @@
 #include "solid-hardware.h"
 
 
+#include <QElapsedTimer>
+#include <QFutureWatcher>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QString>
 #include <QStringList>
 #include <QMetaProperty>
 #include <QMetaEnum>
 #include <QTextStream>
+#include <QVector>
+
+#include <algorithm>
+#include <functional>
 
 #include <QCommandLineParser>
 
@@ -145,6 +153,69 @@ std::ostream &operator<<(std::ostream &out, const Solid::Device &device)
     return out;
 }
 
+static QJsonValue propertyToJson(const QMetaProperty &property, const QVariant &value)
+{
+    if (property.isEnumType()) {
+        const QMetaEnum metaEnum = property.enumerator();
+        if (metaEnum.isFlag()) {
+            return QString::fromLatin1(metaEnum.valueToKeys(value.toInt()));
+        }
+        return QString::fromLatin1(metaEnum.valueToKey(value.toInt()));
+    }
+
+    return QJsonValue::fromVariant(value);
+}
+
+static QJsonObject deviceToJson(const Solid::Device &device, bool interfaces, bool nonportable)
+{
+    QJsonObject object;
+    object.insert(QStringLiteral("udi"), device.udi());
+
+    if (interfaces) {
+        object.insert(QStringLiteral("parent"), device.parentUdi());
+        object.insert(QStringLiteral("vendor"), device.vendor());
+        object.insert(QStringLiteral("product"), device.product());
+        object.insert(QStringLiteral("description"), device.description());
+        object.insert(QStringLiteral("icon"), device.icon());
+
+        const int index = Solid::DeviceInterface::staticMetaObject.indexOfEnumerator("Type");
+        const QMetaEnum typeEnum = Solid::DeviceInterface::staticMetaObject.enumerator(index);
+
+        for (int i = 0; i < typeEnum.keyCount(); i++) {
+            const Solid::DeviceInterface::Type type = (Solid::DeviceInterface::Type)typeEnum.value(i);
+            const Solid::DeviceInterface *interface = device.asDeviceInterface(type);
+
+            if (interface == nullptr) {
+                continue;
+            }
+
+            const QMetaObject *meta = interface->metaObject();
+
+            QJsonObject interfaceObject;
+            for (int j = meta->propertyOffset(); j < meta->propertyCount(); j++) {
+                const QMetaProperty property = meta->property(j);
+                interfaceObject.insert(QString::fromLatin1(property.name()),
+                                       propertyToJson(property, property.read(interface)));
+            }
+
+            object.insert(QString(meta->className()).mid(7), interfaceObject);
+        }
+    }
+
+    if (nonportable && device.is<Solid::GenericInterface>()) {
+        // One batch snapshot instead of one backend round trip per key.
+        const QMap<QString, QVariant> properties = device.as<Solid::GenericInterface>()->allProperties();
+        object.insert(QStringLiteral("properties"), QJsonObject::fromVariantMap(properties));
+    }
+
+    return object;
+}
+
+static void printJsonLine(const QJsonObject &object)
+{
+    cout << QJsonDocument(object).toJson(QJsonDocument::Compact).constData() << endl;
+}
+
 std::ostream &operator<<(std::ostream &out, const QMap<QString,QVariant> &properties)
 {
     for (auto it = properties.cbegin(); it != properties.cend(); ++it) {
@@ -179,7 +250,9 @@ static QString commandsHelp()
             "             # - If the 'details' option is specified, the device interfaces\n"
             "             # and the corresponding properties are listed in a platform\n"
             "             # neutral fashion,\n"
-            "             # - Otherwise only device UDIs are listed.\n") << '\n';
+            "             # - Otherwise only device UDIs are listed.\n"
+            "             # With --json, one JSON object per device is emitted instead\n"
+            "             # (NDJSON), suitable for machine consumption.\n") << '\n';
 
     cout << "  solid-hardware details 'udi'" << '\n';
     cout << QCoreApplication::translate("solid-hardware",
@@ -198,21 +271,50 @@ static QString commandsHelp()
             "             # branch of the corresponding device,\n"
             "             # - Otherwise the search is done on all the devices.\n") << '\n';
 
-    cout << "  solid-hardware mount 'udi'" << '\n';
+    cout << "  solid-hardware mount 'udi' ['udi'...]" << '\n';
     cout << QCoreApplication::translate("solid-hardware",
-            "             # If applicable, mount the device corresponding to 'udi'.\n") << '\n';
+            "             # If applicable, mount the devices corresponding to the given UDIs.\n"
+            "             # Several UDIs share one library initialization and are mounted\n"
+            "             # concurrently; one status line is printed per device.\n") << '\n';
 
-    cout << "  solid-hardware unmount 'udi'" << '\n';
+    cout << "  solid-hardware unmount 'udi' ['udi'...]" << '\n';
     cout << QCoreApplication::translate("solid-hardware",
-            "             # If applicable, unmount the device corresponding to 'udi'.\n") << '\n';
+            "             # If applicable, unmount the devices corresponding to the given UDIs.\n") << '\n';
 
     cout << "  solid-hardware eject 'udi'" << '\n';
     cout << QCoreApplication::translate("solid-hardware",
             "             # If applicable, eject the device corresponding to 'udi'.\n") << '\n';
 
-    cout << "  solid-hardware listen" << '\n';
+    cout << "  solid-hardware benchmark ['runs']" << '\n';
+    cout << QCoreApplication::translate("solid-hardware",
+            "             # Run device enumeration, per-type queries and predicate\n"
+            "             # matching 'runs' times (default 20) and report\n"
+            "             # min/median/p99 timings, for performance regression testing.\n") << '\n';
+
+    cout << "  solid-hardware listen ['predicate']" << '\n';
+    cout << QCoreApplication::translate("solid-hardware",
+            "             # Listen to all add/remove events on supported hardware.\n"
+            "             # - If 'predicate' is specified, only events of devices\n"
+            "             # matching it are printed.") << '\n';
+
+    cout << "  solid-hardware record 'file'" << '\n';
+    cout << QCoreApplication::translate("solid-hardware",
+            "             # Record all device add/remove/change events with\n"
+            "             # timestamps to 'file' until interrupted. The log can be\n"
+            "             # replayed against the fake backend for deterministic\n"
+            "             # performance testing and regression bisecting.") << '\n';
+
+    cout << "  solid-hardware dump-state ['file']" << '\n';
+    cout << QCoreApplication::translate("solid-hardware",
+            "             # Dump Solid's internal state — cache and index sizes,\n"
+            "             # subscription counts, performance counters — as JSON to\n"
+            "             # 'file' (or standard output), for performance forensics.\n") << '\n';
+
+    cout << "  solid-hardware diff-state 'before' 'after'" << '\n';
     cout << QCoreApplication::translate("solid-hardware",
-            "             # Listen to all add/remove events on supported hardware.") << '\n';
+            "             # Compare two state dumps and print the values that\n"
+            "             # changed, to spot cache leaks or subscription\n"
+            "             # accumulation between two points in time.\n") << '\n';
 
     return data;
 }
@@ -235,6 +337,10 @@ int main(int argc, char **argv)
     commands.setFlags(QCommandLineOption::HiddenFromHelp);
     parser.addOption(commands);
 
+    QCommandLineOption jsonOption("json", QCoreApplication::translate("solid-hardware",
+                                  "Emit one JSON object per device (NDJSON) instead of human-readable text"));
+    parser.addOption(jsonOption);
+
     parser.process(app);
     if (parser.isSet(commands))
     {
@@ -258,13 +364,13 @@ int main(int argc, char **argv)
         parser.process(app);
         args = parser.positionalArguments();
         QByteArray extra(args.count() == 2 ? args.at(1).toLocal8Bit() : "");
-        return app.hwList(extra == "details", extra == "nonportableinfo");
+        return app.hwList(extra == "details", extra == "nonportableinfo", parser.isSet(jsonOption));
     } else if (command == "details") {
         const QString udi = getUdiFromArguments(app, parser);
-        return app.hwCapabilities(udi);
+        return app.hwCapabilities(udi, parser.isSet(jsonOption));
     } else if (command == "nonportableinfo") {
         const QString udi = getUdiFromArguments(app, parser);
-        return app.hwProperties(udi);
+        return app.hwProperties(udi, parser.isSet(jsonOption));
     } else if (command == "query") {
         parser.addPositionalArgument("udi", QCoreApplication::translate("solid-hardware", "Device udi"));
         parser.addPositionalArgument("parent", QCoreApplication::translate("solid-hardware", "Parent device udi"));
@@ -282,17 +388,75 @@ int main(int argc, char **argv)
         }
 
         return app.hwQuery(parent, query);
-    } else if (command == "mount") {
-        const QString udi = getUdiFromArguments(app, parser);
-        return app.hwVolumeCall(SolidHardware::Mount, udi);
-    } else if (command == "unmount") {
-        const QString udi = getUdiFromArguments(app, parser);
-        return app.hwVolumeCall(SolidHardware::Unmount, udi);
+    } else if (command == "mount" || command == "unmount") {
+        parser.addPositionalArgument("udi", QCoreApplication::translate("solid-hardware", "Device udis"), "udi [udi...]");
+        parser.process(app);
+        const QStringList udis = parser.positionalArguments().mid(1);
+        if (udis.isEmpty()) {
+            parser.showHelp(1);
+        }
+
+        const SolidHardware::VolumeCallType type = (command == "mount") ? SolidHardware::Mount : SolidHardware::Unmount;
+        if (udis.count() == 1) {
+            return app.hwVolumeCall(type, udis.first());
+        }
+        return app.hwBulkVolumeCall(type, udis);
     } else if (command == "eject") {
         const QString udi = getUdiFromArguments(app, parser);
         return app.hwVolumeCall(SolidHardware::Eject, udi);
+    } else if (command == "benchmark") {
+        parser.addPositionalArgument("runs", QCoreApplication::translate("solid-hardware", "Number of runs"));
+        parser.process(app);
+
+        int runs = 20;
+        if (parser.positionalArguments().count() == 2) {
+            bool ok = false;
+            runs = parser.positionalArguments().at(1).toInt(&ok);
+            if (!ok || runs < 1) {
+                parser.showHelp(1);
+            }
+        }
+
+        return app.benchmark(runs);
     } else if (command == "listen") {
-        return app.listen();
+        parser.addPositionalArgument("predicate", QCoreApplication::translate("solid-hardware", "Predicate to filter events"));
+        parser.process(app);
+
+        QString query;
+        if (parser.positionalArguments().count() == 2) {
+            query = parser.positionalArguments().at(1);
+        }
+
+        return app.listen(query);
+    } else if (command == "record") {
+        parser.addPositionalArgument("file", QCoreApplication::translate("solid-hardware", "File to record the events to"));
+        parser.process(app);
+
+        if (parser.positionalArguments().count() != 2) {
+            parser.showHelp(1);
+        }
+
+        return app.record(parser.positionalArguments().at(1));
+    } else if (command == "dump-state") {
+        parser.addPositionalArgument("file", QCoreApplication::translate("solid-hardware", "File to write the state dump to"));
+        parser.process(app);
+
+        const QStringList dumpArgs = parser.positionalArguments();
+        if (dumpArgs.count() > 2) {
+            parser.showHelp(1);
+        }
+
+        return app.hwDumpState(dumpArgs.count() == 2 ? dumpArgs.at(1) : QString());
+    } else if (command == "diff-state") {
+        parser.addPositionalArgument("before", QCoreApplication::translate("solid-hardware", "State dump to compare from"));
+        parser.addPositionalArgument("after", QCoreApplication::translate("solid-hardware", "State dump to compare to"));
+        parser.process(app);
+
+        if (parser.positionalArguments().count() != 3) {
+            parser.showHelp(1);
+        }
+
+        return app.hwDiffState(parser.positionalArguments().at(1), parser.positionalArguments().at(2));
     }
 
     cerr << QCoreApplication::translate("solid-hardware", "Syntax Error: Unknown command '%1'").arg(command) << endl;
@@ -300,10 +464,17 @@ int main(int argc, char **argv)
     return 1;
 }
 
-bool SolidHardware::hwList(bool interfaces, bool system)
+bool SolidHardware::hwList(bool interfaces, bool system, bool json)
 {
     const QList<Solid::Device> all = Solid::Device::allDevices();
 
+    if (json) {
+        for (const Solid::Device &device : all) {
+            printJsonLine(deviceToJson(device, interfaces, system));
+        }
+        return true;
+    }
+
     for (const Solid::Device &device : all)
     {
         cout << "udi = '" << device.udi() << "'" << endl;
@@ -322,20 +493,30 @@ bool SolidHardware::hwList(bool interfaces, bool system)
     return true;
 }
 
-bool SolidHardware::hwCapabilities(const QString &udi)
+bool SolidHardware::hwCapabilities(const QString &udi, bool json)
 {
     const Solid::Device device(udi);
 
+    if (json) {
+        printJsonLine(deviceToJson(device, true, false));
+        return true;
+    }
+
     cout << "udi = '" << device.udi() << "'" << endl;
     cout << device << endl;
 
     return true;
 }
 
-bool SolidHardware::hwProperties(const QString &udi)
+bool SolidHardware::hwProperties(const QString &udi, bool json)
 {
     const Solid::Device device(udi);
 
+    if (json) {
+        printJsonLine(deviceToJson(device, false, true));
+        return true;
+    }
+
     cout << "udi = '" << device.udi() << "'" << endl;
     if (device.is<Solid::GenericInterface>()) {
         QMap<QString,QVariant> properties = device.as<Solid::GenericInterface>()->allProperties();
@@ -408,8 +589,222 @@ bool SolidHardware::hwVolumeCall(SolidHardware::VolumeCallType type, const QStri
     return true;
 }
 
-bool SolidHardware::listen()
+bool SolidHardware::hwBulkVolumeCall(SolidHardware::VolumeCallType type, const QStringList &udis)
+{
+    // One process, one library initialization, one aggregated request:
+    // the per-device operations are all started before the first outcome
+    // is awaited, so a batch costs roughly its slowest member instead of
+    // the sum of the members.
+    QList<Solid::Device> devices;
+    devices.reserve(udis.count());
+    for (const QString &udi : udis) {
+        devices.append(Solid::Device(udi));
+    }
+
+    QFuture<QMap<QString, Solid::StorageAccess::AccessResult>> future
+        = (type == Mount) ? Solid::StorageAccess::setupAll(devices)
+                          : Solid::StorageAccess::teardownAll(devices);
+
+    QFutureWatcher<QMap<QString, Solid::StorageAccess::AccessResult>> watcher;
+    connect(&watcher, &QFutureWatcherBase::finished, &m_loop, &QEventLoop::quit);
+    watcher.setFuture(future);
+    if (!future.isFinished()) {
+        m_loop.exec();
+    }
+
+    const QMap<QString, Solid::StorageAccess::AccessResult> results = future.result();
+
+    bool allOk = true;
+    for (const QString &udi : udis) {
+        const Solid::StorageAccess::AccessResult result = results.value(udi);
+        if (result.error == Solid::NoError) {
+            cout << udi << ": " << tr("ok") << endl;
+        } else {
+            allOk = false;
+            QString message = result.errorData.toString();
+            if (message.isEmpty()) {
+                message = tr("operation failed (error %1)").arg(int(result.error));
+            }
+            cerr << udi << ": " << tr("error: %1").arg(message) << endl;
+        }
+    }
+
+    return allOk;
+}
+
+bool SolidHardware::hwDumpState(const QString &filePath)
+{
+    const QVariantMap state = Solid::DeviceNotifier::diagnosticState();
+    QByteArray json = QJsonDocument(QJsonObject::fromVariantMap(state)).toJson(QJsonDocument::Compact);
+    json.append('\n');
+
+    if (filePath.isEmpty()) {
+        cout << json.constData();
+        return true;
+    }
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        cerr << tr("Error: cannot write %1.").arg(filePath) << endl;
+        return false;
+    }
+    file.write(json);
+    return true;
+}
+
+static bool readStateDump(const QString &filePath, QVariantMap *state)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        cerr << SolidHardware::tr("Error: cannot read %1.").arg(filePath) << endl;
+        return false;
+    }
+
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (!document.isObject()) {
+        cerr << SolidHardware::tr("Error: %1 is not a state dump: %2.")
+                .arg(filePath, parseError.errorString()) << endl;
+        return false;
+    }
+
+    *state = document.object().toVariantMap();
+    return true;
+}
+
+/* Nested groups become dotted keys ("backends./org/....cachedProperties"),
+ * so two dumps diff as flat key/value sets whatever their grouping. */
+static void flattenState(const QVariantMap &state, const QString &prefix, QMap<QString, QVariant> *flat)
+{
+    for (auto it = state.constBegin(); it != state.constEnd(); ++it) {
+        const QString key = prefix.isEmpty() ? it.key() : prefix + '.' + it.key();
+        if (it.value().type() == QVariant::Map) {
+            flattenState(it.value().toMap(), key, flat);
+        } else {
+            flat->insert(key, it.value());
+        }
+    }
+}
+
+bool SolidHardware::hwDiffState(const QString &beforePath, const QString &afterPath)
+{
+    QVariantMap before;
+    QVariantMap after;
+    if (!readStateDump(beforePath, &before) || !readStateDump(afterPath, &after)) {
+        return false;
+    }
+
+    QMap<QString, QVariant> flatBefore;
+    QMap<QString, QVariant> flatAfter;
+    flattenState(before, QString(), &flatBefore);
+    flattenState(after, QString(), &flatAfter);
+
+    QStringList keys = flatBefore.keys() + flatAfter.keys();
+    keys.removeDuplicates();
+    keys.sort();
+
+    int differences = 0;
+    for (const QString &key : qAsConst(keys)) {
+        const bool inBefore = flatBefore.contains(key);
+        const bool inAfter = flatAfter.contains(key);
+
+        if (!inAfter) {
+            cout << key << ": " << flatBefore.value(key) << " -> " << tr("(gone)") << endl;
+            ++differences;
+        } else if (!inBefore) {
+            cout << key << ": " << tr("(new)") << " -> " << flatAfter.value(key) << endl;
+            ++differences;
+        } else if (flatBefore.value(key) != flatAfter.value(key)) {
+            cout << key << ": " << flatBefore.value(key) << " -> " << flatAfter.value(key) << endl;
+            ++differences;
+        }
+    }
+
+    if (differences == 0) {
+        cout << tr("No differences.") << endl;
+    }
+    return true;
+}
+
+static qint64 percentileOf(const QVector<qint64> &sortedSamples, double percentile)
+{
+    const int index = int(percentile * (sortedSamples.count() - 1) + 0.5);
+    return sortedSamples.at(qBound(0, index, sortedSamples.count() - 1));
+}
+
+bool SolidHardware::benchmark(int runs)
+{
+    struct Benchmark {
+        QString name;
+        std::function<int()> run;
+    };
+
+    const QList<Benchmark> benchmarks = {
+        { QStringLiteral("full enumeration (allDevices)"), []() {
+            return Solid::Device::allDevices().count();
+        } },
+        { QStringLiteral("per-type queries (listFromType, all types)"), []() {
+            int count = 0;
+            const int index = Solid::DeviceInterface::staticMetaObject.indexOfEnumerator("Type");
+            const QMetaEnum typeEnum = Solid::DeviceInterface::staticMetaObject.enumerator(index);
+            for (int i = 0; i < typeEnum.keyCount(); i++) {
+                const Solid::DeviceInterface::Type type = (Solid::DeviceInterface::Type)typeEnum.value(i);
+                count += Solid::Device::listFromType(type).count();
+            }
+            return count;
+        } },
+        { QStringLiteral("predicate matching (StorageVolume.usage == 'FileSystem')"), []() {
+            return Solid::Device::listFromQuery(QStringLiteral("StorageVolume.usage == 'FileSystem'")).count();
+        } },
+    };
+
+    cout << tr("Running %1 iterations per benchmark (plus one discarded warm-up)...").arg(runs) << endl << endl;
+
+    for (const Benchmark &benchmark : benchmarks) {
+        // The warm-up run populates the frontend caches and loads the
+        // backends, so the reported numbers describe steady-state cost.
+        const int results = benchmark.run();
+
+        QVector<qint64> samples;
+        samples.reserve(runs);
+
+        QElapsedTimer timer;
+        for (int i = 0; i < runs; i++) {
+            timer.start();
+            benchmark.run();
+            samples.append(timer.nsecsElapsed());
+        }
+
+        std::sort(samples.begin(), samples.end());
+
+        cout << benchmark.name << endl;
+        cout << tr("  results: %1  min: %2 us  median: %3 us  p99: %4 us")
+                .arg(results)
+                .arg(samples.first() / 1000.0, 0, 'f', 1)
+                .arg(percentileOf(samples, 0.5) / 1000.0, 0, 'f', 1)
+                .arg(percentileOf(samples, 0.99) / 1000.0, 0, 'f', 1) << endl;
+    }
+
+    return true;
+}
+
+bool SolidHardware::listen(const QString &query)
 {
+    if (!query.isEmpty()) {
+        m_listenPredicate = Solid::Predicate::fromString(query);
+        if (!m_listenPredicate.isValid()) {
+            cerr << tr("Error: invalid predicate '%1'").arg(query) << endl;
+            return false;
+        }
+
+        // Remember the devices matching right now, so removal events can
+        // be filtered later without touching the then-vanished device.
+        const QList<Solid::Device> devices = Solid::Device::listFromQuery(m_listenPredicate);
+        for (const Solid::Device &device : devices) {
+            m_matchedUdis.insert(device.udi());
+        }
+    }
+
     Solid::DeviceNotifier *notifier = Solid::DeviceNotifier::instance();
     bool a = connect(notifier, SIGNAL(deviceAdded(QString)), this, SLOT(deviceAdded(QString)));
     bool d = connect(notifier, SIGNAL(deviceRemoved(QString)), this, SLOT(deviceRemoved(QString)));
@@ -425,16 +820,87 @@ bool SolidHardware::listen()
 
 void SolidHardware::deviceAdded(const QString &udi)
 {
+    if (m_listenPredicate.isValid()) {
+        if (!m_listenPredicate.matches(Solid::Device(udi))) {
+            return;
+        }
+        m_matchedUdis.insert(udi);
+    }
+
     cout << "Device Added:" << endl;
     cout << "udi = '" << udi << "'" << endl;
 }
 
 void SolidHardware::deviceRemoved(const QString &udi)
 {
+    if (m_listenPredicate.isValid() && !m_matchedUdis.remove(udi)) {
+        return;
+    }
+
     cout << "Device Removed:" << endl;
     cout << "udi = '" << udi << "'" << endl;
 }
 
+bool SolidHardware::record(const QString &filePath)
+{
+    m_recordFile.setFileName(filePath);
+    if (!m_recordFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        cerr << tr("Error: cannot write '%1'").arg(filePath) << endl;
+        return false;
+    }
+    m_recordStream.setDevice(&m_recordFile);
+    m_recordStream << "# solid-hardware event log: <msecs> added|removed|changed <udi>\n";
+
+    // Keep the current population registered, so its property changes
+    // reach the journal, and record changes from here on.
+    m_recordedDevices = Solid::Device::allDevices();
+    Solid::DeviceNotifier::setChangeJournalEnabled(true);
+    m_recordSequence = Solid::DeviceNotifier::lastEventSequence();
+    m_recordClock.start();
+
+    m_recordPollTimer.setInterval(100);
+    connect(&m_recordPollTimer, SIGNAL(timeout()), this, SLOT(drainEventJournal()));
+    m_recordPollTimer.start();
+
+    cout << tr("Recording device events to '%1', interrupt to stop.").arg(filePath) << endl;
+    m_loop.exec();
+    return true;
+}
+
+void SolidHardware::drainEventJournal()
+{
+    QList<Solid::DeviceNotifier::Event> events;
+    if (!Solid::DeviceNotifier::eventsSince(m_recordSequence, &events)) {
+        // The journal wrapped between two polls; resync and leave a
+        // mark so the gap is visible in the log.
+        m_recordStream << "# journal overflowed, events lost\n";
+        m_recordSequence = Solid::DeviceNotifier::lastEventSequence();
+        m_recordStream.flush();
+        return;
+    }
+
+    const qint64 msecs = m_recordClock.elapsed();
+    for (const Solid::DeviceNotifier::Event &event : qAsConst(events)) {
+        const char *kind = "changed";
+        switch (event.kind) {
+        case Solid::DeviceNotifier::Event::DeviceAdded:
+            kind = "added";
+            break;
+        case Solid::DeviceNotifier::Event::DeviceRemoved:
+            kind = "removed";
+            break;
+        case Solid::DeviceNotifier::Event::DeviceChanged:
+            break;
+        }
+        m_recordStream << msecs << ' ' << kind << ' ' << event.udi << '\n';
+        m_recordSequence = event.sequence;
+    }
+
+    if (!events.isEmpty()) {
+        m_recordStream.flush();
+    }
+}
+
 void SolidHardware::slotStorageResult(Solid::ErrorType error, const QVariant &errorData)
 {
     if (error) {
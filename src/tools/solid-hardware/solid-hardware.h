@@ -9,8 +9,15 @@
 #define SOLID_HARDWARE_H
 
 #include <QCoreApplication>
+#include <QElapsedTimer>
 #include <QEventLoop>
+#include <QFile>
+#include <QSet>
+#include <QTextStream>
+#include <QTimer>
 
+#include <solid/device.h>
+#include <solid/predicate.h>
 #include <solid/storageaccess.h>
 
 class QCommandLineParser;
@@ -20,24 +27,46 @@ class SolidHardware : public QCoreApplication
 public:
     SolidHardware(int &argc, char **argv) : QCoreApplication(argc, argv), m_error(0) {}
 
-    bool hwList(bool interfaces, bool system);
-    bool hwCapabilities(const QString &udi);
-    bool hwProperties(const QString &udi);
+    bool hwList(bool interfaces, bool system, bool json = false);
+    bool hwCapabilities(const QString &udi, bool json = false);
+    bool hwProperties(const QString &udi, bool json = false);
     bool hwQuery(const QString &parentUdi, const QString &query);
-    bool listen();
+    bool benchmark(int runs);
+    bool listen(const QString &query = QString());
+    bool record(const QString &filePath);
+    bool hwDumpState(const QString &filePath);
+    bool hwDiffState(const QString &beforePath, const QString &afterPath);
 
     enum VolumeCallType { Mount, Unmount, Eject };
     bool hwVolumeCall(VolumeCallType type, const QString &udi);
+    bool hwBulkVolumeCall(VolumeCallType type, const QStringList &udis);
 
 private:
     QEventLoop m_loop;
     int m_error;
     QString m_errorString;
 
+    // Filter state for listen: events are only printed for devices
+    // matching the predicate. Matching UDIs are remembered so removal
+    // events can be filtered without touching the vanished device.
+    Solid::Predicate m_listenPredicate;
+    QSet<QString> m_matchedUdis;
+
+    // Recording state: the notifier's event journal is tailed
+    // periodically and written out with timestamps. The device list
+    // keeps the population registered so property changes are journaled.
+    QFile m_recordFile;
+    QTextStream m_recordStream;
+    QElapsedTimer m_recordClock;
+    QTimer m_recordPollTimer;
+    quint64 m_recordSequence = 0;
+    QList<Solid::Device> m_recordedDevices;
+
 private Q_SLOTS:
     void slotStorageResult(Solid::ErrorType error, const QVariant &errorData);
     void deviceAdded(const QString &udi);
     void deviceRemoved(const QString &udi);
+    void drainEventJournal();
 };
 
 Q_DECLARE_METATYPE(QList<int>)